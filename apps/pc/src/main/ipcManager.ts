@@ -2,7 +2,7 @@ import path from "node:path";
 import { ipcMain } from "electron";
 
 import trainer from "../native/build/Release/trainer.node";
-import { bufferToNumber, IDataType, IDataTypeSize, numberToBuffer } from "./utils";
+import { IDataType } from "./utils";
 
 export function bindIpcEvents(): void {
   // IPC test
@@ -20,24 +20,44 @@ export function bindIpcEvents(): void {
   });
 
   ipcMain.handle("read-memory", (_event, pointer, type: IDataType) => {
-    const addr = trainer.resolvePointer(pointer);
-    const buff = trainer.readBytes(addr, IDataTypeSize[type.toUpperCase()]);
-    return buff ? bufferToNumber(buff, type) : null;
+    return trainer.readValue(pointer, type);
   });
 
   ipcMain.handle("write-memory", (_event, pointer, type: IDataType, value) => {
-    const addr = trainer.resolvePointer(pointer);
-    const buff = numberToBuffer(value, type);
-    return trainer.writeBytes(addr, buff);
+    return trainer.writeValue(pointer, type, value);
   });
 
+  // 值由 native 侧按类型校验和编码，非法值返回 -1 而不是锁定错误的字节
   ipcMain.handle("lock-memory", (_event, pointer, type: IDataType, value) => {
-    const addr = trainer.resolvePointer(pointer);
-    const buff = numberToBuffer(value, type);
-    return trainer.lockMemory(addr, buff, 200);
+    return trainer.lockValue(pointer, type, value, 200);
   });
 
   ipcMain.handle("unlock-memory", (_event, id) => {
     return trainer.unlockMemory(id);
   });
+
+  // 修改器表：一次加载、整表（或分组）应用/读取/锁定
+  ipcMain.handle("load-table", (_event, entries) => {
+    return trainer.loadTable(entries);
+  });
+
+  ipcMain.handle("apply-table", (_event, id: number, group?: string) => {
+    return trainer.applyTable(id, group);
+  });
+
+  ipcMain.handle("read-table", (_event, id: number, group?: string) => {
+    return trainer.readTable(id, group);
+  });
+
+  ipcMain.handle("lock-table", (_event, id: number, group?: string) => {
+    return trainer.lockTable(id, group);
+  });
+
+  ipcMain.handle("unlock-table", (_event, id: number, group?: string) => {
+    return trainer.unlockTable(id, group);
+  });
+
+  ipcMain.handle("release-table", (_event, id: number) => {
+    return trainer.releaseTable(id);
+  });
 }
@@ -0,0 +1,307 @@
+#include "aob_scanner.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <queue>
+#include "cpu_features.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define AOB_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define AOB_TARGET_AVX2
+#else
+#define AOB_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+
+// x86 代码/数据中常见字节的权重，越大越常见；选择锚点时优先使用权重小的字节
+int ByteWeight(uint8_t b) {
+    switch (b) {
+    case 0x00: case 0xFF: case 0xCC: return 100;
+    case 0x48: case 0x8B: case 0x89: case 0x0F: case 0x4C: case 0x24: case 0x44: return 50;
+    case 0xE8: case 0x83: case 0x85: case 0xC0: case 0x01: case 0x90: case 0x74: case 0x75: case 0xEB: return 20;
+    default: return 1;
+    }
+}
+
+int HexNibble(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// 对每个满足 data[i+o1]==b1 && data[i+o2]==b2 的 i ∈ [0, count) 调用 fn(i)
+template<typename F>
+void FilterScalar(const uint8_t* data, size_t count, uint32_t o1, uint8_t b1, uint32_t o2, uint8_t b2, F&& fn) {
+    for (size_t i = 0; i < count; ++i) {
+        if (data[i + o1] == b1 && data[i + o2] == b2) fn(i);
+    }
+}
+
+inline unsigned LowestBit32(uint32_t v) {
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward(&idx, v);
+    return idx;
+#else
+    return static_cast<unsigned>(__builtin_ctz(v));
+#endif
+}
+
+#ifdef AOB_X86
+template<typename F>
+void FilterSse2(const uint8_t* data, size_t count, uint32_t o1, uint8_t b1, uint32_t o2, uint8_t b2, F&& fn) {
+    const __m128i v1 = _mm_set1_epi8(static_cast<char>(b1));
+    const __m128i v2 = _mm_set1_epi8(static_cast<char>(b2));
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + o1));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + o2));
+        uint32_t bits = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, v1), _mm_cmpeq_epi8(b, v2))));
+        while (bits) {
+            fn(i + LowestBit32(bits));
+            bits &= bits - 1;
+        }
+    }
+    FilterScalar(data + i, count - i, o1, b1, o2, b2, [&](size_t k) { fn(i + k); });
+}
+
+template<typename F>
+AOB_TARGET_AVX2 void FilterAvx2(const uint8_t* data, size_t count, uint32_t o1, uint8_t b1, uint32_t o2, uint8_t b2, F&& fn) {
+    const __m256i v1 = _mm256_set1_epi8(static_cast<char>(b1));
+    const __m256i v2 = _mm256_set1_epi8(static_cast<char>(b2));
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + o1));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + o2));
+        uint32_t bits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, v1), _mm256_cmpeq_epi8(b, v2))));
+        while (bits) {
+            fn(i + LowestBit32(bits));
+            bits &= bits - 1;
+        }
+    }
+    FilterScalar(data + i, count - i, o1, b1, o2, b2, [&](size_t k) { fn(i + k); });
+}
+#endif
+
+} // namespace
+
+// ---------------- Signature ----------------
+
+bool Signature::Parse(const std::string& text, Signature& out) {
+    out.bytes.clear();
+    out.mask.clear();
+    size_t i = 0;
+    while (i < text.size()) {
+        if (std::isspace(static_cast<unsigned char>(text[i]))) { ++i; continue; }
+        // 单独的 "?" 表示整字节通配
+        if (text[i] == '?' && (i + 1 >= text.size() || std::isspace(static_cast<unsigned char>(text[i + 1])))) {
+            out.bytes.push_back(0);
+            out.mask.push_back(0);
+            ++i;
+            continue;
+        }
+        if (i + 1 >= text.size()) return false;
+        char hi = text[i], lo = text[i + 1];
+        if (i + 2 < text.size() && !std::isspace(static_cast<unsigned char>(text[i + 2]))) return false;
+        uint8_t value = 0, mask = 0;
+        if (hi != '?') {
+            int n = HexNibble(hi);
+            if (n < 0) return false;
+            value |= static_cast<uint8_t>(n << 4);
+            mask |= 0xF0;
+        }
+        if (lo != '?') {
+            int n = HexNibble(lo);
+            if (n < 0) return false;
+            value |= static_cast<uint8_t>(n);
+            mask |= 0x0F;
+        }
+        out.bytes.push_back(value);
+        out.mask.push_back(mask);
+        i += 2;
+    }
+    // 至少需要一个精确字节作为锚点
+    return std::find(out.mask.begin(), out.mask.end(), 0xFF) != out.mask.end();
+}
+
+std::string Signature::ToString() const {
+    static const char kHex[] = "0123456789ABCDEF";
+    std::string s;
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        if (i) s.push_back(' ');
+        s.push_back((mask[i] & 0xF0) ? kHex[bytes[i] >> 4] : '?');
+        s.push_back((mask[i] & 0x0F) ? kHex[bytes[i] & 0xF] : '?');
+    }
+    return s;
+}
+
+bool Signature::MatchAt(const uint8_t* p) const {
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        if ((p[i] & mask[i]) != bytes[i]) return false;
+    }
+    return true;
+}
+
+// ---------------- AobScanner ----------------
+
+AobScanner::AobScanner() : maxLength(0), simd(DetectSimd()), built(false) {}
+
+AobScanner::SimdLevel AobScanner::DetectSimd() {
+#ifdef AOB_X86
+    return GetCpuFeatures().avx2 ? SimdLevel::AVX2 : SimdLevel::SSE2;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+uint32_t AobScanner::Add(const Signature& sig) {
+    sigs.push_back(sig);
+    maxLength = std::max(maxLength, sig.Size());
+    built = false;
+    return static_cast<uint32_t>(sigs.size() - 1);
+}
+
+void AobScanner::Clear() {
+    sigs.clear();
+    prepared.clear();
+    delta.clear();
+    outputs.clear();
+    maxLength = 0;
+    built = false;
+}
+
+void AobScanner::Build() {
+    prepared.assign(sigs.size(), Prepared{});
+    for (size_t s = 0; s < sigs.size(); ++s) {
+        const Signature &sig = sigs[s];
+        Prepared &p = prepared[s];
+        // 两个权重最小的精确字节作为 SIMD 过滤锚点；只有一个精确字节时两个锚点相同
+        int best1 = -1, best2 = -1;
+        for (size_t i = 0; i < sig.Size(); ++i) {
+            if (sig.mask[i] != 0xFF) continue;
+            int w = ByteWeight(sig.bytes[i]);
+            if (best1 < 0 || w < ByteWeight(sig.bytes[best1])) {
+                best2 = best1;
+                best1 = static_cast<int>(i);
+            } else if (best2 < 0 || w < ByteWeight(sig.bytes[best2])) {
+                best2 = static_cast<int>(i);
+            }
+        }
+        if (best1 < 0) best1 = 0;       // Parse 保证至少有一个精确字节
+        if (best2 < 0) best2 = best1;
+        p.anchor1 = static_cast<uint32_t>(best1);
+        p.anchor2 = static_cast<uint32_t>(best2);
+
+        // 最长的连续精确片段，超过 kMaxFragment 时截取
+        size_t runStart = 0, bestStart = 0, bestLen = 0;
+        for (size_t i = 0; i <= sig.Size(); ++i) {
+            if (i < sig.Size() && sig.mask[i] == 0xFF) continue;
+            if (i - runStart > bestLen) {
+                bestLen = i - runStart;
+                bestStart = runStart;
+            }
+            runStart = i + 1;
+        }
+        p.fragOffset = static_cast<uint32_t>(bestStart);
+        p.fragLength = static_cast<uint32_t>(std::min(bestLen, kMaxFragment));
+    }
+
+    delta.clear();
+    outputs.clear();
+    if (sigs.size() > kDirectLimit) {
+        // 先构建 trie（0 为根），再按 BFS 计算失败链并补全为稠密 DFA
+        delta.assign(256, 0);
+        outputs.emplace_back();
+        std::vector<uint8_t> hasEdge(256, 0);
+        for (size_t s = 0; s < sigs.size(); ++s) {
+            const Prepared &p = prepared[s];
+            uint32_t state = 0;
+            for (uint32_t k = 0; k < p.fragLength; ++k) {
+                uint8_t c = sigs[s].bytes[p.fragOffset + k];
+                uint32_t &next = delta[state * 256 + c];
+                if (!hasEdge[state * 256 + c]) {
+                    uint32_t created = static_cast<uint32_t>(outputs.size());
+                    hasEdge[state * 256 + c] = 1;
+                    next = created;
+                    outputs.emplace_back();
+                    delta.resize(delta.size() + 256, 0);
+                    hasEdge.resize(hasEdge.size() + 256, 0);
+                }
+                state = delta[state * 256 + c];
+            }
+            outputs[state].push_back(static_cast<uint32_t>(s));
+        }
+        std::vector<uint32_t> fail(outputs.size(), 0);
+        std::queue<uint32_t> q;
+        for (int c = 0; c < 256; ++c) {
+            if (hasEdge[c]) q.push(delta[c]);
+        }
+        while (!q.empty()) {
+            uint32_t u = q.front();
+            q.pop();
+            const auto &inherited = outputs[fail[u]];
+            outputs[u].insert(outputs[u].end(), inherited.begin(), inherited.end());
+            for (int c = 0; c < 256; ++c) {
+                size_t e = static_cast<size_t>(u) * 256 + c;
+                if (hasEdge[e]) {
+                    fail[delta[e]] = delta[static_cast<size_t>(fail[u]) * 256 + c];
+                    q.push(delta[e]);
+                } else {
+                    delta[e] = delta[static_cast<size_t>(fail[u]) * 256 + c];
+                }
+            }
+        }
+    }
+    built = true;
+}
+
+void AobScanner::Scan(const uint8_t* data, size_t len, size_t limit, uintptr_t base, std::vector<AobMatch>& out) const {
+    if (!built || sigs.empty()) return;
+    limit = std::min(limit, len);
+    if (sigs.size() > kDirectLimit) ScanAutomaton(data, len, limit, base, out);
+    else ScanDirect(data, len, limit, base, out);
+}
+
+void AobScanner::ScanDirect(const uint8_t* data, size_t len, size_t limit, uintptr_t base, std::vector<AobMatch>& out) const {
+    for (size_t s = 0; s < sigs.size(); ++s) {
+        const Signature &sig = sigs[s];
+        const Prepared &p = prepared[s];
+        if (sig.Size() > len) continue;
+        size_t count = std::min(limit, len - sig.Size() + 1);
+        uint8_t b1 = sig.bytes[p.anchor1], b2 = sig.bytes[p.anchor2];
+        auto verify = [&](size_t i) {
+            if (sig.MatchAt(data + i)) out.push_back({ static_cast<uint32_t>(s), base + i });
+        };
+        switch (simd) {
+#ifdef AOB_X86
+        case SimdLevel::AVX2: FilterAvx2(data, count, p.anchor1, b1, p.anchor2, b2, verify); break;
+        case SimdLevel::SSE2: FilterSse2(data, count, p.anchor1, b1, p.anchor2, b2, verify); break;
+#endif
+        default: FilterScalar(data, count, p.anchor1, b1, p.anchor2, b2, verify); break;
+        }
+    }
+}
+
+void AobScanner::ScanAutomaton(const uint8_t* data, size_t len, size_t limit, uintptr_t base, std::vector<AobMatch>& out) const {
+    uint32_t state = 0;
+    for (size_t j = 0; j < len; ++j) {
+        state = delta[static_cast<size_t>(state) * 256 + data[j]];
+        const auto &hits = outputs[state];
+        if (hits.empty()) continue;
+        for (uint32_t s : hits) {
+            const Prepared &p = prepared[s];
+            // 片段在 j 处结束，推算特征码起点
+            size_t fragStart = j + 1 - p.fragLength;
+            if (fragStart < p.fragOffset) continue;
+            size_t start = fragStart - p.fragOffset;
+            if (start >= limit || start + sigs[s].Size() > len) continue;
+            if (sigs[s].MatchAt(data + start)) out.push_back({ s, base + start });
+        }
+    }
+}
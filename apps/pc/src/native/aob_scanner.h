@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * IDA 风格特征码："48 8B 05 ?? ?? ?? ?? 8B 4? 08"。
+ * "?" / "??" 为通配字节，"4?" / "?8" 为半字节掩码。
+ */
+struct Signature {
+    std::vector<uint8_t> bytes;
+    std::vector<uint8_t> mask;      // 0xFF 精确匹配，0x00 通配，0xF0/0x0F 半字节
+
+    static bool Parse(const std::string& text, Signature& out);
+    std::string ToString() const;   // 规范化文本，可作为缓存键
+
+    size_t Size() const { return bytes.size(); }
+    bool MatchAt(const uint8_t* p) const;
+};
+
+struct AobMatch {
+    uint32_t signature;             // Add 返回的下标
+    uintptr_t address;
+};
+
+/**
+ * 特征码扫描核心，只处理内存中的字节区间，不依赖平台 API。
+ * 特征码较少时逐个用 SIMD 过滤两个最少见的精确字节再完整比较；
+ * 较多时对每个特征码最长的精确片段构建 Aho-Corasick 自动机，一遍扫描找出全部候选。
+ * Add 之后需要调用 Build；Build 之后 Scan 可在多个线程中并发调用。
+ */
+class AobScanner {
+public:
+    enum class SimdLevel { Scalar, SSE2, AVX2 };
+
+    // 特征码数量不超过该值时使用逐个 SIMD 过滤
+    static constexpr size_t kDirectLimit = 4;
+    // 自动机片段的最大长度，限制状态数
+    static constexpr size_t kMaxFragment = 8;
+
+    AobScanner();
+
+    uint32_t Add(const Signature& sig);
+    void Build();
+    void Clear();
+
+    size_t Count() const { return sigs.size(); }
+    size_t MaxLength() const { return maxLength; }
+
+    // 扫描 [data, data+len)，只报告起点偏移 < limit 的匹配（分块扫描时尾部重叠区交给下一块）
+    void Scan(const uint8_t* data, size_t len, size_t limit, uintptr_t base, std::vector<AobMatch>& out) const;
+
+    static SimdLevel DetectSimd();
+    void SetSimd(SimdLevel level) { simd = level; }     // 测试/基准用，默认为 DetectSimd()
+    SimdLevel Simd() const { return simd; }
+
+private:
+    struct Prepared {
+        uint32_t anchor1, anchor2;      // 两个最少见的精确字节在特征码中的偏移
+        uint32_t fragOffset, fragLength;// 最长精确片段
+    };
+
+    void ScanDirect(const uint8_t* data, size_t len, size_t limit, uintptr_t base, std::vector<AobMatch>& out) const;
+    void ScanAutomaton(const uint8_t* data, size_t len, size_t limit, uintptr_t base, std::vector<AobMatch>& out) const;
+
+    std::vector<Signature> sigs;
+    std::vector<Prepared> prepared;
+    size_t maxLength;
+    SimdLevel simd;
+    bool built;
+
+    // Aho-Corasick：稠密转移表 states x 256，outputs 为各状态结束的特征码（已合并失败链上的输出）
+    std::vector<uint32_t> delta;
+    std::vector<std::vector<uint32_t>> outputs;
+};
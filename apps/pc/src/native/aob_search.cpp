@@ -0,0 +1,220 @@
+#include "aob_search.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include "mapped_file.h"
+#include "thread_pool.h"
+
+namespace {
+
+constexpr size_t kPageSize = 0x1000;
+constexpr size_t kChunkSize = 1024 * 1024;
+constexpr size_t kHeaderSize = 0x1000;
+// IMAGE_SCN_CNT_CODE | IMAGE_SCN_MEM_EXECUTE
+constexpr uint32_t kExecutableSection = 0x00000020 | 0x20000000;
+
+const char kCacheMagic[4] = { 'X', 'A', 'O', 'B' };
+constexpr uint32_t kCacheVersion = 1;
+
+template<typename T>
+bool ReadPod(FILE* f, T& v) { return std::fread(&v, sizeof(T), 1, f) == 1; }
+
+template<typename T>
+bool WritePod(FILE* f, const T& v) { return std::fwrite(&v, sizeof(T), 1, f) == 1; }
+
+} // namespace
+
+// ---------------- SignatureCache ----------------
+
+std::string SignatureCache::MakeKey(uint64_t imageHash, const std::string& key) {
+    char buf[20];
+    std::snprintf(buf, sizeof(buf), "%016llx:", static_cast<unsigned long long>(imageHash));
+    return buf + key;
+}
+
+bool SignatureCache::Lookup(uint64_t imageHash, const std::string& key, std::vector<uint32_t>& rvas) const {
+    std::lock_guard<std::mutex> g(m);
+    auto it = entries.find(MakeKey(imageHash, key));
+    if (it == entries.end()) return false;
+    rvas = it->second;
+    return true;
+}
+
+void SignatureCache::Store(uint64_t imageHash, const std::string& key, const std::vector<uint32_t>& rvas) {
+    std::lock_guard<std::mutex> g(m);
+    entries[MakeKey(imageHash, key)] = rvas;
+}
+
+void SignatureCache::Clear() {
+    std::lock_guard<std::mutex> g(m);
+    entries.clear();
+}
+
+size_t SignatureCache::Size() const {
+    std::lock_guard<std::mutex> g(m);
+    return entries.size();
+}
+
+// 文件格式："XAOB" | version | count | { keyLen:u32 key rvaCount:u32 rva:u32... }
+bool SignatureCache::Load(const std::string& path) {
+    FILE* f = OpenFileUtf8(path, "rb");
+    if (!f) return false;
+    std::unordered_map<std::string, std::vector<uint32_t>> loaded;
+    char magic[4];
+    uint32_t version = 0, count = 0;
+    bool ok = std::fread(magic, 1, 4, f) == 4 && std::memcmp(magic, kCacheMagic, 4) == 0
+        && ReadPod(f, version) && version == kCacheVersion && ReadPod(f, count);
+    for (uint32_t i = 0; ok && i < count; ++i) {
+        uint32_t keyLen = 0, n = 0;
+        std::string key;
+        std::vector<uint32_t> rvas;
+        ok = ReadPod(f, keyLen) && keyLen < 4096;
+        if (ok) {
+            key.resize(keyLen);
+            ok = std::fread(&key[0], 1, keyLen, f) == keyLen && ReadPod(f, n) && n < (1u << 24);
+        }
+        if (ok) {
+            rvas.resize(n);
+            ok = n == 0 || std::fread(rvas.data(), sizeof(uint32_t), n, f) == n;
+        }
+        if (ok) loaded[std::move(key)] = std::move(rvas);
+    }
+    std::fclose(f);
+    if (!ok) return false;
+    std::lock_guard<std::mutex> g(m);
+    for (auto &kv : loaded) entries[kv.first] = std::move(kv.second);
+    return true;
+}
+
+bool SignatureCache::Save(const std::string& path) const {
+    FILE* f = OpenFileUtf8(path, "wb");
+    if (!f) return false;
+    std::lock_guard<std::mutex> g(m);
+    bool ok = std::fwrite(kCacheMagic, 1, 4, f) == 4 && WritePod(f, kCacheVersion)
+        && WritePod(f, static_cast<uint32_t>(entries.size()));
+    for (auto it = entries.begin(); ok && it != entries.end(); ++it) {
+        uint32_t keyLen = static_cast<uint32_t>(it->first.size());
+        uint32_t n = static_cast<uint32_t>(it->second.size());
+        ok = WritePod(f, keyLen) && std::fwrite(it->first.data(), 1, keyLen, f) == keyLen && WritePod(f, n)
+            && (n == 0 || std::fwrite(it->second.data(), sizeof(uint32_t), n, f) == n);
+    }
+    return std::fclose(f) == 0 && ok;
+}
+
+// ---------------- search ----------------
+
+bool ModuleImageHash(IMemorySource& mem, const ModuleInfo& module, uint64_t& out) {
+    uint8_t header[kHeaderSize];
+    size_t len = std::min(kHeaderSize, module.size);
+    if (len == 0 || !mem.ReadMemory(module.base, header, len)) return false;
+    // FNV-1a；PE 头包含链接时间戳、校验和与节表，足以区分不同构建
+    uint64_t h = 1469598103934665603ull;
+    for (size_t i = 0; i < len; ++i) {
+        h ^= header[i];
+        h *= 1099511628211ull;
+    }
+    h ^= static_cast<uint64_t>(module.size);
+    h *= 1099511628211ull;
+    out = h;
+    return true;
+}
+
+bool FindSignatures(IMemorySource& mem, const ModuleInfo& module, const std::vector<Signature>& sigs,
+                    const AobSearchOptions& opts, SignatureCache* cache,
+                    std::vector<std::vector<uintptr_t>>& results, const std::atomic<bool>* cancel) {
+    results.assign(sigs.size(), {});
+    uint64_t hash = 0;
+    if (!ModuleImageHash(mem, module, hash)) return false;
+
+    struct Range { uintptr_t base; size_t size; };
+    std::vector<Range> ranges;
+    if (opts.codeOnly) {
+        for (const auto &s : module.sections) {
+            if (s.characteristics & kExecutableSection) ranges.push_back({ module.base + s.rva, s.size });
+        }
+    }
+    // 没有节信息时扫描整个映像，结果与 codeOnly=false 相同，使用同一个缓存键
+    const bool codeRanges = !ranges.empty();
+    if (!codeRanges) ranges.push_back({ module.base, module.size });
+
+    // 缓存命中的直接换算地址，其余合并到一个扫描器中
+    std::vector<std::string> keys(sigs.size());
+    std::vector<size_t> pending;
+    AobScanner scanner;
+    for (size_t i = 0; i < sigs.size(); ++i) {
+        keys[i] = (codeRanges ? "x:" : "a:") + sigs[i].ToString();
+        std::vector<uint32_t> rvas;
+        if (opts.useCache && cache && cache->Lookup(hash, keys[i], rvas)) {
+            for (uint32_t rva : rvas) results[i].push_back(module.base + rva);
+            continue;
+        }
+        scanner.Add(sigs[i]);
+        pending.push_back(i);
+    }
+    if (pending.empty()) return true;
+    scanner.Build();
+
+    // 每块多读 MaxLength-1 字节，跨块的匹配由前一块报告
+    struct Chunk { uintptr_t base; size_t size; size_t readSize; };
+    std::vector<Chunk> chunks;
+    const size_t overlap = scanner.MaxLength() - 1;
+    for (const auto &r : ranges) {
+        uintptr_t end = r.base + r.size;
+        for (uintptr_t b = r.base; b < end; b += kChunkSize) {
+            size_t size = std::min<size_t>(kChunkSize, end - b);
+            chunks.push_back({ b, size, std::min<size_t>(size + overlap, end - b) });
+        }
+    }
+
+    ThreadPool &pool = ThreadPool::Shared();
+    const size_t window = pool.Size() * 4;
+    std::vector<std::vector<AobMatch>> hits(std::min(window, chunks.size()));
+    std::atomic<bool> complete(true);   // 有页无法读取时结果不完整，不写入缓存
+    for (size_t start = 0; start < chunks.size(); start += window) {
+        if (cancel && cancel->load()) return false;
+        size_t n = std::min(window, chunks.size() - start);
+        pool.ParallelFor(n, [&](size_t i) {
+            const Chunk &c = chunks[start + i];
+            thread_local std::vector<uint8_t> buf;
+            buf.resize(c.readSize);
+            hits[i].clear();
+            if (mem.ReadMemory(c.base, buf.data(), c.readSize)) {
+                scanner.Scan(buf.data(), c.readSize, c.size, c.base, hits[i]);
+                return;
+            }
+            // 整块读取失败时按页重读到同一缓冲区，连续可读的页拼接后一起扫描，
+            // 跨页的匹配不会丢失；不可读的页把块分成几段
+            size_t run = 0;
+            for (size_t off = 0;; off += kPageSize) {
+                bool done = off >= c.readSize;
+                if (!done) {
+                    size_t len = std::min(kPageSize, c.readSize - off);
+                    if (mem.ReadMemory(c.base + off, buf.data() + off, len)) continue;
+                    if (off < c.size) complete.store(false);
+                }
+                // [run, end) 为一段连续可读的数据，起点在本块之后的匹配交给下一块
+                size_t end = std::min(off, c.readSize);
+                if (end > run && run < c.size) {
+                    scanner.Scan(buf.data() + run, end - run, std::min(end, c.size) - run, c.base + run, hits[i]);
+                }
+                if (done) break;
+                run = off + kPageSize;
+            }
+        });
+        for (size_t i = 0; i < n; ++i) {
+            for (const auto &h : hits[i]) results[pending[h.signature]].push_back(h.address);
+        }
+    }
+
+    for (size_t i : pending) {
+        auto &r = results[i];
+        std::sort(r.begin(), r.end());
+        r.erase(std::unique(r.begin(), r.end()), r.end());
+        if (cache && complete.load()) {
+            std::vector<uint32_t> rvas(r.size());
+            for (size_t k = 0; k < r.size(); ++k) rvas[k] = static_cast<uint32_t>(r[k] - module.base);
+            cache->Store(hash, keys[i], rvas);
+        }
+    }
+    return true;
+}
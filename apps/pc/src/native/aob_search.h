@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "aob_scanner.h"
+#include "memory_source.h"
+#include "module_map.h"
+
+struct AobSearchOptions {
+    bool codeOnly = false;          // 只扫描可执行节
+    bool useCache = true;
+};
+
+/**
+ * 特征码结果缓存：按模块映像哈希（PE 头内容，含时间戳/校验和/节表）+ 特征码保存 RVA 列表。
+ * 同一版本的模块（包括游戏重启后）直接命中缓存；可保存到文件供下次启动使用。
+ */
+class SignatureCache {
+public:
+    bool Lookup(uint64_t imageHash, const std::string& key, std::vector<uint32_t>& rvas) const;
+    void Store(uint64_t imageHash, const std::string& key, const std::vector<uint32_t>& rvas);
+    void Clear();
+    size_t Size() const;
+
+    bool Load(const std::string& path);
+    bool Save(const std::string& path) const;
+
+private:
+    static std::string MakeKey(uint64_t imageHash, const std::string& key);
+
+    mutable std::mutex m;
+    std::unordered_map<std::string, std::vector<uint32_t>> entries;
+};
+
+// 读取模块 PE 头计算映像哈希，读取失败返回 false
+bool ModuleImageHash(IMemorySource& mem, const ModuleInfo& module, uint64_t& out);
+
+/**
+ * 在模块映像中查找一组特征码，results[i] 为第 i 个特征码的全部匹配地址（升序）。
+ * 未命中缓存的特征码合并为一遍扫描，模块按块并行读取；有页无法读取时结果不写入缓存。
+ * 被取消或模块头无法读取时返回 false。
+ */
+bool FindSignatures(IMemorySource& mem, const ModuleInfo& module, const std::vector<Signature>& sigs,
+                    const AobSearchOptions& opts, SignatureCache* cache,
+                    std::vector<std::vector<uintptr_t>>& results, const std::atomic<bool>* cancel = nullptr);
@@ -0,0 +1,106 @@
+#include "async_queue.h"
+#include <exception>
+
+AsyncQueue::AsyncQueue(size_t threads, size_t limit)
+    : threadCount(threads ? threads : 1), pending(0), limit(limit ? limit : 1) {}
+
+void AsyncQueue::Init(Napi::Env env) {
+    // 队列大小 0 表示不限制，NonBlockingCall 不会因为队列满而失败
+    tsfn = Napi::ThreadSafeFunction::New(env, Napi::Function::New(env, [](const Napi::CallbackInfo&) {}),
+                                         "xmodder-async", 0, 1);
+    // 没有未完成的调用时不阻止事件循环退出
+    tsfn.Unref(env);
+}
+
+void AsyncQueue::Release() {
+    tsfn.Release();
+}
+
+Napi::Value AsyncQueue::MakeError(Napi::Env env, const std::string& message, const char* code) {
+    Napi::Error err = Napi::Error::New(env, message);
+    err.Set("code", Napi::String::New(env, code));
+    return err.Value();
+}
+
+Napi::Value AsyncQueue::Rejected(Napi::Env env, const std::string& message) {
+    auto deferred = Napi::Promise::Deferred::New(env);
+    deferred.Reject(MakeError(env, message, "EINVAL"));
+    return deferred.Promise();
+}
+
+Napi::Value AsyncQueue::Enqueue(Napi::Env env, ExecuteFn execute, CompleteFn complete, CancelFlag cancel) {
+    auto deferred = Napi::Promise::Deferred::New(env);
+    if (pending.load() >= limit.load()) {
+        deferred.Reject(MakeError(env, "async queue is full", "EBUSY"));
+        return deferred.Promise();
+    }
+    if (!pool) pool = std::make_unique<ThreadPool>(threadCount);
+    if (pending.fetch_add(1) == 0) {
+        tsfn.Ref(env);
+        if (onActive) onActive(true);
+    }
+
+    Op* op = new Op{ deferred, std::move(execute), std::move(complete), std::move(cancel), false, false, std::string() };
+    pool->Submit([this, op]() {
+        // 排队期间已取消的调用不再执行
+        if (op->cancel && op->cancel->load()) {
+            op->cancelled = true;
+        } else {
+            // 执行中的异常（例如分配失败）转为 Promise 拒绝，不能逃出 worker 线程
+            try {
+                op->ok = op->execute(op->error);
+            } catch (const std::exception& e) {
+                op->ok = false;
+                op->error = e.what();
+            } catch (...) {
+                op->ok = false;
+                op->error = "operation failed";
+            }
+            op->cancelled = op->cancel && op->cancel->load();
+        }
+        if (tsfn.NonBlockingCall(op, [this](Napi::Env env, Napi::Function, Op* op) { Finish(env, op); }) != napi_ok) {
+            // 环境已销毁，无法再回到 JS 线程
+            delete op;
+        }
+    });
+    return deferred.Promise();
+}
+
+void AsyncQueue::Finish(Napi::Env env, Op* op) {
+    std::unique_ptr<Op> guard(op);
+    if (op->cancelled) {
+        op->deferred.Reject(MakeError(env, "operation cancelled", "ECANCELED"));
+    } else if (!op->ok) {
+        op->deferred.Reject(MakeError(env, op->error.empty() ? "operation failed" : op->error, "EFAIL"));
+    } else {
+        op->deferred.Resolve(op->complete ? op->complete(env) : env.Undefined());
+    }
+    // complete 可能访问所有者的状态，结算之后才放开所有者
+    if (pending.fetch_sub(1) == 1) {
+        tsfn.Unref(env);
+        if (onActive) onActive(false);
+    }
+}
+
+int CancelTokens::Create() {
+    int id = nextToken++;
+    tokens[id] = std::make_shared<std::atomic<bool>>(false);
+    return id;
+}
+
+bool CancelTokens::Cancel(int id) {
+    auto it = tokens.find(id);
+    if (it == tokens.end()) return false;
+    it->second->store(true);
+    return true;
+}
+
+bool CancelTokens::Release(int id) {
+    // 正在使用该令牌的调用持有 shared_ptr，释放后仍可安全读取
+    return tokens.erase(id) > 0;
+}
+
+CancelFlag CancelTokens::Get(int id) const {
+    auto it = tokens.find(id);
+    return it == tokens.end() ? nullptr : it->second;
+}
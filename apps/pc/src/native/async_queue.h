@@ -0,0 +1,84 @@
+#pragma once
+#include <napi.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "thread_pool.h"
+
+// 取消标记：由 JS 线程设置，工作线程在长操作的检查点读取
+using CancelFlag = std::shared_ptr<std::atomic<bool>>;
+
+/**
+ * 取消令牌表：令牌在模块级创建，可以传给任意会话的异步调用。只在 JS 线程创建/查找，不需要加锁
+ */
+class CancelTokens {
+public:
+    int Create();
+    bool Cancel(int id);
+    bool Release(int id);
+    CancelFlag Get(int id) const;
+
+private:
+    std::unordered_map<int, CancelFlag> tokens;
+    int nextToken = 1;
+};
+
+/**
+ * 异步调用队列：工作在独立的原生线程池上执行（不占用 libuv 线程池，避免拖慢 fs 等操作），
+ * 完成后通过 ThreadSafeFunction 回到 JS 线程 resolve/reject Promise。
+ * 未完成的调用数有上限，达到上限时新调用立即以 EBUSY 拒绝，由调用方自行退避。
+ * 取消的调用以 ECANCELED 拒绝。
+ */
+class AsyncQueue {
+public:
+    // 在工作线程执行，失败时写入 error 并返回 false
+    using ExecuteFn = std::function<bool(std::string& error)>;
+    // 在 JS 线程执行，把工作线程产生的结果转换为 JS 值
+    using CompleteFn = std::function<Napi::Value(Napi::Env)>;
+
+    static constexpr size_t kDefaultThreads = 2;
+    static constexpr size_t kDefaultLimit = 64;
+
+    explicit AsyncQueue(size_t threads = kDefaultThreads, size_t limit = kDefaultLimit);
+
+    // 在模块 Init / 会话创建时调用一次
+    void Init(Napi::Env env);
+    // 会话回收时调用，此后不能再入队
+    void Release();
+
+    // 有无未完成调用的切换时在 JS 线程回调，所有者借此在调用完成前保持存活
+    void SetActiveHook(std::function<void(bool active)> hook) { onActive = std::move(hook); }
+
+    // 返回 Promise；execute 在工作线程执行，成功后 complete 的返回值作为 resolve 的值
+    Napi::Value Enqueue(Napi::Env env, ExecuteFn execute, CompleteFn complete, CancelFlag cancel = nullptr);
+
+    // 参数错误等情况下直接返回已拒绝的 Promise（code 为 EINVAL）
+    Napi::Value Rejected(Napi::Env env, const std::string& message);
+
+    void SetLimit(size_t limit) { this->limit = limit ? limit : 1; }
+    size_t Limit() const { return limit.load(); }
+    size_t Pending() const { return pending.load(); }
+
+private:
+    struct Op {
+        Napi::Promise::Deferred deferred;
+        ExecuteFn execute;
+        CompleteFn complete;
+        CancelFlag cancel;
+        bool ok;
+        bool cancelled;
+        std::string error;
+    };
+
+    static Napi::Value MakeError(Napi::Env env, const std::string& message, const char* code);
+    void Finish(Napi::Env env, Op* op);
+
+    size_t threadCount;
+    std::unique_ptr<ThreadPool> pool;   // 第一次调用时创建，避免在模块加载期间启动线程
+    Napi::ThreadSafeFunction tsfn;
+    std::atomic<size_t> pending;
+    std::atomic<size_t> limit;
+    std::function<void(bool active)> onActive;
+};
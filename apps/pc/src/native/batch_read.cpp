@@ -0,0 +1,95 @@
+#include "batch_read.h"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+size_t ReadBatch(IMemorySource& src, const ReadRequest* reqs, size_t count, uint8_t* out, uint8_t* okBits,
+                 size_t maxGap, size_t maxSpan) {
+    std::memset(okBits, 0, (count + 7) / 8);
+    if (count == 0) return 0;
+
+    thread_local std::vector<uint32_t> order;
+    thread_local std::vector<uint8_t> scratch;
+    thread_local std::vector<ReadSpan> spans;
+    thread_local std::vector<uint8_t> spanOk;
+    order.resize(count);
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [reqs](uint32_t a, uint32_t b) {
+        return reqs[a].address < reqs[b].address;
+    });
+
+    size_t ok = 0;
+    auto mark = [&](uint32_t idx) {
+        okBits[idx >> 3] |= static_cast<uint8_t>(1u << (idx & 7));
+        ++ok;
+    };
+
+    // 按地址分组：向后扩展当前组，直到间距或总跨度超限
+    struct Group { size_t first; size_t last; uintptr_t lo; uintptr_t hi; size_t scratchOffset; };
+    thread_local std::vector<Group> groups;
+    groups.clear();
+    size_t scratchSize = 0;
+    size_t i = 0;
+    while (i < count) {
+        const ReadRequest &first = reqs[order[i]];
+        uintptr_t lo = first.address;
+        uintptr_t hi = first.address + first.size;
+        size_t j = i + 1;
+        while (j < count) {
+            const ReadRequest &r = reqs[order[j]];
+            uintptr_t end = std::max(hi, r.address + r.size);
+            if (r.address > hi + maxGap || end - lo > maxSpan) break;
+            hi = end;
+            ++j;
+        }
+        groups.push_back({ i, j, lo, hi, scratchSize });
+        if (j - i > 1) scratchSize += hi - lo;
+        i = j;
+    }
+
+    // 所有组作为一次分散读取提交；单项组直接读入输出缓冲区
+    scratch.resize(scratchSize);
+    spans.clear();
+    for (const auto &g : groups) {
+        if (g.last - g.first == 1) {
+            const ReadRequest &r = reqs[order[g.first]];
+            spans.push_back({ r.address, out + r.outOffset, r.size });
+        } else {
+            spans.push_back({ g.lo, scratch.data() + g.scratchOffset, g.hi - g.lo });
+        }
+    }
+    spanOk.resize(spans.size());
+    src.ReadSpans(spans.data(), spans.size(), spanOk.data());
+
+    thread_local std::vector<uint32_t> retry;
+    retry.clear();
+    for (size_t k = 0; k < groups.size(); ++k) {
+        const Group &g = groups[k];
+        if (g.last - g.first == 1) {
+            if (spanOk[k]) mark(order[g.first]);
+            continue;
+        }
+        for (size_t m = g.first; m < g.last; ++m) {
+            const ReadRequest &r = reqs[order[m]];
+            if (spanOk[k]) {
+                std::memcpy(out + r.outOffset, scratch.data() + g.scratchOffset + (r.address - g.lo), r.size);
+                mark(order[m]);
+            } else {
+                retry.push_back(order[m]);
+            }
+        }
+    }
+
+    // 合并区间跨越了不可读页，逐项重试以保留可读部分
+    if (!retry.empty()) {
+        spans.clear();
+        for (uint32_t idx : retry) spans.push_back({ reqs[idx].address, out + reqs[idx].outOffset, reqs[idx].size });
+        spanOk.resize(spans.size());
+        src.ReadSpans(spans.data(), spans.size(), spanOk.data());
+        for (size_t k = 0; k < retry.size(); ++k) {
+            if (spanOk[k]) mark(retry[k]);
+        }
+    }
+    return ok;
+}
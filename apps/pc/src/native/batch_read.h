@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "memory_source.h"
+
+struct ReadRequest {
+    uintptr_t address;
+    uint32_t size;
+    size_t outOffset;       // 结果写入输出缓冲区的偏移（总输出可超过 4GB）
+};
+
+// 间距不超过 kMaxGap 的请求合并读取，合并后的单次读取不超过 kMaxSpan
+constexpr size_t kBatchMaxGap = 512;
+constexpr size_t kBatchMaxSpan = 64 * 1024;
+
+/**
+ * 批量读取：按地址排序后把相邻请求合并成尽量少的读取段，所有段通过一次 ReadSpans 提交
+ * （Linux 下为一次 process_vm_readv），合并读取失败的组再逐项重试。
+ * okBits 按请求原始顺序逐位标记成功（需 (count+7)/8 字节），返回成功数量。
+ */
+size_t ReadBatch(IMemorySource& src, const ReadRequest* reqs, size_t count, uint8_t* out, uint8_t* okBits,
+                 size_t maxGap = kBatchMaxGap, size_t maxSpan = kBatchMaxSpan);
@@ -0,0 +1,395 @@
+// 原生层基准测试：启动 bench_target 合成目标进程，通过 IMemory 测量读写、批量读取、
+// 指针解析、锁定写入和进程查找的性能，另外在本地缓冲区上测量扫描比较内核的吞吐量。结果以 JSON 输出到 stdout（或 --out 指定的文件），
+// 便于在不同提交之间比较；进度信息输出到 stderr。
+//
+//   bench [--target path] [--heap-mb 64] [--depth 8] [--values 4096] [--duration-ms 1000] [--out file]
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "batch_read.h"
+#include "compare_kernels.h"
+#include "memory.h"
+#include "pointer_resolver.h"
+#include "process.h"
+#include "utf8.h"
+#ifdef _WIN32
+#include <windows.h>
+#define popen _popen
+#define pclose _pclose
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Result {
+    std::string name;
+    double value;
+    const char* unit;
+};
+
+struct Config {
+    std::string target;
+    size_t heapMb = 64;
+    int depth = 8;
+    size_t values = 4096;
+    uint32_t durationMs = 1000;
+    std::string out;
+};
+
+// bench_target 输出的结构地址
+struct TargetInfo {
+    uint32_t pid = 0;
+    uintptr_t heap = 0;
+    size_t heapSize = 0;
+    uintptr_t roots = 0;
+    int depth = 0;
+    uintptr_t values = 0;
+    size_t valueCount = 0;
+    uintptr_t stopFlag = 0;
+};
+
+std::vector<Result> results;
+
+void Report(const std::string& name, double value, const char* unit) {
+    results.push_back({ name, value, unit });
+    std::fprintf(stderr, "  %-32s %14.2f %s\n", name.c_str(), value, unit);
+}
+
+// 从一行扁平 JSON 中取数值字段，支持 123 与 "0x1A" 两种写法
+bool JsonField(const std::string& line, const char* key, uint64_t& out) {
+    std::string pat = std::string("\"") + key + "\":";
+    size_t p = line.find(pat);
+    if (p == std::string::npos) return false;
+    p += pat.size();
+    if (line[p] == '"') ++p;
+    out = std::strtoull(line.c_str() + p, nullptr, 0);
+    return true;
+}
+
+bool ParseTargetInfo(const std::string& line, TargetInfo& t) {
+    uint64_t v[8] = {};
+    const char* keys[8] = { "pid", "heap", "heapSize", "roots", "depth", "values", "valueCount", "stopFlag" };
+    for (int i = 0; i < 8; ++i) {
+        if (!JsonField(line, keys[i], v[i])) return false;
+    }
+    t.pid = static_cast<uint32_t>(v[0]);
+    t.heap = static_cast<uintptr_t>(v[1]);
+    t.heapSize = static_cast<size_t>(v[2]);
+    t.roots = static_cast<uintptr_t>(v[3]);
+    t.depth = static_cast<int>(v[4]);
+    t.values = static_cast<uintptr_t>(v[5]);
+    t.valueCount = static_cast<size_t>(v[6]);
+    t.stopFlag = static_cast<uintptr_t>(v[7]);
+    return true;
+}
+
+// 在 durationMs 内重复执行 fn，返回每秒执行次数
+template<typename F>
+double Rate(uint32_t durationMs, F&& fn) {
+    auto start = Clock::now();
+    auto end = start + std::chrono::milliseconds(durationMs);
+    uint64_t n = 0;
+    auto now = start;
+    do {
+        for (int i = 0; i < 16; ++i) fn();
+        n += 16;
+        now = Clock::now();
+    } while (now < end);
+    return n / std::chrono::duration<double>(now - start).count();
+}
+
+// 执行 count 次 fn 的平均耗时（微秒）
+template<typename F>
+double AverageUs(int count, F&& fn) {
+    auto start = Clock::now();
+    for (int i = 0; i < count; ++i) fn();
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count() / count;
+}
+
+// 本进程累计 CPU 时间（用户 + 内核，秒）
+double ProcessCpuSeconds() {
+#ifdef _WIN32
+    FILETIME c, e, k, u;
+    if (!GetProcessTimes(GetCurrentProcess(), &c, &e, &k, &u)) return 0;
+    auto toSec = [](const FILETIME& f) {
+        return ((static_cast<uint64_t>(f.dwHighDateTime) << 32) | f.dwLowDateTime) / 1e7;
+    };
+    return toSec(k) + toSec(u);
+#else
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) != 0) return 0;
+    return ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6 + ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6;
+#endif
+}
+
+std::string DefaultTarget(const char* argv0) {
+    std::string dir(argv0);
+    size_t p = dir.find_last_of("/\\");
+    dir = p == std::string::npos ? std::string(".") : dir.substr(0, p);
+#ifdef _WIN32
+    return dir + "\\bench_target.exe";
+#else
+    return dir + "/bench_target";
+#endif
+}
+
+std::string BaseName(const std::string& path) {
+    size_t p = path.find_last_of("/\\");
+    return p == std::string::npos ? path : path.substr(p + 1);
+}
+
+// ---------------- benchmarks ----------------
+
+void BenchProcess(const Config& cfg, const TargetInfo& t) {
+    std::wstring name = Utf8ToWstring(BaseName(cfg.target));
+    Report("process.findPidByName", AverageUs(20, [&]() { FindPidByName(name); }) / 1000.0, "ms");
+    std::wstring path;
+    QueryProcessPath(t.pid, path);
+    Report("process.isRunning", AverageUs(20, [&]() { IsRunning(name, path); }) / 1000.0, "ms");
+    IMemory mem;
+    Report("process.open", AverageUs(10, [&]() { mem.OpenProcessByPid(t.pid); }) / 1000.0, "ms");
+    std::vector<MemoryRegion> regions;
+    Report("process.queryRegions", AverageUs(10, [&]() { mem.QueryRegions(regions); }) / 1000.0, "ms");
+}
+
+void BenchReads(const Config& cfg, IMemory& mem, const TargetInfo& t) {
+    std::mt19937_64 rng(1);
+    auto randomAddr = [&](size_t span) { return t.heap + (rng() % (t.heapSize - span)) / 4 * 4; };
+    uint8_t buf[4096];
+
+    Report("read.single.4B", Rate(cfg.durationMs, [&]() { mem.ReadMemory(randomAddr(4), buf, 4); }), "ops/s");
+    double r4k = Rate(cfg.durationMs, [&]() { mem.ReadMemory(randomAddr(4096), buf, 4096); });
+    Report("read.single.4KB", r4k, "ops/s");
+    Report("read.single.4KB.throughput", r4k * 4096 / (1024.0 * 1024.0), "MB/s");
+
+    // 分散的小读取：每次批量 256 项
+    const size_t kBatch = 256;
+    std::vector<ReadRequest> reqs(kBatch);
+    std::vector<uint8_t> out(kBatch * 4);
+    std::vector<uint8_t> bits((kBatch + 7) / 8);
+    auto fill = [&](size_t window) {
+        uintptr_t base = randomAddr(window);
+        for (size_t i = 0; i < kBatch; ++i) {
+            reqs[i] = { base + (rng() % (window - 4)) / 4 * 4, 4, i * 4 };
+        }
+    };
+    double scattered = Rate(cfg.durationMs, [&]() {
+        fill(t.heapSize - 8);
+        ReadBatch(mem, reqs.data(), kBatch, out.data(), bits.data());
+    });
+    Report("read.batch256.scattered", scattered * kBatch, "reads/s");
+    // 同一 16KB 窗口内的读取，可以合并
+    double local = Rate(cfg.durationMs, [&]() {
+        fill(16 * 1024);
+        ReadBatch(mem, reqs.data(), kBatch, out.data(), bits.data());
+    });
+    Report("read.batch256.local", local * kBatch, "reads/s");
+}
+
+void BenchWrites(const Config& cfg, IMemory& mem, const TargetInfo& t) {
+    std::mt19937_64 rng(2);
+    int32_t v = 0;
+    Report("write.single.4B", Rate(cfg.durationMs, [&]() {
+        mem.WriteMemory(t.values + (rng() % t.valueCount) * 4, &v, 4);
+    }), "ops/s");
+
+    const size_t kItems = 64;
+    double txns = Rate(cfg.durationMs, [&]() {
+        WriteTransaction txn;
+        for (size_t i = 0; i < kItems; ++i) txn.Add(t.values + (rng() % t.valueCount) * 4, &v, 4);
+        std::vector<uint8_t> bits;
+        mem.CommitWrites(txn, bits);
+    });
+    Report("write.txn64.4B", txns * kItems, "writes/s");
+}
+
+void BenchPointers(IMemory& mem, const TargetInfo& t) {
+    PointerResolver resolver(mem);
+    std::vector<int> deepest;
+    for (int d = 1; d <= t.depth; ++d) {
+        PointerPath path;
+        path.baseOffset = t.roots + d * sizeof(uintptr_t);
+        for (int k = 0; k + 1 < d; ++k) path.offsets.push_back(0x8);
+        path.offsets.push_back(0x10);
+        uintptr_t out = 0;
+        int32_t value = 0;
+        if (!resolver.ResolvePath(path, out) || !mem.ReadMemory(out, &value, 4) || value != 1000 * d + d - 1) {
+            std::fprintf(stderr, "  pointer chain of depth %d did not resolve\n", d);
+            continue;
+        }
+        Report("pointer.resolve.depth" + std::to_string(d), AverageUs(2000, [&]() { resolver.ResolvePath(path, out); }), "us");
+        int handle = resolver.Compile(path);
+        Report("pointer.compiled.depth" + std::to_string(d), AverageUs(2000, [&]() { resolver.Resolve(handle, out); }), "us");
+        if (d == t.depth) deepest.assign(256, handle);
+    }
+    if (!deepest.empty()) {
+        // 256 个不同句柄指向同一条最深的链，测批量解析的开销
+        PointerPath path;
+        path.baseOffset = t.roots + t.depth * sizeof(uintptr_t);
+        for (int k = 0; k + 1 < t.depth; ++k) path.offsets.push_back(0x8);
+        path.offsets.push_back(0x10);
+        for (auto &h : deepest) h = resolver.Compile(path);
+        std::vector<uintptr_t> addrs;
+        std::vector<uint8_t> ok;
+        resolver.Invalidate();
+        Report("pointer.resolveMany256.cold", AverageUs(1, [&]() { resolver.ResolveMany(deepest, addrs, ok); }), "us");
+        Report("pointer.resolveMany256.warm", AverageUs(200, [&]() { resolver.ResolveMany(deepest, addrs, ok); }), "us");
+    }
+}
+
+void BenchLocks(const Config& cfg, IMemory& mem, const TargetInfo& t) {
+    const size_t kLocks = std::min<size_t>(100, t.valueCount);
+    const int kPeriodMs = 10;
+    std::vector<int> ids;
+    std::vector<uint8_t> data(4, 0x7F);
+    double cpu0 = ProcessCpuSeconds();
+    auto start = Clock::now();
+    for (size_t i = 0; i < kLocks; ++i) ids.push_back(mem.LockMemory(t.values + i * 4, data, 4, kPeriodMs));
+    std::this_thread::sleep_for(std::chrono::milliseconds(std::max<uint32_t>(cfg.durationMs * 2, 1000)));
+    double wall = std::chrono::duration<double>(Clock::now() - start).count();
+    double cpu = ProcessCpuSeconds() - cpu0;
+
+    double jitterSum = 0, jitterMax = 0, writes = 0;
+    size_t n = 0;
+    for (int id : ids) {
+        LockStats st;
+        if (!mem.Locks().GetStats(id, st)) continue;
+        jitterSum += st.avgJitterUs;
+        jitterMax = std::max(jitterMax, st.maxJitterUs);
+        writes += st.writesPerSec;
+        ++n;
+    }
+    for (int id : ids) mem.UnlockMemory(id);
+    Report("lock.100x10ms.avgJitter", n ? jitterSum / n : 0, "us");
+    Report("lock.100x10ms.maxJitter", jitterMax, "us");
+    Report("lock.100x10ms.writes", writes, "writes/s");
+    Report("lock.100x10ms.cpu", wall > 0 ? cpu / wall * 100.0 : 0, "%");
+}
+
+// 扫描比较内核：64MB 本地缓冲区，每个 CPU 支持的指令集各测一遍
+void BenchKernels(const Config& cfg) {
+    const size_t kBytes = 64 * 1024 * 1024;
+    std::vector<uint8_t> cur(kBytes);
+    std::mt19937_64 rng(3);
+    for (size_t i = 0; i < kBytes; i += 8) {
+        uint64_t r = rng() & 0x3F3F3F3F3F3F3F3Full;     // 浮点解释下为有限值
+        std::memcpy(cur.data() + i, &r, 8);
+    }
+    std::vector<uint8_t> old(cur);
+    for (size_t i = 0; i < kBytes; i += 4096) old[i] ^= 1;
+    std::vector<uint64_t> mask(kBytes / 64 + 1);
+
+    struct Case { const char* name; ValueType type; CompareOp op; size_t stride; double a; double b; };
+    const Case cases[] = {
+        { "int32.equal", ValueType::Int32, CompareOp::Equal, 4, 100, 0 },
+        { "int32.equal.align1", ValueType::Int32, CompareOp::Equal, 1, 100, 0 },
+        { "uint8.greater", ValueType::UInt8, CompareOp::Greater, 1, 200, 0 },
+        { "float.between", ValueType::Float, CompareOp::Between, 4, 0.5, 1.0 },
+        { "int32.changed", ValueType::Int32, CompareOp::Changed, 4, 0, 0 },
+        { "double.increasedBy", ValueType::Double, CompareOp::IncreasedBy, 8, 1.0, 0.001 },
+    };
+    const CompareIsa best = ActiveCompareIsa();
+    for (int isa = 0; isa <= static_cast<int>(best); ++isa) {
+        ForceCompareIsa(static_cast<CompareIsa>(isa));
+        for (const auto &c : cases) {
+            CompareArgs args;
+            DispatchValueType(c.type, [&](auto tag) {
+                using T = decltype(tag);
+                T a = static_cast<T>(c.a), b = static_cast<T>(c.b);
+                std::memcpy(&args.a, &a, sizeof(T));
+                std::memcpy(&args.b, &b, sizeof(T));
+            });
+            size_t n = (kBytes - 8) / c.stride;
+            double rate = Rate(cfg.durationMs, [&]() {
+                CompareBuffer(c.type, c.op, args, cur.data(), old.data(), n, c.stride, mask.data());
+            });
+            Report(std::string("kernel.") + CompareIsaName(static_cast<CompareIsa>(isa)) + "." + c.name,
+                   rate * kBytes / (1024.0 * 1024.0 * 1024.0), "GB/s");
+        }
+    }
+    ForceCompareIsa(best);
+}
+
+void WriteJson(std::FILE* f, const Config& cfg) {
+#ifdef _WIN32
+    const char* platform = "win32";
+#elif defined(__linux__)
+    const char* platform = "linux";
+#else
+    const char* platform = "other";
+#endif
+    std::fprintf(f, "{\"platform\":\"%s\",\"pointerSize\":%u,\"config\":{\"heapMb\":%llu,\"depth\":%d,\"values\":%llu,\"durationMs\":%u},\"results\":[",
+                 platform, static_cast<unsigned>(sizeof(void*)), static_cast<unsigned long long>(cfg.heapMb), cfg.depth,
+                 static_cast<unsigned long long>(cfg.values), cfg.durationMs);
+    for (size_t i = 0; i < results.size(); ++i) {
+        std::fprintf(f, "%s{\"name\":\"%s\",\"value\":%.4f,\"unit\":\"%s\"}", i ? "," : "",
+                     results[i].name.c_str(), results[i].value, results[i].unit);
+    }
+    std::fprintf(f, "]}\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Config cfg;
+    cfg.target = DefaultTarget(argv[0]);
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string k = argv[i];
+        const char* v = argv[i + 1];
+        if (k == "--target") cfg.target = v;
+        else if (k == "--heap-mb") cfg.heapMb = std::strtoull(v, nullptr, 0);
+        else if (k == "--depth") cfg.depth = std::atoi(v);
+        else if (k == "--values") cfg.values = std::strtoull(v, nullptr, 0);
+        else if (k == "--duration-ms") cfg.durationMs = static_cast<uint32_t>(std::strtoul(v, nullptr, 0));
+        else if (k == "--out") cfg.out = v;
+        else { std::fprintf(stderr, "unknown option %s\n", k.c_str()); return 2; }
+    }
+
+    std::string cmd = "\"" + cfg.target + "\" --heap-mb " + std::to_string(cfg.heapMb) + " --depth " + std::to_string(cfg.depth)
+        + " --values " + std::to_string(cfg.values);
+    std::FILE* child = popen(cmd.c_str(), "r");
+    if (!child) { std::fprintf(stderr, "cannot start %s\n", cfg.target.c_str()); return 1; }
+    char line[1024] = {};
+    TargetInfo t;
+    if (!std::fgets(line, sizeof(line), child) || !ParseTargetInfo(line, t)) {
+        std::fprintf(stderr, "unexpected target output: %s\n", line);
+        pclose(child);
+        return 1;
+    }
+    std::fprintf(stderr, "target pid %u, heap %llu MB, depth %d\n", t.pid,
+                 static_cast<unsigned long long>(t.heapSize >> 20), t.depth);
+
+    IMemory mem;
+    if (!mem.OpenProcessByPid(t.pid)) {
+        std::fprintf(stderr, "cannot open target process %u\n", t.pid);
+        pclose(child);
+        return 1;
+    }
+    BenchProcess(cfg, t);
+    BenchReads(cfg, mem, t);
+    BenchWrites(cfg, mem, t);
+    BenchPointers(mem, t);
+    BenchLocks(cfg, mem, t);
+    BenchKernels(cfg);
+
+    int32_t stop = 1;
+    mem.WriteMemory(t.stopFlag, &stop, sizeof(stop));
+    mem.CloseProcess();
+    pclose(child);
+
+    std::FILE* f = cfg.out.empty() ? stdout : std::fopen(cfg.out.c_str(), "w");
+    if (!f) { std::fprintf(stderr, "cannot write %s\n", cfg.out.c_str()); return 1; }
+    WriteJson(f, cfg);
+    if (f != stdout) std::fclose(f);
+    return 0;
+}
@@ -0,0 +1,111 @@
+// 基准测试用的合成目标进程：分配堆、构造各级深度的指针链并周期性修改数值。
+// 启动后在 stdout 输出一行 JSON 描述各结构的地址，之后等待基准程序把 stopFlag 写为非 0 后退出。
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+
+namespace {
+
+constexpr int kMaxDepth = 16;
+
+// 指针链节点：next 位于 +0x8，value 位于 +0x10
+struct Node {
+    uint64_t tag;
+    Node* next;
+    int32_t value;
+    int32_t pad;
+};
+
+// 各级深度指针链的根指针，位于模块的 .data/.bss 中（静态基址）
+Node* volatile g_roots[kMaxDepth + 1];
+volatile int32_t g_stopFlag = 0;
+
+uint32_t CurrentPid() {
+#ifdef _WIN32
+    return GetCurrentProcessId();
+#else
+    return static_cast<uint32_t>(getpid());
+#endif
+}
+
+size_t ArgValue(int argc, char** argv, const char* name, size_t def) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], name) == 0) return static_cast<size_t>(std::strtoull(argv[i + 1], nullptr, 0));
+    }
+    return def;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+#ifdef __linux__
+    // Yama ptrace_scope=1 时允许任意进程读取本进程（基准程序不一定是直接父进程）
+    prctl(PR_SET_PTRACER, PR_SET_PTRACER_ANY, 0, 0, 0);
+#endif
+    const size_t heapMb = ArgValue(argc, argv, "--heap-mb", 64);
+    const size_t valueCount = ArgValue(argc, argv, "--values", 4096);
+    const size_t changeMs = ArgValue(argc, argv, "--change-ms", 10);
+    const int depth = static_cast<int>(std::min<size_t>(ArgValue(argc, argv, "--depth", 8), kMaxDepth));
+    const size_t maxSeconds = ArgValue(argc, argv, "--seconds", 300);
+
+    // 堆：填充可预测的内容，页全部提交
+    std::vector<uint8_t> heap(heapMb * 1024 * 1024);
+    std::mt19937_64 rng(12345);
+    for (size_t i = 0; i + 8 <= heap.size(); i += 8) {
+        uint64_t v = rng();
+        std::memcpy(&heap[i], &v, 8);
+    }
+
+    // 每种深度一条链，节点分散在各自的分配中
+    std::vector<Node*> nodes;
+    for (int d = 1; d <= depth; ++d) {
+        Node* prev = nullptr;
+        for (int k = 0; k < d; ++k) {
+            Node* n = new Node{ 0x4E4F4445ull, nullptr, 1000 * d + k, 0 };
+            nodes.push_back(n);
+            if (prev) prev->next = n;
+            else g_roots[d] = n;
+            prev = n;
+        }
+    }
+
+    std::vector<std::atomic<int32_t>> values(valueCount);
+    for (size_t i = 0; i < valueCount; ++i) values[i].store(static_cast<int32_t>(i));
+
+    std::printf("{\"pid\":%u,\"heap\":\"0x%llx\",\"heapSize\":%llu,\"roots\":\"0x%llx\",\"depth\":%d,"
+                "\"values\":\"0x%llx\",\"valueCount\":%llu,\"stopFlag\":\"0x%llx\"}\n",
+                CurrentPid(), static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(heap.data())),
+                static_cast<unsigned long long>(heap.size()),
+                static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(&g_roots[0])), depth,
+                static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(values.data())),
+                static_cast<unsigned long long>(valueCount),
+                static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(&g_stopFlag)));
+    std::fflush(stdout);
+
+    // 周期性修改一部分数值，模拟游戏中不断变化的状态
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(maxSeconds);
+    uint32_t tick = 0;
+    while (!g_stopFlag && std::chrono::steady_clock::now() < deadline) {
+        for (size_t i = tick % 16; i < valueCount; i += 16) values[i].fetch_add(1, std::memory_order_relaxed);
+        ++tick;
+        std::this_thread::sleep_for(std::chrono::milliseconds(changeMs ? changeMs : 1));
+    }
+
+    for (Node* n : nodes) delete n;
+    return 0;
+}
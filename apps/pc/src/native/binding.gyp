@@ -1,4 +1,7 @@
 {
+  "variables": {
+    "trainer_stats%": 0
+  },
   "targets": [
     {
       "target_name": "trainer",
@@ -6,7 +9,38 @@
         "trainer.cpp",
         "memory.cpp",
         "process.cpp",
-        "helper.cpp"
+        "helper.cpp",
+        "utf8.cpp",
+        "thread_pool.cpp",
+        "scanner.cpp",
+        "result_store.cpp",
+        "mapped_file.cpp",
+        "batch_read.cpp",
+        "pointer_resolver.cpp",
+        "module_map.cpp",
+        "lock_scheduler.cpp",
+        "region_map.cpp",
+        "async_queue.cpp",
+        "watch_engine.cpp",
+        "aob_scanner.cpp",
+        "aob_search.cpp",
+        "pointer_map.cpp",
+        "pointer_scan.cpp",
+        "snapshot.cpp",
+        "stats.cpp",
+        "process_watcher.cpp",
+        "page_cache.cpp",
+        "compare_kernels.cpp",
+        "cpu_features.cpp",
+        "cheat_table.cpp",
+        "gather.cpp",
+        "change_tracker.cpp",
+        "string_search.cpp"
+      ],
+      "conditions": [
+        ["OS=='win'", { "sources": [ "process_backend_win.cpp" ] }],
+        ["OS=='linux'", { "sources": [ "process_backend_linux.cpp" ] }],
+        ["trainer_stats==1", { "defines": [ "TRAINER_STATS=1" ] }]
       ],
       "include_dirs": [
          "../../node_modules/node-addon-api"
@@ -14,13 +48,98 @@
       "dependencies": [
         "<!(node -p \"require('node-addon-api').gyp\")"
       ],
-      "defines": [ "NAPI_CPP_EXCEPTIONS" ],
+      "defines": [ "NAPI_CPP_EXCEPTIONS", "NOMINMAX" ],
       "cflags_cc": ["-fexceptions"], 
       "msvs_settings": {
         "VCCLCompilerTool": {
           "ExceptionHandling": 1
         }
       }
+    },
+    {
+      "target_name": "bench",
+      "type": "executable",
+      "sources": [
+        "bench.cpp",
+        "memory.cpp",
+        "process.cpp",
+        "utf8.cpp",
+        "batch_read.cpp",
+        "pointer_resolver.cpp",
+        "module_map.cpp",
+        "lock_scheduler.cpp",
+        "region_map.cpp",
+        "stats.cpp",
+        "page_cache.cpp",
+        "compare_kernels.cpp",
+        "cpu_features.cpp"
+      ],
+      "conditions": [
+        ["OS=='win'", { "sources": [ "process_backend_win.cpp" ] }],
+        ["OS=='linux'", { "sources": [ "process_backend_linux.cpp" ], "libraries": [ "-pthread" ] }]
+      ],
+      "defines": [ "NOMINMAX" ],
+      "cflags_cc": ["-fexceptions", "-pthread"],
+      "msvs_settings": {
+        "VCCLCompilerTool": {
+          "ExceptionHandling": 1
+        }
+      }
+    },
+    {
+      "target_name": "native_test",
+      "type": "executable",
+      "sources": [
+        "tests/test_main.cpp",
+        "tests/scanner_test.cpp",
+        "tests/aob_test.cpp",
+        "tests/compare_kernels_test.cpp",
+        "tests/pointer_scan_test.cpp",
+        "tests/pointer_resolver_test.cpp",
+        "tests/region_map_test.cpp",
+        "thread_pool.cpp",
+        "scanner.cpp",
+        "result_store.cpp",
+        "mapped_file.cpp",
+        "compare_kernels.cpp",
+        "cpu_features.cpp",
+        "snapshot.cpp",
+        "module_map.cpp",
+        "utf8.cpp",
+        "aob_scanner.cpp",
+        "aob_search.cpp",
+        "pointer_map.cpp",
+        "pointer_scan.cpp",
+        "pointer_resolver.cpp",
+        "batch_read.cpp",
+        "region_map.cpp"
+      ],
+      "conditions": [
+        ["OS=='linux'", { "libraries": [ "-pthread" ] }]
+      ],
+      "include_dirs": [ ".", "tests" ],
+      "defines": [ "NOMINMAX" ],
+      "cflags_cc": ["-fexceptions", "-pthread"],
+      "msvs_settings": {
+        "VCCLCompilerTool": {
+          "ExceptionHandling": 1
+        }
+      }
+    },
+    {
+      "target_name": "bench_target",
+      "type": "executable",
+      "sources": [ "bench_target.cpp" ],
+      "conditions": [
+        ["OS=='linux'", { "libraries": [ "-pthread" ] }]
+      ],
+      "defines": [ "NOMINMAX" ],
+      "cflags_cc": ["-fexceptions", "-pthread"],
+      "msvs_settings": {
+        "VCCLCompilerTool": {
+          "ExceptionHandling": 1
+        }
+      }
     }
   ]
 }
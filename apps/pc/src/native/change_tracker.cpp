@@ -0,0 +1,291 @@
+#include "change_tracker.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+constexpr size_t kPagesPerTask = 256;       // 每个任务读取 1 MiB
+constexpr size_t kWindowFactor = 4;
+constexpr uint64_t kUnreadable = 0x9e3779b97f4a7c15ull;
+
+constexpr uint64_t P1 = 0x9E3779B185EBCA87ull;
+constexpr uint64_t P2 = 0xC2B2AE3D27D4EB4Full;
+constexpr uint64_t P3 = 0x165667B19E3779F9ull;
+constexpr uint64_t P4 = 0x85EBCA77C2B2AE63ull;
+constexpr uint64_t P5 = 0x27D4EB2F165667C5ull;
+
+inline uint64_t Rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+inline uint64_t Load64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t Round(uint64_t acc, uint64_t input) {
+    acc += input * P2;
+    return Rotl(acc, 31) * P1;
+}
+
+inline uint64_t Merge(uint64_t acc, uint64_t v) {
+    acc ^= Round(0, v);
+    return acc * P1 + P4;
+}
+
+struct Task {
+    size_t region;
+    size_t page;        // 区域内的起始页
+    size_t pages;
+};
+
+struct TaskOut {
+    std::vector<uintptr_t> pages;
+    std::vector<ChangedRange> ranges;
+    std::vector<std::pair<uintptr_t, std::vector<uint8_t>>> newCopies;
+};
+
+// 逐字比较一页，差异字节按 gap 合并为范围
+void DiffPage(const uint8_t* oldData, const uint8_t* newData, uintptr_t base, size_t gap, std::vector<ChangedRange>& out) {
+    size_t start = 0, end = 0;
+    bool open = false;
+    for (size_t off = 0; off < ChangeTracker::kPageSize; off += 8) {
+        uint64_t x = Load64(oldData + off) ^ Load64(newData + off);
+        if (!x) continue;
+        for (size_t b = 0; b < 8; ++b) {
+            if (!((x >> (b * 8)) & 0xff)) continue;
+            size_t pos = off + b;
+            if (open && pos <= end + gap) {
+                end = pos + 1;
+            } else {
+                if (open) out.push_back({ base + start, static_cast<uint32_t>(end - start) });
+                start = pos;
+                end = pos + 1;
+                open = true;
+            }
+        }
+    }
+    if (open) out.push_back({ base + start, static_cast<uint32_t>(end - start) });
+}
+
+} // namespace
+
+uint64_t ChangeTracker::HashPage(const uint8_t* data, size_t size) {
+    const uint8_t* p = data;
+    const uint8_t* end = data + size;
+    uint64_t h;
+    if (size >= 32) {
+        uint64_t v1 = P1 + P2, v2 = P2, v3 = 0, v4 = 0 - P1;
+        const uint8_t* limit = end - 32;
+        do {
+            v1 = Round(v1, Load64(p));
+            v2 = Round(v2, Load64(p + 8));
+            v3 = Round(v3, Load64(p + 16));
+            v4 = Round(v4, Load64(p + 24));
+            p += 32;
+        } while (p <= limit);
+        h = Rotl(v1, 1) + Rotl(v2, 7) + Rotl(v3, 12) + Rotl(v4, 18);
+        h = Merge(h, v1);
+        h = Merge(h, v2);
+        h = Merge(h, v3);
+        h = Merge(h, v4);
+    } else {
+        h = P5;
+    }
+    h += size;
+    for (; p + 8 <= end; p += 8) h = Rotl(h ^ Round(0, Load64(p)), 27) * P1 + P4;
+    for (; p < end; ++p) h = Rotl(h ^ (*p * P5), 11) * P1;
+    h ^= h >> 33;
+    h *= P2;
+    h ^= h >> 29;
+    h *= P3;
+    h ^= h >> 32;
+    return h;
+}
+
+ChangeTracker::ChangeTracker(ThreadPool& pool) : pool(pool) {}
+
+size_t ChangeTracker::Start(IMemorySource& src, const ChangeTrackerOptions& opts, const std::atomic<bool>* cancel) {
+    std::lock_guard<std::mutex> g(m);
+    busy = true;
+    options = opts;
+    started = false;
+    epoch = 0;
+    regions.clear();
+    hashes.clear();
+    changedAt.clear();
+    copies.clear();
+
+    std::vector<MemoryRegion> all;
+    if (src.QueryRegions(all)) {
+        size_t total = 0;
+        for (const auto &r : all) {
+            if (!(r.flags & RegionReadable) || (r.flags & RegionGuard)) continue;
+            if (options.writableOnly && !(r.flags & RegionWritable)) continue;
+            if (!options.includeMapped && (r.flags & RegionMapped)) continue;
+            uintptr_t lo = std::max(r.base, options.startAddress) & ~static_cast<uintptr_t>(kPageSize - 1);
+            uintptr_t hi = std::min(r.base + r.size, options.endAddress);
+            if (hi <= lo) continue;
+            size_t pages = (hi - lo + kPageSize - 1) / kPageSize;
+            regions.push_back({ lo, pages, total });
+            total += pages;
+        }
+        hashes.assign(total, kUnreadable);
+        changedAt.assign(total, 0);
+        started = HashAll(src, false, nullptr, cancel) == total;
+    }
+    if (!started) {
+        regions.clear();
+        hashes.clear();
+        changedAt.clear();
+    }
+    busy = false;
+    return hashes.size();
+}
+
+bool ChangeTracker::Update(IMemorySource& src, ChangeSet& out) {
+    std::lock_guard<std::mutex> g(m);
+    if (!started) return false;
+    busy = true;
+    out.pages.clear();
+    out.ranges.clear();
+    out.epoch = ++epoch;
+    out.pagesHashed = HashAll(src, true, &out, nullptr);
+
+    // 副本超过上限时淘汰最久未变化的页
+    if (copies.size() > options.maxCopies) {
+        std::vector<std::pair<uint32_t, uintptr_t>> order;
+        order.reserve(copies.size());
+        for (const auto &kv : copies) order.push_back({ changedAt[PageIndex(kv.first)], kv.first });
+        size_t drop = copies.size() - options.maxCopies;
+        std::nth_element(order.begin(), order.begin() + drop, order.end());
+        for (size_t i = 0; i < drop; ++i) copies.erase(order[i].second);
+    }
+    busy = false;
+    return true;
+}
+
+size_t ChangeTracker::HashAll(IMemorySource& src, bool diff, ChangeSet* out, const std::atomic<bool>* cancel) {
+    std::vector<Task> tasks;
+    for (size_t r = 0; r < regions.size(); ++r) {
+        for (size_t p = 0; p < regions[r].pages; p += kPagesPerTask) {
+            tasks.push_back({ r, p, std::min(kPagesPerTask, regions[r].pages - p) });
+        }
+    }
+
+    const size_t window = pool.Size() * kWindowFactor;
+    std::vector<TaskOut> outs(diff ? std::min(window, tasks.size()) : 0);
+    std::atomic<size_t> copyBudget{ options.maxCopies };
+    size_t hashed = 0;
+    for (size_t start = 0; start < tasks.size(); start += window) {
+        if (cancel && cancel->load()) return hashed;
+        size_t n = std::min(window, tasks.size() - start);
+        pool.ParallelFor(n, [&](size_t i) {
+            const Task &t = tasks[start + i];
+            const Region &region = regions[t.region];
+            uintptr_t base = region.base + t.page * kPageSize;
+            thread_local std::vector<uint8_t> buf;
+            thread_local std::vector<uint8_t> readable;
+            buf.resize(t.pages * kPageSize);
+            readable.assign(t.pages, 1);
+            if (!src.ReadMemory(base, buf.data(), buf.size())) {
+                for (size_t k = 0; k < t.pages; ++k) {
+                    readable[k] = src.ReadMemory(base + k * kPageSize, buf.data() + k * kPageSize, kPageSize) ? 1 : 0;
+                }
+            }
+            TaskOut* o = diff ? &outs[i] : nullptr;
+            if (o) {
+                o->pages.clear();
+                o->ranges.clear();
+                o->newCopies.clear();
+            }
+            for (size_t k = 0; k < t.pages; ++k) {
+                size_t idx = region.first + t.page + k;
+                const uint8_t* data = buf.data() + k * kPageSize;
+                uint64_t h = readable[k] ? HashPage(data, kPageSize) : kUnreadable;
+                if (o && h != hashes[idx]) {
+                    uintptr_t addr = base + k * kPageSize;
+                    o->pages.push_back(addr);
+                    // 每页只属于一个任务，这里可以直接读写已有的副本；新副本在合并阶段插入
+                    auto it = copies.find(addr);
+                    if (!readable[k]) {
+                        o->ranges.push_back({ addr, static_cast<uint32_t>(kPageSize) });
+                    } else if (it != copies.end()) {
+                        DiffPage(it->second.data(), data, addr, options.mergeGap, o->ranges);
+                        std::memcpy(it->second.data(), data, kPageSize);
+                    } else {
+                        o->ranges.push_back({ addr, static_cast<uint32_t>(kPageSize) });
+                        size_t left = copyBudget.load();
+                        while (left && !copyBudget.compare_exchange_weak(left, left - 1)) {}
+                        if (left) o->newCopies.emplace_back(addr, std::vector<uint8_t>(data, data + kPageSize));
+                    }
+                }
+                hashes[idx] = h;
+            }
+        });
+        for (size_t i = 0; i < n; ++i) hashed += tasks[start + i].pages;
+        if (!diff) continue;
+        for (size_t i = 0; i < n; ++i) {
+            TaskOut &o = outs[i];
+            for (uintptr_t addr : o.pages) {
+                changedAt[PageIndex(addr)] = epoch;
+                if (hashes[PageIndex(addr)] == kUnreadable) copies.erase(addr);
+            }
+            for (auto &c : o.newCopies) copies[c.first] = std::move(c.second);
+            out->pages.insert(out->pages.end(), o.pages.begin(), o.pages.end());
+            out->ranges.insert(out->ranges.end(), o.ranges.begin(), o.ranges.end());
+        }
+    }
+    return hashed;
+}
+
+size_t ChangeTracker::PageIndex(uintptr_t address) const {
+    auto it = std::upper_bound(regions.begin(), regions.end(), address,
+                               [](uintptr_t a, const Region& r) { return a < r.base; });
+    if (it == regions.begin()) return SIZE_MAX;
+    --it;
+    size_t page = (address - it->base) / kPageSize;
+    return page < it->pages ? it->first + page : SIZE_MAX;
+}
+
+void ChangeTracker::ChangedSince(uint32_t since, std::vector<uintptr_t>& pages) const {
+    std::lock_guard<std::mutex> g(m);
+    pages.clear();
+    for (const Region &r : regions) {
+        for (size_t k = 0; k < r.pages; ++k) {
+            if (changedAt[r.first + k] > since) pages.push_back(r.base + k * kPageSize);
+        }
+    }
+}
+
+bool ChangeTracker::ChangedSince(uintptr_t address, uint32_t since) const {
+    std::lock_guard<std::mutex> g(m);
+    size_t idx = PageIndex(address);
+    return idx != SIZE_MAX && changedAt[idx] > since;
+}
+
+uint32_t ChangeTracker::Epoch() const {
+    std::lock_guard<std::mutex> g(m);
+    return epoch;
+}
+
+size_t ChangeTracker::PageCount() const {
+    std::lock_guard<std::mutex> g(m);
+    return hashes.size();
+}
+
+size_t ChangeTracker::BytesUsed() const {
+    std::lock_guard<std::mutex> g(m);
+    return hashes.size() * (sizeof(uint64_t) + sizeof(uint32_t)) + regions.size() * sizeof(Region) +
+           copies.size() * kPageSize;
+}
+
+void ChangeTracker::Reset() {
+    std::lock_guard<std::mutex> g(m);
+    started = false;
+    epoch = 0;
+    regions.clear();
+    hashes.clear();
+    changedAt.clear();
+    copies.clear();
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "memory_source.h"
+#include "thread_pool.h"
+
+struct ChangeTrackerOptions {
+    bool writableOnly = true;
+    bool includeMapped = false;
+    uintptr_t startAddress = 0;
+    uintptr_t endAddress = UINTPTR_MAX;
+    size_t maxCopies = 4096;        // 保留页副本的上限（用于逐字节比较），默认 16 MiB
+    uint32_t mergeGap = 8;          // 间距不超过该值的变化字节合并为一个范围
+};
+
+struct ChangedRange {
+    uintptr_t address;
+    uint32_t size;
+};
+
+// 一次 Update 的结果：epoch - 1 到 epoch 之间变化的页和字节范围
+struct ChangeSet {
+    uint32_t epoch = 0;
+    size_t pagesHashed = 0;
+    std::vector<uintptr_t> pages;           // 按地址升序
+    std::vector<ChangedRange> ranges;       // 有旧副本的页给出精确范围，否则为整页
+};
+
+/**
+ * 页哈希变化跟踪器：Start 时记录目标所有可读页的 64 位哈希，之后每次 Update 并行重新读取并哈希，
+ * 只有哈希变化的页才做逐字节比较。每页常驻 12 字节（哈希 + 最后变化的纪元），
+ * 只为最近变化过的页保留副本（数量有上限），没有副本的页按整页报告，并从此保留副本。
+ * 跟踪的区域在 Start 时确定，之后新分配的内存需要重新 Start。
+ */
+class ChangeTracker {
+public:
+    static constexpr size_t kPageSize = 0x1000;
+
+    explicit ChangeTracker(ThreadPool& pool = ThreadPool::Shared());
+
+    // 返回跟踪的页数；被取消时不保留任何状态，返回 0
+    size_t Start(IMemorySource& src, const ChangeTrackerOptions& opts, const std::atomic<bool>* cancel = nullptr);
+    // 推进纪元并返回本次的变化；未 Start 时返回 false。
+    // 更新不可中途取消，否则未处理的页会被归到之后的纪元
+    bool Update(IMemorySource& src, ChangeSet& out);
+
+    // epoch 之后（不含）变化过的页，按地址升序
+    void ChangedSince(uint32_t epoch, std::vector<uintptr_t>& pages) const;
+    bool ChangedSince(uintptr_t address, uint32_t epoch) const;
+
+    uint32_t Epoch() const;
+    size_t PageCount() const;
+    size_t BytesUsed() const;
+    bool Busy() const { return busy.load(); }
+    void Reset();
+
+    // XXH64 风格的 4 路并行哈希，编译器可以向量化
+    static uint64_t HashPage(const uint8_t* data, size_t size);
+
+private:
+    struct Region {
+        uintptr_t base;
+        size_t pages;
+        size_t first;       // 在 hashes/changedAt 中的起始下标
+    };
+
+    // 调用方持有 m
+    size_t PageIndex(uintptr_t address) const;
+    size_t HashAll(IMemorySource& src, bool diff, ChangeSet* out, const std::atomic<bool>* cancel);
+
+    ThreadPool& pool;
+    mutable std::mutex m;
+    std::atomic<bool> busy{ false };
+    ChangeTrackerOptions options;
+    bool started = false;
+    uint32_t epoch = 0;
+    std::vector<Region> regions;
+    std::vector<uint64_t> hashes;
+    std::vector<uint32_t> changedAt;        // 最后一次变化的纪元，0 表示从未变化
+    std::unordered_map<uintptr_t, std::vector<uint8_t>> copies;
+};
@@ -0,0 +1,250 @@
+#include "cheat_table.h"
+#include <algorithm>
+#include <cstring>
+#include "batch_read.h"
+#include "memory.h"
+#include "write_txn.h"
+
+CheatTable::CheatTable(IMemory& mem, PointerResolver& resolver, const std::vector<CheatEntry>& entries)
+    : mem(mem), resolver(resolver) {
+    size_t n = entries.size();
+    handles.reserve(n);
+    types.reserve(n);
+    values.reserve(n);
+    hasValue.reserve(n);
+    lockFlags.reserve(n);
+    freqs.reserve(n);
+    groups.reserve(n);
+    lockIds.assign(n, 0);
+    for (const CheatEntry& e : entries) {
+        handles.push_back(resolver.Compile(e.path));
+        types.push_back(e.type);
+        values.push_back(e.value);
+        hasValue.push_back(e.hasValue ? 1 : 0);
+        lockFlags.push_back(e.lock ? 1 : 0);
+        freqs.push_back(e.freqMs);
+        auto it = groupIds.emplace(e.group, static_cast<int>(groupIds.size())).first;
+        groups.push_back(it->second);
+    }
+}
+
+CheatTable::~CheatTable() {
+    Unlock(kAllGroups);
+    for (int h : handles) resolver.Release(h);
+}
+
+bool CheatTable::FindGroup(const std::string& name, int& group) const {
+    if (name.empty()) {
+        group = kAllGroups;
+        return true;
+    }
+    auto it = groupIds.find(name);
+    if (it == groupIds.end()) return false;
+    group = it->second;
+    return true;
+}
+
+void CheatTable::Select(int group, std::vector<uint32_t>& out) const {
+    out.clear();
+    for (size_t i = 0; i < groups.size(); ++i) {
+        if (group == kAllGroups || groups[i] == group) out.push_back(static_cast<uint32_t>(i));
+    }
+}
+
+void CheatTable::ResolveSelected(const std::vector<uint32_t>& sel, std::vector<uintptr_t>& addrs, std::vector<uint8_t>& ok) {
+    thread_local std::vector<int> selHandles;
+    selHandles.resize(sel.size());
+    for (size_t k = 0; k < sel.size(); ++k) selHandles[k] = handles[sel[k]];
+    resolver.ResolveMany(selHandles, addrs, ok);
+}
+
+size_t CheatTable::Apply(int group, std::vector<uint8_t>& okBits) {
+    thread_local std::vector<uint32_t> sel;
+    thread_local std::vector<uintptr_t> addrs;
+    thread_local std::vector<uint8_t> ok;
+    thread_local std::vector<uint32_t> slots;
+    thread_local std::vector<uint8_t> bits;
+    thread_local WriteTransaction txn;
+    okBits.assign((Count() + 7) / 8, 0);
+
+    Select(group, sel);
+    // 只解析有值的项
+    sel.erase(std::remove_if(sel.begin(), sel.end(), [&](uint32_t i) { return !hasValue[i]; }), sel.end());
+    if (sel.empty()) return 0;
+    ResolveSelected(sel, addrs, ok);
+
+    txn.Clear();
+    slots.clear();
+    for (size_t k = 0; k < sel.size(); ++k) {
+        if (!ok[k]) continue;
+        uint32_t i = sel[k];
+        slots.push_back(i);
+        txn.Add(addrs[k], &values[i], ValueTypeSize(types[i]));
+    }
+    mem.CommitWrites(txn, bits);
+
+    size_t n = 0;
+    for (size_t k = 0; k < slots.size(); ++k) {
+        if (k / 8 >= bits.size() || !((bits[k / 8] >> (k % 8)) & 1)) continue;
+        okBits[slots[k] / 8] |= 1 << (slots[k] % 8);
+        ++n;
+    }
+    return n;
+}
+
+size_t CheatTable::Read(int group, std::vector<uint64_t>& out, std::vector<uint8_t>& okBits) {
+    thread_local std::vector<uint32_t> sel;
+    thread_local std::vector<uintptr_t> addrs;
+    thread_local std::vector<uint8_t> ok;
+    thread_local std::vector<ReadRequest> reqs;
+    thread_local std::vector<uint32_t> slots;
+    thread_local std::vector<uint8_t> bits;
+    out.assign(Count(), 0);
+    okBits.assign((Count() + 7) / 8, 0);
+
+    Select(group, sel);
+    if (sel.empty()) return 0;
+    ResolveSelected(sel, addrs, ok);
+
+    reqs.clear();
+    slots.clear();
+    for (size_t k = 0; k < sel.size(); ++k) {
+        if (!ok[k]) continue;
+        uint32_t i = sel[k];
+        slots.push_back(i);
+        reqs.push_back({ addrs[k], static_cast<uint32_t>(ValueTypeSize(types[i])), i * 8 });
+    }
+    bits.assign((reqs.size() + 7) / 8, 0);
+    size_t n = ReadBatch(mem, reqs.data(), reqs.size(), reinterpret_cast<uint8_t*>(out.data()), bits.data());
+    for (size_t k = 0; k < slots.size(); ++k) {
+        if ((bits[k / 8] >> (k % 8)) & 1) okBits[slots[k] / 8] |= 1 << (slots[k] % 8);
+    }
+    return n;
+}
+
+size_t CheatTable::Lock(int group, int freqMs) {
+    thread_local std::vector<uint32_t> sel;
+    thread_local std::vector<uintptr_t> addrs;
+    thread_local std::vector<uint8_t> ok;
+    thread_local std::vector<uint8_t> data;
+
+    Select(group, sel);
+    sel.erase(std::remove_if(sel.begin(), sel.end(), [&](uint32_t i) { return !hasValue[i] || !lockFlags[i]; }), sel.end());
+    if (sel.empty()) return 0;
+    ResolveSelected(sel, addrs, ok);
+
+    size_t n = 0;
+    for (size_t k = 0; k < sel.size(); ++k) {
+        uint32_t i = sel[k];
+        // 重新锁定时地址可能已变化，先解除旧的锁定
+        if (lockIds[i] > 0) {
+            mem.UnlockMemory(lockIds[i]);
+            lockIds[i] = 0;
+        }
+        if (!ok[k]) continue;
+        size_t size = ValueTypeSize(types[i]);
+        data.resize(size);
+        std::memcpy(data.data(), &values[i], size);
+        int id = mem.LockMemory(addrs[k], data, size, freqMs > 0 ? freqMs : static_cast<int>(freqs[i]));
+        if (id > 0) {
+            lockIds[i] = id;
+            ++n;
+        }
+    }
+    return n;
+}
+
+size_t CheatTable::Unlock(int group) {
+    size_t n = 0;
+    for (size_t i = 0; i < lockIds.size(); ++i) {
+        if (lockIds[i] <= 0 || (group != kAllGroups && groups[i] != group)) continue;
+        if (mem.UnlockMemory(lockIds[i])) ++n;
+        lockIds[i] = 0;
+    }
+    return n;
+}
+
+CheatTableSet::CheatTableSet(IMemory& mem, PointerResolver& resolver) : mem(mem), resolver(resolver), nextId(1) {}
+
+// FNV-1a，覆盖影响编译结果的全部字段
+uint64_t CheatTableSet::Hash(const std::vector<CheatEntry>& entries) {
+    uint64_t h = 0xcbf29ce484222325ull;
+    auto mix = [&h](const void* data, size_t size) {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            h ^= p[i];
+            h *= 0x100000001b3ull;
+        }
+    };
+    auto mixValue = [&mix](uint64_t v) { mix(&v, sizeof(v)); };
+    mixValue(entries.size());
+    for (const CheatEntry& e : entries) {
+        mixValue(e.path.hasModule);
+        mixValue(e.path.module.size());
+        mix(e.path.module.data(), e.path.module.size() * sizeof(wchar_t));
+        mixValue(e.path.baseOffset);
+        mixValue(e.path.offsets.size());
+        mix(e.path.offsets.data(), e.path.offsets.size() * sizeof(uint64_t));
+        mixValue(static_cast<uint64_t>(e.type));
+        mixValue(e.hasValue);
+        mixValue(e.value);
+        mixValue(e.lock);
+        mixValue(e.freqMs);
+        mixValue(e.group.size());
+        mix(e.group.data(), e.group.size());
+    }
+    return h;
+}
+
+bool CheatTableSet::SameEntries(const std::vector<CheatEntry>& a, const std::vector<CheatEntry>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        const CheatEntry &x = a[i], &y = b[i];
+        if (x.path.hasModule != y.path.hasModule || x.path.module != y.path.module ||
+            x.path.baseOffset != y.path.baseOffset || x.path.offsets != y.path.offsets || x.type != y.type ||
+            x.hasValue != y.hasValue || x.value != y.value || x.lock != y.lock || x.freqMs != y.freqMs ||
+            x.group != y.group) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int CheatTableSet::Load(const std::vector<CheatEntry>& entries) {
+    uint64_t h = Hash(entries);
+    auto range = byHash.equal_range(h);
+    for (auto it = range.first; it != range.second; ++it) {
+        Slot &slot = tables[it->second];
+        if (!SameEntries(slot.entries, entries)) continue;
+        ++slot.refs;
+        return it->second;
+    }
+    int id = nextId++;
+    tables[id] = { std::make_unique<CheatTable>(mem, resolver, entries), entries, h, 1 };
+    byHash.emplace(h, id);
+    return id;
+}
+
+CheatTable* CheatTableSet::Get(int id) {
+    auto it = tables.find(id);
+    return it == tables.end() ? nullptr : it->second.table.get();
+}
+
+bool CheatTableSet::Release(int id) {
+    auto it = tables.find(id);
+    if (it == tables.end()) return false;
+    if (--it->second.refs > 0) return true;
+    auto range = byHash.equal_range(it->second.hash);
+    for (auto h = range.first; h != range.second; ++h) {
+        if (h->second != id) continue;
+        byHash.erase(h);
+        break;
+    }
+    tables.erase(it);
+    return true;
+}
+
+void CheatTableSet::Clear() {
+    byHash.clear();
+    tables.clear();
+}
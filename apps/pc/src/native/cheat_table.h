@@ -0,0 +1,100 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "pointer_resolver.h"
+#include "value_type.h"
+
+class IMemory;
+
+// 修改器表的一项：指针路径 + 类型 + 要写入/锁定的值
+struct CheatEntry {
+    PointerPath path;
+    ValueType type = ValueType::Int32;
+    bool hasValue = false;          // 没有值的项只用于读取
+    uint64_t value = 0;             // 按 type 解释的原始字节（低位对齐）
+    bool lock = false;              // lockTable 时是否锁定
+    uint32_t freqMs = 200;
+    std::string group;
+};
+
+/**
+ * 编译后的修改器表：各项的指针路径预编译为解析器句柄，类型、值、锁定参数和分组按列存放。
+ * 应用、读取和锁定都按整表或分组一次完成：所有路径经 PointerResolver::ResolveMany 解析
+ * （相同前缀只读取一次），读取合并为一次 ReadBatch，写入作为一个写入事务提交。
+ */
+class CheatTable {
+public:
+    static constexpr int kAllGroups = -1;
+
+    CheatTable(IMemory& mem, PointerResolver& resolver, const std::vector<CheatEntry>& entries);
+    ~CheatTable();      // 解除本表的锁定并释放解析器句柄
+
+    size_t Count() const { return handles.size(); }
+    // 分组名 -> 分组编号；空名表示整表（kAllGroups），未知分组返回 false
+    bool FindGroup(const std::string& name, int& group) const;
+
+    // 写入所选项的值（没有值的项跳过），okBits 按表中顺序逐位标记成功，返回成功数量
+    size_t Apply(int group, std::vector<uint8_t>& okBits);
+    // 读取所选项的当前值到 out[i]（低位对齐），返回成功数量
+    size_t Read(int group, std::vector<uint64_t>& out, std::vector<uint8_t>& okBits);
+    // 锁定所选项中标记了 lock 且有值的项，已锁定的项先解除；freqMs > 0 时覆盖各项的频率
+    size_t Lock(int group, int freqMs);
+    size_t Unlock(int group);
+
+    ValueType TypeAt(size_t i) const { return types[i]; }
+
+private:
+    // 所选项在表中的下标
+    void Select(int group, std::vector<uint32_t>& out) const;
+    void ResolveSelected(const std::vector<uint32_t>& sel, std::vector<uintptr_t>& addrs, std::vector<uint8_t>& ok);
+
+    IMemory& mem;
+    PointerResolver& resolver;
+
+    // 按列存放
+    std::vector<int> handles;
+    std::vector<ValueType> types;
+    std::vector<uint64_t> values;
+    std::vector<uint8_t> hasValue;
+    std::vector<uint8_t> lockFlags;
+    std::vector<uint32_t> freqs;
+    std::vector<int> groups;
+    std::vector<int> lockIds;       // 0 表示未锁定
+
+    std::unordered_map<std::string, int> groupIds;
+};
+
+/**
+ * 一个会话加载的全部修改器表。按定义内容缓存编译结果（哈希只用于分桶，命中后逐项比较定义）：
+ * 重新加载未修改的表直接返回已有的表，不重新编译，解析器中缓存的中间指针和已生效的锁定都保留。同一个表被加载几次就需要释放几次。
+ */
+class CheatTableSet {
+public:
+    CheatTableSet(IMemory& mem, PointerResolver& resolver);
+
+    int Load(const std::vector<CheatEntry>& entries);
+    CheatTable* Get(int id);
+    bool Release(int id);
+    void Clear();
+
+    static uint64_t Hash(const std::vector<CheatEntry>& entries);
+    static bool SameEntries(const std::vector<CheatEntry>& a, const std::vector<CheatEntry>& b);
+
+private:
+    struct Slot {
+        std::unique_ptr<CheatTable> table;
+        std::vector<CheatEntry> entries;    // 表的定义，哈希冲突时用于区分
+        uint64_t hash;
+        int refs;
+    };
+
+    IMemory& mem;
+    PointerResolver& resolver;
+    std::unordered_map<int, Slot> tables;
+    std::unordered_multimap<uint64_t, int> byHash;
+    int nextId;
+};
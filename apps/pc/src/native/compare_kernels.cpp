@@ -0,0 +1,529 @@
+#include "compare_kernels.h"
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include "cpu_features.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define COMPARE_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#else
+#define COMPARE_X86 0
+#endif
+
+// MSVC 不需要为使用高级指令集的函数单独标注
+#if COMPARE_X86 && !defined(_MSC_VER)
+#define TARGET_SSE42 __attribute__((target("sse4.2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE42
+#define TARGET_AVX2
+#endif
+
+namespace {
+
+inline size_t PopCount(uint64_t x) {
+    return std::bitset<64>(x).count();
+}
+
+template<typename T>
+struct Params {
+    T a;
+    T b;
+};
+
+template<typename T>
+inline T LoadAt(const uint8_t* p) {
+    T v;
+    std::memcpy(&v, p, sizeof(T));
+    return v;
+}
+
+// 整数按补码回绕相加/相减（有符号溢出不是未定义行为）
+template<typename T>
+inline T WrapAdd(T x, T y) {
+    if constexpr (std::is_integral<T>::value) {
+        using U = std::make_unsigned_t<T>;
+        return static_cast<T>(static_cast<U>(static_cast<U>(x) + static_cast<U>(y)));
+    } else {
+        return x + y;
+    }
+}
+
+template<typename T>
+inline T WrapSub(T x, T y) {
+    if constexpr (std::is_integral<T>::value) {
+        using U = std::make_unsigned_t<T>;
+        return static_cast<T>(static_cast<U>(static_cast<U>(x) - static_cast<U>(y)));
+    } else {
+        return x - y;
+    }
+}
+
+template<typename T, CompareOp Op>
+inline bool Test(T v, T o, const Params<T>& p) {
+    if constexpr (Op == CompareOp::Equal) return v == p.a;
+    else if constexpr (Op == CompareOp::NotEqual) return v != p.a;
+    else if constexpr (Op == CompareOp::Greater) return v > p.a;
+    else if constexpr (Op == CompareOp::Less) return v < p.a;
+    else if constexpr (Op == CompareOp::Between) return (v >= p.a) & (v <= p.b);
+    else if constexpr (Op == CompareOp::Changed) return v != o;
+    else if constexpr (Op == CompareOp::Unchanged) return v == o;
+    else if constexpr (Op == CompareOp::Increased) return v > o;
+    else if constexpr (Op == CompareOp::Decreased) return v < o;
+    else if constexpr (Op == CompareOp::IncreasedBy) {
+        if constexpr (std::is_floating_point<T>::value) {
+            T d = v - o - p.a;
+            return (d < 0 ? -d : d) <= p.b;
+        } else {
+            return v == WrapAdd(o, p.a);
+        }
+    } else {
+        static_assert(Op == CompareOp::DecreasedBy, "unsupported compare op");
+        if constexpr (std::is_floating_point<T>::value) {
+            T d = v - o + p.a;
+            return (d < 0 ? -d : d) <= p.b;
+        } else {
+            return v == WrapSub(o, p.a);
+        }
+    }
+}
+
+// 标量内核：Stride 为 0 时使用运行时步长。每 64 个位置先无分支地算出命中字再写出
+template<typename T, CompareOp Op, size_t Stride>
+size_t ScalarKernel(const uint8_t* cur, const uint8_t* old, size_t n, size_t stride, const Params<T>& p, uint64_t* mask) {
+    const size_t step = Stride ? Stride : stride;
+    size_t hits = 0;
+    for (size_t base = 0; base < n; base += 64) {
+        size_t cnt = std::min<size_t>(64, n - base);
+        uint64_t m = 0;
+        for (size_t j = 0; j < cnt; ++j) {
+            size_t off = (base + j) * step;
+            T o = CompareNeedsOld(Op) ? LoadAt<T>(old + off) : T();
+            m |= static_cast<uint64_t>(Test<T, Op>(LoadAt<T>(cur + off), o, p)) << j;
+        }
+        mask[base / 64] = m;
+        hits += PopCount(m);
+    }
+    return hits;
+}
+
+#if COMPARE_X86
+
+// ---------------- SSE4.2 ----------------
+namespace sse {
+
+template<size_t W> struct Lanes;
+template<> struct Lanes<1> {
+    static TARGET_SSE42 __m128i Set1(uint64_t x) { return _mm_set1_epi8(static_cast<char>(x)); }
+    static TARGET_SSE42 __m128i Eq(__m128i a, __m128i b) { return _mm_cmpeq_epi8(a, b); }
+    static TARGET_SSE42 __m128i Gt(__m128i a, __m128i b) { return _mm_cmpgt_epi8(a, b); }
+    static TARGET_SSE42 __m128i Add(__m128i a, __m128i b) { return _mm_add_epi8(a, b); }
+    static TARGET_SSE42 __m128i Sub(__m128i a, __m128i b) { return _mm_sub_epi8(a, b); }
+};
+template<> struct Lanes<2> {
+    static TARGET_SSE42 __m128i Set1(uint64_t x) { return _mm_set1_epi16(static_cast<short>(x)); }
+    static TARGET_SSE42 __m128i Eq(__m128i a, __m128i b) { return _mm_cmpeq_epi16(a, b); }
+    static TARGET_SSE42 __m128i Gt(__m128i a, __m128i b) { return _mm_cmpgt_epi16(a, b); }
+    static TARGET_SSE42 __m128i Add(__m128i a, __m128i b) { return _mm_add_epi16(a, b); }
+    static TARGET_SSE42 __m128i Sub(__m128i a, __m128i b) { return _mm_sub_epi16(a, b); }
+};
+template<> struct Lanes<4> {
+    static TARGET_SSE42 __m128i Set1(uint64_t x) { return _mm_set1_epi32(static_cast<int>(x)); }
+    static TARGET_SSE42 __m128i Eq(__m128i a, __m128i b) { return _mm_cmpeq_epi32(a, b); }
+    static TARGET_SSE42 __m128i Gt(__m128i a, __m128i b) { return _mm_cmpgt_epi32(a, b); }
+    static TARGET_SSE42 __m128i Add(__m128i a, __m128i b) { return _mm_add_epi32(a, b); }
+    static TARGET_SSE42 __m128i Sub(__m128i a, __m128i b) { return _mm_sub_epi32(a, b); }
+};
+template<> struct Lanes<8> {
+    static TARGET_SSE42 __m128i Set1(uint64_t x) { return _mm_set1_epi64x(static_cast<long long>(x)); }
+    static TARGET_SSE42 __m128i Eq(__m128i a, __m128i b) { return _mm_cmpeq_epi64(a, b); }
+    static TARGET_SSE42 __m128i Gt(__m128i a, __m128i b) { return _mm_cmpgt_epi64(a, b); }
+    static TARGET_SSE42 __m128i Add(__m128i a, __m128i b) { return _mm_add_epi64(a, b); }
+    static TARGET_SSE42 __m128i Sub(__m128i a, __m128i b) { return _mm_sub_epi64(a, b); }
+};
+
+template<typename T>
+struct IntTraits {
+    using V = __m128i;
+    using L = Lanes<sizeof(T)>;
+    static constexpr size_t kLanes = 16 / sizeof(T);
+    static constexpr bool kFloat = false;
+
+    static TARGET_SSE42 V Load(const uint8_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static TARGET_SSE42 V Set1(T x) {
+        uint64_t raw = 0;
+        std::memcpy(&raw, &x, sizeof(T));
+        return L::Set1(raw);
+    }
+    // 无符号比较：翻转符号位后按有符号比较
+    static TARGET_SSE42 V Bias(V a) {
+        if constexpr (std::is_signed<T>::value) return a;
+        else return _mm_xor_si128(a, L::Set1(uint64_t(1) << (sizeof(T) * 8 - 1)));
+    }
+    static TARGET_SSE42 V Not(V a) { return _mm_xor_si128(a, _mm_set1_epi32(-1)); }
+    static TARGET_SSE42 V And(V a, V b) { return _mm_and_si128(a, b); }
+    static TARGET_SSE42 V Eq(V a, V b) { return L::Eq(a, b); }
+    static TARGET_SSE42 V Gt(V a, V b) { return L::Gt(Bias(a), Bias(b)); }
+    static TARGET_SSE42 V Lt(V a, V b) { return Gt(b, a); }
+    static TARGET_SSE42 V Ge(V a, V b) { return Not(Gt(b, a)); }
+    static TARGET_SSE42 V Le(V a, V b) { return Not(Gt(a, b)); }
+    static TARGET_SSE42 V Add(V a, V b) { return L::Add(a, b); }
+    static TARGET_SSE42 V Sub(V a, V b) { return L::Sub(a, b); }
+    static TARGET_SSE42 uint64_t Mask2(V c0, V c1) {
+        if constexpr (sizeof(T) == 1) {
+            return static_cast<uint32_t>(_mm_movemask_epi8(c0)) | static_cast<uint64_t>(_mm_movemask_epi8(c1)) << 16;
+        } else if constexpr (sizeof(T) == 2) {
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_packs_epi16(c0, c1)));
+        } else if constexpr (sizeof(T) == 4) {
+            return static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(c0)) | _mm_movemask_ps(_mm_castsi128_ps(c1)) << 4);
+        } else {
+            return static_cast<uint32_t>(_mm_movemask_pd(_mm_castsi128_pd(c0)) | _mm_movemask_pd(_mm_castsi128_pd(c1)) << 2);
+        }
+    }
+};
+
+struct FloatTraits {
+    using V = __m128;
+    static constexpr size_t kLanes = 4;
+    static constexpr bool kFloat = true;
+
+    static TARGET_SSE42 V Load(const uint8_t* p) { return _mm_loadu_ps(reinterpret_cast<const float*>(p)); }
+    static TARGET_SSE42 V Set1(float x) { return _mm_set1_ps(x); }
+    static TARGET_SSE42 V Not(V a) { return _mm_xor_ps(a, _mm_castsi128_ps(_mm_set1_epi32(-1))); }
+    static TARGET_SSE42 V And(V a, V b) { return _mm_and_ps(a, b); }
+    static TARGET_SSE42 V Eq(V a, V b) { return _mm_cmpeq_ps(a, b); }
+    static TARGET_SSE42 V Gt(V a, V b) { return _mm_cmpgt_ps(a, b); }
+    static TARGET_SSE42 V Lt(V a, V b) { return _mm_cmplt_ps(a, b); }
+    static TARGET_SSE42 V Ge(V a, V b) { return _mm_cmpge_ps(a, b); }
+    static TARGET_SSE42 V Le(V a, V b) { return _mm_cmple_ps(a, b); }
+    static TARGET_SSE42 V Add(V a, V b) { return _mm_add_ps(a, b); }
+    static TARGET_SSE42 V Sub(V a, V b) { return _mm_sub_ps(a, b); }
+    static TARGET_SSE42 V Abs(V a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static TARGET_SSE42 uint64_t Mask2(V c0, V c1) {
+        return static_cast<uint32_t>(_mm_movemask_ps(c0) | _mm_movemask_ps(c1) << 4);
+    }
+};
+
+struct DoubleTraits {
+    using V = __m128d;
+    static constexpr size_t kLanes = 2;
+    static constexpr bool kFloat = true;
+
+    static TARGET_SSE42 V Load(const uint8_t* p) { return _mm_loadu_pd(reinterpret_cast<const double*>(p)); }
+    static TARGET_SSE42 V Set1(double x) { return _mm_set1_pd(x); }
+    static TARGET_SSE42 V Not(V a) { return _mm_xor_pd(a, _mm_castsi128_pd(_mm_set1_epi32(-1))); }
+    static TARGET_SSE42 V And(V a, V b) { return _mm_and_pd(a, b); }
+    static TARGET_SSE42 V Eq(V a, V b) { return _mm_cmpeq_pd(a, b); }
+    static TARGET_SSE42 V Gt(V a, V b) { return _mm_cmpgt_pd(a, b); }
+    static TARGET_SSE42 V Lt(V a, V b) { return _mm_cmplt_pd(a, b); }
+    static TARGET_SSE42 V Ge(V a, V b) { return _mm_cmpge_pd(a, b); }
+    static TARGET_SSE42 V Le(V a, V b) { return _mm_cmple_pd(a, b); }
+    static TARGET_SSE42 V Add(V a, V b) { return _mm_add_pd(a, b); }
+    static TARGET_SSE42 V Sub(V a, V b) { return _mm_sub_pd(a, b); }
+    static TARGET_SSE42 V Abs(V a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+    static TARGET_SSE42 uint64_t Mask2(V c0, V c1) {
+        return static_cast<uint32_t>(_mm_movemask_pd(c0) | _mm_movemask_pd(c1) << 2);
+    }
+};
+
+template<typename T>
+using Traits = std::conditional_t<std::is_same<T, float>::value, FloatTraits,
+               std::conditional_t<std::is_same<T, double>::value, DoubleTraits, IntTraits<T>>>;
+
+#define SIMD_TARGET TARGET_SSE42
+#include "compare_kernels_simd.inl"
+#undef SIMD_TARGET
+
+} // namespace sse
+
+// ---------------- AVX2 ----------------
+namespace avx {
+
+template<size_t W> struct Lanes;
+template<> struct Lanes<1> {
+    static TARGET_AVX2 __m256i Set1(uint64_t x) { return _mm256_set1_epi8(static_cast<char>(x)); }
+    static TARGET_AVX2 __m256i Eq(__m256i a, __m256i b) { return _mm256_cmpeq_epi8(a, b); }
+    static TARGET_AVX2 __m256i Gt(__m256i a, __m256i b) { return _mm256_cmpgt_epi8(a, b); }
+    static TARGET_AVX2 __m256i Add(__m256i a, __m256i b) { return _mm256_add_epi8(a, b); }
+    static TARGET_AVX2 __m256i Sub(__m256i a, __m256i b) { return _mm256_sub_epi8(a, b); }
+};
+template<> struct Lanes<2> {
+    static TARGET_AVX2 __m256i Set1(uint64_t x) { return _mm256_set1_epi16(static_cast<short>(x)); }
+    static TARGET_AVX2 __m256i Eq(__m256i a, __m256i b) { return _mm256_cmpeq_epi16(a, b); }
+    static TARGET_AVX2 __m256i Gt(__m256i a, __m256i b) { return _mm256_cmpgt_epi16(a, b); }
+    static TARGET_AVX2 __m256i Add(__m256i a, __m256i b) { return _mm256_add_epi16(a, b); }
+    static TARGET_AVX2 __m256i Sub(__m256i a, __m256i b) { return _mm256_sub_epi16(a, b); }
+};
+template<> struct Lanes<4> {
+    static TARGET_AVX2 __m256i Set1(uint64_t x) { return _mm256_set1_epi32(static_cast<int>(x)); }
+    static TARGET_AVX2 __m256i Eq(__m256i a, __m256i b) { return _mm256_cmpeq_epi32(a, b); }
+    static TARGET_AVX2 __m256i Gt(__m256i a, __m256i b) { return _mm256_cmpgt_epi32(a, b); }
+    static TARGET_AVX2 __m256i Add(__m256i a, __m256i b) { return _mm256_add_epi32(a, b); }
+    static TARGET_AVX2 __m256i Sub(__m256i a, __m256i b) { return _mm256_sub_epi32(a, b); }
+};
+template<> struct Lanes<8> {
+    static TARGET_AVX2 __m256i Set1(uint64_t x) { return _mm256_set1_epi64x(static_cast<long long>(x)); }
+    static TARGET_AVX2 __m256i Eq(__m256i a, __m256i b) { return _mm256_cmpeq_epi64(a, b); }
+    static TARGET_AVX2 __m256i Gt(__m256i a, __m256i b) { return _mm256_cmpgt_epi64(a, b); }
+    static TARGET_AVX2 __m256i Add(__m256i a, __m256i b) { return _mm256_add_epi64(a, b); }
+    static TARGET_AVX2 __m256i Sub(__m256i a, __m256i b) { return _mm256_sub_epi64(a, b); }
+};
+
+template<typename T>
+struct IntTraits {
+    using V = __m256i;
+    using L = Lanes<sizeof(T)>;
+    static constexpr size_t kLanes = 32 / sizeof(T);
+    static constexpr bool kFloat = false;
+
+    static TARGET_AVX2 V Load(const uint8_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static TARGET_AVX2 V Set1(T x) {
+        uint64_t raw = 0;
+        std::memcpy(&raw, &x, sizeof(T));
+        return L::Set1(raw);
+    }
+    static TARGET_AVX2 V Bias(V a) {
+        if constexpr (std::is_signed<T>::value) return a;
+        else return _mm256_xor_si256(a, L::Set1(uint64_t(1) << (sizeof(T) * 8 - 1)));
+    }
+    static TARGET_AVX2 V Not(V a) { return _mm256_xor_si256(a, _mm256_set1_epi32(-1)); }
+    static TARGET_AVX2 V And(V a, V b) { return _mm256_and_si256(a, b); }
+    static TARGET_AVX2 V Eq(V a, V b) { return L::Eq(a, b); }
+    static TARGET_AVX2 V Gt(V a, V b) { return L::Gt(Bias(a), Bias(b)); }
+    static TARGET_AVX2 V Lt(V a, V b) { return Gt(b, a); }
+    static TARGET_AVX2 V Ge(V a, V b) { return Not(Gt(b, a)); }
+    static TARGET_AVX2 V Le(V a, V b) { return Not(Gt(a, b)); }
+    static TARGET_AVX2 V Add(V a, V b) { return L::Add(a, b); }
+    static TARGET_AVX2 V Sub(V a, V b) { return L::Sub(a, b); }
+    static TARGET_AVX2 uint64_t Mask2(V c0, V c1) {
+        if constexpr (sizeof(T) == 1) {
+            return static_cast<uint32_t>(_mm256_movemask_epi8(c0)) | static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(c1))) << 32;
+        } else if constexpr (sizeof(T) == 2) {
+            // packs 按 128 位通道交错，重排后恢复元素顺序
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi16(c0, c1), 0xD8);
+            return static_cast<uint32_t>(_mm256_movemask_epi8(packed));
+        } else if constexpr (sizeof(T) == 4) {
+            return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(c0)) | _mm256_movemask_ps(_mm256_castsi256_ps(c1)) << 8);
+        } else {
+            return static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(c0)) | _mm256_movemask_pd(_mm256_castsi256_pd(c1)) << 4);
+        }
+    }
+};
+
+struct FloatTraits {
+    using V = __m256;
+    static constexpr size_t kLanes = 8;
+    static constexpr bool kFloat = true;
+
+    static TARGET_AVX2 V Load(const uint8_t* p) { return _mm256_loadu_ps(reinterpret_cast<const float*>(p)); }
+    static TARGET_AVX2 V Set1(float x) { return _mm256_set1_ps(x); }
+    static TARGET_AVX2 V Not(V a) { return _mm256_xor_ps(a, _mm256_castsi256_ps(_mm256_set1_epi32(-1))); }
+    static TARGET_AVX2 V And(V a, V b) { return _mm256_and_ps(a, b); }
+    static TARGET_AVX2 V Eq(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+    static TARGET_AVX2 V Gt(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static TARGET_AVX2 V Lt(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static TARGET_AVX2 V Ge(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    static TARGET_AVX2 V Le(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static TARGET_AVX2 V Add(V a, V b) { return _mm256_add_ps(a, b); }
+    static TARGET_AVX2 V Sub(V a, V b) { return _mm256_sub_ps(a, b); }
+    static TARGET_AVX2 V Abs(V a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static TARGET_AVX2 uint64_t Mask2(V c0, V c1) {
+        return static_cast<uint32_t>(_mm256_movemask_ps(c0) | _mm256_movemask_ps(c1) << 8);
+    }
+};
+
+struct DoubleTraits {
+    using V = __m256d;
+    static constexpr size_t kLanes = 4;
+    static constexpr bool kFloat = true;
+
+    static TARGET_AVX2 V Load(const uint8_t* p) { return _mm256_loadu_pd(reinterpret_cast<const double*>(p)); }
+    static TARGET_AVX2 V Set1(double x) { return _mm256_set1_pd(x); }
+    static TARGET_AVX2 V Not(V a) { return _mm256_xor_pd(a, _mm256_castsi256_pd(_mm256_set1_epi32(-1))); }
+    static TARGET_AVX2 V And(V a, V b) { return _mm256_and_pd(a, b); }
+    static TARGET_AVX2 V Eq(V a, V b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+    static TARGET_AVX2 V Gt(V a, V b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+    static TARGET_AVX2 V Lt(V a, V b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+    static TARGET_AVX2 V Ge(V a, V b) { return _mm256_cmp_pd(a, b, _CMP_GE_OQ); }
+    static TARGET_AVX2 V Le(V a, V b) { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+    static TARGET_AVX2 V Add(V a, V b) { return _mm256_add_pd(a, b); }
+    static TARGET_AVX2 V Sub(V a, V b) { return _mm256_sub_pd(a, b); }
+    static TARGET_AVX2 V Abs(V a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+    static TARGET_AVX2 uint64_t Mask2(V c0, V c1) {
+        return static_cast<uint32_t>(_mm256_movemask_pd(c0) | _mm256_movemask_pd(c1) << 4);
+    }
+};
+
+template<typename T>
+using Traits = std::conditional_t<std::is_same<T, float>::value, FloatTraits,
+               std::conditional_t<std::is_same<T, double>::value, DoubleTraits, IntTraits<T>>>;
+
+#define SIMD_TARGET TARGET_AVX2
+#include "compare_kernels_simd.inl"
+#undef SIMD_TARGET
+
+} // namespace avx
+
+#endif // COMPARE_X86
+
+template<typename T, CompareOp Op>
+size_t Compare(const uint8_t* cur, const uint8_t* old, size_t n, size_t stride, const Params<T>& p, uint64_t* mask,
+               CompareIsa isa) {
+    if (stride == sizeof(T)) {
+        // 完整的 64 位置组交给向量内核，不足一组的尾部走标量
+        size_t words = 0;
+        size_t hits = 0;
+#if COMPARE_X86
+        if (isa == CompareIsa::Avx2) {
+            words = n / 64;
+            hits = avx::Run<T, Op>(cur, old, words, p, mask);
+        } else if (isa == CompareIsa::Sse42) {
+            words = n / 64;
+            hits = sse::Run<T, Op>(cur, old, words, p, mask);
+        }
+#else
+        (void)isa;
+#endif
+        size_t done = words * 64;
+        if (done < n) {
+            hits += ScalarKernel<T, Op, sizeof(T)>(cur + done * sizeof(T), old ? old + done * sizeof(T) : nullptr,
+                                                   n - done, stride, p, mask + words);
+        }
+        return hits;
+    }
+    switch (stride) {
+        case 1: return ScalarKernel<T, Op, 1>(cur, old, n, stride, p, mask);
+        case 2: return ScalarKernel<T, Op, 2>(cur, old, n, stride, p, mask);
+        case 4: return ScalarKernel<T, Op, 4>(cur, old, n, stride, p, mask);
+        case 8: return ScalarKernel<T, Op, 8>(cur, old, n, stride, p, mask);
+        default: return ScalarKernel<T, Op, 0>(cur, old, n, stride, p, mask);
+    }
+}
+
+template<typename T>
+size_t CompareTyped(CompareOp op, const Params<T>& p, const uint8_t* cur, const uint8_t* old, size_t n, size_t stride,
+                    uint64_t* mask, CompareIsa isa) {
+    switch (op) {
+        case CompareOp::Equal: return Compare<T, CompareOp::Equal>(cur, old, n, stride, p, mask, isa);
+        case CompareOp::NotEqual: return Compare<T, CompareOp::NotEqual>(cur, old, n, stride, p, mask, isa);
+        case CompareOp::Greater: return Compare<T, CompareOp::Greater>(cur, old, n, stride, p, mask, isa);
+        case CompareOp::Less: return Compare<T, CompareOp::Less>(cur, old, n, stride, p, mask, isa);
+        case CompareOp::Between: return Compare<T, CompareOp::Between>(cur, old, n, stride, p, mask, isa);
+        case CompareOp::Changed: return Compare<T, CompareOp::Changed>(cur, old, n, stride, p, mask, isa);
+        case CompareOp::Unchanged: return Compare<T, CompareOp::Unchanged>(cur, old, n, stride, p, mask, isa);
+        case CompareOp::Increased: return Compare<T, CompareOp::Increased>(cur, old, n, stride, p, mask, isa);
+        case CompareOp::Decreased: return Compare<T, CompareOp::Decreased>(cur, old, n, stride, p, mask, isa);
+        case CompareOp::IncreasedBy: return Compare<T, CompareOp::IncreasedBy>(cur, old, n, stride, p, mask, isa);
+        case CompareOp::DecreasedBy: return Compare<T, CompareOp::DecreasedBy>(cur, old, n, stride, p, mask, isa);
+        default: break;
+    }
+    std::fill(mask, mask + (n + 63) / 64, 0);
+    return 0;
+}
+
+// Approx 转换为 Between：整数的上下界饱和到类型范围，容差取绝对值
+template<typename T>
+void ApproxBounds(T target, T eps, Params<T>& p) {
+    if constexpr (std::is_floating_point<T>::value) {
+        if (eps < 0) eps = -eps;
+        p.a = target - eps;
+        p.b = target + eps;
+    } else {
+        if constexpr (std::is_signed<T>::value) {
+            if (eps < 0) eps = 0;
+        }
+        p.a = target < std::numeric_limits<T>::min() + eps ? std::numeric_limits<T>::min() : static_cast<T>(target - eps);
+        p.b = target > std::numeric_limits<T>::max() - eps ? std::numeric_limits<T>::max() : static_cast<T>(target + eps);
+    }
+}
+
+CompareIsa DetectIsa() {
+    const CpuFeatures &cpu = GetCpuFeatures();
+    if (COMPARE_X86 && cpu.avx2) return CompareIsa::Avx2;
+    if (COMPARE_X86 && cpu.sse42) return CompareIsa::Sse42;
+    return CompareIsa::Scalar;
+}
+
+std::atomic<int> activeIsa{ -1 };
+
+} // namespace
+
+CompareIsa ActiveCompareIsa() {
+    int v = activeIsa.load(std::memory_order_relaxed);
+    if (v < 0) {
+        v = static_cast<int>(DetectIsa());
+        activeIsa.store(v, std::memory_order_relaxed);
+    }
+    return static_cast<CompareIsa>(v);
+}
+
+CompareIsa ForceCompareIsa(CompareIsa isa) {
+    CompareIsa best = DetectIsa();
+    if (isa > best) isa = best;
+    activeIsa.store(static_cast<int>(isa), std::memory_order_relaxed);
+    return isa;
+}
+
+const char* CompareIsaName(CompareIsa isa) {
+    switch (isa) {
+        case CompareIsa::Avx2: return "avx2";
+        case CompareIsa::Sse42: return "sse4.2";
+        default: return "scalar";
+    }
+}
+
+bool ParseCompareOp(const std::string& name, CompareOp& out) {
+    static const struct { const char* name; CompareOp op; } table[] = {
+        { "any", CompareOp::Any },                 { "equal", CompareOp::Equal },
+        { "notEqual", CompareOp::NotEqual },       { "greater", CompareOp::Greater },
+        { "less", CompareOp::Less },               { "between", CompareOp::Between },
+        { "approx", CompareOp::Approx },           { "changed", CompareOp::Changed },
+        { "unchanged", CompareOp::Unchanged },     { "increased", CompareOp::Increased },
+        { "decreased", CompareOp::Decreased },     { "increasedBy", CompareOp::IncreasedBy },
+        { "decreasedBy", CompareOp::DecreasedBy },
+    };
+    for (const auto& e : table) {
+        if (name == e.name) { out = e.op; return true; }
+    }
+    return false;
+}
+
+size_t CompareBuffer(ValueType type, CompareOp op, const CompareArgs& args,
+                     const uint8_t* cur, const uint8_t* old, size_t n, size_t stride, uint64_t* mask) {
+    if (n == 0) return 0;
+    size_t words = (n + 63) / 64;
+    if (op == CompareOp::Any) {
+        std::fill(mask, mask + words, ~0ull);
+        if (n % 64) mask[words - 1] = (1ull << (n % 64)) - 1;
+        return n;
+    }
+    if (CompareNeedsOld(op) && !old) {
+        std::fill(mask, mask + words, 0);
+        return 0;
+    }
+    // Changed/Unchanged 按位比较，浮点使用同宽度的整数内核
+    if (op == CompareOp::Changed || op == CompareOp::Unchanged) {
+        if (type == ValueType::Float) type = ValueType::UInt32;
+        else if (type == ValueType::Double) type = ValueType::UInt64;
+    }
+    CompareIsa isa = ActiveCompareIsa();
+    return DispatchValueType(type, [&](auto tag) -> size_t {
+        using T = decltype(tag);
+        Params<T> p;
+        std::memcpy(&p.a, &args.a, sizeof(T));
+        std::memcpy(&p.b, &args.b, sizeof(T));
+        CompareOp kernelOp = op;
+        if (op == CompareOp::Approx) {
+            ApproxBounds<T>(p.a, p.b, p);
+            kernelOp = CompareOp::Between;
+        }
+        return CompareTyped<T>(kernelOp, p, cur, old, n, stride, mask, isa);
+    });
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include "value_type.h"
+
+// 扫描比较条件：前一组与常量比较，后一组与旧值（上一轮的快照）比较
+enum class CompareOp : uint8_t {
+    Any,            // 全部命中（未知初始值的首次扫描）
+    Equal,          // v == a
+    NotEqual,       // v != a
+    Greater,        // v > a
+    Less,           // v < a
+    Between,        // a <= v <= b
+    Approx,         // |v - a| <= b，浮点按容差比较，整数等价于 Between(a - b, a + b)
+    Changed,        // v != old（按位比较，浮点也不例外）
+    Unchanged,      // v == old
+    Increased,      // v > old
+    Decreased,      // v < old
+    IncreasedBy,    // v == old + a；浮点为 |v - old - a| <= b
+    DecreasedBy,    // v == old - a；浮点为 |v - old + a| <= b
+};
+
+constexpr bool CompareNeedsOld(CompareOp op) { return op >= CompareOp::Changed; }
+
+// 比较参数，按 ValueType 解释的原始字节（低位对齐，同 JsValueToTyped 的输出）
+struct CompareArgs {
+    uint64_t a = 0;
+    uint64_t b = 0;
+};
+
+enum class CompareIsa : uint8_t {
+    Scalar,
+    Sse42,
+    Avx2,
+};
+
+/**
+ * 扫描比较内核：对 n 个位置计算命中位图，第 i 个位置的值位于 cur + i * stride，
+ * 旧值（CompareNeedsOld 时）位于 old + i * stride。
+ * mask 需 (n + 63) / 64 个字，第 i 位对应第 i 个位置；返回命中数量。
+ *
+ * 内核按类型、条件和步长在编译期特化。步长等于类型大小时（按类型对齐的快速扫描，
+ * 以及连续存放的旧值/新值数组）使用 AVX2 / SSE4.2 向量比较，直接由比较结果生成位图；
+ * 其他步长（1/2/4/8 及任意值）使用无分支的标量内核。指令集在首次调用时按 CPU 选择。
+ */
+size_t CompareBuffer(ValueType type, CompareOp op, const CompareArgs& args,
+                     const uint8_t* cur, const uint8_t* old, size_t n, size_t stride, uint64_t* mask);
+
+// 当前使用的指令集；ForceCompareIsa 用于基准测试对比，超出 CPU 支持范围时降级
+CompareIsa ActiveCompareIsa();
+CompareIsa ForceCompareIsa(CompareIsa isa);
+const char* CompareIsaName(CompareIsa isa);
+
+// "equal" / "changed" ... -> CompareOp，未知名称返回 false
+bool ParseCompareOp(const std::string& name, CompareOp& out);
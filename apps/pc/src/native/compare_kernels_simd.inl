@@ -0,0 +1,56 @@
+// 与指令集无关的向量内核主体，由 compare_kernels.cpp 在各指令集的命名空间内分别包含。
+// 包含前需定义 SIMD_TARGET（函数的 target 属性），并在同一命名空间内提供 Traits<T>：
+//   V, kLanes, kFloat, Load, Set1, Eq, Gt, Lt, Ge, Le, Not, And, Add, Sub, Abs（仅浮点）,
+//   Mask2(c0, c1) -> 两个比较结果向量对应的 2 * kLanes 位
+
+template<class S, CompareOp Op>
+SIMD_TARGET inline typename S::V Eval(typename S::V v, typename S::V o, typename S::V a, typename S::V b) {
+    if constexpr (Op == CompareOp::Equal) return S::Eq(v, a);
+    else if constexpr (Op == CompareOp::NotEqual) return S::Not(S::Eq(v, a));
+    else if constexpr (Op == CompareOp::Greater) return S::Gt(v, a);
+    else if constexpr (Op == CompareOp::Less) return S::Lt(v, a);
+    else if constexpr (Op == CompareOp::Between) return S::And(S::Ge(v, a), S::Le(v, b));
+    else if constexpr (Op == CompareOp::Changed) return S::Not(S::Eq(v, o));
+    else if constexpr (Op == CompareOp::Unchanged) return S::Eq(v, o);
+    else if constexpr (Op == CompareOp::Increased) return S::Gt(v, o);
+    else if constexpr (Op == CompareOp::Decreased) return S::Lt(v, o);
+    else if constexpr (Op == CompareOp::IncreasedBy) {
+        if constexpr (S::kFloat) return S::Le(S::Abs(S::Sub(S::Sub(v, o), a)), b);
+        else return S::Eq(v, S::Add(o, a));
+    } else {
+        static_assert(Op == CompareOp::DecreasedBy, "unsupported compare op");
+        if constexpr (S::kFloat) return S::Le(S::Abs(S::Add(S::Sub(v, o), a)), b);
+        else return S::Eq(v, S::Sub(o, a));
+    }
+}
+
+// 处理 words 个完整的 64 位置组（值连续存放），返回命中数
+template<typename T, CompareOp Op>
+SIMD_TARGET size_t Run(const uint8_t* cur, const uint8_t* old, size_t words, const Params<T>& p, uint64_t* mask) {
+    using S = Traits<T>;
+    using V = typename S::V;
+    constexpr size_t kStep = 2 * S::kLanes;
+    constexpr size_t kVecBytes = S::kLanes * sizeof(T);
+    const V a = S::Set1(p.a);
+    const V b = S::Set1(p.b);
+    size_t hits = 0;
+    for (size_t w = 0; w < words; ++w) {
+        const uint8_t* c = cur + w * 64 * sizeof(T);
+        const uint8_t* o = CompareNeedsOld(Op) ? old + w * 64 * sizeof(T) : nullptr;
+        uint64_t m = 0;
+        for (size_t k = 0; k < 64; k += kStep) {
+            size_t off = k * sizeof(T);
+            V o0 = V(), o1 = V();
+            if constexpr (CompareNeedsOld(Op)) {
+                o0 = S::Load(o + off);
+                o1 = S::Load(o + off + kVecBytes);
+            }
+            V c0 = Eval<S, Op>(S::Load(c + off), o0, a, b);
+            V c1 = Eval<S, Op>(S::Load(c + off + kVecBytes), o1, a, b);
+            m |= S::Mask2(c0, c1) << k;
+        }
+        mask[w] = m;
+        hits += PopCount(m);
+    }
+    return hits;
+}
@@ -0,0 +1,44 @@
+#include "cpu_features.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CPU_X86 1
+#ifdef _MSC_VER
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+#endif
+
+namespace {
+
+CpuFeatures Detect() {
+    CpuFeatures f;
+#ifdef CPU_X86
+#ifdef _MSC_VER
+    int r[4];
+    __cpuid(r, 0);
+    int maxLeaf = r[0];
+    __cpuid(r, 1);
+    f.sse42 = (r[2] & (1 << 20)) != 0;
+    bool osxsave = (r[2] & (1 << 27)) != 0;
+    bool avx = (r[2] & (1 << 28)) != 0;
+    // CPUID 只说明 CPU 支持，还需确认操作系统保存了 XMM/YMM 状态
+    if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 6) == 6) {
+        __cpuidex(r, 7, 0);
+        f.avx2 = (r[1] & (1 << 5)) != 0;
+    }
+#else
+    // libgcc 的检测同样检查 OSXSAVE/XGETBV
+    __builtin_cpu_init();
+    f.sse42 = __builtin_cpu_supports("sse4.2");
+    f.avx2 = __builtin_cpu_supports("avx2");
+#endif
+#endif
+    return f;
+}
+
+} // namespace
+
+const CpuFeatures& GetCpuFeatures() {
+    static const CpuFeatures features = Detect();
+    return features;
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+// 当前 CPU 与操作系统都支持的指令集扩展；AVX/AVX2 还要求操作系统保存 YMM 寄存器状态
+struct CpuFeatures {
+    bool sse42 = false;
+    bool avx2 = false;
+};
+
+// 第一次调用时检测并缓存结果；非 x86 平台全部为 false
+const CpuFeatures& GetCpuFeatures();
@@ -0,0 +1,168 @@
+#include "gather.h"
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+#include "batch_read.h"
+
+namespace {
+
+size_t FieldSpan(const GatherField& f) {
+    return f.deref.empty() ? ValueTypeSize(f.type) : sizeof(uintptr_t);
+}
+
+bool StructSize(const GatherLayout& layout, size_t& size) {
+    size_t need = 0;
+    for (const GatherField& f : layout.fields) need = std::max(need, static_cast<size_t>(f.offset) + FieldSpan(f));
+    if (layout.mode == GatherMode::List) need = std::max(need, static_cast<size_t>(layout.nextOffset) + sizeof(uintptr_t));
+    size = layout.structSize ? layout.structSize : need;
+    return size >= need && size > 0;
+}
+
+uintptr_t LoadPointer(const uint8_t* p) {
+    uintptr_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// 沿 deref 逐层读取，每层所有元素一次 ReadBatch；最后一层把值直接读到列中
+void GatherDeref(IMemorySource& src, const GatherField& f, const std::vector<uint8_t>& structs, size_t structSize,
+                 const std::vector<uint8_t>& valid, uint8_t* column) {
+    thread_local std::vector<uintptr_t> ptrs;
+    thread_local std::vector<uint32_t> owners;
+    thread_local std::vector<ReadRequest> reqs;
+    thread_local std::vector<uint8_t> bits;
+    thread_local std::vector<uintptr_t> next;
+    size_t count = valid.size();
+    size_t valueSize = ValueTypeSize(f.type);
+
+    ptrs.clear();
+    owners.clear();
+    for (size_t i = 0; i < count; ++i) {
+        if (!valid[i]) continue;
+        uintptr_t p = LoadPointer(structs.data() + i * structSize + f.offset);
+        if (!p) continue;
+        ptrs.push_back(p);
+        owners.push_back(static_cast<uint32_t>(i));
+    }
+
+    for (size_t level = 0; level < f.deref.size() && !ptrs.empty(); ++level) {
+        bool last = level + 1 == f.deref.size();
+        reqs.clear();
+        for (size_t k = 0; k < ptrs.size(); ++k) {
+            uintptr_t addr = ptrs[k] + static_cast<uintptr_t>(f.deref[level]);
+            if (last) reqs.push_back({ addr, static_cast<uint32_t>(valueSize), owners[k] * valueSize });
+            else reqs.push_back({ addr, sizeof(uintptr_t), k * sizeof(uintptr_t) });
+        }
+        bits.assign((reqs.size() + 7) / 8, 0);
+        if (last) {
+            ReadBatch(src, reqs.data(), reqs.size(), column, bits.data());
+            // 合并读取的失败组会留下部分数据，统一清零
+            for (size_t k = 0; k < reqs.size(); ++k) {
+                if (!((bits[k / 8] >> (k % 8)) & 1)) std::memset(column + owners[k] * valueSize, 0, valueSize);
+            }
+            break;
+        }
+        next.assign(ptrs.size(), 0);
+        ReadBatch(src, reqs.data(), reqs.size(), reinterpret_cast<uint8_t*>(next.data()), bits.data());
+        size_t n = 0;
+        for (size_t k = 0; k < ptrs.size(); ++k) {
+            if (!((bits[k / 8] >> (k % 8)) & 1) || !next[k]) continue;
+            ptrs[n] = next[k];
+            owners[n] = owners[k];
+            ++n;
+        }
+        ptrs.resize(n);
+        owners.resize(n);
+    }
+}
+
+} // namespace
+
+bool Gather(IMemorySource& src, uintptr_t base, const GatherLayout& layout, GatherResult& out) {
+    size_t structSize;
+    if (!StructSize(layout, structSize) || layout.count > kGatherMaxCount || structSize > kBatchMaxSpan ||
+        layout.count * structSize > kGatherMaxBytes) {
+        return false;
+    }
+    out.count = 0;
+    out.addresses.clear();
+    out.valid.clear();
+    out.columns.assign(layout.fields.size(), {});
+    if (!base || layout.count == 0) return true;
+
+    thread_local std::vector<uint8_t> structs;
+    thread_local std::vector<ReadRequest> reqs;
+    thread_local std::vector<uint8_t> bits;
+    size_t count = layout.count;
+
+    if (layout.mode == GatherMode::List) {
+        // 链表只能逐节点读取；遇到空指针或回到已访问的节点时结束
+        thread_local std::unordered_set<uintptr_t> visited;
+        visited.clear();
+        structs.resize(count * structSize);
+        uintptr_t node = base;
+        size_t n = 0;
+        while (n < count && node && visited.insert(node).second) {
+            uint8_t* dst = structs.data() + n * structSize;
+            if (!src.ReadMemory(node, dst, structSize)) break;
+            out.addresses.push_back(node);
+            ++n;
+            node = LoadPointer(dst + layout.nextOffset);
+        }
+        count = n;
+        structs.resize(count * structSize);
+        out.valid.assign(count, 1);
+    } else {
+        if (layout.mode == GatherMode::Array) {
+            size_t stride = layout.stride ? layout.stride : structSize;
+            out.addresses.resize(count);
+            for (size_t i = 0; i < count; ++i) out.addresses[i] = base + i * stride;
+        } else {
+            // 先读取指针数组本身
+            size_t stride = layout.stride ? layout.stride : sizeof(uintptr_t);
+            if (stride < sizeof(uintptr_t)) return false;
+            std::vector<uintptr_t> ptrs(count, 0);
+            reqs.resize(count);
+            for (size_t i = 0; i < count; ++i) {
+                reqs[i] = { base + i * stride, sizeof(uintptr_t), i * sizeof(uintptr_t) };
+            }
+            bits.assign((count + 7) / 8, 0);
+            ReadBatch(src, reqs.data(), count, reinterpret_cast<uint8_t*>(ptrs.data()), bits.data());
+            out.addresses.resize(count);
+            for (size_t i = 0; i < count; ++i) out.addresses[i] = (bits[i / 8] >> (i % 8)) & 1 ? ptrs[i] : 0;
+        }
+
+        // 所有结构体一次批量读取，连续存放的会合并成少数几段
+        structs.assign(count * structSize, 0);
+        reqs.clear();
+        thread_local std::vector<uint32_t> slots;
+        slots.clear();
+        for (size_t i = 0; i < count; ++i) {
+            if (!out.addresses[i]) continue;
+            slots.push_back(static_cast<uint32_t>(i));
+            reqs.push_back({ out.addresses[i], static_cast<uint32_t>(structSize), i * structSize });
+        }
+        bits.assign((reqs.size() + 7) / 8, 0);
+        ReadBatch(src, reqs.data(), reqs.size(), structs.data(), bits.data());
+        out.valid.assign(count, 0);
+        for (size_t k = 0; k < slots.size(); ++k) {
+            if ((bits[k / 8] >> (k % 8)) & 1) out.valid[slots[k]] = 1;
+        }
+    }
+    out.count = count;
+
+    for (size_t j = 0; j < layout.fields.size(); ++j) {
+        const GatherField& f = layout.fields[j];
+        size_t size = ValueTypeSize(f.type);
+        std::vector<uint8_t>& col = out.columns[j];
+        col.assign(count * size, 0);
+        if (!f.deref.empty()) {
+            GatherDeref(src, f, structs, structSize, out.valid, col.data());
+            continue;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            if (out.valid[i]) std::memcpy(col.data() + i * size, structs.data() + i * structSize + f.offset, size);
+        }
+    }
+    return true;
+}
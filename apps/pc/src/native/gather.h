@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "memory_source.h"
+#include "value_type.h"
+
+// 结构体中的一个字段；deref 非空时 offset 处为指针，沿 deref 逐级读取（同指针路径，最后一级只加偏移）
+struct GatherField {
+    std::string name;
+    uint32_t offset = 0;
+    ValueType type = ValueType::Int32;
+    std::vector<uint64_t> deref;
+};
+
+enum class GatherMode : uint8_t {
+    Array,          // 结构体连续存放：base + i * stride
+    PointerArray,   // 指针数组：*(base + i * stride) 为第 i 个结构体
+    List,           // 链表：base 为首个结构体，下一个为 *(node + nextOffset)
+};
+
+struct GatherLayout {
+    GatherMode mode = GatherMode::Array;
+    uint32_t count = 0;         // 元素数；链表为最多遍历的节点数
+    uint32_t stride = 0;        // 0 时 Array 取 structSize，PointerArray 取指针大小
+    uint32_t nextOffset = 0;
+    uint32_t structSize = 0;    // 0 时取各字段（及链表的 next 指针）覆盖的范围
+    std::vector<GatherField> fields;
+};
+
+// 列式结果：columns[j] 为第 j 个字段的 count 个值，按字段类型紧密排列；读取失败的值为 0
+struct GatherResult {
+    size_t count = 0;
+    std::vector<uintptr_t> addresses;               // 各结构体的地址
+    std::vector<uint8_t> valid;                     // 结构体本身是否读取成功
+    std::vector<std::vector<uint8_t>> columns;
+};
+
+// 单次遍历的元素数与结构体总字节数上限
+constexpr uint32_t kGatherMaxCount = 1 << 20;
+constexpr size_t kGatherMaxBytes = 256 << 20;
+
+/**
+ * 按布局遍历目标内存中的结构体数组或链表：每个结构体整块读取一次，字段在本地解码为列。
+ * 数组的所有结构体合并为一次 ReadBatch（连续存放时只需少数几次读取）；链表逐节点读取。
+ * 需要解引用的字段按层批量读取，所有元素的同一层合并为一次 ReadBatch。
+ * 布局不合法（字段越界、链表 next 不在结构体内、数量超限）时返回 false。
+ */
+bool Gather(IMemorySource& src, uintptr_t base, const GatherLayout& layout, GatherResult& out);
@@ -1,4 +1,8 @@
 #include "helper.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
 
 // helper to convert JS BigInt/Number -> uintptr_t
 bool JsValueToAddress(const Napi::Value& v, uintptr_t &out) {
@@ -16,11 +20,56 @@ bool JsValueToAddress(const Napi::Value& v, uintptr_t &out) {
     }
 }
 
-// helper: JS string (utf-8) -> wstring
-std::wstring Utf8ToWstring(const std::string& s) {
-    if (s.empty()) return std::wstring();
-    int len = MultiByteToWideChar(CP_UTF8, 0, s.c_str(), (int)s.size(), NULL, 0);
-    std::wstring r(len, L'\0');
-    MultiByteToWideChar(CP_UTF8, 0, s.c_str(), (int)s.size(), &r[0], len);
-    return r;
+// helper: JS Number/BigInt -> 按 type 编码的原始字节
+// 整数类型的 Number 向零取整；NaN、±Inf、超出类型范围的值以及无法无损表示的 BigInt 返回 false
+bool JsValueToTyped(const Napi::Value& v, ValueType type, uint64_t &out) {
+    if (!v.IsNumber() && !v.IsBigInt()) return false;
+    out = 0;
+    return DispatchValueType(type, [&](auto tag) {
+        using T = decltype(tag);
+        using Limits = std::numeric_limits<T>;
+        T val;
+        if (v.IsBigInt()) {
+            bool lossless = false;
+            if constexpr (std::is_signed<T>::value) {
+                int64_t i = v.As<Napi::BigInt>().Int64Value(&lossless);
+                if (!lossless) return false;
+                if constexpr (Limits::is_integer) {
+                    if (i < static_cast<int64_t>(Limits::min()) || i > static_cast<int64_t>(Limits::max())) return false;
+                }
+                val = static_cast<T>(i);
+            } else {
+                uint64_t u = v.As<Napi::BigInt>().Uint64Value(&lossless);
+                if (!lossless || u > static_cast<uint64_t>(Limits::max())) return false;
+                val = static_cast<T>(u);
+            }
+        } else {
+            double d = v.As<Napi::Number>().DoubleValue();
+            if (Limits::is_integer) {
+                if (!std::isfinite(d)) return false;
+                d = std::trunc(d);
+                // [min, 2^digits) 的端点都能精确表示为 double
+                double hi = std::ldexp(1.0, Limits::digits);
+                double lo = std::is_signed<T>::value ? -hi : 0.0;
+                if (d < lo || d >= hi) return false;
+            } else if (std::isfinite(d) && std::fabs(d) > static_cast<double>(Limits::max())) {
+                return false;
+            }
+            val = static_cast<T>(d);
+        }
+        std::memcpy(&out, &val, sizeof(T));
+        return true;
+    });
+}
+
+// helper: 原始字节 -> JS 值
+Napi::Value TypedToJsValue(Napi::Env env, ValueType type, const void* data) {
+    return DispatchValueType(type, [&](auto tag) -> Napi::Value {
+        using T = decltype(tag);
+        T val;
+        std::memcpy(&val, data, sizeof(T));
+        if (std::is_same<T, int64_t>::value) return Napi::BigInt::New(env, static_cast<int64_t>(val));
+        if (std::is_same<T, uint64_t>::value) return Napi::BigInt::New(env, static_cast<uint64_t>(val));
+        return Napi::Number::New(env, static_cast<double>(val));
+    });
 }
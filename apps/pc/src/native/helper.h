@@ -1,10 +1,14 @@
 #pragma once
 #include <napi.h>
 #include <string>
-#include <windows.h>
+#include "value_type.h"
+#include "utf8.h"
 
 // helper to convert JS BigInt/Number -> uintptr_t
 bool JsValueToAddress(const Napi::Value& v, uintptr_t &out);
 
-// helper: JS string (utf-8) -> wstring
-std::wstring Utf8ToWstring(const std::string& s);
+// helper: JS Number/BigInt -> 按 type 编码的原始字节（低位在前写入 out）；非有限值、越界或有损的输入返回 false
+bool JsValueToTyped(const Napi::Value& v, ValueType type, uint64_t &out);
+
+// helper: 原始字节 -> JS 值；64 位整数返回 BigInt，其余返回 Number
+Napi::Value TypedToJsValue(Napi::Env env, ValueType type, const void* data);
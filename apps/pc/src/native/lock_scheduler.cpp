@@ -0,0 +1,316 @@
+#include "lock_scheduler.h"
+#include <algorithm>
+#include <cstring>
+#include "memory.h"
+#include "batch_read.h"
+#include "stats.h"
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace {
+constexpr uint32_t kDefaultPeriodMs = 200;
+// 等待时间短于该值时使用高精度定时器，否则使用条件变量（可被新任务唤醒）
+constexpr auto kPreciseWaitThreshold = std::chrono::milliseconds(20);
+}
+
+// ---------------- TimerWheel ----------------
+
+LockScheduler::TimerWheel::TimerWheel() : current(0), count(0) {}
+
+void LockScheduler::TimerWheel::Insert(const TaskPtr& t) {
+    uint64_t due = std::max(t->dueTick, current);
+    uint64_t delta = due - current;
+    if (delta < 256) level0[due & 255].push_back(t);
+    else if (delta < (1ull << 14)) level1[(due >> 8) & 63].push_back(t);
+    else if (delta < (1ull << 20)) level2[(due >> 14) & 63].push_back(t);
+    else overflow.push_back(t);
+    ++count;
+}
+
+void LockScheduler::TimerWheel::Cascade(std::vector<TaskPtr>& slot) {
+    std::vector<TaskPtr> moved;
+    moved.swap(slot);
+    count -= moved.size();
+    for (auto &t : moved) Insert(t);
+}
+
+void LockScheduler::TimerWheel::Advance(uint64_t tick, std::vector<TaskPtr>& due) {
+    while (current <= tick) {
+        if ((current & 255) == 0) {
+            if ((current & ((1ull << 20) - 1)) == 0) Cascade(overflow);
+            if ((current & ((1ull << 14) - 1)) == 0) Cascade(level2[(current >> 14) & 63]);
+            Cascade(level1[(current >> 8) & 63]);
+        }
+        auto &slot = level0[current & 255];
+        count -= slot.size();
+        for (auto &t : slot) due.push_back(std::move(t));
+        slot.clear();
+        ++current;
+    }
+}
+
+uint64_t LockScheduler::TimerWheel::NextTick() const {
+    if (count == 0) return UINT64_MAX;
+    for (uint64_t t = current; t < current + 256; ++t) {
+        if (t != current && (t & 255) == 0) return t; // 级联点，需要唤醒搬移上层任务
+        if (!level0[t & 255].empty()) return t;
+    }
+    return (current | 255) + 1;
+}
+
+void LockScheduler::TimerWheel::Clear() {
+    for (auto &s : level0) s.clear();
+    for (auto &s : level1) s.clear();
+    for (auto &s : level2) s.clear();
+    overflow.clear();
+    count = 0;
+}
+
+// ---------------- LockScheduler ----------------
+
+LockScheduler::LockScheduler(IMemory& mem)
+    : mem(mem), clearRequested(false), stopping(false), nextId(1), timer(nullptr) {}
+
+LockScheduler::~LockScheduler() {
+    {
+        std::lock_guard<std::mutex> g(m);
+        stopping = true;
+    }
+    cv.notify_all();
+    if (worker.joinable()) worker.join();
+#ifdef _WIN32
+    if (timer) CloseHandle(static_cast<HANDLE>(timer));
+#endif
+}
+
+void LockScheduler::EnsureThread() {
+    // 调用方持有 m；线程在第一次加锁时才启动，避免在模块加载期间创建线程
+    if (worker.joinable()) return;
+    epoch = Clock::now();
+#ifdef _WIN32
+    timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+#endif
+    worker = std::thread([this]() { Run(); });
+}
+
+int LockScheduler::Add(uintptr_t address, const std::vector<uint8_t>& data, int frequencyMs, bool compareFirst) {
+    if (data.empty()) return -1;
+    auto t = std::make_shared<Task>();
+    t->address = address;
+    t->data = data;
+    t->periodMs = frequencyMs > 0 ? static_cast<uint32_t>(frequencyMs) : kDefaultPeriodMs;
+    t->compareFirst = compareFirst;
+    t->active = true;
+    t->dueTick = 0;
+    t->addedAt = Clock::now();
+    t->writes = 0;
+    t->skipped = 0;
+    t->failures = 0;
+    t->jitterSumUs = 0;
+    t->jitterMaxUs = 0;
+    t->runs = 0;
+    {
+        std::lock_guard<std::mutex> g(m);
+        t->id = nextId++;
+        tasks[t->id] = t;
+        incoming.push_back(t);
+        EnsureThread();
+    }
+    cv.notify_all();
+    return t->id;
+}
+
+bool LockScheduler::Remove(int lockId) {
+    std::lock_guard<std::mutex> g(m);
+    auto it = tasks.find(lockId);
+    if (it == tasks.end()) return false;
+    // 只做标记，调度线程下次取到该任务时丢弃
+    it->second->active = false;
+    tasks.erase(it);
+    return true;
+}
+
+void LockScheduler::Clear() {
+    {
+        std::lock_guard<std::mutex> g(m);
+        for (auto &kv : tasks) kv.second->active = false;
+        tasks.clear();
+        incoming.clear();
+        clearRequested = true;
+    }
+    cv.notify_all();
+    // 等待正在执行的 tick：调度线程在 tickMutex 内重新检查 active，之后取到的任务都已失效
+    std::lock_guard<std::mutex> g(tickMutex);
+}
+
+bool LockScheduler::GetStats(int lockId, LockStats& out) {
+    TaskPtr t;
+    {
+        std::lock_guard<std::mutex> g(m);
+        auto it = tasks.find(lockId);
+        if (it == tasks.end()) return false;
+        t = it->second;
+    }
+    uint64_t runs = t->runs.load();
+    double secs = std::chrono::duration<double>(Clock::now() - t->addedAt).count();
+    out.writes = t->writes.load();
+    out.skipped = t->skipped.load();
+    out.failures = t->failures.load();
+    out.avgJitterUs = runs ? static_cast<double>(t->jitterSumUs.load()) / runs : 0.0;
+    out.maxJitterUs = static_cast<double>(t->jitterMaxUs.load());
+    out.writesPerSec = secs > 0 ? runs / secs : 0.0;
+    return true;
+}
+
+size_t LockScheduler::ActiveCount() {
+    std::lock_guard<std::mutex> g(m);
+    return tasks.size();
+}
+
+size_t LockScheduler::ThreadCount() {
+    std::lock_guard<std::mutex> g(m);
+    return worker.joinable() ? 1 : 0;
+}
+
+uint64_t LockScheduler::TickOf(Clock::time_point t) const {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(t - epoch).count());
+}
+
+void LockScheduler::SleepUntil(Clock::time_point t) {
+#ifdef _WIN32
+    if (timer) {
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(t - Clock::now()).count();
+        if (us <= 0) return;
+        LARGE_INTEGER due;
+        due.QuadPart = -static_cast<LONGLONG>(us) * 10; // 相对时间，100ns 单位
+        if (SetWaitableTimer(static_cast<HANDLE>(timer), &due, 0, nullptr, nullptr, FALSE)) {
+            WaitForSingleObject(static_cast<HANDLE>(timer), INFINITE);
+            return;
+        }
+    }
+#endif
+    std::this_thread::sleep_until(t);
+}
+
+void LockScheduler::Run() {
+    std::vector<TaskPtr> fresh;
+    std::vector<TaskPtr> due;
+    while (true) {
+        {
+            std::lock_guard<std::mutex> g(m);
+            if (stopping) return;
+            if (clearRequested) {
+                wheel.Clear();
+                clearRequested = false;
+            }
+            fresh.swap(incoming);
+        }
+
+        Clock::time_point now = Clock::now();
+        uint64_t nowTick = TickOf(now);
+        for (auto &t : fresh) {
+            t->dueTick = nowTick;   // 新加入的锁立即写入一次
+            wheel.Insert(t);
+        }
+        fresh.clear();
+
+        due.clear();
+        wheel.Advance(nowTick, due);
+        if (!due.empty()) {
+            std::lock_guard<std::mutex> tg(tickMutex);
+            due.erase(std::remove_if(due.begin(), due.end(),
+                [](const TaskPtr& t) { return !t->active.load(); }), due.end());
+            if (!due.empty()) Execute(due, now);
+            for (auto &t : due) {
+                // 按计划时间推进，保持相位不漂移；落后超过一个周期时重新对齐
+                t->dueTick += t->periodMs;
+                if (t->dueTick <= nowTick) t->dueTick = nowTick + t->periodMs;
+                wheel.Insert(t);
+            }
+        }
+
+        uint64_t next = wheel.NextTick();
+        Clock::time_point wake = epoch + std::chrono::milliseconds(next == UINT64_MAX ? 0 : next);
+        auto woken = [this]() { return stopping.load() || clearRequested || !incoming.empty(); };
+        if (next == UINT64_MAX) {
+            std::unique_lock<std::mutex> lk(m);
+            cv.wait(lk, woken);
+        } else if (wake - Clock::now() <= kPreciseWaitThreshold) {
+            SleepUntil(wake);
+        } else {
+            std::unique_lock<std::mutex> lk(m);
+            cv.wait_until(lk, wake - kPreciseWaitThreshold / 2, woken);
+        }
+    }
+}
+
+void LockScheduler::Execute(std::vector<TaskPtr>& due, Clock::time_point now) {
+    STAT_TIMER(tick);
+    // 记录抖动：实际执行时间 - 计划时间
+    for (auto &t : due) {
+        auto planned = epoch + std::chrono::milliseconds(t->dueTick);
+        uint64_t jitter = now > planned
+            ? static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - planned).count())
+            : 0;
+        t->jitterSumUs += jitter;
+        if (jitter > t->jitterMaxUs.load()) t->jitterMaxUs = jitter;
+        ++t->runs;
+    }
+
+    // 需要比较的锁先批量读取当前值，值未变化的跳过
+    std::vector<Task*> pending;
+    std::vector<ReadRequest> reqs;
+    std::vector<Task*> compared;
+    size_t total = 0;
+    for (auto &t : due) {
+        if (!t->compareFirst) { pending.push_back(t.get()); continue; }
+        reqs.push_back({ t->address, static_cast<uint32_t>(t->data.size()), total });
+        total += t->data.size();
+        compared.push_back(t.get());
+    }
+    if (!compared.empty()) {
+        std::vector<uint8_t> current(total);
+        std::vector<uint8_t> bits((compared.size() + 7) / 8);
+        // 比较必须读取实时值，不经过页缓存
+        ReadBatch(mem.Uncached(), reqs.data(), reqs.size(), current.data(), bits.data());
+        for (size_t k = 0; k < compared.size(); ++k) {
+            Task* t = compared[k];
+            bool read = (bits[k >> 3] >> (k & 7)) & 1;
+            if (read && std::memcmp(current.data() + reqs[k].outOffset, t->data.data(), t->data.size()) == 0) {
+                ++t->skipped;
+            } else {
+                pending.push_back(t);
+            }
+        }
+    }
+    if (pending.empty()) {
+        STAT_RECORD(StatLockTick, tick, 0, true);
+        STAT_ADD(StatLockSkipped, due.size());
+        return;
+    }
+
+    // 整批作为一个写入事务提交：合并相邻写入，每个页段只修改一次保护属性
+    WriteTransaction txn;
+    for (Task* t : pending) txn.Add(t->address, t->data.data(), t->data.size());
+    std::vector<uint8_t> bits;
+    mem.CommitWrites(txn, bits);
+    for (size_t k = 0; k < pending.size(); ++k) {
+        if ((bits[k >> 3] >> (k & 7)) & 1) ++pending[k]->writes;
+        else ++pending[k]->failures;
+    }
+#if TRAINER_STATS
+    size_t written = 0;
+    uint64_t bytes = 0;
+    for (size_t k = 0; k < pending.size(); ++k) {
+        if ((bits[k >> 3] >> (k & 7)) & 1) {
+            ++written;
+            bytes += pending[k]->data.size();
+        }
+    }
+    STAT_RECORD(StatLockTick, tick, bytes, written == pending.size());
+    STAT_ADD(StatLockWrites, written);
+    STAT_ADD(StatLockSkipped, due.size() - pending.size());
+    STAT_ADD(StatLockFailures, pending.size() - written);
+#endif
+}
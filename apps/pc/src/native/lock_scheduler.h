@@ -0,0 +1,107 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class IMemory;
+
+struct LockStats {
+    uint64_t writes;        // 实际写入次数
+    uint64_t skipped;       // 先读比较后值未变而跳过的次数
+    uint64_t failures;
+    double avgJitterUs;     // 实际执行时间相对计划时间的平均延迟
+    double maxJitterUs;
+    double writesPerSec;    // 自加入以来的实际执行频率
+};
+
+/**
+ * 锁定调度器：单个调度线程 + 分层时间轮（1ms 精度）。
+ * 每个 tick 把所有到期的锁放在一起处理：需要比较的先批量读取，
+ * 然后作为一个写入事务提交（IMemory::CommitWrites）。
+ * Add/Remove 只在互斥锁内做 O(1) 操作，不会等待调度线程；
+ * Clear 会等待正在执行的 tick 结束，返回后不会再写入任何已清除的锁（关闭进程句柄前调用）。
+ */
+class LockScheduler {
+public:
+    explicit LockScheduler(IMemory& mem);
+    ~LockScheduler();
+
+    // 返回 lockId (>0)
+    int Add(uintptr_t address, const std::vector<uint8_t>& data, int frequencyMs, bool compareFirst);
+    bool Remove(int lockId);
+    void Clear();
+
+    bool GetStats(int lockId, LockStats& out);
+    size_t ActiveCount();
+    size_t ThreadCount();       // 调度线程数（尚未加过锁时为 0）
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Task {
+        int id;
+        uintptr_t address;
+        std::vector<uint8_t> data;
+        uint32_t periodMs;
+        bool compareFirst;
+        std::atomic<bool> active;
+        uint64_t dueTick;
+        Clock::time_point addedAt;
+        std::atomic<uint64_t> writes;
+        std::atomic<uint64_t> skipped;
+        std::atomic<uint64_t> failures;
+        std::atomic<uint64_t> jitterSumUs;
+        std::atomic<uint64_t> jitterMaxUs;
+        std::atomic<uint64_t> runs;
+    };
+    using TaskPtr = std::shared_ptr<Task>;
+
+    // 三级时间轮：256 x 1ms，64 x 256ms，64 x 16384ms，更远的放在 overflow
+    class TimerWheel {
+    public:
+        TimerWheel();
+        void Insert(const TaskPtr& t);
+        void Advance(uint64_t tick, std::vector<TaskPtr>& due);
+        uint64_t NextTick() const;      // 下一个可能有任务到期的 tick，空时返回 UINT64_MAX
+        void Clear();
+        uint64_t Current() const { return current; }
+
+    private:
+        void Cascade(std::vector<TaskPtr>& slot);
+
+        std::vector<TaskPtr> level0[256];
+        std::vector<TaskPtr> level1[64];
+        std::vector<TaskPtr> level2[64];
+        std::vector<TaskPtr> overflow;
+        uint64_t current;
+        size_t count;
+    };
+
+    void EnsureThread();
+    void Run();
+    void Execute(std::vector<TaskPtr>& due, Clock::time_point now);
+    uint64_t TickOf(Clock::time_point t) const;
+    void SleepUntil(Clock::time_point t);
+
+    IMemory& mem;
+    std::mutex m;
+    std::mutex tickMutex;   // 调度线程执行一个 tick 期间持有
+    std::condition_variable cv;
+    std::unordered_map<int, TaskPtr> tasks;
+    std::vector<TaskPtr> incoming;
+    bool clearRequested;
+    std::atomic<bool> stopping;
+    std::thread worker;
+    int nextId;
+
+    // 以下仅由调度线程访问
+    TimerWheel wheel;
+    Clock::time_point epoch;
+    void* timer;            // Windows 高精度可等待定时器
+};
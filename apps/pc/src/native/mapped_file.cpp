@@ -0,0 +1,164 @@
+#include "mapped_file.h"
+#include <cstring>
+#include "utf8.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+std::FILE* OpenFileUtf8(const std::string& path, const char* mode) {
+    std::wstring wmode(mode, mode + std::strlen(mode));
+    return _wfopen(Utf8ToWstring(path).c_str(), wmode.c_str());
+}
+
+MappedFile::MappedFile() : data(nullptr), size(0), readOnly(false), hFile(nullptr), hMapping(nullptr) {}
+
+bool MappedFile::OpenRead(const std::string& path) {
+    Close();
+    HANDLE h = CreateFileW(Utf8ToWstring(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (h == INVALID_HANDLE_VALUE) return false;
+    hFile = h;
+    LARGE_INTEGER sz;
+    if (!GetFileSizeEx(h, &sz) || sz.QuadPart == 0) { Close(); return false; }
+    HANDLE m = CreateFileMappingW(h, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m) { Close(); return false; }
+    void* view = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+    if (!view) { CloseHandle(m); Close(); return false; }
+    hMapping = m;
+    data = static_cast<uint8_t*>(view);
+    size = static_cast<size_t>(sz.QuadPart);
+    readOnly = true;
+    return true;
+}
+
+bool MappedFile::CreateTemp(size_t newSize) {
+    Close();
+    wchar_t dir[MAX_PATH];
+    wchar_t path[MAX_PATH];
+    if (!GetTempPathW(MAX_PATH, dir)) return false;
+    if (!GetTempFileNameW(dir, L"xmd", 0, path)) return false;
+    HANDLE h = CreateFileW(path, GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                           FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+    if (h == INVALID_HANDLE_VALUE) return false;
+    hFile = h;
+    if (!Map(newSize)) { Close(); return false; }
+    return true;
+}
+
+bool MappedFile::Map(size_t newSize) {
+    // 映射大小超过文件大小时系统会自动扩展文件
+    ULONGLONG sz = static_cast<ULONGLONG>(newSize);
+    HANDLE m = CreateFileMappingW(static_cast<HANDLE>(hFile), nullptr, PAGE_READWRITE,
+                                  static_cast<DWORD>(sz >> 32), static_cast<DWORD>(sz & 0xFFFFFFFF), nullptr);
+    if (!m) return false;
+    void* view = MapViewOfFile(m, FILE_MAP_ALL_ACCESS, 0, 0, newSize);
+    if (!view) { CloseHandle(m); return false; }
+    hMapping = m;
+    data = static_cast<uint8_t*>(view);
+    size = newSize;
+    return true;
+}
+
+void MappedFile::Unmap() {
+    if (data) UnmapViewOfFile(data);
+    if (hMapping) CloseHandle(static_cast<HANDLE>(hMapping));
+    data = nullptr;
+    hMapping = nullptr;
+    size = 0;
+}
+
+void MappedFile::Close() {
+    Unmap();
+    if (hFile) CloseHandle(static_cast<HANDLE>(hFile));
+    hFile = nullptr;
+    readOnly = false;
+}
+
+#else
+
+std::FILE* OpenFileUtf8(const std::string& path, const char* mode) {
+    return std::fopen(path.c_str(), mode);
+}
+
+MappedFile::MappedFile() : data(nullptr), size(0), readOnly(false), fd(-1) {}
+
+bool MappedFile::OpenRead(const std::string& path) {
+    Close();
+    fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) { Close(); return false; }
+    void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED) { Close(); return false; }
+    data = static_cast<uint8_t*>(view);
+    size = static_cast<size_t>(st.st_size);
+    readOnly = true;
+    return true;
+}
+
+bool MappedFile::CreateTemp(size_t newSize) {
+    Close();
+    const char* dir = getenv("TMPDIR");
+    std::string path = std::string(dir && *dir ? dir : "/tmp") + "/xmdXXXXXX";
+    fd = mkstemp(&path[0]);
+    if (fd < 0) return false;
+    unlink(path.c_str()); // 最后一个描述符关闭后文件自动删除
+    if (!Map(newSize)) { Close(); return false; }
+    return true;
+}
+
+bool MappedFile::Map(size_t newSize) {
+    if (ftruncate(fd, static_cast<off_t>(newSize)) != 0) return false;
+    void* view = mmap(nullptr, newSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED) return false;
+    data = static_cast<uint8_t*>(view);
+    size = newSize;
+    return true;
+}
+
+void MappedFile::Unmap() {
+    if (data) munmap(data, size);
+    data = nullptr;
+    size = 0;
+}
+
+void MappedFile::Close() {
+    Unmap();
+    if (fd >= 0) close(fd);
+    fd = -1;
+    readOnly = false;
+}
+
+#endif
+
+MappedFile::~MappedFile() { Close(); }
+
+bool MappedFile::Resize(size_t newSize) {
+    if (!IsOpen() || readOnly) return false;
+    if (newSize == size) return true;
+    // 先建立新映射再释放旧映射：失败时原映射和其中的数据保持可用
+    uint8_t* oldData = data;
+#ifdef _WIN32
+    void* oldMapping = hMapping;
+    if (!Map(newSize)) return false;
+    UnmapViewOfFile(oldData);
+    CloseHandle(static_cast<HANDLE>(oldMapping));
+#else
+    size_t oldSize = size;
+    if (!Map(newSize)) {
+        // Map 可能已经修改了文件大小，恢复原大小；截断后无法恢复时旧映射超出文件末尾的页不可访问，只能关闭
+        if (ftruncate(fd, static_cast<off_t>(oldSize)) != 0 && newSize < oldSize) Close();
+        return false;
+    }
+    munmap(oldData, oldSize);
+#endif
+    return true;
+}
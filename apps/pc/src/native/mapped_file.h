@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+// 以 UTF-8 路径打开文件（Windows 下转换为宽字符路径），mode 同 fopen
+std::FILE* OpenFileUtf8(const std::string& path, const char* mode);
+
+/**
+ * 内存映射文件，Windows 使用 CreateFileMapping，其他平台使用 mmap。
+ * 临时文件可读写，关闭后自动删除；OpenRead 以只读方式映射已有文件。
+ */
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // 在系统临时目录创建并映射 size 字节
+    bool CreateTemp(size_t size);
+
+    // 只读映射已有文件（UTF-8 路径），不能 Resize，也不能写入 Data()
+    bool OpenRead(const std::string& path);
+
+    // 调整文件大小并重新映射；原有数据保留，成功后 Data() 指针会失效，失败时原映射不变
+    bool Resize(size_t size);
+
+    void Close();
+
+    uint8_t* Data() const { return data; }
+    size_t Size() const { return size; }
+    bool IsOpen() const { return data != nullptr; }
+
+private:
+    bool Map(size_t newSize);
+    void Unmap();
+
+    uint8_t* data;
+    size_t size;
+    bool readOnly;
+#ifdef _WIN32
+    void* hFile;
+    void* hMapping;
+#else
+    int fd;
+#endif
+};
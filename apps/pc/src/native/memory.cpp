@@ -1,66 +1,94 @@
 ﻿#include "memory.h"
-#include <TlHelp32.h>
+#include "stats.h"
 #include <iostream>
+#include <algorithm>
+#include <cstring>
 
-IMemory::IMemory() : hProcess(nullptr), processId(0), nextLockId(1) {}
+// 两次模块变化检查之间的最小间隔
+static const auto kModuleCheckInterval = std::chrono::milliseconds(250);
+
+IMemory::IMemory()
+    : backend(CreateProcessBackend()), processId(0), moduleFingerprint(0), direct(*this), lockScheduler(new LockScheduler(*this)) {}
 IMemory::~IMemory() { CloseProcess(); }
 
 uint32_t IMemory::OpenProcessByPid(uint32_t pid, uint32_t access) {
     CloseProcess();
-    HANDLE h = nullptr;
-    uint32_t result = ::OpenProcessByPid(pid, h, access);
-    if (result != 0) {
-        hProcess = h;
-        processId = pid;
-        return processId;
-    }
-    return 0;
+    if (pid == 0 || !backend->Open(pid, access)) return 0;
+    processId = pid;
+    RefreshRegions();
+    RefreshModules(true);
+    return processId;
 }
 
 uint32_t IMemory::OpenProcessByName(const std::wstring& exeName, uint32_t access) {
     CloseProcess();
-    HANDLE h = nullptr;
-    uint32_t pid = ::OpenProcessByName(exeName, h, access);
-    if (pid != 0) {
-        hProcess = h;
-        processId = pid;
-        return processId;
-    }
-    return 0;
+    uint32_t pid = FindPidByName(exeName);
+    if (pid == 0) return 0;
+    return OpenProcessByPid(pid, access);
 }
 
 void IMemory::CloseProcess() {
-    std::lock_guard<std::mutex> g(lockMutex);
-    // 停止所有锁线程
-    for (auto &kv : locks) {
-        kv.second->active = false;
-        if (kv.second->th.joinable()) kv.second->th.join();
-    }
-    locks.clear();
+    // 取消所有锁定并等待正在执行的 tick 结束，之后调度线程不会再写入旧进程或新附加的进程
+    lockScheduler->Clear();
 
-    if (hProcess) {
-        CloseHandle(hProcess);
-        hProcess = nullptr;
-        processId = 0;
-    }
+    backend->Close();
+    processId = 0;
+    modules.Clear();
+    moduleFingerprint = 0;
+    regionCache.Clear();
+    pageCache.Clear();
 }
 
 uintptr_t IMemory::GetModuleBaseAddress(const std::wstring& moduleName) {
     if (!processId) return 0;
-    HANDLE snap = CreateToolhelp32Snapshot(TH32CS_SNAPMODULE | TH32CS_SNAPMODULE32, processId);
-    if (snap == INVALID_HANDLE_VALUE) return 0;
-    MODULEENTRY32W me; me.dwSize = sizeof(me);
-    uintptr_t base = 0;
-    if (Module32FirstW(snap, &me)) {
-        do {
-            if (moduleName == me.szModule) {
-                base = reinterpret_cast<uintptr_t>(me.modBaseAddr);
-                break;
-            }
-        } while (Module32NextW(snap, &me));
+    auto table = GetModules();
+    const ModuleInfo* mod = table ? table->Find(moduleName) : nullptr;
+    if (!mod && RefreshModules()) {
+        // 未找到时可能是刚加载的模块，检查一次变化后重试
+        table = modules.Table();
+        mod = table ? table->Find(moduleName) : nullptr;
     }
-    CloseHandle(snap);
-    return base;
+    return mod ? mod->base : 0;
+}
+
+std::shared_ptr<const ModuleTable> IMemory::GetModules() {
+    RefreshModules();
+    return modules.Table();
+}
+
+// 返回 true 表示模块表已重建
+bool IMemory::RefreshModules(bool force) {
+    if (!backend->IsOpen()) return false;
+    std::lock_guard<std::mutex> g(moduleMutex);
+    auto now = std::chrono::steady_clock::now();
+    if (!force && now - lastModuleCheck < kModuleCheckInterval) return false;
+    lastModuleCheck = now;
+
+    uint64_t fp = backend->ModuleFingerprint();
+    if (!force && fp != 0 && fp == moduleFingerprint) return false;
+
+    std::vector<ModuleInfo> list;
+    if (!BuildModuleList(list)) return false;
+    moduleFingerprint = fp;
+    modules.Assign(std::move(list));
+    return true;
+}
+
+bool IMemory::BuildModuleList(std::vector<ModuleInfo>& out) {
+    if (!backend->EnumModules(out)) return false;
+
+    // 读取每个模块的 PE 头解析节表（ELF 模块没有 PE 头，节表为空）
+    uint8_t header[0x1000];
+    for (auto &mod : out) {
+        if (ReadMemory(mod.base, header, sizeof(header))) {
+            ModuleMap::ParsePeSections(header, sizeof(header), mod.sections);
+        }
+    }
+    return true;
+}
+
+bool IMemory::QueryRegions(std::vector<MemoryRegion>& out) {
+    return backend->QueryRegions(out);
 }
 
 bool IMemory::ResolvePointerPath(uintptr_t baseAddr, const std::vector<uint64_t>& offsets, uintptr_t &outAddr) {
@@ -80,93 +108,419 @@ bool IMemory::ResolvePointerPath(uintptr_t baseAddr, const std::vector<uint64_t>
     return true;
 }
 
-bool IMemory::ReadMemory(uintptr_t address, void* buffer, SIZE_T size) {
-    if (!hProcess) return false;
-    SIZE_T out = 0;
-    BOOL ok = ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(address), buffer, size, &out);
-    return ok && out == size;
+size_t IMemory::ReadPartial(uintptr_t address, void* buffer, size_t size, std::vector<ReadSpan>* valid) {
+    if (valid) valid->clear();
+    if (!backend->IsOpen() || size == 0) return 0;
+    if (address + size < address) size = UINTPTR_MAX - address;
+    uint8_t* dst = static_cast<uint8_t*>(buffer);
+    if (ReadMemory(address, buffer, size)) {
+        if (valid) valid->push_back({ address, buffer, size });
+        return size;
+    }
+    std::memset(buffer, 0, size);
+
+    // 按区域边界拆分，相邻的可读区域合并为一段
+    thread_local std::vector<ReadSpan> pieces;
+    thread_local std::vector<ReadSpan> pages;
+    thread_local std::vector<uint8_t> ok;
+    thread_local std::vector<uint8_t> pageOk;
+    pieces.clear();
+    uintptr_t end = address + size;
+    uintptr_t addr = address;
+    while (addr < end) {
+        MemoryRegion r;
+        if (!QueryRegionAt(addr, r)) break;
+        uintptr_t next = r.base + r.size;
+        if (next <= addr) break;
+        uintptr_t segEnd = std::min(end, next);
+        if ((r.flags & RegionReadable) && !(r.flags & RegionGuard)) {
+            if (!pieces.empty() && pieces.back().address + pieces.back().size == addr) {
+                pieces.back().size += segEnd - addr;
+            } else {
+                pieces.push_back({ addr, dst + (addr - address), segEnd - addr });
+            }
+        }
+        addr = segEnd;
+    }
+    ok.assign(pieces.size(), 0);
+    ReadSpans(pieces.data(), pieces.size(), ok.data());
+
+    // 索引过期时整段可能失败，按页重试
+    const uintptr_t kPage = 0x1000;
+    size_t bytes = 0;
+    auto accept = [&](const ReadSpan& s) {
+        bytes += s.size;
+        if (!valid) return;
+        if (!valid->empty() && valid->back().address + valid->back().size == s.address) valid->back().size += s.size;
+        else valid->push_back(s);
+    };
+    for (size_t i = 0; i < pieces.size(); ++i) {
+        const ReadSpan &p = pieces[i];
+        if (ok[i]) {
+            accept(p);
+            continue;
+        }
+        pages.clear();
+        for (uintptr_t a = p.address; a < p.address + p.size;) {
+            uintptr_t pageEnd = std::min<uintptr_t>((a & ~(kPage - 1)) + kPage, p.address + p.size);
+            pages.push_back({ a, dst + (a - address), pageEnd - a });
+            a = pageEnd;
+        }
+        pageOk.assign(pages.size(), 0);
+        ReadSpans(pages.data(), pages.size(), pageOk.data());
+        for (size_t k = 0; k < pages.size(); ++k) {
+            if (pageOk[k]) accept(pages[k]);
+            else std::memset(pages[k].buffer, 0, pages[k].size);
+        }
+    }
+    return bytes;
 }
 
-bool IMemory::WriteMemory(uintptr_t address, const void* buffer, SIZE_T size) {
-    if (!hProcess) return false;
-    DWORD oldProtect = 0;
-    // 先尝试修改保护
-    if (VirtualProtectEx(hProcess, reinterpret_cast<LPVOID>(address), size, PAGE_EXECUTE_READWRITE, &oldProtect)) {
-        SIZE_T out = 0;
-        BOOL ok = WriteProcessMemory(hProcess, reinterpret_cast<LPVOID>(address), buffer, size, &out);
-        // 恢复保护
-        VirtualProtectEx(hProcess, reinterpret_cast<LPVOID>(address), size, oldProtect, &oldProtect);
-        return ok && out == size;
-    } else {
-        SIZE_T out = 0;
-        BOOL ok = WriteProcessMemory(hProcess, reinterpret_cast<LPVOID>(address), buffer, size, &out);
-        return ok && out == size;
+bool IMemory::ReadMemory(uintptr_t address, void* buffer, size_t size) {
+    if (pageCache.Enabled()) {
+        ReadSpan span{ address, buffer, size };
+        uint8_t ok = 0;
+        if (pageCache.ReadSpans(direct, &span, 1, &ok)) return true;
     }
+    return BackendRead(address, buffer, size);
 }
 
-bool IMemory::ReadBytes(uintptr_t address, std::vector<uint8_t>& out, SIZE_T size) {
-    out.resize(size);
-    return ReadMemory(address, out.data(), size);
+size_t IMemory::ReadSpans(const ReadSpan* spans, size_t count, uint8_t* ok) {
+    if (!pageCache.Enabled()) return BackendReadSpans(spans, count, ok);
+    size_t n = pageCache.ReadSpans(direct, spans, count, ok);
+    if (n == count) return n;
+
+    // 缓存无法提供的段（超过块大小或所在块读取失败）直接读取
+    thread_local std::vector<ReadSpan> rest;
+    thread_local std::vector<size_t> restIndex;
+    thread_local std::vector<uint8_t> restOk;
+    rest.clear();
+    restIndex.clear();
+    for (size_t i = 0; i < count; ++i) {
+        if (ok[i]) continue;
+        rest.push_back(spans[i]);
+        restIndex.push_back(i);
+    }
+    restOk.assign(rest.size(), 0);
+    n += BackendReadSpans(rest.data(), rest.size(), restOk.data());
+    for (size_t k = 0; k < rest.size(); ++k) ok[restIndex[k]] = restOk[k];
+    return n;
 }
 
-bool IMemory::WriteBytes(uintptr_t address, const uint8_t* data, SIZE_T size) {
-    return WriteMemory(address, data, size);
+// 以下函数包装后端的读写与保护修改，便于统计系统调用次数和耗时
+bool IMemory::BackendRead(uintptr_t address, void* buffer, size_t size) {
+    MaybeRefreshRegions();
+    MemoryRegion hint{ 0, 0, 0, 0 };
+    if (!MayRead(address, size, hint)) return false;
+    STAT_TIMER(t);
+    bool ok = backend->Read(address, buffer, size);
+    STAT_RECORD(StatRead, t, ok ? size : 0, ok);
+    if (!ok) NoteReadFailure(address, size);
+    return ok;
 }
 
-int IMemory::LockMemory(uintptr_t address, const std::vector<uint8_t>& data, SIZE_T size, int frequency_ms) {
-    if (!hProcess) return -1;
-    auto entry = std::make_shared<LockEntry>();
-    entry->active = true;
-    entry->addr = address;
-    entry->data = data;
-    entry->size = size;
-    entry->freq_ms = frequency_ms > 0 ? frequency_ms : 200;
-    int id = nextLockId.fetch_add(1);
-    entry->th = std::thread([this, entry]() {
-        while (entry->active) {
-            this->WriteMemory(entry->addr, entry->data.data(), entry->size);
-            std::this_thread::sleep_for(std::chrono::milliseconds(entry->freq_ms));
-        }
-    });
-    {
-        std::lock_guard<std::mutex> g(lockMutex);
-        locks[id] = entry;
+size_t IMemory::BackendReadSpans(const ReadSpan* spans, size_t count, uint8_t* ok) {
+    MaybeRefreshRegions();
+    // 先按索引剔除不可读的段：Linux 下 process_vm_readv 遇到失败的段就会中断，剩余的段需要再次调用
+    thread_local std::vector<ReadSpan> pass;
+    thread_local std::vector<size_t> passIndex;
+    thread_local std::vector<uint8_t> passOk;
+    pass.clear();
+    passIndex.clear();
+    MemoryRegion hint{ 0, 0, 0, 0 };
+    for (size_t i = 0; i < count; ++i) {
+        ok[i] = 0;
+        if (!MayRead(spans[i].address, spans[i].size, hint)) continue;
+        pass.push_back(spans[i]);
+        passIndex.push_back(i);
+    }
+    passOk.assign(pass.size(), 0);
+
+    STAT_TIMER(t);
+    size_t n = pass.empty() ? 0 : backend->ReadSpans(pass.data(), pass.size(), passOk.data());
+#if TRAINER_STATS
+    uint64_t bytes = 0;
+    for (size_t k = 0; k < pass.size(); ++k) if (passOk[k]) bytes += pass[k].size;
+    if (!pass.empty()) STAT_RECORD(StatRead, t, bytes, n == pass.size());
+#endif
+    for (size_t k = 0; k < pass.size(); ++k) {
+        ok[passIndex[k]] = passOk[k];
+        if (!passOk[k]) NoteReadFailure(pass[k].address, pass[k].size);
     }
-    return id;
+    return n;
 }
 
-bool IMemory::UnlockMemory(int lockId) {
-    std::shared_ptr<LockEntry> entry;
-    {
-        std::lock_guard<std::mutex> g(lockMutex);
-        auto it = locks.find(lockId);
-        if (it == locks.end()) return false;
-        entry = it->second;
-        locks.erase(it);
-    }
-    if (entry) {
-        entry->active = false;
-        if (entry->th.joinable()) entry->th.join();
+bool IMemory::BackendWrite(uintptr_t address, const void* buffer, size_t size) {
+    STAT_TIMER(t);
+    bool ok = backend->Write(address, buffer, size);
+    STAT_RECORD(StatWrite, t, ok ? size : 0, ok);
+    // 失败时也可能写入了一部分
+    pageCache.Invalidate(address, size);
+    return ok;
+}
+
+bool IMemory::BackendMakeWritable(uintptr_t address, size_t size, bool executable, uint32_t& oldProtect) {
+    STAT_TIMER(t);
+    bool ok = backend->MakeWritable(address, size, executable, oldProtect);
+    STAT_RECORD(StatProtect, t, 0, ok);
+    return ok;
+}
+
+void IMemory::BackendRestoreProtection(uintptr_t address, size_t size, uint32_t oldProtect) {
+    STAT_TIMER(t);
+    backend->RestoreProtection(address, size, oldProtect);
+    STAT_RECORD(StatProtect, t, 0, true);
+}
+
+bool IMemory::QueryRegionAt(uintptr_t address, MemoryRegion& out) {
+    uint64_t checked = 0;
+    bool known = regionCache.Find(address, out, &checked);
+    // 可读的条目在读取失败时才重新查询；不可读的条目过期后重新查询，新分配的内存不会一直被拒绝
+    if (known && ((out.flags & RegionReadable) || RegionMap::NowMs() - checked < regionRecheckMs.load())) return true;
+    MemoryRegion fresh;
+    if (QueryBackendRegion(address, fresh)) {
+        out = fresh;
+        return true;
     }
+    // 查询失败（例如内核地址）时保留旧条目并刷新其时间，避免每次读取都重新查询
+    if (known) regionCache.Insert(out);
+    return known;
+}
+
+bool IMemory::QueryBackendRegion(uintptr_t address, MemoryRegion& out) {
+    if (!backend->QueryRegionAt(address, out)) return false;
+    ++regionQueries;
+    regionCache.Insert(out);
     return true;
 }
 
-bool IMemory::InjectShellcode(const std::vector<uint8_t>& shellcode, uintptr_t &remote_addr, HANDLE &remote_thread) {
-    if (!hProcess) return false;
-    SIZE_T size = shellcode.size();
-    LPVOID alloc = VirtualAllocEx(hProcess, nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE);
-    if (!alloc) return false;
-    SIZE_T written = 0;
-    if (!WriteProcessMemory(hProcess, alloc, shellcode.data(), size, &written) || written != size) {
-        VirtualFreeEx(hProcess, alloc, 0, MEM_RELEASE);
+bool IMemory::MayRead(uintptr_t address, size_t size, MemoryRegion& hint) {
+    if (!filterReads.load(std::memory_order_relaxed) || !regionCache.Complete()) return true;
+    uintptr_t end = address + size;
+    if (end < address) {
+        ++readsFiltered;
         return false;
     }
-    HANDLE th = CreateRemoteThread(hProcess, nullptr, 0, reinterpret_cast<LPTHREAD_START_ROUTINE>(alloc), nullptr, 0, nullptr);
-    if (!th) {
-        VirtualFreeEx(hProcess, alloc, 0, MEM_RELEASE);
-        return false;
+    // 同一次调用中的段大多落在同一区域内
+    if (hint.size && address - hint.base < hint.size && end - hint.base <= hint.size) return true;
+    while (address < end) {
+        MemoryRegion r;
+        if (!QueryRegionAt(address, r)) return true;    // 无法判断时交给内核
+        if (!(r.flags & RegionReadable) || (r.flags & RegionGuard)) {
+            ++readsFiltered;
+            return false;
+        }
+        hint = r;
+        uintptr_t next = r.base + r.size;
+        if (next <= address) return true;
+        address = next;
     }
-    remote_addr = reinterpret_cast<uintptr_t>(alloc);
-    remote_thread = th;
     return true;
 }
+
+// 索引认为可读但内核读取失败：索引已过期，重新查询失败范围内的区域（同一条目在 recheckMs 内只查询一次）
+void IMemory::NoteReadFailure(uintptr_t address, size_t size) {
+    if (!regionCache.Complete()) return;
+    uint64_t now = RegionMap::NowMs();
+    uint32_t recheck = regionRecheckMs.load();
+    uintptr_t end = address + size;
+    if (end < address) end = UINTPTR_MAX;
+    while (address < end) {
+        MemoryRegion r;
+        uint64_t checked = 0;
+        if (!regionCache.Find(address, r, &checked) || now - checked >= recheck) {
+            if (!QueryBackendRegion(address, r)) return;
+        }
+        uintptr_t next = r.base + r.size;
+        if (next <= address) return;
+        address = next;
+    }
+}
+
+void IMemory::MaybeRefreshRegions() {
+    uint32_t interval = regionRefreshMs.load(std::memory_order_relaxed);
+    if (!interval || !regionCache.Complete()) return;
+    uint64_t now = RegionMap::NowMs();
+    uint64_t last = lastRegionRefresh.load();
+    if (now - last < interval) return;
+    // 只由一个线程重建，其他线程继续使用旧索引
+    if (!lastRegionRefresh.compare_exchange_strong(last, now)) return;
+    RefreshRegions();
+}
+
+size_t IMemory::RefreshRegions() {
+    std::vector<MemoryRegion> all;
+    if (!backend->IsOpen() || !backend->QueryAllRegions(all)) return 0;
+    regionCache.Assign(all);
+    ++regionRebuilds;
+    lastRegionRefresh = RegionMap::NowMs();
+    return regionCache.Count();
+}
+
+bool IMemory::ConfigureRegionMap(const RegionMapOptions& options) {
+    filterReads = options.filterReads;
+    regionRefreshMs = options.refreshMs;
+    regionRecheckMs = options.recheckMs;
+    return true;
+}
+
+RegionMapOptions IMemory::RegionMapSettings() const {
+    RegionMapOptions o;
+    o.filterReads = filterReads.load();
+    o.refreshMs = regionRefreshMs.load();
+    o.recheckMs = regionRecheckMs.load();
+    return o;
+}
+
+RegionMapStats IMemory::GetRegionMapStats() const {
+    RegionMapStats st;
+    st.entries = regionCache.Count();
+    st.complete = regionCache.Complete();
+    st.rebuilds = regionRebuilds.load();
+    st.queries = regionQueries.load();
+    st.filtered = readsFiltered.load();
+    st.ageMs = st.complete ? RegionMap::NowMs() - lastRegionRefresh.load() : 0;
+    return st;
+}
+
+bool IMemory::IsRangeWritable(uintptr_t address, size_t size) {
+    uintptr_t end = address + size;
+    while (address < end) {
+        MemoryRegion r;
+        if (!QueryRegionAt(address, r) || !(r.flags & RegionWritable)) return false;
+        address = r.base + r.size;
+    }
+    return true;
+}
+
+bool IMemory::WriteMemory(uintptr_t address, const void* buffer, size_t size) {
+    if (!backend->IsOpen()) return false;
+    // 已可写的页直接写入，只需一次系统调用
+    if (IsRangeWritable(address, size)) {
+        if (BackendWrite(address, buffer, size)) return true;
+        regionCache.Invalidate(address, size); // 目标可能修改了保护属性，重新查询
+    }
+    uint32_t oldProtect = 0;
+    // 先尝试修改保护
+    if (BackendMakeWritable(address, size, true, oldProtect)) {
+        bool ok = BackendWrite(address, buffer, size);
+        // 恢复保护
+        BackendRestoreProtection(address, size, oldProtect);
+        return ok;
+    } else {
+        return BackendWrite(address, buffer, size);
+    }
+}
+
+size_t IMemory::CommitWrites(const WriteTransaction& txn, std::vector<uint8_t>& okBits) {
+    const auto &items = txn.Items();
+    okBits.assign((items.size() + 7) / 8, 0);
+    if (!backend->IsOpen() || items.empty()) return 0;
+
+    std::vector<uint32_t> order(items.size());
+    for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return items[a].address < items[b].address;
+    });
+
+    // 合并相邻/重叠的写入；重叠部分以后加入的为准
+    struct Run { uintptr_t lo; uintptr_t hi; size_t first; size_t last; };
+    std::vector<Run> runs;
+    for (size_t k = 0; k < order.size(); ++k) {
+        const auto &it = items[order[k]];
+        if (!runs.empty() && it.address <= runs.back().hi) {
+            runs.back().hi = std::max<uintptr_t>(runs.back().hi, it.address + it.size);
+            runs.back().last = k + 1;
+        } else {
+            runs.push_back({ it.address, it.address + it.size, k, k + 1 });
+        }
+    }
+
+    // 找出需要修改保护属性的页段：按缓存的区域切分，同一区域内的连续页只修改一次
+    const uintptr_t kPage = 0x1000;
+    struct ProtectRange { uintptr_t base; size_t size; bool executable; uint32_t oldProtect; bool changed; };
+    std::vector<ProtectRange> protects;
+    for (const auto &run : runs) {
+        uintptr_t addr = run.lo;
+        while (addr < run.hi) {
+            MemoryRegion r;
+            if (!QueryRegionAt(addr, r)) break;
+            uintptr_t segEnd = std::min<uintptr_t>(run.hi, r.base + r.size);
+            if (!(r.flags & RegionWritable)) {
+                uintptr_t pageLo = addr & ~(kPage - 1);
+                uintptr_t pageHi = (segEnd + kPage - 1) & ~(kPage - 1);
+                bool exec = (r.flags & RegionExecutable) != 0;
+                if (!protects.empty() && protects.back().base + protects.back().size >= pageLo
+                    && protects.back().executable == exec && protects.back().oldProtect == r.protect) {
+                    uintptr_t hi = std::max<uintptr_t>(protects.back().base + protects.back().size, pageHi);
+                    protects.back().size = hi - protects.back().base;
+                } else {
+                    protects.push_back({ pageLo, pageHi - pageLo, exec, r.protect, false });
+                }
+            }
+            addr = segEnd;
+        }
+    }
+    for (auto &p : protects) {
+        uint32_t old = 0;
+        p.changed = BackendMakeWritable(p.base, p.size, p.executable, old);
+        if (p.changed) p.oldProtect = old;
+    }
+
+    size_t ok = 0;
+    auto mark = [&](uint32_t idx) {
+        okBits[idx >> 3] |= static_cast<uint8_t>(1u << (idx & 7));
+        ++ok;
+    };
+    std::vector<uint8_t> merged;
+    std::vector<uint32_t> added;
+    for (const auto &run : runs) {
+        // 按加入顺序填充，重叠部分由后加入的覆盖
+        added.assign(order.begin() + run.first, order.begin() + run.last);
+        std::sort(added.begin(), added.end());
+        merged.resize(run.hi - run.lo);
+        for (uint32_t idx : added) {
+            const auto &it = items[idx];
+            std::memcpy(merged.data() + (it.address - run.lo), txn.Data(it), it.size);
+        }
+        if (BackendWrite(run.lo, merged.data(), merged.size())) {
+            for (uint32_t idx : added) mark(idx);
+            continue;
+        }
+        // 合并写入失败时按加入顺序逐项重试，保留可写部分
+        for (uint32_t idx : added) {
+            const auto &it = items[idx];
+            if (BackendWrite(it.address, txn.Data(it), it.size)) mark(idx);
+        }
+        regionCache.Invalidate(run.lo, run.hi - run.lo);
+    }
+
+    for (const auto &p : protects) {
+        if (p.changed) BackendRestoreProtection(p.base, p.size, p.oldProtect);
+    }
+    return ok;
+}
+
+bool IMemory::ReadBytes(uintptr_t address, std::vector<uint8_t>& out, size_t size) {
+    out.resize(size);
+    return ReadMemory(address, out.data(), size);
+}
+
+bool IMemory::WriteBytes(uintptr_t address, const uint8_t* data, size_t size) {
+    return WriteMemory(address, data, size);
+}
+
+int IMemory::LockMemory(uintptr_t address, const std::vector<uint8_t>& data, size_t size, int frequency_ms, bool compareFirst) {
+    if (!backend->IsOpen()) return -1;
+    if (size > data.size()) return -1;
+    std::vector<uint8_t> bytes(data.begin(), data.begin() + size);
+    return lockScheduler->Add(address, bytes, frequency_ms, compareFirst);
+}
+
+bool IMemory::UnlockMemory(int lockId) {
+    return lockScheduler->Remove(lockId);
+}
+
+bool IMemory::InjectShellcode(const std::vector<uint8_t>& shellcode, uintptr_t &remote_addr, uint32_t &thread_id) {
+    return backend->InjectShellcode(shellcode, remote_addr, thread_id);
+}
@@ -1,6 +1,4 @@
 ﻿#pragma once
-#include <napi.h>
-#include <windows.h>
 #include <string>
 #include <vector>
 #include <thread>
@@ -8,27 +6,87 @@
 #include <unordered_map>
 #include <mutex>
 #include <memory>
+#include <chrono>
 #include "process.h"
+#include "process_backend.h"
+#include "module_map.h"
+#include "lock_scheduler.h"
+#include "memory_source.h"
+#include "region_map.h"
+#include "write_txn.h"
+#include "page_cache.h"
 
-class IMemory {
+struct RegionMapStats {
+    size_t entries;
+    bool complete;
+    uint64_t rebuilds;      // 完整重建次数
+    uint64_t queries;       // 单个区域的平台查询次数
+    uint64_t filtered;      // 按索引直接拒绝的读取
+    uint64_t ageMs;         // 距上次完整重建的时间
+};
+
+/**
+ * 在线进程的内存访问。平台相关的部分（打开进程、读写、区域与模块枚举）由 ProcessBackend 实现，
+ * 这里负责模块表、区域索引、读取页缓存、批量写入事务和锁定。
+ * 区域索引在打开进程时完整构建，读取前按索引检查，落在不可读区域的读取不进入内核。
+ */
+class IMemory : public IMemorySource {
 public:
     IMemory();
     ~IMemory();
 
     // 打开/关闭
-    uint32_t OpenProcessByPid(uint32_t pid, uint32_t access = PROCESS_ALL_ACCESS);
-    uint32_t OpenProcessByName(const std::wstring& exeName, uint32_t access = PROCESS_ALL_ACCESS);
+    uint32_t OpenProcessByPid(uint32_t pid, uint32_t access = kProcessAllAccess);
+    uint32_t OpenProcessByName(const std::wstring& exeName, uint32_t access = kProcessAllAccess);
     void CloseProcess();
+    uint32_t ProcessId() const { return processId; }
+
+    // 枚举已提交且可访问的内存区域
+    bool QueryRegions(std::vector<MemoryRegion>& out) override;
 
-    // 模块基址
-    uintptr_t GetModuleBaseAddress(const std::wstring& moduleName);
+    // 模块基址（查询模块映射，名称不区分大小写）
+    uintptr_t GetModuleBaseAddress(const std::wstring& moduleName) override;
+
+    // 模块映射：打开进程时构建，之后仅在模块列表变化时重建
+    std::shared_ptr<const ModuleTable> GetModules() override;
+    uint64_t ModuleGeneration() const override { return modules.Generation(); }
+    bool RefreshModules(bool force = false);
 
     // pointer resolving: baseAddr + offsets
     bool ResolvePointerPath(uintptr_t baseAddr, const std::vector<uint64_t>& offsets, uintptr_t &outAddr);
 
-    // 读写基础
-    bool ReadMemory(uintptr_t address, void* buffer, SIZE_T size);
-    bool WriteMemory(uintptr_t address, const void* buffer, SIZE_T size);
+    // 读写基础；目标页已可写时 WriteMemory 直接写入，不再修改保护属性
+    bool ReadMemory(uintptr_t address, void* buffer, size_t size) override;
+    bool WriteMemory(uintptr_t address, const void* buffer, size_t size);
+
+    // 分散读取，Linux 下一次 process_vm_readv 完成
+    size_t ReadSpans(const ReadSpan* spans, size_t count, uint8_t* ok) override;
+
+    // 读取 [address, address+size) 中可读的部分：按区域边界拆分后一次分散读取，其余部分填 0。
+    // valid 按地址升序给出成功读取的段，返回读取的字节数
+    size_t ReadPartial(uintptr_t address, void* buffer, size_t size, std::vector<ReadSpan>* valid = nullptr);
+
+    // 读取页缓存（默认关闭）。经由本类的写入会使对应的块失效
+    bool ConfigureReadCache(const PageCacheOptions& options) { return pageCache.Configure(options); }
+    PageCacheOptions ReadCacheOptions() const { return pageCache.Options(); }
+    uint64_t NextReadEpoch() { return pageCache.NextEpoch(); }
+    // 绕过页缓存的读取视图，用于锁定比较等需要实时值的场合
+    IMemorySource& Uncached() { return direct; }
+
+    // 提交批量写入事务，okBits 按事务中的顺序逐位标记成功，返回成功数量
+    size_t CommitWrites(const WriteTransaction& txn, std::vector<uint8_t>& okBits);
+
+    // 查询 address 所在区域（优先使用索引；不可读的条目超过 recheckMs 后重新查询）
+    bool QueryRegionAt(uintptr_t address, MemoryRegion& out);
+
+    // 区域索引：完整重建返回条目数；List 按地址分页，返回符合条件的条目总数
+    bool ConfigureRegionMap(const RegionMapOptions& options);
+    RegionMapOptions RegionMapSettings() const;
+    size_t RefreshRegions();
+    size_t ListRegions(size_t offset, size_t count, bool includeFree, std::vector<MemoryRegion>& out) const {
+        return regionCache.List(offset, count, includeFree, out);
+    }
+    RegionMapStats GetRegionMapStats() const;
 
     // Typed helpers (implemented inline in header to avoid template ODR issues)
     template<typename T>
@@ -42,30 +100,60 @@ public:
     }
 
     // 字节数组读写
-    bool ReadBytes(uintptr_t address, std::vector<uint8_t>& out, SIZE_T size);
-    bool WriteBytes(uintptr_t address, const uint8_t* data, SIZE_T size);
+    bool ReadBytes(uintptr_t address, std::vector<uint8_t>& out, size_t size);
+    bool WriteBytes(uintptr_t address, const uint8_t* data, size_t size);
 
     // 锁定（周期写回），返回 lockId (>0) 成功，<=0 失败
-    int LockMemory(uintptr_t address, const std::vector<uint8_t>& data, SIZE_T size, int frequency_ms);
+    // compareFirst 为 true 时先读取比较，值未变化则不写入
+    int LockMemory(uintptr_t address, const std::vector<uint8_t>& data, size_t size, int frequency_ms, bool compareFirst = false);
     bool UnlockMemory(int lockId);
+    LockScheduler& Locks() { return *lockScheduler; }
 
-    // 注入 shellcode（把 shellcode 写入远程并创建线程）
-    bool InjectShellcode(const std::vector<uint8_t>& shellcode, uintptr_t &remote_addr, HANDLE &remote_thread);
+    // 注入 shellcode（把 shellcode 写入远程并创建线程），仅 Windows 支持
+    bool InjectShellcode(const std::vector<uint8_t>& shellcode, uintptr_t &remote_addr, uint32_t &thread_id);
 
 private:
-    HANDLE hProcess;
-    uint32_t processId;
-    std::mutex lockMutex;
-
-    struct LockEntry {
-        std::atomic<bool> active;
-        uintptr_t addr;
-        std::vector<uint8_t> data;
-        SIZE_T size;
-        int freq_ms;
-        std::thread th;
+    class DirectView : public IMemorySource {
+    public:
+        explicit DirectView(IMemory& owner) : owner(owner) {}
+        bool QueryRegions(std::vector<MemoryRegion>& out) override { return owner.QueryRegions(out); }
+        bool ReadMemory(uintptr_t address, void* buffer, size_t size) override { return owner.BackendRead(address, buffer, size); }
+        size_t ReadSpans(const ReadSpan* spans, size_t count, uint8_t* ok) override { return owner.BackendReadSpans(spans, count, ok); }
+
+    private:
+        IMemory& owner;
     };
 
-    std::unordered_map<int, std::shared_ptr<LockEntry>> locks;
-    std::atomic<int> nextLockId;
+    bool BuildModuleList(std::vector<ModuleInfo>& out);
+    bool IsRangeWritable(uintptr_t address, size_t size);
+    // 按索引检查读取范围，hint 缓存上一次命中的可读区域；未完整构建索引或关闭过滤时总是放行
+    bool MayRead(uintptr_t address, size_t size, MemoryRegion& hint);
+    void NoteReadFailure(uintptr_t address, size_t size);
+    void MaybeRefreshRegions();
+    bool QueryBackendRegion(uintptr_t address, MemoryRegion& out);
+    bool BackendRead(uintptr_t address, void* buffer, size_t size);
+    size_t BackendReadSpans(const ReadSpan* spans, size_t count, uint8_t* ok);
+    bool BackendWrite(uintptr_t address, const void* buffer, size_t size);
+    bool BackendMakeWritable(uintptr_t address, size_t size, bool executable, uint32_t& oldProtect);
+    void BackendRestoreProtection(uintptr_t address, size_t size, uint32_t oldProtect);
+
+    std::unique_ptr<ProcessBackend> backend;
+    uint32_t processId;
+
+    ModuleMap modules;
+    std::mutex moduleMutex;
+    std::chrono::steady_clock::time_point lastModuleCheck;
+    uint64_t moduleFingerprint;
+
+    RegionMap regionCache;
+    std::atomic<bool> filterReads{ RegionMapOptions().filterReads };
+    std::atomic<uint32_t> regionRefreshMs{ RegionMapOptions().refreshMs };
+    std::atomic<uint32_t> regionRecheckMs{ RegionMapOptions().recheckMs };
+    std::atomic<uint64_t> lastRegionRefresh{ 0 };
+    std::atomic<uint64_t> regionRebuilds{ 0 };
+    std::atomic<uint64_t> regionQueries{ 0 };
+    std::atomic<uint64_t> readsFiltered{ 0 };
+    PageCache pageCache;
+    DirectView direct;
+    std::unique_ptr<LockScheduler> lockScheduler;
 };
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "module_map.h"
+
+// 与平台无关的内存区域属性
+enum RegionFlags : uint32_t {
+    RegionReadable   = 1u << 0,
+    RegionWritable   = 1u << 1,
+    RegionExecutable = 1u << 2,
+    RegionGuard      = 1u << 3,
+    RegionPrivate    = 1u << 4,
+    RegionImage      = 1u << 5,
+    RegionMapped     = 1u << 6,
+    RegionCommitted  = 1u << 7,     // 已提交（不一定可访问）
+    RegionReserved   = 1u << 8,     // 只保留了地址范围；Linux 下为 PROT_NONE 的映射
+};
+
+struct MemoryRegion {
+    uintptr_t base;
+    size_t size;
+    uint32_t flags;     // RegionFlags 组合
+    uint32_t protect;   // 平台原始保护属性（Windows 下为 PAGE_*，Linux 下为 PROT_*）
+};
+
+// 分散读取中的一段
+struct ReadSpan {
+    uintptr_t address;
+    void* buffer;
+    size_t size;
+};
+
+/**
+ * 扫描引擎使用的目标内存抽象：只需要区域枚举和批量读取。
+ * IMemory 为在线进程实现了该接口，SnapshotSource 由快照文件提供同样的数据。
+ * 模块表是可选的：没有模块信息的实现返回 nullptr。
+ */
+class IMemorySource {
+public:
+    virtual ~IMemorySource() = default;
+
+    // 枚举已提交的内存区域，按地址升序
+    virtual bool QueryRegions(std::vector<MemoryRegion>& out) = 0;
+
+    // 读取 [address, address+size)，必须完整读取才返回 true
+    virtual bool ReadMemory(uintptr_t address, void* buffer, size_t size) = 0;
+
+    // 分散读取：ok[i] 标记第 i 段是否完整读取，返回成功段数。
+    // 默认逐段调用 ReadMemory；支持向量化读取的实现一次系统调用完成多段
+    virtual size_t ReadSpans(const ReadSpan* spans, size_t count, uint8_t* ok) {
+        size_t n = 0;
+        for (size_t i = 0; i < count; ++i) {
+            ok[i] = ReadMemory(spans[i].address, spans[i].buffer, spans[i].size) ? 1 : 0;
+            n += ok[i];
+        }
+        return n;
+    }
+
+    // 当前模块表及其代号，代号变化表示模块表已重建
+    virtual std::shared_ptr<const ModuleTable> GetModules() { return nullptr; }
+    virtual uint64_t ModuleGeneration() const { return 0; }
+
+    // 模块基址（名称不区分大小写），未找到返回 0
+    virtual uintptr_t GetModuleBaseAddress(const std::wstring& moduleName) {
+        auto table = GetModules();
+        const ModuleInfo* mod = table ? table->Find(moduleName) : nullptr;
+        return mod ? mod->base : 0;
+    }
+};
@@ -0,0 +1,99 @@
+#include "module_map.h"
+#include <algorithm>
+#include <cstring>
+#include <cwctype>
+
+namespace {
+
+template<typename T>
+bool ReadField(const uint8_t* buf, size_t len, size_t offset, T& out) {
+    if (offset + sizeof(T) > len) return false;
+    std::memcpy(&out, buf + offset, sizeof(T));
+    return true;
+}
+
+} // namespace
+
+// ---------------- ModuleTable ----------------
+
+ModuleTable::ModuleTable(std::vector<ModuleInfo> mods, uint64_t gen) : modules(std::move(mods)), generation(gen) {
+    std::sort(modules.begin(), modules.end(),
+        [](const ModuleInfo& a, const ModuleInfo& b) { return a.base < b.base; });
+    for (size_t i = 0; i < modules.size(); ++i) {
+        // 同名模块保留第一个（与 Toolhelp 遍历顺序下的旧行为一致）
+        byName.emplace(NormalizeName(modules[i].name), i);
+    }
+}
+
+std::wstring ModuleTable::NormalizeName(const std::wstring& name) {
+    std::wstring r(name);
+    for (auto &c : r) c = static_cast<wchar_t>(std::towlower(c));
+    return r;
+}
+
+const ModuleInfo* ModuleTable::Find(const std::wstring& name) const {
+    auto it = byName.find(NormalizeName(name));
+    return it == byName.end() ? nullptr : &modules[it->second];
+}
+
+const ModuleInfo* ModuleTable::FindByAddress(uintptr_t address) const {
+    auto it = std::upper_bound(modules.begin(), modules.end(), address,
+        [](uintptr_t addr, const ModuleInfo& m) { return addr < m.base; });
+    if (it == modules.begin()) return nullptr;
+    --it;
+    return address < it->base + it->size ? &*it : nullptr;
+}
+
+// ---------------- ModuleMap ----------------
+
+ModuleMap::ModuleMap() : generation(0) {}
+
+void ModuleMap::Assign(std::vector<ModuleInfo> modules) {
+    std::lock_guard<std::mutex> g(m);
+    table = std::make_shared<const ModuleTable>(std::move(modules), ++generation);
+}
+
+void ModuleMap::Clear() {
+    std::lock_guard<std::mutex> g(m);
+    table.reset();
+    ++generation;
+}
+
+std::shared_ptr<const ModuleTable> ModuleMap::Table() const {
+    std::lock_guard<std::mutex> g(m);
+    return table;
+}
+
+uint64_t ModuleMap::Generation() const {
+    std::lock_guard<std::mutex> g(m);
+    return generation;
+}
+
+bool ModuleMap::ParsePeSections(const uint8_t* header, size_t len, std::vector<ModuleSection>& out) {
+    out.clear();
+    uint16_t mz = 0;
+    uint32_t lfanew = 0, signature = 0;
+    if (!ReadField(header, len, 0, mz) || mz != 0x5A4D) return false;            // "MZ"
+    if (!ReadField(header, len, 0x3C, lfanew)) return false;
+    if (!ReadField(header, len, lfanew, signature) || signature != 0x4550) return false; // "PE\0\0"
+
+    // IMAGE_FILE_HEADER 紧跟在签名之后
+    uint16_t numberOfSections = 0, sizeOfOptionalHeader = 0;
+    if (!ReadField(header, len, lfanew + 4 + 2, numberOfSections)) return false;
+    if (!ReadField(header, len, lfanew + 4 + 16, sizeOfOptionalHeader)) return false;
+
+    size_t table = lfanew + 4 + 20 + sizeOfOptionalHeader;
+    const size_t kSectionHeaderSize = 40;
+    for (uint16_t i = 0; i < numberOfSections; ++i) {
+        size_t sh = table + i * kSectionHeaderSize;
+        if (sh + kSectionHeaderSize > len) break;
+        ModuleSection s;
+        const char* rawName = reinterpret_cast<const char*>(header + sh);
+        s.name.assign(rawName, strnlen(rawName, 8));
+        ReadField(header, len, sh + 8, s.size);
+        ReadField(header, len, sh + 12, s.rva);
+        ReadField(header, len, sh + 36, s.characteristics);
+        out.push_back(std::move(s));
+    }
+    return true;
+}
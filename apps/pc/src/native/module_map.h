@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct ModuleSection {
+    std::string name;           // ".text" / ".data" ...
+    uint32_t rva;
+    uint32_t size;
+    uint32_t characteristics;   // IMAGE_SCN_*
+};
+
+struct ModuleInfo {
+    std::wstring name;
+    std::wstring path;
+    uintptr_t base;
+    size_t size;
+    std::vector<ModuleSection> sections;
+};
+
+/**
+ * 某一时刻的模块表，构建后只读，可在多个线程中无锁查询。
+ * 按基址排序，地址反查使用二分查找；名称查找不区分大小写。
+ */
+class ModuleTable {
+public:
+    ModuleTable(std::vector<ModuleInfo> modules, uint64_t generation);
+
+    const ModuleInfo* Find(const std::wstring& name) const;
+    const ModuleInfo* FindByAddress(uintptr_t address) const;
+
+    const std::vector<ModuleInfo>& Modules() const { return modules; }
+    uint64_t Generation() const { return generation; }
+
+    static std::wstring NormalizeName(const std::wstring& name);
+
+private:
+    std::vector<ModuleInfo> modules;
+    std::unordered_map<std::wstring, size_t> byName;
+    uint64_t generation;
+};
+
+/**
+ * 目标进程的模块映射。模块列表由平台层枚举后通过 Assign 提交，
+ * 每次提交生成新的 ModuleTable 并替换旧表，已取出的旧表仍然有效。
+ */
+class ModuleMap {
+public:
+    ModuleMap();
+
+    void Assign(std::vector<ModuleInfo> modules);
+    void Clear();
+
+    std::shared_ptr<const ModuleTable> Table() const;
+    uint64_t Generation() const;
+
+    // 解析 PE 头（模块起始处的字节）中的节表
+    static bool ParsePeSections(const uint8_t* header, size_t len, std::vector<ModuleSection>& out);
+
+private:
+    mutable std::mutex m;
+    std::shared_ptr<const ModuleTable> table;
+    uint64_t generation;
+};
@@ -0,0 +1,200 @@
+#include "page_cache.h"
+#include <algorithm>
+#include <cstring>
+#include "stats.h"
+
+namespace {
+constexpr size_t kMinPageSize = 0x1000;
+constexpr size_t kMaxPageSize = 1 << 20;
+}
+
+PageCache::PageCache() : enabled(false), epoch(0), generation(0) {}
+
+bool PageCache::Configure(const PageCacheOptions& options) {
+    size_t ps = options.pageSize;
+    if (ps < kMinPageSize || ps > kMaxPageSize || (ps & (ps - 1)) != 0 || options.maxPages == 0) return false;
+    std::lock_guard<std::mutex> g(m);
+    if (!options.enabled || ps != opts.pageSize) ClearLocked();
+    opts = options;
+    // 缩小上限时淘汰多出的块
+    while (lru.size() > opts.maxPages) {
+        index.erase(lru.back().base);
+        lru.pop_back();
+    }
+    enabled.store(opts.enabled, std::memory_order_relaxed);
+    return true;
+}
+
+PageCacheOptions PageCache::Options() const {
+    std::lock_guard<std::mutex> g(m);
+    return opts;
+}
+
+uint64_t PageCache::NextEpoch() {
+    std::lock_guard<std::mutex> g(m);
+    return ++epoch;
+}
+
+void PageCache::Invalidate(uintptr_t address, size_t size) {
+    if (!Enabled() || size == 0) return;
+    std::lock_guard<std::mutex> g(m);
+    ++generation;
+    uintptr_t mask = ~static_cast<uintptr_t>(opts.pageSize - 1);
+    uintptr_t first = address & mask;
+    uintptr_t last = (address + size - 1) & mask;
+    size_t pages = (last - first) / opts.pageSize + 1;
+    if (pages > index.size()) {
+        // 范围比缓存本身大时遍历缓存
+        for (auto it = lru.begin(); it != lru.end();) {
+            if (it->base >= first && it->base <= last) {
+                index.erase(it->base);
+                it = lru.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        return;
+    }
+    for (uintptr_t p = first;; p += opts.pageSize) {
+        auto it = index.find(p);
+        if (it != index.end()) {
+            lru.erase(it->second);
+            index.erase(it);
+        }
+        if (p == last) break;
+    }
+}
+
+void PageCache::Clear() {
+    std::lock_guard<std::mutex> g(m);
+    ClearLocked();
+}
+
+void PageCache::ClearLocked() {
+    ++generation;
+    lru.clear();
+    index.clear();
+}
+
+const uint8_t* PageCache::FreshData(uintptr_t base, Clock::time_point now) {
+    auto it = index.find(base);
+    if (it == index.end()) return nullptr;
+    Page &p = *it->second;
+    if (p.epoch != epoch || (opts.maxAgeMs && now - p.fetchedAt > std::chrono::milliseconds(opts.maxAgeMs))) {
+        return nullptr;
+    }
+    lru.splice(lru.begin(), lru, it->second);
+    return p.data.data();
+}
+
+void PageCache::Store(uintptr_t base, const uint8_t* data, uint64_t fetchEpoch, Clock::time_point fetchedAt) {
+    auto it = index.find(base);
+    if (it != index.end()) {
+        lru.splice(lru.begin(), lru, it->second);
+    } else if (lru.size() >= opts.maxPages) {
+        // 复用最久未使用的块，避免重新分配
+        index.erase(lru.back().base);
+        lru.splice(lru.begin(), lru, std::prev(lru.end()));
+        index[base] = lru.begin();
+    } else {
+        lru.emplace_front();
+        lru.front().data.resize(opts.pageSize);
+        index[base] = lru.begin();
+    }
+    Page &p = lru.front();
+    p.base = base;
+    p.epoch = fetchEpoch;
+    p.fetchedAt = fetchedAt;
+    std::memcpy(p.data.data(), data, opts.pageSize);
+}
+
+size_t PageCache::ReadSpans(IMemorySource& origin, const ReadSpan* spans, size_t count, uint8_t* ok) {
+    std::fill(ok, ok + count, 0);
+    if (!Enabled()) return 0;
+
+    thread_local std::vector<uintptr_t> missing;
+    thread_local std::vector<uint8_t> fetched;
+    thread_local std::vector<ReadSpan> fetchSpans;
+    thread_local std::vector<uint8_t> fetchOk;
+    missing.clear();
+
+    // 第一遍：找出缺失或过期的块
+    size_t pageSize;
+    uint64_t gen, fetchEpoch;
+    Clock::time_point fetchedAt;
+    uint64_t hits = 0;
+    {
+        std::lock_guard<std::mutex> g(m);
+        pageSize = opts.pageSize;
+        gen = generation;
+        fetchEpoch = epoch;
+        fetchedAt = Clock::now();
+        uintptr_t mask = ~static_cast<uintptr_t>(pageSize - 1);
+        for (size_t i = 0; i < count; ++i) {
+            const ReadSpan &s = spans[i];
+            if (s.size == 0 || s.size > pageSize) continue;
+            uintptr_t last = (s.address + s.size - 1) & mask;
+            for (uintptr_t p = s.address & mask;; p += pageSize) {
+                if (FreshData(p, fetchedAt)) ++hits;
+                else missing.push_back(p);
+                if (p == last) break;
+            }
+        }
+    }
+    std::sort(missing.begin(), missing.end());
+    missing.erase(std::unique(missing.begin(), missing.end()), missing.end());
+
+    // 缺失的块一次提交读取，不持锁
+    if (!missing.empty()) {
+        fetched.resize(missing.size() * pageSize);
+        fetchSpans.resize(missing.size());
+        fetchOk.assign(missing.size(), 0);
+        for (size_t k = 0; k < missing.size(); ++k) {
+            fetchSpans[k] = { missing[k], fetched.data() + k * pageSize, pageSize };
+        }
+        origin.ReadSpans(fetchSpans.data(), fetchSpans.size(), fetchOk.data());
+    }
+    STAT_ADD(StatCacheHits, hits);
+    STAT_ADD(StatCacheMisses, missing.size());
+
+    std::lock_guard<std::mutex> g(m);
+    if (opts.pageSize != pageSize) return 0;
+    // 读取期间发生过写入或清空时，结果只用于本次返回，不放入缓存
+    if (gen == generation && opts.enabled) {
+        for (size_t k = 0; k < missing.size(); ++k) {
+            if (fetchOk[k]) Store(missing[k], fetched.data() + k * pageSize, fetchEpoch, fetchedAt);
+        }
+    }
+
+    size_t n = 0;
+    uintptr_t mask = ~static_cast<uintptr_t>(pageSize - 1);
+    Clock::time_point now = Clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        const ReadSpan &s = spans[i];
+        if (s.size == 0 || s.size > pageSize) continue;
+        uint8_t* dst = static_cast<uint8_t*>(s.buffer);
+        uintptr_t a = s.address;
+        size_t left = s.size;
+        while (left) {
+            uintptr_t p = a & mask;
+            size_t off = a - p;
+            size_t len = std::min(left, pageSize - off);
+            const uint8_t* src = nullptr;
+            auto it = std::lower_bound(missing.begin(), missing.end(), p);
+            if (it != missing.end() && *it == p) {
+                size_t k = it - missing.begin();
+                if (fetchOk[k]) src = fetched.data() + k * pageSize;
+            } else {
+                src = FreshData(p, now);
+            }
+            if (!src) break;
+            std::memcpy(dst, src + off, len);
+            dst += len;
+            a += len;
+            left -= len;
+        }
+        ok[i] = left == 0 ? 1 : 0;
+        n += ok[i];
+    }
+    return n;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "memory_source.h"
+
+struct PageCacheOptions {
+    bool enabled = false;
+    size_t pageSize = 0x1000;       // 未命中时读取的对齐块大小，2 的幂，4 KiB ~ 1 MiB
+    size_t maxPages = 256;          // 缓存块数上限，超出时淘汰最久未使用的块
+    uint32_t maxAgeMs = 16;         // 块的有效期；0 表示不按时间过期，只随纪元失效
+};
+
+/**
+ * 目标进程内存的读穿透缓存：未命中时整块读取（同一批次的所有缺失块通过一次 ReadSpans 提交），
+ * 之后在有效期内、且纪元未推进时直接从本地副本复制，同一结构体内的大量字段只需少数几次系统调用。
+ * 块按 LRU 淘汰，数量有上限。经由 IMemory 的写入会使对应的块失效。
+ * 只缓存不超过一个块大小的读取，更大的读取（扫描等）由调用方直接读取。
+ */
+class PageCache {
+public:
+    PageCache();
+
+    // 修改块大小会清空缓存；pageSize 不合法时返回 false
+    bool Configure(const PageCacheOptions& options);
+    PageCacheOptions Options() const;
+    bool Enabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    // 推进纪元：之前读取的块全部视为过期，返回新的纪元
+    uint64_t NextEpoch();
+    void Invalidate(uintptr_t address, size_t size);
+    void Clear();
+
+    // 从缓存提供各段，缺失的块经 origin 读取；无法提供的段（过大或所在块读取失败）ok 为 0，
+    // 由调用方直接读取。返回成功段数
+    size_t ReadSpans(IMemorySource& origin, const ReadSpan* spans, size_t count, uint8_t* ok);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Page {
+        uintptr_t base;
+        uint64_t epoch;
+        Clock::time_point fetchedAt;
+        std::vector<uint8_t> data;
+    };
+
+    // 调用方持有 m
+    const uint8_t* FreshData(uintptr_t base, Clock::time_point now);
+    void Store(uintptr_t base, const uint8_t* data, uint64_t fetchEpoch, Clock::time_point fetchedAt);
+    void ClearLocked();
+
+    mutable std::mutex m;
+    PageCacheOptions opts;
+    std::atomic<bool> enabled;
+    uint64_t epoch;
+    uint64_t generation;            // 每次失效/清空时递增，读取期间发生变化则不把结果放入缓存
+    std::list<Page> lru;            // 表头为最近使用
+    std::unordered_map<uintptr_t, std::list<Page>::iterator> index;
+};
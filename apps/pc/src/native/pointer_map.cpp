@@ -0,0 +1,223 @@
+#include "pointer_map.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr size_t kChunkSize = 4 * 1024 * 1024;
+const char kMapMagic[4] = { 'X', 'P', 'M', 'P' };
+constexpr uint32_t kMapVersion = 1;
+
+struct Pair {
+    uint64_t value;
+    uint64_t location;
+    bool operator<(const Pair& o) const { return value < o.value || (value == o.value && location < o.location); }
+};
+
+struct Range {
+    uint64_t lo;
+    uint64_t hi;    // 不含
+};
+
+bool InRanges(const std::vector<Range>& ranges, uint64_t v) {
+    auto it = std::upper_bound(ranges.begin(), ranges.end(), v, [](uint64_t x, const Range& r) { return x < r.lo; });
+    if (it == ranges.begin()) return false;
+    --it;
+    return v < it->hi;
+}
+
+template<typename T>
+bool WritePod(std::FILE* f, const T& v) { return std::fwrite(&v, sizeof(T), 1, f) == 1; }
+
+template<typename T>
+bool ReadAt(const uint8_t* data, size_t size, size_t& off, T& v) {
+    if (off + sizeof(T) > size) return false;
+    std::memcpy(&v, data + off, sizeof(T));
+    off += sizeof(T);
+    return true;
+}
+
+} // namespace
+
+PointerMap::PointerMap(ThreadPool& pool) : pool(pool), values(nullptr), locations(nullptr), count(0) {}
+
+void PointerMap::Clear() {
+    modules.clear();
+    ownedValues.clear();
+    ownedValues.shrink_to_fit();
+    ownedLocations.clear();
+    ownedLocations.shrink_to_fit();
+    file.Close();
+    values = nullptr;
+    locations = nullptr;
+    count = 0;
+}
+
+bool PointerMap::Build(IMemorySource& src, const ModuleTable* table, const PointerMapOptions& opts,
+                       const std::atomic<bool>* cancel) {
+    Clear();
+    if (table) {
+        for (const auto &m : table->Modules()) modules.push_back({ m.name, m.base, m.size });
+    }
+
+    std::vector<MemoryRegion> regions;
+    if (!src.QueryRegions(regions)) return false;
+    std::sort(regions.begin(), regions.end(), [](const MemoryRegion& a, const MemoryRegion& b) { return a.base < b.base; });
+
+    // 有效的指针目标：所有可读区域，相邻区域合并
+    std::vector<Range> targets;
+    for (const auto &r : regions) {
+        if (!(r.flags & RegionReadable)) continue;
+        if (!targets.empty() && targets.back().hi == r.base) targets.back().hi += r.size;
+        else targets.push_back({ r.base, r.base + r.size });
+    }
+    if (targets.empty()) return true;
+    const uint64_t minTarget = targets.front().lo;
+    const uint64_t maxTarget = targets.back().hi;
+
+    const size_t align = opts.alignment ? opts.alignment : sizeof(uintptr_t);
+    struct Task { uintptr_t base; size_t size; };
+    std::vector<Task> tasks;
+    for (const auto &r : regions) {
+        if (!(r.flags & RegionReadable) || (r.flags & RegionGuard)) continue;
+        if (opts.writableOnly && !(r.flags & RegionWritable)) continue;
+        if (!opts.includeMapped && (r.flags & RegionMapped)) continue;
+        for (uintptr_t b = r.base; b < r.base + r.size; b += kChunkSize) {
+            tasks.push_back({ b, std::min<size_t>(kChunkSize, r.base + r.size - b) });
+        }
+    }
+
+    // 每块内排好序，最后再合并
+    std::vector<std::vector<Pair>> runs(tasks.size());
+    const size_t window = pool.Size() * 4;
+    for (size_t start = 0; start < tasks.size(); start += window) {
+        if (cancel && cancel->load()) { Clear(); return false; }
+        size_t n = std::min(window, tasks.size() - start);
+        pool.ParallelFor(n, [&](size_t i) {
+            const Task &t = tasks[start + i];
+            thread_local std::vector<uint8_t> buf;
+            buf.resize(t.size);
+            if (!src.ReadMemory(t.base, buf.data(), t.size)) return;
+            auto &out = runs[start + i];
+            size_t first = (align - (t.base % align)) % align;
+            for (size_t off = first; off + sizeof(uintptr_t) <= t.size; off += align) {
+                uintptr_t v;
+                std::memcpy(&v, buf.data() + off, sizeof(v));
+                if (v < minTarget || v >= maxTarget || !InRanges(targets, v)) continue;
+                out.push_back({ v, t.base + off });
+            }
+            std::sort(out.begin(), out.end());
+        });
+    }
+
+    // 两两并行归并，直到只剩一个有序序列
+    runs.erase(std::remove_if(runs.begin(), runs.end(), [](const std::vector<Pair>& r) { return r.empty(); }), runs.end());
+    while (runs.size() > 1) {
+        if (cancel && cancel->load()) { Clear(); return false; }
+        std::vector<std::vector<Pair>> merged((runs.size() + 1) / 2);
+        pool.ParallelFor(merged.size(), [&](size_t i) {
+            if (2 * i + 1 >= runs.size()) {
+                merged[i].swap(runs[2 * i]);
+                return;
+            }
+            auto &a = runs[2 * i];
+            auto &b = runs[2 * i + 1];
+            merged[i].resize(a.size() + b.size());
+            std::merge(a.begin(), a.end(), b.begin(), b.end(), merged[i].begin());
+            std::vector<Pair>().swap(a);
+            std::vector<Pair>().swap(b);
+        });
+        runs.swap(merged);
+    }
+
+    if (!runs.empty()) {
+        const auto &all = runs[0];
+        ownedValues.resize(all.size());
+        ownedLocations.resize(all.size());
+        for (size_t i = 0; i < all.size(); ++i) {
+            ownedValues[i] = all[i].value;
+            ownedLocations[i] = all[i].location;
+        }
+    }
+    values = ownedValues.data();
+    locations = ownedLocations.data();
+    count = ownedValues.size();
+    return true;
+}
+
+void PointerMap::FindRange(uint64_t lo, uint64_t hi, size_t& first, size_t& last) const {
+    first = std::lower_bound(values, values + count, lo) - values;
+    last = std::upper_bound(values + first, values + count, hi) - values;
+}
+
+int PointerMap::FindModule(uint64_t address) const {
+    auto it = std::upper_bound(modules.begin(), modules.end(), address,
+        [](uint64_t a, const PointerMapModule& m) { return a < m.base; });
+    if (it == modules.begin()) return -1;
+    --it;
+    return address < it->base + it->size ? static_cast<int>(it - modules.begin()) : -1;
+}
+
+// 文件格式："XPMP" | version | pointerSize | moduleCount | count:u64
+//          | { base:u64 size:u64 nameLen:u32 name:u16[] } 对齐到 8 | values:u64[count] | locations:u64[count]
+bool PointerMap::Save(const std::string& path) const {
+    std::FILE* f = OpenFileUtf8(path, "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(kMapMagic, 1, 4, f) == 4 && WritePod(f, kMapVersion)
+        && WritePod(f, static_cast<uint32_t>(sizeof(uintptr_t)))
+        && WritePod(f, static_cast<uint32_t>(modules.size())) && WritePod(f, static_cast<uint64_t>(count));
+    size_t written = 4 + 4 * 3 + 8;
+    for (size_t i = 0; ok && i < modules.size(); ++i) {
+        const auto &m = modules[i];
+        std::vector<uint16_t> name(m.name.begin(), m.name.end());
+        ok = WritePod(f, m.base) && WritePod(f, m.size) && WritePod(f, static_cast<uint32_t>(name.size()))
+            && (name.empty() || std::fwrite(name.data(), 2, name.size(), f) == name.size());
+        written += 8 + 8 + 4 + name.size() * 2;
+    }
+    static const uint8_t kZero[8] = {};
+    size_t pad = (8 - written % 8) % 8;
+    if (ok && pad) ok = std::fwrite(kZero, 1, pad, f) == pad;
+    if (ok && count) {
+        ok = std::fwrite(values, sizeof(uint64_t), count, f) == count
+            && std::fwrite(locations, sizeof(uint64_t), count, f) == count;
+    }
+    return std::fclose(f) == 0 && ok;
+}
+
+bool PointerMap::Load(const std::string& path) {
+    Clear();
+    if (!file.OpenRead(path)) return false;
+    const uint8_t* data = file.Data();
+    const size_t size = file.Size();
+    size_t off = 4;
+    uint32_t version = 0, pointerSize = 0, moduleCount = 0;
+    uint64_t n = 0;
+    bool ok = size >= 4 && std::memcmp(data, kMapMagic, 4) == 0
+        && ReadAt(data, size, off, version) && version == kMapVersion
+        && ReadAt(data, size, off, pointerSize) && pointerSize == sizeof(uintptr_t)
+        && ReadAt(data, size, off, moduleCount) && ReadAt(data, size, off, n);
+    for (uint32_t i = 0; ok && i < moduleCount; ++i) {
+        PointerMapModule m;
+        uint32_t nameLen = 0;
+        ok = ReadAt(data, size, off, m.base) && ReadAt(data, size, off, m.size) && ReadAt(data, size, off, nameLen)
+            && off + static_cast<size_t>(nameLen) * 2 <= size;
+        if (!ok) break;
+        for (uint32_t k = 0; k < nameLen; ++k) {
+            uint16_t c;
+            std::memcpy(&c, data + off + k * 2, 2);
+            m.name.push_back(static_cast<wchar_t>(c));
+        }
+        off += static_cast<size_t>(nameLen) * 2;
+        modules.push_back(std::move(m));
+    }
+    off += (8 - off % 8) % 8;
+    ok = ok && n <= (size - std::min(off, size)) / 16 && off + n * 16 <= size;
+    if (!ok) {
+        Clear();
+        return false;
+    }
+    values = reinterpret_cast<const uint64_t*>(data + off);
+    locations = values + n;
+    count = static_cast<size_t>(n);
+    return true;
+}
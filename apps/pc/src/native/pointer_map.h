@@ -0,0 +1,62 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "mapped_file.h"
+#include "memory_source.h"
+#include "module_map.h"
+#include "thread_pool.h"
+
+struct PointerMapOptions {
+    size_t alignment = sizeof(uintptr_t);   // 指针存放位置的对齐
+    bool writableOnly = true;               // 只在可写区域中寻找指针
+    bool includeMapped = false;
+};
+
+// 建图时的模块范围，作为指针路径的静态起点
+struct PointerMapModule {
+    std::wstring name;
+    uint64_t base;
+    uint64_t size;
+};
+
+/**
+ * 反向指针表：目标进程中所有"值落在可读区域内"的指针，按指针值排序。
+ * 查询"哪些位置指向 [lo, hi]"为一次二分查找。
+ * 值和位置分两列紧密存放（每项 16 字节，无额外开销），
+ * 可保存为文件并以只读内存映射方式重新加载，加载后无需读取目标进程。
+ */
+class PointerMap {
+public:
+    explicit PointerMap(ThreadPool& pool = ThreadPool::Shared());
+
+    bool Build(IMemorySource& src, const ModuleTable* modules, const PointerMapOptions& opts,
+               const std::atomic<bool>* cancel = nullptr);
+    bool Save(const std::string& path) const;
+    bool Load(const std::string& path);
+    void Clear();
+
+    size_t Count() const { return count; }
+    bool Empty() const { return count == 0; }
+
+    // 指针值落在 [lo, hi] 内的条目下标范围 [first, last)
+    void FindRange(uint64_t lo, uint64_t hi, size_t& first, size_t& last) const;
+    uint64_t ValueAt(size_t i) const { return values[i]; }
+    uint64_t LocationAt(size_t i) const { return locations[i]; }
+
+    const std::vector<PointerMapModule>& Modules() const { return modules; }
+    // 包含 address 的模块下标，不在任何模块内返回 -1
+    int FindModule(uint64_t address) const;
+
+private:
+    ThreadPool& pool;
+    std::vector<PointerMapModule> modules;     // 按基址排序
+    std::vector<uint64_t> ownedValues;
+    std::vector<uint64_t> ownedLocations;
+    MappedFile file;
+    const uint64_t* values;
+    const uint64_t* locations;
+    size_t count;
+};
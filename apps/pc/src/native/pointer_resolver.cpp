@@ -0,0 +1,227 @@
+#include "pointer_resolver.h"
+#include <algorithm>
+#include <map>
+#include "batch_read.h"
+
+PointerResolver::PointerResolver(IMemorySource& mem) : mem(mem), generation(1), nextHandle(1) {}
+
+int PointerResolver::Compile(const PointerPath& path) {
+    std::lock_guard<std::mutex> g(m);
+    int id = nextHandle++;
+    entries[id].path = path;
+    return id;
+}
+
+bool PointerResolver::Release(int handle) {
+    std::lock_guard<std::mutex> g(m);
+    return entries.erase(handle) > 0;
+}
+
+void PointerResolver::Invalidate() {
+    std::lock_guard<std::mutex> g(m);
+    ++generation;
+}
+
+bool PointerResolver::RootAddress(const PointerPath& path, uintptr_t& out) {
+    if (!path.hasModule) {
+        out = static_cast<uintptr_t>(path.baseOffset);
+        return true;
+    }
+    uintptr_t base = mem.GetModuleBaseAddress(path.module);
+    if (base == 0) return false;
+    out = base + static_cast<uintptr_t>(path.baseOffset);
+    return true;
+}
+
+bool PointerResolver::IsFresh(const Entry& e, uint64_t moduleGeneration) const {
+    return e.generation == generation && e.moduleGeneration == moduleGeneration;
+}
+
+uintptr_t PointerResolver::LevelAddress(const Entry& e, size_t level) {
+    return level == 0 ? e.root : e.levels[level - 1] + static_cast<uintptr_t>(e.path.offsets[level - 1]);
+}
+
+bool PointerResolver::ChainUnchanged(const Entry& e) {
+    const size_t n = e.levels.size();
+    if (n == 1) {
+        uintptr_t v = 0;
+        return mem.ReadMemory(e.root, &v, sizeof(v)) && v == e.levels[0];
+    }
+    thread_local std::vector<uintptr_t> values;
+    thread_local std::vector<ReadSpan> spans;
+    thread_local std::vector<uint8_t> readOk;
+    values.assign(n, 0);
+    spans.resize(n);
+    readOk.assign(n, 0);
+    for (size_t i = 0; i < n; ++i) spans[i] = { LevelAddress(e, i), &values[i], sizeof(uintptr_t) };
+    return mem.ReadSpans(spans.data(), n, readOk.data()) == n && std::equal(values.begin(), values.end(), e.levels.begin());
+}
+
+bool PointerResolver::WalkFull(Entry& e) {
+    e.generation = 0;
+    e.levels.clear();
+    if (!RootAddress(e.path, e.root)) return false;
+    uintptr_t addr = e.root;
+    for (uint64_t off : e.path.offsets) {
+        uintptr_t temp = 0;
+        if (!mem.ReadMemory(addr, &temp, sizeof(temp))) return false;
+        e.levels.push_back(temp);
+        addr = temp + static_cast<uintptr_t>(off);
+    }
+    e.resolved = addr;
+    e.generation = generation;
+    e.moduleGeneration = mem.ModuleGeneration();
+    return true;
+}
+
+bool PointerResolver::Resolve(int handle, uintptr_t& out) {
+    std::lock_guard<std::mutex> g(m);
+    auto it = entries.find(handle);
+    if (it == entries.end()) return false;
+    Entry &e = it->second;
+
+    if (IsFresh(e, mem.ModuleGeneration()) && (e.levels.empty() || ChainUnchanged(e))) {
+        out = e.resolved;
+        return true;
+    }
+    if (!WalkFull(e)) return false;
+    out = e.resolved;
+    return true;
+}
+
+bool PointerResolver::ResolvePath(const PointerPath& path, uintptr_t& out) {
+    std::lock_guard<std::mutex> g(m);
+    uintptr_t root = 0;
+    if (!RootAddress(path, root)) return false;
+    uintptr_t addr = root;
+    for (uint64_t off : path.offsets) {
+        uintptr_t temp = 0;
+        if (!mem.ReadMemory(addr, &temp, sizeof(temp))) return false;
+        addr = temp + static_cast<uintptr_t>(off);
+    }
+    out = addr;
+    return true;
+}
+
+void PointerResolver::ResolveMany(const std::vector<int>& handles, std::vector<uintptr_t>& out, std::vector<uint8_t>& ok) {
+    std::lock_guard<std::mutex> g(m);
+    const size_t n = handles.size();
+    out.assign(n, 0);
+    ok.assign(n, 0);
+
+    std::vector<Entry*> list(n, nullptr);
+    for (size_t i = 0; i < n; ++i) {
+        auto it = entries.find(handles[i]);
+        if (it != entries.end()) list[i] = &it->second;
+    }
+
+    // 第一步：仍然有效的句柄把整条链上的各级指针合并为一次批量读取，全部未变化的直接复用
+    uint64_t moduleGeneration = mem.ModuleGeneration();
+    std::vector<size_t> walk;
+    std::vector<size_t> check;
+    std::vector<ReadRequest> reqs;
+    for (size_t i = 0; i < n; ++i) {
+        Entry* e = list[i];
+        if (!e) continue;
+        if (!IsFresh(*e, moduleGeneration)) { walk.push_back(i); continue; }
+        if (e->levels.empty()) { out[i] = e->resolved; ok[i] = 1; continue; }
+        for (size_t level = 0; level < e->levels.size(); ++level) {
+            reqs.push_back({ LevelAddress(*e, level), sizeof(uintptr_t), reqs.size() * sizeof(uintptr_t) });
+        }
+        check.push_back(i);
+    }
+    if (!check.empty()) {
+        std::vector<uintptr_t> values(reqs.size());
+        std::vector<uint8_t> bits((reqs.size() + 7) / 8);
+        ReadBatch(mem, reqs.data(), reqs.size(), reinterpret_cast<uint8_t*>(values.data()), bits.data());
+        size_t r = 0;
+        for (size_t k = 0; k < check.size(); ++k) {
+            size_t i = check[k];
+            const Entry &e = *list[i];
+            bool same = true;
+            for (size_t level = 0; level < e.levels.size(); ++level, ++r) {
+                same = same && ((bits[r >> 3] >> (r & 7)) & 1) && values[r] == e.levels[level];
+            }
+            if (same) {
+                out[i] = list[i]->resolved;
+                ok[i] = 1;
+            } else {
+                walk.push_back(i);
+            }
+        }
+    }
+    if (walk.empty()) return;
+
+    // 第二步：剩余句柄逐层解析，相同前缀合并成一个节点，每层所有节点一次批量读取
+    struct Node { uintptr_t addr; uintptr_t value; bool ok; };
+    std::vector<Node> nodes;
+    std::map<std::pair<size_t, uint64_t>, size_t> index;   // (父节点, 偏移) -> 节点；根节点父为 SIZE_MAX
+    std::vector<size_t> cur(n, SIZE_MAX);
+    std::vector<std::vector<uintptr_t>> levels(n);     // 同一句柄可能在 handles 中重复出现，最后统一写回
+    size_t depth = 0;
+
+    for (size_t i : walk) {
+        Entry &e = *list[i];
+        e.generation = 0;
+        if (!RootAddress(e.path, e.root)) continue;
+        auto key = std::make_pair(SIZE_MAX, static_cast<uint64_t>(e.root));
+        auto it = index.find(key);
+        if (it == index.end()) {
+            it = index.emplace(key, nodes.size()).first;
+            nodes.push_back({ e.root, 0, false });
+        }
+        cur[i] = it->second;
+        depth = std::max(depth, e.path.offsets.size());
+    }
+
+    std::vector<size_t> pending;
+    for (size_t level = 0; level < depth; ++level) {
+        // 收集本层需要读取的唯一节点
+        pending.clear();
+        for (size_t i : walk) {
+            if (cur[i] == SIZE_MAX || list[i]->path.offsets.size() <= level) continue;
+            pending.push_back(cur[i]);
+        }
+        std::sort(pending.begin(), pending.end());
+        pending.erase(std::unique(pending.begin(), pending.end()), pending.end());
+
+        reqs.clear();
+        for (size_t k = 0; k < pending.size(); ++k) {
+            reqs.push_back({ nodes[pending[k]].addr, sizeof(uintptr_t), k * sizeof(uintptr_t) });
+        }
+        std::vector<uintptr_t> values(pending.size());
+        std::vector<uint8_t> bits((pending.size() + 7) / 8);
+        ReadBatch(mem, reqs.data(), reqs.size(), reinterpret_cast<uint8_t*>(values.data()), bits.data());
+        for (size_t k = 0; k < pending.size(); ++k) {
+            nodes[pending[k]].value = values[k];
+            nodes[pending[k]].ok = (bits[k >> 3] >> (k & 7)) & 1;
+        }
+
+        // 推进到下一层节点
+        for (size_t i : walk) {
+            if (cur[i] == SIZE_MAX || list[i]->path.offsets.size() <= level) continue;
+            const Node parent = nodes[cur[i]];
+            if (!parent.ok) { cur[i] = SIZE_MAX; continue; }
+            uint64_t off = list[i]->path.offsets[level];
+            levels[i].push_back(parent.value);
+            auto key = std::make_pair(cur[i], off);
+            auto it = index.find(key);
+            if (it == index.end()) {
+                it = index.emplace(key, nodes.size()).first;
+                nodes.push_back({ parent.value + static_cast<uintptr_t>(off), 0, false });
+            }
+            cur[i] = it->second;
+        }
+    }
+
+    for (size_t i : walk) {
+        if (cur[i] == SIZE_MAX) continue;
+        Entry &e = *list[i];
+        e.levels = levels[i];
+        e.resolved = nodes[cur[i]].addr;
+        e.generation = generation;
+        e.moduleGeneration = moduleGeneration;
+        out[i] = e.resolved;
+        ok[i] = 1;
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "memory_source.h"
+
+// 解析后的指针路径："module.dll+0x10" / 绝对地址 + 偏移列表
+struct PointerPath {
+    bool hasModule = false;
+    std::wstring module;
+    uint64_t baseOffset = 0;    // hasModule 时为模块内偏移，否则为绝对地址
+    std::vector<uint64_t> offsets;
+};
+
+/**
+ * 预编译指针路径解析器。
+ * 每个句柄缓存根地址和各级中间指针值；同一代（generation）内用一次批量读取重新读取整条链上
+ * 的各级指针（各级地址由缓存的上一级推出），全部与缓存一致时与逐级解析的结果相同，直接复用；
+ * 任何一级变化（包括中间一级被重新分配）都会重新逐级解析。相比逐级解析省去了模块基址查找，
+ * 多级路径只需一次系统调用。模块基址来自内存源的模块表（在线进程或快照）。
+ * 代号在 Invalidate()（打开/关闭进程）时递增，模块映射重建也会使缓存失效。
+ */
+class PointerResolver {
+public:
+    explicit PointerResolver(IMemorySource& mem);
+
+    int Compile(const PointerPath& path);
+    bool Release(int handle);
+
+    bool Resolve(int handle, uintptr_t& out);
+
+    // 批量解析：各路径相同的前缀只读取一次，每一层的读取合并为一次批量读取
+    void ResolveMany(const std::vector<int>& handles, std::vector<uintptr_t>& out, std::vector<uint8_t>& ok);
+
+    // 一次性解析未编译的路径（不缓存中间值）
+    bool ResolvePath(const PointerPath& path, uintptr_t& out);
+
+    void Invalidate();
+
+private:
+    struct Entry {
+        PointerPath path;
+        uint64_t generation = 0;            // 0 表示从未解析
+        uint64_t moduleGeneration = 0;
+        uintptr_t root = 0;                 // 路径起点（模块基址 + 偏移）
+        std::vector<uintptr_t> levels;      // levels[i] 为第 i 级读取到的指针值
+        uintptr_t resolved = 0;
+    };
+
+    bool RootAddress(const PointerPath& path, uintptr_t& out);
+    bool WalkFull(Entry& e);
+    bool IsFresh(const Entry& e, uint64_t moduleGeneration) const;
+    // 第 level 级指针所在的地址，由缓存的上一级指针推出
+    static uintptr_t LevelAddress(const Entry& e, size_t level);
+    // 一次批量读取各级指针并与缓存比较
+    bool ChainUnchanged(const Entry& e);
+
+    IMemorySource& mem;
+    std::mutex m;
+    std::unordered_map<int, Entry> entries;
+    uint64_t generation;
+    int nextHandle;
+};
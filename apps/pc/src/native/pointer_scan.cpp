@@ -0,0 +1,305 @@
+#include "pointer_scan.h"
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+#include "batch_read.h"
+
+namespace {
+
+// 每个并行任务处理的节点数
+constexpr size_t kNodesPerTask = 256;
+const char kResultMagic[4] = { 'X', 'P', 'S', 'R' };
+constexpr uint32_t kResultVersion = 1;
+
+struct BusyScope {
+    std::atomic<bool>& flag;
+    explicit BusyScope(std::atomic<bool>& f) : flag(f) { flag = true; }
+    ~BusyScope() { flag = false; }
+};
+
+bool ChainLess(const PointerChain& a, const PointerChain& b) {
+    if (a.module != b.module) return a.module < b.module;
+    if (a.baseOffset != b.baseOffset) return a.baseOffset < b.baseOffset;
+    if (a.depth != b.depth) return a.depth < b.depth;
+    return std::lexicographical_compare(a.offsets, a.offsets + a.depth, b.offsets, b.offsets + b.depth);
+}
+
+bool ChainEqual(const PointerChain& a, const PointerChain& b) {
+    return a.module == b.module && a.baseOffset == b.baseOffset && a.depth == b.depth
+        && std::equal(a.offsets, a.offsets + a.depth, b.offsets);
+}
+
+template<typename T>
+bool WritePod(std::FILE* f, const T& v) { return std::fwrite(&v, sizeof(T), 1, f) == 1; }
+
+template<typename T>
+bool ReadPod(std::FILE* f, T& v) { return std::fread(&v, sizeof(T), 1, f) == 1; }
+
+} // namespace
+
+PointerScanner::PointerScanner(ThreadPool& pool) : pool(pool), map(pool) {}
+
+bool PointerScanner::BuildMap(IMemorySource& src, const ModuleTable* modules, const PointerMapOptions& opts,
+                              const std::atomic<bool>* cancel) {
+    std::lock_guard<std::mutex> g(m);
+    BusyScope scope(busy);
+    return map.Build(src, modules, opts, cancel);
+}
+
+bool PointerScanner::LoadMap(const std::string& path) {
+    std::lock_guard<std::mutex> g(m);
+    return map.Load(path);
+}
+
+bool PointerScanner::SaveMap(const std::string& path) const {
+    std::lock_guard<std::mutex> g(m);
+    return map.Save(path);
+}
+
+size_t PointerScanner::MapSize() const {
+    std::lock_guard<std::mutex> g(m);
+    return map.Count();
+}
+
+size_t PointerScanner::Scan(uint64_t target, const PointerScanOptions& opts, const std::atomic<bool>* cancel) {
+    std::lock_guard<std::mutex> g(m);
+    BusyScope scope(busy);
+    if (map.Empty()) return chains.size();
+    const uint32_t maxDepth = std::max<uint32_t>(1, std::min(opts.maxDepth, kMaxPointerDepth));
+    const auto &mods = map.Modules();
+
+    // levels[d] 为第 d 层节点：address 处保存的指针加上 offset 等于父节点地址
+    struct Node {
+        uint64_t address;
+        uint32_t parent;
+        uint32_t offset;
+    };
+    std::vector<std::vector<Node>> levels(1);
+    levels[0].push_back({ target, 0, 0 });
+    std::unordered_set<uint64_t> visited{ target };
+    std::vector<PointerChain> found;
+    std::atomic<size_t> foundCount{ 0 };
+
+    for (uint32_t d = 1; d <= maxDepth && !levels[d - 1].empty(); ++d) {
+        if (cancel && cancel->load()) return chains.size();
+        const auto &frontier = levels[d - 1];
+        const size_t tasks = (frontier.size() + kNodesPerTask - 1) / kNodesPerTask;
+        std::vector<std::vector<Node>> nextParts(tasks);
+        std::vector<std::vector<PointerChain>> chainParts(tasks);
+        pool.ParallelFor(tasks, [&](size_t t) {
+            if (cancel && cancel->load()) return;
+            size_t end = std::min(frontier.size(), (t + 1) * kNodesPerTask);
+            for (size_t idx = t * kNodesPerTask; idx < end; ++idx) {
+                uint64_t a = frontier[idx].address;
+                size_t first, last;
+                map.FindRange(a >= opts.maxOffset ? a - opts.maxOffset : 0, a, first, last);
+                for (size_t i = first; i < last; ++i) {
+                    uint64_t loc = map.LocationAt(i);
+                    uint32_t off = static_cast<uint32_t>(a - map.ValueAt(i));
+                    int mod = map.FindModule(loc);
+                    if (mod < 0) {
+                        if (d < maxDepth) nextParts[t].push_back({ loc, static_cast<uint32_t>(idx), off });
+                        continue;
+                    }
+                    // 落在模块内：沿父节点回溯得到完整路径，offsets 从外到内
+                    if (foundCount.fetch_add(1) >= opts.maxResults) continue;
+                    PointerChain c{};
+                    c.module = static_cast<uint32_t>(mod);
+                    c.depth = d;
+                    c.baseOffset = loc - mods[mod].base;
+                    c.offsets[0] = off;
+                    uint32_t k = 1;
+                    size_t p = idx;
+                    for (uint32_t lv = d - 1; lv >= 1; --lv) {
+                        const Node &n = levels[lv][p];
+                        c.offsets[k++] = n.offset;
+                        p = n.parent;
+                    }
+                    chainParts[t].push_back(c);
+                }
+            }
+        });
+
+        for (auto &part : chainParts) found.insert(found.end(), part.begin(), part.end());
+        if (d == maxDepth || foundCount.load() >= opts.maxResults) break;
+
+        // 下一层去重：每个地址只展开一次
+        std::vector<Node> next;
+        for (auto &part : nextParts) next.insert(next.end(), part.begin(), part.end());
+        std::sort(next.begin(), next.end(), [](const Node& x, const Node& y) { return x.address < y.address; });
+        size_t kept = 0;
+        for (size_t i = 0; i < next.size(); ++i) {
+            if (kept && next[kept - 1].address == next[i].address) continue;
+            if (!visited.insert(next[i].address).second) continue;
+            next[kept++] = next[i];
+        }
+        next.resize(kept);
+        levels.push_back(std::move(next));
+    }
+    if (cancel && cancel->load()) return chains.size();
+    if (found.size() > opts.maxResults) found.resize(opts.maxResults);
+
+    std::vector<std::wstring> names;
+    for (const auto &mod : mods) names.push_back(mod.name);
+    std::sort(found.begin(), found.end(), ChainLess);
+    if (opts.intersect && !moduleNames.empty()) {
+        IntersectWith(found, names);
+    } else {
+        chains.swap(found);
+        moduleNames.swap(names);
+    }
+    return chains.size();
+}
+
+void PointerScanner::IntersectWith(std::vector<PointerChain>& fresh, const std::vector<std::wstring>& freshNames) {
+    // 按模块名（不区分大小写）把 fresh 的模块下标换算为当前下标，不存在的模块无法匹配
+    std::unordered_map<std::wstring, uint32_t> index;
+    for (uint32_t i = 0; i < moduleNames.size(); ++i) index.emplace(ModuleTable::NormalizeName(moduleNames[i]), i);
+    size_t kept = 0;
+    for (auto &c : fresh) {
+        auto it = index.find(ModuleTable::NormalizeName(freshNames[c.module]));
+        if (it == index.end()) continue;
+        c.module = it->second;
+        fresh[kept++] = c;
+    }
+    fresh.resize(kept);
+    std::sort(fresh.begin(), fresh.end(), ChainLess);
+
+    std::vector<PointerChain> out;
+    std::set_intersection(chains.begin(), chains.end(), fresh.begin(), fresh.end(), std::back_inserter(out),
+        [](const PointerChain& a, const PointerChain& b) { return ChainLess(a, b); });
+    out.erase(std::unique(out.begin(), out.end(), ChainEqual), out.end());
+    chains.swap(out);
+}
+
+size_t PointerScanner::Filter(IMemorySource& src, const ModuleTable* modules, uint64_t target) {
+    std::lock_guard<std::mutex> g(m);
+    BusyScope scope(busy);
+    if (!modules) {
+        chains.clear();
+        return 0;
+    }
+
+    // 每条路径当前解析到的地址；模块不存在的路径直接丢弃
+    std::vector<uint64_t> addrs(chains.size(), 0);
+    std::vector<uint8_t> alive(chains.size(), 0);
+    for (size_t i = 0; i < chains.size(); ++i) {
+        const ModuleInfo* mod = modules->Find(moduleNames[chains[i].module]);
+        if (!mod) continue;
+        addrs[i] = mod->base + chains[i].baseOffset;
+        alive[i] = 1;
+    }
+
+    // 逐层批量读取，每层只读取仍然存活的路径
+    std::vector<ReadRequest> reqs;
+    std::vector<size_t> owners;
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> bits;
+    for (uint32_t level = 0; level < kMaxPointerDepth; ++level) {
+        reqs.clear();
+        owners.clear();
+        for (size_t i = 0; i < chains.size(); ++i) {
+            if (!alive[i] || chains[i].depth <= level) continue;
+            reqs.push_back({ static_cast<uintptr_t>(addrs[i]), sizeof(uintptr_t), owners.size() * sizeof(uintptr_t) });
+            owners.push_back(i);
+        }
+        if (reqs.empty()) break;
+        data.assign(reqs.size() * sizeof(uintptr_t), 0);
+        bits.assign((reqs.size() + 7) / 8, 0);
+        ReadBatch(src, reqs.data(), reqs.size(), data.data(), bits.data());
+        for (size_t k = 0; k < owners.size(); ++k) {
+            size_t i = owners[k];
+            if (!((bits[k >> 3] >> (k & 7)) & 1)) {
+                alive[i] = 0;
+                continue;
+            }
+            uintptr_t v;
+            std::memcpy(&v, data.data() + k * sizeof(uintptr_t), sizeof(v));
+            addrs[i] = static_cast<uint64_t>(v) + chains[i].offsets[level];
+        }
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < chains.size(); ++i) {
+        if (alive[i] && addrs[i] == target) chains[kept++] = chains[i];
+    }
+    chains.resize(kept);
+    return kept;
+}
+
+size_t PointerScanner::Count() const {
+    std::lock_guard<std::mutex> g(m);
+    return chains.size();
+}
+
+size_t PointerScanner::GetResults(size_t offset, size_t count, std::vector<PointerChain>& out) const {
+    std::lock_guard<std::mutex> g(m);
+    out.clear();
+    if (offset >= chains.size()) return 0;
+    size_t end = std::min(chains.size(), offset + count);
+    out.assign(chains.begin() + offset, chains.begin() + end);
+    return out.size();
+}
+
+std::wstring PointerScanner::ModuleName(uint32_t module) const {
+    std::lock_guard<std::mutex> g(m);
+    return module < moduleNames.size() ? moduleNames[module] : std::wstring();
+}
+
+void PointerScanner::Reset() {
+    std::lock_guard<std::mutex> g(m);
+    chains.clear();
+    moduleNames.clear();
+}
+
+// 文件格式："XPSR" | version | moduleCount | { nameLen:u32 name:u16[] } | count:u64 | PointerChain[count]
+bool PointerScanner::SaveResults(const std::string& path) const {
+    std::lock_guard<std::mutex> g(m);
+    std::FILE* f = OpenFileUtf8(path, "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(kResultMagic, 1, 4, f) == 4 && WritePod(f, kResultVersion)
+        && WritePod(f, static_cast<uint32_t>(moduleNames.size()));
+    for (size_t i = 0; ok && i < moduleNames.size(); ++i) {
+        std::vector<uint16_t> name(moduleNames[i].begin(), moduleNames[i].end());
+        ok = WritePod(f, static_cast<uint32_t>(name.size()))
+            && (name.empty() || std::fwrite(name.data(), 2, name.size(), f) == name.size());
+    }
+    ok = ok && WritePod(f, static_cast<uint64_t>(chains.size()))
+        && (chains.empty() || std::fwrite(chains.data(), sizeof(PointerChain), chains.size(), f) == chains.size());
+    return std::fclose(f) == 0 && ok;
+}
+
+bool PointerScanner::LoadResults(const std::string& path) {
+    std::lock_guard<std::mutex> g(m);
+    std::FILE* f = OpenFileUtf8(path, "rb");
+    if (!f) return false;
+    char magic[4];
+    uint32_t version = 0, moduleCount = 0;
+    uint64_t n = 0;
+    std::vector<std::wstring> names;
+    std::vector<PointerChain> loaded;
+    bool ok = std::fread(magic, 1, 4, f) == 4 && std::memcmp(magic, kResultMagic, 4) == 0
+        && ReadPod(f, version) && version == kResultVersion && ReadPod(f, moduleCount) && moduleCount < 65536;
+    for (uint32_t i = 0; ok && i < moduleCount; ++i) {
+        uint32_t len = 0;
+        ok = ReadPod(f, len) && len < 32768;
+        std::vector<uint16_t> name(ok ? len : 0);
+        ok = ok && (len == 0 || std::fread(name.data(), 2, len, f) == len);
+        names.emplace_back(name.begin(), name.end());
+    }
+    ok = ok && ReadPod(f, n) && n < (1ull << 32);
+    if (ok) {
+        loaded.resize(static_cast<size_t>(n));
+        ok = n == 0 || std::fread(loaded.data(), sizeof(PointerChain), loaded.size(), f) == loaded.size();
+    }
+    std::fclose(f);
+    for (const auto &c : loaded) {
+        if (!ok) break;
+        ok = c.module < names.size() && c.depth >= 1 && c.depth <= kMaxPointerDepth;
+    }
+    if (!ok) return false;
+    moduleNames.swap(names);
+    chains.swap(loaded);
+    return true;
+}
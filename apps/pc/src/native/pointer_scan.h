@@ -0,0 +1,73 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "memory_source.h"
+#include "module_map.h"
+#include "pointer_map.h"
+#include "thread_pool.h"
+
+constexpr uint32_t kMaxPointerDepth = 8;
+
+struct PointerScanOptions {
+    uint32_t maxDepth = 5;          // 最多几级指针
+    uint32_t maxOffset = 0x1000;    // 每级允许的最大偏移
+    size_t maxResults = 1000000;
+    bool intersect = false;         // 与上一次的结果求交集，而不是替换
+};
+
+// 一条指针路径：modules[module]+baseOffset，依次读取并加上 offsets[0..depth)
+struct PointerChain {
+    uint32_t module;
+    uint32_t depth;
+    uint64_t baseOffset;
+    uint32_t offsets[kMaxPointerDepth];
+};
+
+/**
+ * 指针扫描器：在 PointerMap 上从目标地址向回做分层 BFS，
+ * 每层的节点分给线程池并行查找"指向本节点附近"的位置，
+ * 位置落在模块映像内时得到一条以模块为起点的路径。
+ * 每个中间地址只展开一次（先到达的路径最短），避免路径数量指数增长。
+ * 结果可保存/加载，可与另一次扫描求交集，也可对当前进程重新验证（只读取路径上的指针）。
+ */
+class PointerScanner {
+public:
+    explicit PointerScanner(ThreadPool& pool = ThreadPool::Shared());
+
+    bool BuildMap(IMemorySource& src, const ModuleTable* modules, const PointerMapOptions& opts,
+                  const std::atomic<bool>* cancel = nullptr);
+    bool LoadMap(const std::string& path);
+    bool SaveMap(const std::string& path) const;
+    size_t MapSize() const;
+
+    // 返回结果数量；被取消时保留原有结果
+    size_t Scan(uint64_t target, const PointerScanOptions& opts, const std::atomic<bool>* cancel = nullptr);
+
+    // 在当前进程中逐条解析，只保留仍然指向 target 的路径，返回剩余数量
+    size_t Filter(IMemorySource& src, const ModuleTable* modules, uint64_t target);
+
+    size_t Count() const;
+    size_t GetResults(size_t offset, size_t count, std::vector<PointerChain>& out) const;
+    std::wstring ModuleName(uint32_t module) const;
+
+    bool SaveResults(const std::string& path) const;
+    bool LoadResults(const std::string& path);
+    void Reset();
+
+    bool Busy() const { return busy.load(); }
+
+private:
+    // 把 fresh 的模块下标换算到当前名称表后与当前结果求交集，结果保存在 chains
+    void IntersectWith(std::vector<PointerChain>& fresh, const std::vector<std::wstring>& freshNames);
+
+    ThreadPool& pool;
+    mutable std::mutex m;
+    std::atomic<bool> busy{ false };
+    PointerMap map;
+    std::vector<std::wstring> moduleNames;      // 结果中的 module 为此处下标
+    std::vector<PointerChain> chains;
+};
@@ -1,10 +1,22 @@
-﻿#include <windows.h>
-#include <tlhelp32.h>
-#include <psapi.h>
-#include <tchar.h>
+﻿#include "process.h"
 #include <string>
-#include <iostream>
-#include "process.h"
+#ifdef _WIN32
+#include <windows.h>
+#include <tlhelp32.h>
+#else
+#include <cstdio>
+#include <cstdlib>
+#include <cwchar>
+#include <dirent.h>
+#include <unistd.h>
+#include "utf8.h"
+#endif
+
+#ifdef _WIN32
+
+bool EnumerateProcessesIncremental(const std::function<bool(uint32_t pid)>&, const ProcessCallback& callback) {
+    return EnumerateProcesses(callback);
+}
 
 bool EnumerateProcesses(const ProcessCallback& callback) {
     HANDLE snap = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
@@ -16,7 +28,8 @@ bool EnumerateProcesses(const ProcessCallback& callback) {
     bool success = true;
     if (Process32FirstW(snap, &pe)) {
         do {
-            if (!callback(pe)) {
+            ProcessEntry entry{ static_cast<uint32_t>(pe.th32ProcessID), pe.szExeFile };
+            if (!callback(entry)) {
                 break; // 回调返回false，停止遍历
             }
         } while (Process32NextW(snap, &pe));
@@ -28,12 +41,100 @@ bool EnumerateProcesses(const ProcessCallback& callback) {
     return success;
 }
 
+bool QueryProcessPath(uint32_t pid, std::wstring& out) {
+    HANDLE hProcess = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+    if (!hProcess) return false;
+    wchar_t exePath[MAX_PATH];
+    DWORD size = MAX_PATH;
+    bool ok = QueryFullProcessImageNameW(hProcess, 0, exePath, &size) != 0;
+    if (ok) out.assign(exePath, size);
+    CloseHandle(hProcess);
+    return ok;
+}
+
+bool ProcessNameEquals(const std::wstring& a, const std::wstring& b) {
+    return _wcsicmp(a.c_str(), b.c_str()) == 0;
+}
+
+#else
+
+// /proc/<pid>/cmdline 的第一个参数
+static bool ReadArgv0(uint32_t pid, std::string& out) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "/proc/%u/cmdline", pid);
+    std::FILE* f = std::fopen(name, "rb");
+    if (!f) return false;
+    char buf[4096];
+    size_t n = std::fread(buf, 1, sizeof(buf) - 1, f);
+    std::fclose(f);
+    buf[n] = 0;
+    out = buf;
+    return !out.empty();
+}
+
+static std::string ExeNameOf(uint32_t pid) {
+    std::string arg;
+    if (ReadArgv0(pid, arg)) {
+        // Wine/Proton 下为 Windows 路径
+        size_t p = arg.find_last_of("/\\");
+        return p == std::string::npos ? arg : arg.substr(p + 1);
+    }
+    char name[64];
+    std::snprintf(name, sizeof(name), "/proc/%u/comm", pid);
+    std::FILE* f = std::fopen(name, "r");
+    if (!f) return std::string();
+    char buf[64] = {};
+    if (std::fgets(buf, sizeof(buf), f)) arg = buf;
+    std::fclose(f);
+    while (!arg.empty() && arg.back() == '\n') arg.pop_back();
+    return arg;
+}
+
+bool EnumerateProcessesIncremental(const std::function<bool(uint32_t pid)>& known, const ProcessCallback& callback) {
+    DIR* dir = opendir("/proc");
+    if (!dir) return false;
+    while (struct dirent* d = readdir(dir)) {
+        char* end = nullptr;
+        unsigned long pid = std::strtoul(d->d_name, &end, 10);
+        if (pid == 0 || *end != 0) continue;
+        ProcessEntry entry{ static_cast<uint32_t>(pid), std::wstring() };
+        if (!known || !known(entry.pid)) {
+            std::string name = ExeNameOf(entry.pid);
+            if (name.empty()) continue; // 内核线程
+            entry.exeName = Utf8ToWstring(name);
+        }
+        if (!callback(entry)) break;
+    }
+    closedir(dir);
+    return true;
+}
+
+bool EnumerateProcesses(const ProcessCallback& callback) {
+    return EnumerateProcessesIncremental(nullptr, callback);
+}
+
+bool QueryProcessPath(uint32_t pid, std::wstring& out) {
+    char name[64];
+    char buf[4096];
+    std::snprintf(name, sizeof(name), "/proc/%u/exe", pid);
+    ssize_t n = readlink(name, buf, sizeof(buf) - 1);
+    if (n <= 0) return false;
+    out = Utf8ToWstring(std::string(buf, static_cast<size_t>(n)));
+    return true;
+}
+
+bool ProcessNameEquals(const std::wstring& a, const std::wstring& b) {
+    return a == b;
+}
+
+#endif
+
 uint32_t FindPidByName(const std::wstring& exeName) {
     uint32_t foundPid = 0;
 
-    EnumerateProcesses([&](const PROCESSENTRY32W& pe) -> bool {
-        if (exeName == pe.szExeFile) {
-            foundPid = pe.th32ProcessID;
+    EnumerateProcesses([&](const ProcessEntry& pe) -> bool {
+        if (exeName == pe.exeName) {
+            foundPid = pe.pid;
             return false; // 找到了，停止遍历
         }
         return true; // 继续遍历
@@ -42,47 +143,27 @@ uint32_t FindPidByName(const std::wstring& exeName) {
     return foundPid;
 }
 
-uint32_t OpenProcessByPid(uint32_t pid, HANDLE& outHandle, uint32_t access) {
-    HANDLE h = OpenProcess(access, FALSE, pid);
-    if (!h) {
-        outHandle = nullptr;
-        return 0;
-    }
-    outHandle = h;
-    return pid;
-}
-
-uint32_t OpenProcessByName(const std::wstring& exeName, HANDLE& outHandle, uint32_t access) {
-    uint32_t pid = FindPidByName(exeName);
-    if (!pid) {
-        outHandle = nullptr;
-        return 0;
-    }
-    return OpenProcessByPid(pid, outHandle, access);
+bool ProcessMatchesPath(uint32_t pid, const std::wstring& exePath) {
+    std::wstring runningPath;
+    if (QueryProcessPath(pid, runningPath) && ProcessNameEquals(runningPath, exePath)) return true;
+#ifndef _WIN32
+    // Wine/Proton 进程的 exe 链接指向加载器，改为比较命令行中的路径
+    std::string arg;
+    if (ReadArgv0(pid, arg) && Utf8ToWstring(arg) == exePath) return true;
+#endif
+    return false;
 }
 
 bool IsRunning(const std::wstring& targetExeName, const std::wstring& targetExePath) {
     bool found = false;
 
-    EnumerateProcesses([&](const PROCESSENTRY32W& pe32) -> bool {
+    EnumerateProcesses([&](const ProcessEntry& pe) -> bool {
         // 先对比进程名
-        if (_wcsicmp(pe32.szExeFile, targetExeName.c_str()) == 0) {
-            // 打开进程
-            HANDLE hProcess = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pe32.th32ProcessID);
-            if (hProcess) {
-                wchar_t exePath[MAX_PATH];
-                DWORD size = MAX_PATH;
-                if (QueryFullProcessImageNameW(hProcess, 0, exePath, &size)) {
-                    std::wstring runningPath(exePath);
-                    // 校验路径是否一致
-                    if (_wcsicmp(runningPath.c_str(), targetExePath.c_str()) == 0) {
-                        found = true;
-                        CloseHandle(hProcess);
-                        return false; // 找到目标进程，停止遍历
-                    }
-                }
-                CloseHandle(hProcess);
-            }
+        if (!ProcessNameEquals(pe.exeName, targetExeName)) return true;
+        // 校验路径是否一致
+        if (ProcessMatchesPath(pe.pid, targetExePath)) {
+            found = true;
+            return false; // 找到目标进程，停止遍历
         }
         return true; // 继续遍历
     });
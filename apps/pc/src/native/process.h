@@ -1,23 +1,57 @@
 ﻿#pragma once
+#include <cstdint>
 #include <string>
-#include <windows.h>
 #include <functional>
-#include <TlHelp32.h>
+
+// 进程列表中的一项；Linux 下 exeName 取命令行第一个参数的文件名（Wine/Proton 下为 Windows 可执行文件名）
+struct ProcessEntry {
+    uint32_t pid;
+    std::wstring exeName;
+};
 
 /**
  * 进程遍历回调函数类型
- * @param pe32 进程信息结构体
+ * @param entry 进程信息
  * @return 返回true继续遍历，返回false停止遍历
  */
-using ProcessCallback = std::function<bool(const PROCESSENTRY32W& pe32)>;
+using ProcessCallback = std::function<bool(const ProcessEntry& entry)>;
 
 /**
  * 遍历所有进程并对每个进程执行回调函数
+ * Windows 使用 Toolhelp32 快照，Linux 遍历 /proc
  * @param callback 对每个进程执行的回调函数
  * @return 成功返回true，失败返回false
  */
 bool EnumerateProcesses(const ProcessCallback& callback);
 
+/**
+ * 增量遍历：known(pid) 返回 true 的进程不再获取名称，回调收到的 exeName 为空
+ * Windows 快照自带名称，known 被忽略；Linux 下名称需要读取 /proc/<pid>/cmdline，跳过已知进程可省去这部分开销
+ * @param known 判断 PID 是否已知
+ * @param callback 对每个进程执行的回调函数
+ * @return 成功返回true，失败返回false
+ */
+bool EnumerateProcessesIncremental(const std::function<bool(uint32_t pid)>& known, const ProcessCallback& callback);
+
+/**
+ * 查询进程可执行文件的完整路径
+ * @param pid 进程ID
+ * @param out 输出参数，存储路径
+ * @return 成功返回true
+ */
+bool QueryProcessPath(uint32_t pid, std::wstring& out);
+
+/**
+ * 检查进程的可执行文件路径是否为 exePath
+ * Linux 下同时比较命令行中的路径（Wine/Proton 进程的 exe 链接指向加载器）
+ */
+bool ProcessMatchesPath(uint32_t pid, const std::wstring& exePath);
+
+/**
+ * 比较进程名：Windows 不区分大小写，Linux 区分
+ */
+bool ProcessNameEquals(const std::wstring& a, const std::wstring& b);
+
 /**
  * 检查指定名称和路径的进程是否正在运行
  * @param targetExeName 目标进程的可执行文件名（如 "notepad.exe"）
@@ -32,20 +66,3 @@ bool IsRunning(const std::wstring& targetExeName, const std::wstring& targetExeP
  * @return 进程ID，如果未找到返回0
  */
 uint32_t FindPidByName(const std::wstring& exeName);
-
-/**
- * 根据进程ID打开进程
- * @param pid 进程ID
- * @param access 访问权限，默认为PROCESS_ALL_ACCESS
- * @return 成功返回进程ID，失败返回0，并将进程句柄存储在outHandle中
- */
-uint32_t OpenProcessByPid(uint32_t pid, HANDLE& outHandle, uint32_t access = PROCESS_ALL_ACCESS);
-
-/**
- * 根据进程名打开进程
- * @param exeName 进程可执行文件名
- * @param outHandle 输出参数，存储进程句柄
- * @param access 访问权限，默认为PROCESS_ALL_ACCESS
- * @return 成功返回进程ID，失败返回0
- */
-uint32_t OpenProcessByName(const std::wstring& exeName, HANDLE& outHandle, uint32_t access = PROCESS_ALL_ACCESS);
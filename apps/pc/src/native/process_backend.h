@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "memory_source.h"
+#include "module_map.h"
+
+// 默认访问权限，数值同 Windows 的 PROCESS_ALL_ACCESS；其他平台忽略
+constexpr uint32_t kProcessAllAccess = 0x001FFFFF;
+
+/**
+ * 平台相关的进程访问层：打开进程、读写内存、枚举区域和模块。
+ * IMemory 在此之上实现区域缓存、批量写入事务、锁定等与平台无关的逻辑。
+ * Windows 使用 ReadProcessMemory/VirtualQueryEx/Toolhelp32，
+ * Linux 使用 process_vm_readv/writev 与 /proc/<pid>/maps（也适用于 Proton/Wine 下的游戏）。
+ */
+class ProcessBackend {
+public:
+    virtual ~ProcessBackend() = default;
+
+    virtual bool Open(uint32_t pid, uint32_t access) = 0;
+    virtual void Close() = 0;
+    virtual bool IsOpen() const = 0;
+
+    // 完整读写才返回 true；Write 不修改页面保护属性
+    virtual bool Read(uintptr_t address, void* buffer, size_t size) = 0;
+    virtual bool Write(uintptr_t address, const void* buffer, size_t size) = 0;
+
+    // 分散读取，语义同 IMemorySource::ReadSpans；默认逐段 Read
+    virtual size_t ReadSpans(const ReadSpan* spans, size_t count, uint8_t* ok) {
+        size_t n = 0;
+        for (size_t i = 0; i < count; ++i) {
+            ok[i] = Read(spans[i].address, spans[i].buffer, spans[i].size) ? 1 : 0;
+            n += ok[i];
+        }
+        return n;
+    }
+
+    // 已提交且可读的区域，属性相同的相邻区域合并，按地址升序
+    virtual bool QueryRegions(std::vector<MemoryRegion>& out) = 0;
+    // 所有已提交或保留的区域（含不可访问的），属性相同的相邻区域合并，按地址升序；未分配的空洞不列出
+    virtual bool QueryAllRegions(std::vector<MemoryRegion>& out) = 0;
+    // address 所在的区域；未提交或不可访问时 flags 为 0
+    virtual bool QueryRegionAt(uintptr_t address, MemoryRegion& out) = 0;
+
+    // 临时把页面改为可写（executable 时保留可执行），oldProtect 用于恢复；不支持时返回 false
+    virtual bool MakeWritable(uintptr_t address, size_t size, bool executable, uint32_t& oldProtect) = 0;
+    virtual void RestoreProtection(uintptr_t address, size_t size, uint32_t oldProtect) = 0;
+
+    // 模块列表（不含节表），以及变化检测用的廉价指纹（不支持时返回 0）
+    virtual bool EnumModules(std::vector<ModuleInfo>& out) = 0;
+    virtual uint64_t ModuleFingerprint() = 0;
+
+    virtual bool InjectShellcode(const std::vector<uint8_t>& code, uintptr_t& remoteAddr, uint32_t& threadId) = 0;
+};
+
+// 当前平台的实现
+std::unique_ptr<ProcessBackend> CreateProcessBackend();
@@ -0,0 +1,306 @@
+#include "process_backend.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "utf8.h"
+
+namespace {
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+// /proc/<pid>/maps 中的一行
+struct MapsEntry {
+    uintptr_t start;
+    uintptr_t end;
+    char perms[5];
+    uint64_t offset;
+    uint64_t inode;
+    std::string path;
+};
+
+bool ReadMaps(uint32_t pid, std::vector<MapsEntry>& out) {
+    out.clear();
+    char name[64];
+    std::snprintf(name, sizeof(name), "/proc/%u/maps", pid);
+    std::FILE* f = std::fopen(name, "r");
+    if (!f) return false;
+    char line[4096 + 128];
+    while (std::fgets(line, sizeof(line), f)) {
+        MapsEntry e;
+        unsigned long start = 0, end = 0;
+        unsigned long long offset = 0, inode = 0;
+        int pathPos = 0;
+        if (std::sscanf(line, "%lx-%lx %4s %llx %*s %llu %n", &start, &end, e.perms, &offset, &inode, &pathPos) < 5) continue;
+        e.start = start;
+        e.end = end;
+        e.offset = offset;
+        e.inode = inode;
+        if (pathPos > 0) {
+            e.path = line + pathPos;
+            while (!e.path.empty() && (e.path.back() == '\n' || e.path.back() == ' ')) e.path.pop_back();
+        }
+        out.push_back(std::move(e));
+    }
+    std::fclose(f);
+    return true;
+}
+
+// 把 maps 条目转换为平台无关的区域描述；不可读或读不出内容的伪映射没有 RegionReadable
+MemoryRegion RegionFromMaps(const MapsEntry& e) {
+    uint32_t prot = (e.perms[0] == 'r' ? PROT_READ : 0) | (e.perms[1] == 'w' ? PROT_WRITE : 0)
+        | (e.perms[2] == 'x' ? PROT_EXEC : 0);
+    MemoryRegion r{ e.start, e.end - e.start, 0, prot };
+    if (e.inode == 0) r.flags |= RegionPrivate;
+    else if (e.perms[3] == 's') r.flags |= RegionMapped;
+    else r.flags |= RegionImage;    // 文件的私有映射：可执行文件、共享库以及 Wine 加载的 PE 映像
+    // PROT_NONE 的映射通常用于保留地址范围（Wine 的 MEM_RESERVE、线程栈的保护页）
+    r.flags |= prot ? RegionCommitted : RegionReserved;
+    if (!(prot & PROT_READ) || e.path == "[vvar]" || e.path == "[vsyscall]") return r;
+
+    r.flags |= RegionReadable;
+    if (prot & PROT_WRITE) r.flags |= RegionWritable;
+    if (prot & PROT_EXEC) r.flags |= RegionExecutable;
+    return r;
+}
+
+std::string BaseName(const std::string& path) {
+    size_t p = path.find_last_of('/');
+    return p == std::string::npos ? path : path.substr(p + 1);
+}
+
+class LinuxProcessBackend : public ProcessBackend {
+public:
+    LinuxProcessBackend() : pid(0), memFd(-1) {}
+    ~LinuxProcessBackend() override { Close(); }
+
+    bool Open(uint32_t targetPid, uint32_t) override {
+        std::unique_lock<std::shared_mutex> g(m);
+        CloseLocked();
+        char name[64];
+        std::snprintf(name, sizeof(name), "/proc/%u", targetPid);
+        struct stat st;
+        if (targetPid == 0 || stat(name, &st) != 0) return false;
+        pid = targetPid;
+        // /proc/<pid>/mem 用于写入只读页（内核会强制写入），也是 process_vm_* 不可用时的后备
+        std::snprintf(name, sizeof(name), "/proc/%u/mem", targetPid);
+        memFd = open(name, O_RDWR | O_CLOEXEC);
+        if (memFd < 0) memFd = open(name, O_RDONLY | O_CLOEXEC);
+        return true;
+    }
+
+    void Close() override {
+        std::unique_lock<std::shared_mutex> g(m);
+        CloseLocked();
+    }
+
+    bool IsOpen() const override {
+        std::shared_lock<std::shared_mutex> g(m);
+        return pid != 0;
+    }
+
+    bool Read(uintptr_t address, void* buffer, size_t size) override {
+        std::shared_lock<std::shared_mutex> g(m);
+        return ReadLocked(address, buffer, size);
+    }
+
+    // 一次 process_vm_readv 提交最多 IOV_MAX 段；内核在第一个失败的段处停止，
+    // 由返回的字节数确定已完成的段，跳过失败段后继续提交剩余部分
+    size_t ReadSpans(const ReadSpan* spans, size_t count, uint8_t* ok) override {
+        std::shared_lock<std::shared_mutex> g(m);
+        if (!pid) {
+            std::memset(ok, 0, count);
+            return 0;
+        }
+        thread_local std::vector<struct iovec> local;
+        thread_local std::vector<struct iovec> remote;
+        size_t done = 0;
+        size_t i = 0;
+        while (i < count) {
+            size_t n = std::min<size_t>(count - i, IOV_MAX);
+            local.resize(n);
+            remote.resize(n);
+            for (size_t k = 0; k < n; ++k) {
+                local[k] = { spans[i + k].buffer, spans[i + k].size };
+                remote[k] = { reinterpret_cast<void*>(spans[i + k].address), spans[i + k].size };
+            }
+            ssize_t got = process_vm_readv(static_cast<pid_t>(pid), local.data(), n, remote.data(), n, 0);
+            if (got < 0) {
+                if (errno == ENOSYS) {
+                    // 逐段读取；已持有锁，不能再调用 Read
+                    for (; i < count; ++i) {
+                        ok[i] = ReadLocked(spans[i].address, spans[i].buffer, spans[i].size) ? 1 : 0;
+                        done += ok[i];
+                    }
+                    return done;
+                }
+                // 第一段就失败
+                ok[i++] = 0;
+                continue;
+            }
+            size_t bytes = static_cast<size_t>(got);
+            size_t k = 0;
+            while (k < n && spans[i + k].size <= bytes) {
+                bytes -= spans[i + k].size;
+                ok[i + k] = 1;
+                ++done;
+                ++k;
+            }
+            if (k < n) ok[i + k++] = 0;  // 读取在此段中断
+            i += k;
+        }
+        return done;
+    }
+
+    bool Write(uintptr_t address, const void* buffer, size_t size) override {
+        std::shared_lock<std::shared_mutex> g(m);
+        if (!pid) return false;
+        if (size == 0) return true;
+        struct iovec local = { const_cast<void*>(buffer), size };
+        struct iovec remote = { reinterpret_cast<void*>(address), size };
+        if (process_vm_writev(static_cast<pid_t>(pid), &local, 1, &remote, 1, 0) == static_cast<ssize_t>(size)) return true;
+        // 只读页（代码段等）process_vm_writev 会失败，/proc/<pid>/mem 可以写入
+        if (memFd < 0) return false;
+        return pwrite(memFd, buffer, size, static_cast<off_t>(address)) == static_cast<ssize_t>(size);
+    }
+
+    bool QueryRegions(std::vector<MemoryRegion>& out) override {
+        std::shared_lock<std::shared_mutex> g(m);
+        return EnumRegions(out, true);
+    }
+
+    bool QueryAllRegions(std::vector<MemoryRegion>& out) override {
+        std::shared_lock<std::shared_mutex> g(m);
+        return EnumRegions(out, false);
+    }
+
+    bool QueryRegionAt(uintptr_t address, MemoryRegion& out) override {
+        std::shared_lock<std::shared_mutex> g(m);
+        std::vector<MapsEntry> maps;
+        if (!pid || !ReadMaps(pid, maps)) return false;
+        auto it = std::upper_bound(maps.begin(), maps.end(), address,
+            [](uintptr_t a, const MapsEntry& e) { return a < e.start; });
+        if (it != maps.begin() && address < std::prev(it)->end) {
+            out = RegionFromMaps(*std::prev(it));
+            return true;
+        }
+        // 未映射的空洞
+        uintptr_t lo = it == maps.begin() ? 0 : std::prev(it)->end;
+        uintptr_t hi = it == maps.end() ? UINTPTR_MAX : it->start;
+        out = { lo, hi - lo, 0, 0 };
+        return true;
+    }
+
+    // 无法修改其他进程的页面保护；Write 通过 /proc/<pid>/mem 直接写入只读页
+    bool MakeWritable(uintptr_t, size_t, bool, uint32_t&) override { return false; }
+    void RestoreProtection(uintptr_t, size_t, uint32_t) override {}
+
+    // 文件映射按路径归并为模块：从偏移 0 的映射开始，到同一文件的最后一个映射结束
+    bool EnumModules(std::vector<ModuleInfo>& out) override {
+        std::shared_lock<std::shared_mutex> g(m);
+        std::vector<MapsEntry> maps;
+        if (!pid || !ReadMaps(pid, maps)) return false;
+        std::unordered_map<std::string, size_t> byPath;
+        for (const auto &e : maps) {
+            if (e.inode == 0 || e.path.empty() || e.path[0] != '/') continue;
+            auto it = byPath.find(e.path);
+            if (it == byPath.end()) {
+                if (e.offset != 0) continue;
+                std::string path = e.path;
+                const char kDeleted[] = " (deleted)";
+                if (path.size() > sizeof(kDeleted) - 1
+                    && path.compare(path.size() - (sizeof(kDeleted) - 1), std::string::npos, kDeleted) == 0) {
+                    path.resize(path.size() - (sizeof(kDeleted) - 1));
+                }
+                ModuleInfo info;
+                info.name = Utf8ToWstring(BaseName(path));
+                info.path = Utf8ToWstring(path);
+                info.base = e.start;
+                info.size = e.end - e.start;
+                byPath[e.path] = out.size();
+                out.push_back(std::move(info));
+            } else {
+                ModuleInfo &mod = out[it->second];
+                if (e.end > mod.base) mod.size = std::max<size_t>(mod.size, e.end - mod.base);
+            }
+        }
+        return true;
+    }
+
+    uint64_t ModuleFingerprint() override {
+        std::shared_lock<std::shared_mutex> g(m);
+        std::vector<MapsEntry> maps;
+        if (!pid || !ReadMaps(pid, maps)) return 0;
+        uint64_t h = 1469598103934665603ull; // FNV-1a
+        for (const auto &e : maps) {
+            if (e.inode == 0 || e.offset != 0) continue;
+            h = (h ^ e.start) * 1099511628211ull;
+            h = (h ^ e.inode) * 1099511628211ull;
+        }
+        return h;
+    }
+
+    bool InjectShellcode(const std::vector<uint8_t>&, uintptr_t&, uint32_t&) override { return false; }
+
+private:
+    // 调用方持有 m
+    bool ReadLocked(uintptr_t address, void* buffer, size_t size) {
+        if (!pid) return false;
+        if (size == 0) return true;
+        struct iovec local = { buffer, size };
+        struct iovec remote = { reinterpret_cast<void*>(address), size };
+        ssize_t n = process_vm_readv(static_cast<pid_t>(pid), &local, 1, &remote, 1, 0);
+        if (n == static_cast<ssize_t>(size)) return true;
+        if (n < 0 && errno == ENOSYS && memFd >= 0) {
+            return pread(memFd, buffer, size, static_cast<off_t>(address)) == static_cast<ssize_t>(size);
+        }
+        return false;
+    }
+
+    // readableOnly 时只列出可读的区域，否则列出所有映射
+    bool EnumRegions(std::vector<MemoryRegion>& out, bool readableOnly) {
+        out.clear();
+        std::vector<MapsEntry> maps;
+        if (!pid || !ReadMaps(pid, maps)) return false;
+        for (const auto &e : maps) {
+            MemoryRegion r = RegionFromMaps(e);
+            if (readableOnly && !(r.flags & RegionReadable)) continue;
+            if (!out.empty() && out.back().base + out.back().size == r.base
+                && out.back().flags == r.flags && out.back().protect == r.protect) {
+                out.back().size += r.size;
+            } else {
+                out.push_back(r);
+            }
+        }
+        return true;
+    }
+
+    void CloseLocked() {
+        if (memFd >= 0) close(memFd);
+        memFd = -1;
+        pid = 0;
+    }
+
+    // Open/Close 独占，其余操作共享：关闭时等待进行中的读写结束，pid 和描述符不会在使用中被关闭或复用
+    mutable std::shared_mutex m;
+    uint32_t pid;
+    int memFd;
+};
+
+} // namespace
+
+std::unique_ptr<ProcessBackend> CreateProcessBackend() {
+    return std::unique_ptr<ProcessBackend>(new LinuxProcessBackend());
+}
@@ -0,0 +1,206 @@
+#include "process_backend.h"
+#include <windows.h>
+#include <TlHelp32.h>
+#include <psapi.h>
+#include <algorithm>
+#include <mutex>
+#include <shared_mutex>
+
+namespace {
+
+// 把 VirtualQueryEx 结果转换为平台无关的区域描述，空闲区域 flags 为 0，不可访问的区域没有 RegionReadable
+MemoryRegion RegionFromMbi(const MEMORY_BASIC_INFORMATION& mbi) {
+    MemoryRegion r{ reinterpret_cast<uintptr_t>(mbi.BaseAddress), mbi.RegionSize, 0, static_cast<uint32_t>(mbi.Protect) };
+    if (mbi.State == MEM_FREE) return r;
+    if (mbi.Type == MEM_IMAGE) r.flags |= RegionImage;
+    else if (mbi.Type == MEM_MAPPED) r.flags |= RegionMapped;
+    else r.flags |= RegionPrivate;
+    if (mbi.State != MEM_COMMIT) { r.flags |= RegionReserved; return r; }
+
+    r.flags |= RegionCommitted;
+    if (mbi.Protect & PAGE_NOACCESS) return r;
+    if ((mbi.Protect & 0xFF) == PAGE_EXECUTE) return r; // 仅可执行，不可读
+    if (mbi.Protect & PAGE_GUARD) { r.flags |= RegionGuard; return r; }
+
+    r.flags |= RegionReadable;
+    if (mbi.Protect & (PAGE_READWRITE | PAGE_WRITECOPY | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY)) r.flags |= RegionWritable;
+    if (mbi.Protect & (PAGE_EXECUTE | PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY)) r.flags |= RegionExecutable;
+    return r;
+}
+
+class WinProcessBackend : public ProcessBackend {
+public:
+    WinProcessBackend() : hProcess(nullptr), processId(0) {}
+    ~WinProcessBackend() override { Close(); }
+
+    bool Open(uint32_t pid, uint32_t access) override {
+        std::unique_lock<std::shared_mutex> g(m);
+        CloseLocked();
+        HANDLE h = OpenProcess(access, FALSE, pid);
+        if (!h) return false;
+        hProcess = h;
+        processId = pid;
+        return true;
+    }
+
+    void Close() override {
+        std::unique_lock<std::shared_mutex> g(m);
+        CloseLocked();
+    }
+
+    bool IsOpen() const override {
+        std::shared_lock<std::shared_mutex> g(m);
+        return hProcess != nullptr;
+    }
+
+    bool Read(uintptr_t address, void* buffer, size_t size) override {
+        std::shared_lock<std::shared_mutex> g(m);
+        if (!hProcess) return false;
+        SIZE_T out = 0;
+        BOOL ok = ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(address), buffer, size, &out);
+        return ok && out == size;
+    }
+
+    bool Write(uintptr_t address, const void* buffer, size_t size) override {
+        std::shared_lock<std::shared_mutex> g(m);
+        if (!hProcess) return false;
+        SIZE_T out = 0;
+        BOOL ok = WriteProcessMemory(hProcess, reinterpret_cast<LPVOID>(address), buffer, size, &out);
+        return ok && out == size;
+    }
+
+    bool QueryRegions(std::vector<MemoryRegion>& out) override {
+        std::shared_lock<std::shared_mutex> g(m);
+        return EnumRegions(out, true);
+    }
+
+    bool QueryAllRegions(std::vector<MemoryRegion>& out) override {
+        std::shared_lock<std::shared_mutex> g(m);
+        return EnumRegions(out, false);
+    }
+
+    bool QueryRegionAt(uintptr_t address, MemoryRegion& out) override {
+        std::shared_lock<std::shared_mutex> g(m);
+        if (!hProcess) return false;
+        MEMORY_BASIC_INFORMATION mbi;
+        if (VirtualQueryEx(hProcess, reinterpret_cast<LPCVOID>(address), &mbi, sizeof(mbi)) != sizeof(mbi)) return false;
+        out = RegionFromMbi(mbi);
+        return true;
+    }
+
+    bool MakeWritable(uintptr_t address, size_t size, bool executable, uint32_t& oldProtect) override {
+        std::shared_lock<std::shared_mutex> g(m);
+        if (!hProcess) return false;
+        DWORD old = 0;
+        DWORD np = executable ? PAGE_EXECUTE_READWRITE : PAGE_READWRITE;
+        if (!VirtualProtectEx(hProcess, reinterpret_cast<LPVOID>(address), size, np, &old)) return false;
+        oldProtect = old;
+        return true;
+    }
+
+    void RestoreProtection(uintptr_t address, size_t size, uint32_t oldProtect) override {
+        std::shared_lock<std::shared_mutex> g(m);
+        if (!hProcess) return;
+        DWORD old = 0;
+        VirtualProtectEx(hProcess, reinterpret_cast<LPVOID>(address), size, oldProtect, &old);
+    }
+
+    bool EnumModules(std::vector<ModuleInfo>& out) override {
+        std::shared_lock<std::shared_mutex> g(m);
+        HANDLE snap = CreateToolhelp32Snapshot(TH32CS_SNAPMODULE | TH32CS_SNAPMODULE32, processId);
+        if (snap == INVALID_HANDLE_VALUE) return false;
+        MODULEENTRY32W me; me.dwSize = sizeof(me);
+        if (Module32FirstW(snap, &me)) {
+            do {
+                ModuleInfo info;
+                info.name = me.szModule;
+                info.path = me.szExePath;
+                info.base = reinterpret_cast<uintptr_t>(me.modBaseAddr);
+                info.size = me.modBaseSize;
+                out.push_back(std::move(info));
+            } while (Module32NextW(snap, &me));
+        }
+        CloseHandle(snap);
+        return true;
+    }
+
+    // 模块列表指纹：EnumProcessModulesEx 只返回句柄数组，比 Toolhelp 快照便宜得多
+    uint64_t ModuleFingerprint() override {
+        std::shared_lock<std::shared_mutex> g(m);
+        HMODULE handles[1024];
+        DWORD needed = 0;
+        if (!EnumProcessModulesEx(hProcess, handles, sizeof(handles), &needed, LIST_MODULES_ALL)) return 0;
+        size_t count = std::min<size_t>(needed / sizeof(HMODULE), 1024);
+        uint64_t h = 1469598103934665603ull; // FNV-1a
+        for (size_t i = 0; i < count; ++i) {
+            h = (h ^ reinterpret_cast<uintptr_t>(handles[i])) * 1099511628211ull;
+        }
+        return h ^ needed;
+    }
+
+    bool InjectShellcode(const std::vector<uint8_t>& code, uintptr_t& remoteAddr, uint32_t& threadId) override {
+        std::shared_lock<std::shared_mutex> g(m);
+        if (!hProcess) return false;
+        SIZE_T size = code.size();
+        LPVOID alloc = VirtualAllocEx(hProcess, nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE);
+        if (!alloc) return false;
+        SIZE_T written = 0;
+        if (!WriteProcessMemory(hProcess, alloc, code.data(), size, &written) || written != size) {
+            VirtualFreeEx(hProcess, alloc, 0, MEM_RELEASE);
+            return false;
+        }
+        HANDLE th = CreateRemoteThread(hProcess, nullptr, 0, reinterpret_cast<LPTHREAD_START_ROUTINE>(alloc), nullptr, 0, nullptr);
+        if (!th) {
+            VirtualFreeEx(hProcess, alloc, 0, MEM_RELEASE);
+            return false;
+        }
+        remoteAddr = reinterpret_cast<uintptr_t>(alloc);
+        threadId = GetThreadId(th);
+        CloseHandle(th);
+        return true;
+    }
+
+private:
+    // readableOnly 时只列出可读的区域，否则列出除空闲外的所有区域
+    bool EnumRegions(std::vector<MemoryRegion>& out, bool readableOnly) {
+        out.clear();
+        if (!hProcess) return false;
+        MEMORY_BASIC_INFORMATION mbi;
+        uintptr_t addr = 0;
+        while (VirtualQueryEx(hProcess, reinterpret_cast<LPCVOID>(addr), &mbi, sizeof(mbi)) == sizeof(mbi)) {
+            uintptr_t base = reinterpret_cast<uintptr_t>(mbi.BaseAddress);
+            uintptr_t next = base + mbi.RegionSize;
+            if (next <= addr) break; // 地址回绕
+            addr = next;
+
+            MemoryRegion r = RegionFromMbi(mbi);
+            if (readableOnly ? !(r.flags & RegionReadable) : mbi.State == MEM_FREE) continue;
+
+            // 合并属性相同的相邻区域，减少后续分块数量
+            if (!out.empty() && out.back().base + out.back().size == base
+                && out.back().flags == r.flags && out.back().protect == r.protect) {
+                out.back().size += r.size;
+            } else {
+                out.push_back(r);
+            }
+        }
+        return true;
+    }
+
+    void CloseLocked() {
+        if (hProcess) CloseHandle(hProcess);
+        hProcess = nullptr;
+        processId = 0;
+    }
+
+    // Open/Close 独占，其余操作共享：关闭时等待进行中的读写结束，句柄不会在使用中被关闭或复用
+    mutable std::shared_mutex m;
+    HANDLE hProcess;
+    uint32_t processId;
+};
+
+} // namespace
+
+std::unique_ptr<ProcessBackend> CreateProcessBackend() {
+    return std::unique_ptr<ProcessBackend>(new WinProcessBackend());
+}
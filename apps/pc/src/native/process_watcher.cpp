@@ -0,0 +1,261 @@
+#include "process_watcher.h"
+#include <algorithm>
+#include <cwctype>
+#include "process.h"
+
+namespace {
+constexpr uint32_t kDefaultIntervalMs = 500;
+constexpr uint32_t kMinIntervalMs = 50;
+// FindPidByName 未命中时等待一次即时枚举的最长时间
+constexpr auto kRefreshTimeout = std::chrono::seconds(2);
+// 新进程在这段时间内每次枚举都重新读取名称：fork 后 exec（启动器、Wine 加载链）会改变名称而 PID 不变
+constexpr auto kSettleTime = std::chrono::seconds(5);
+
+void EraseValue(std::vector<uint32_t>& v, uint32_t pid) {
+    v.erase(std::remove(v.begin(), v.end(), pid), v.end());
+}
+}
+
+ProcessWatcher::ProcessWatcher()
+    : nextTargetId(1), intervalMs(kDefaultIntervalMs), wake(false), requests(0), served(0), stopping(false), epoch(0) {}
+
+ProcessWatcher::~ProcessWatcher() {
+    {
+        std::lock_guard<std::mutex> g(m);
+        stopping = true;
+    }
+    cv.notify_all();
+    if (worker.joinable()) worker.join();
+}
+
+void ProcessWatcher::SetNotify(std::function<void()> fn) {
+    std::lock_guard<std::mutex> g(m);
+    notify = std::move(fn);
+}
+
+void ProcessWatcher::SetInterval(uint32_t ms) {
+    {
+        std::lock_guard<std::mutex> g(m);
+        intervalMs = std::max(ms, kMinIntervalMs);
+        wake = true;
+    }
+    cv.notify_all();
+}
+
+std::wstring ProcessWatcher::KeyOf(const std::wstring& name) {
+#ifdef _WIN32
+    std::wstring key(name);
+    for (auto &c : key) c = static_cast<wchar_t>(std::towlower(c));
+    return key;
+#else
+    return name;
+#endif
+}
+
+void ProcessWatcher::EnsureStarted() {
+    // 第一次查询在调用线程上同步枚举，之后由监视线程维护；Poll 同一时间只在一个线程上运行
+    std::call_once(startOnce, [this]() {
+        Poll();
+        worker = std::thread([this]() { Run(); });
+    });
+}
+
+void ProcessWatcher::Run() {
+    uint64_t serving = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lk(m);
+            cv.wait_for(lk, std::chrono::milliseconds(intervalMs), [this]() { return stopping.load() || wake; });
+            if (stopping) return;
+            wake = false;
+            serving = requests;
+        }
+        Poll();
+        {
+            std::lock_guard<std::mutex> g(m);
+            served = serving;
+        }
+        cv.notify_all();
+    }
+}
+
+// 请求监视线程立即枚举一次并等待完成
+void ProcessWatcher::PollNow() {
+    std::unique_lock<std::mutex> lk(m);
+    uint64_t id = ++requests;
+    wake = true;
+    cv.notify_all();
+    cv.wait_for(lk, kRefreshTimeout, [&]() { return stopping.load() || served >= id; });
+}
+
+void ProcessWatcher::Poll() {
+    ++epoch;
+    auto now = std::chrono::steady_clock::now();
+    // 表的结构只由本线程修改，但 MatchesPath 会在查询线程上写入条目的路径缓存，
+    // 所以枚举回调访问表时同样持有 m；每次只短暂持锁，枚举本身的系统调用不在锁内
+    std::vector<ProcessEntry> added;
+    bool ok = EnumerateProcessesIncremental(
+        [&](uint32_t pid) {
+            std::lock_guard<std::mutex> g(m);
+            auto it = table.find(pid);
+            return it != table.end() && now - it->second.firstSeen > kSettleTime;
+        },
+        [&](const ProcessEntry& pe) -> bool {
+            std::lock_guard<std::mutex> g(m);
+            auto it = table.find(pe.pid);
+            // 名称变化说明 PID 已被复用或进程执行了 exec，按旧进程退出、新进程启动处理
+            if (it != table.end() && (pe.exeName.empty() || pe.exeName == it->second.exeName)) {
+                it->second.epoch = epoch;
+            } else if (!pe.exeName.empty()) {
+                added.push_back(pe);
+            }
+            return true;
+        });
+    if (!ok) return;
+
+    struct Check { int targetId; uint32_t pid; std::wstring exePath; };
+    std::vector<Check> checks;
+    bool wasEmpty;
+    {
+        std::lock_guard<std::mutex> g(m);
+        wasEmpty = events.empty();
+
+        // 退出（或 PID 被复用）的进程
+        for (auto it = table.begin(); it != table.end();) {
+            if (it->second.epoch == epoch) { ++it; continue; }
+            uint32_t pid = it->first;
+            auto bn = byName.find(it->second.key);
+            if (bn != byName.end()) {
+                EraseValue(bn->second, pid);
+                if (bn->second.empty()) byName.erase(bn);
+            }
+            for (auto &kv : targets) {
+                auto &pids = kv.second.pids;
+                if (std::find(pids.begin(), pids.end(), pid) == pids.end()) continue;
+                EraseValue(pids, pid);
+                events.push_back({ kv.first, false, pid, it->second.exeName });
+            }
+            it = table.erase(it);
+        }
+
+        for (auto &pe : added) {
+            Entry &e = table[pe.pid];
+            e.exeName = pe.exeName;
+            e.key = KeyOf(pe.exeName);
+            e.epoch = epoch;
+            e.firstSeen = now;
+            e.paths.clear();
+            byName[e.key].push_back(pe.pid);
+            for (auto &kv : targets) {
+                if (!kv.second.fresh && kv.second.key == e.key) checks.push_back({ kv.first, pe.pid, kv.second.exePath });
+            }
+        }
+
+        // 新登记的目标与所有现有进程匹配一次
+        for (auto &kv : targets) {
+            if (!kv.second.fresh) continue;
+            kv.second.fresh = false;
+            auto bn = byName.find(kv.second.key);
+            if (bn == byName.end()) continue;
+            for (uint32_t pid : bn->second) checks.push_back({ kv.first, pid, kv.second.exePath });
+        }
+    }
+
+    // 路径校验需要打开进程，放在锁外
+    std::vector<uint8_t> matched(checks.size());
+    for (size_t i = 0; i < checks.size(); ++i) {
+        matched[i] = checks[i].exePath.empty() || MatchesPath(checks[i].pid, checks[i].exePath);
+    }
+
+    std::function<void()> fn;
+    {
+        std::lock_guard<std::mutex> g(m);
+        for (size_t i = 0; i < checks.size(); ++i) {
+            if (!matched[i]) continue;
+            auto t = targets.find(checks[i].targetId);
+            auto e = table.find(checks[i].pid);
+            if (t == targets.end() || e == table.end()) continue;
+            auto &pids = t->second.pids;
+            if (std::find(pids.begin(), pids.end(), checks[i].pid) != pids.end()) continue;
+            pids.push_back(checks[i].pid);
+            events.push_back({ t->first, true, checks[i].pid, e->second.exeName });
+        }
+        if (wasEmpty && !events.empty()) fn = notify;
+    }
+    if (fn) fn();
+}
+
+bool ProcessWatcher::MatchesPath(uint32_t pid, const std::wstring& exePath) {
+    {
+        std::lock_guard<std::mutex> g(m);
+        auto it = table.find(pid);
+        if (it == table.end()) return false;
+        for (const auto &p : it->second.paths) {
+            if (p.first == exePath) return p.second;
+        }
+    }
+    bool ok = ProcessMatchesPath(pid, exePath);
+    std::lock_guard<std::mutex> g(m);
+    auto it = table.find(pid);
+    if (it != table.end()) it->second.paths.emplace_back(exePath, ok);
+    return ok;
+}
+
+bool ProcessWatcher::IsRunning(const std::wstring& exeName, const std::wstring& exePath) {
+    EnsureStarted();
+    std::vector<uint32_t> pids;
+    {
+        std::lock_guard<std::mutex> g(m);
+        auto it = byName.find(KeyOf(exeName));
+        if (it == byName.end()) return false;
+        pids = it->second;
+    }
+    for (uint32_t pid : pids) {
+        if (MatchesPath(pid, exePath)) return true;
+    }
+    return false;
+}
+
+uint32_t ProcessWatcher::FindPidByName(const std::wstring& exeName) {
+    EnsureStarted();
+    std::wstring key = KeyOf(exeName);
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        {
+            std::lock_guard<std::mutex> g(m);
+            auto it = byName.find(key);
+            if (it != byName.end() && !it->second.empty()) return it->second.front();
+        }
+        // 打开进程前表可能还没包含刚启动的进程，未命中时立即枚举一次再查
+        if (attempt == 0) PollNow();
+    }
+    return 0;
+}
+
+int ProcessWatcher::AddTarget(const std::wstring& exeName, const std::wstring& exePath) {
+    if (exeName.empty()) return -1;
+    EnsureStarted();
+    int id;
+    {
+        std::lock_guard<std::mutex> g(m);
+        id = nextTargetId++;
+        Target &t = targets[id];
+        t.exeName = exeName;
+        t.key = KeyOf(exeName);
+        t.exePath = exePath;
+        t.fresh = true;
+        wake = true;
+    }
+    cv.notify_all();
+    return id;
+}
+
+bool ProcessWatcher::RemoveTarget(int id) {
+    std::lock_guard<std::mutex> g(m);
+    return targets.erase(id) != 0;
+}
+
+void ProcessWatcher::TakeEvents(std::vector<ProcessEvent>& out) {
+    std::lock_guard<std::mutex> g(m);
+    out.swap(events);
+    events.clear();
+}
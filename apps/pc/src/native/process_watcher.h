@@ -0,0 +1,90 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct ProcessEvent {
+    int targetId;
+    bool started;                   // false 表示退出
+    uint32_t pid;
+    std::wstring exeName;
+};
+
+/**
+ * 进程监视器：后台线程周期性枚举进程，与上次的 PID 表做差分，
+ * 只为新出现的进程获取名称（Linux）和路径（按需，结果缓存到进程退出）。
+ * IsRunning / FindPidByName 直接查内存中的表（按名称索引），不再每次遍历全部进程。
+ * 登记的目标进程启动或退出时产生事件，累积在待取列表中，
+ * 列表从空变为非空时调用 notify，消费方随后用 TakeEvents 一次取走。
+ */
+class ProcessWatcher {
+public:
+    ProcessWatcher();
+    ~ProcessWatcher();
+
+    // notify 在监视线程上调用，应尽快返回
+    void SetNotify(std::function<void()> notify);
+    // 轮询间隔，默认 500ms
+    void SetInterval(uint32_t ms);
+
+    // 首次调用时同步枚举一次并启动监视线程
+    bool IsRunning(const std::wstring& exeName, const std::wstring& exePath);
+    uint32_t FindPidByName(const std::wstring& exeName);
+
+    // 登记目标：exePath 为空时只比较名称。已在运行的匹配进程会立即产生启动事件
+    int AddTarget(const std::wstring& exeName, const std::wstring& exePath);
+    bool RemoveTarget(int id);
+
+    void TakeEvents(std::vector<ProcessEvent>& out);
+
+private:
+    struct Entry {
+        std::wstring exeName;
+        std::wstring key;                                   // 名称索引键（Windows 下为小写）
+        uint64_t epoch;                                     // 最近一次枚举到该进程的轮次
+        std::chrono::steady_clock::time_point firstSeen;
+        std::vector<std::pair<std::wstring, bool>> paths;   // 已校验过的路径及结果
+    };
+
+    struct Target {
+        std::wstring exeName;
+        std::wstring key;
+        std::wstring exePath;
+        bool fresh;                                         // 新登记，尚未与现有进程匹配
+        std::vector<uint32_t> pids;                         // 当前匹配的进程
+    };
+
+    void EnsureStarted();
+    void Run();
+    void Poll();
+    void PollNow();
+    bool MatchesPath(uint32_t pid, const std::wstring& exePath);
+    static std::wstring KeyOf(const std::wstring& name);
+
+    std::mutex m;
+    std::condition_variable cv;
+    std::unordered_map<uint32_t, Entry> table;
+    std::unordered_map<std::wstring, std::vector<uint32_t>> byName;    // 按首次出现顺序
+    std::unordered_map<int, Target> targets;
+    std::vector<ProcessEvent> events;
+    std::function<void()> notify;
+    int nextTargetId;
+    uint32_t intervalMs;
+    bool wake;
+    uint64_t requests;              // PollNow 请求序号
+    uint64_t served;                // 已完成的枚举所响应的最大请求序号
+    std::once_flag startOnce;
+    std::atomic<bool> stopping;
+    std::thread worker;
+
+    // 以下仅由枚举所在线程访问
+    uint64_t epoch;
+};
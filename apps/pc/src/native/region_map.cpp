@@ -0,0 +1,111 @@
+#include "region_map.h"
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <mutex>
+
+namespace {
+
+bool IsFree(const MemoryRegion& r) {
+    return !(r.flags & (RegionCommitted | RegionReserved));
+}
+
+} // namespace
+
+uint64_t RegionMap::NowMs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+bool RegionMap::Find(uintptr_t address, MemoryRegion& out, uint64_t* checkedMs) const {
+    std::shared_lock<std::shared_mutex> g(m);
+    auto it = regions.upper_bound(address);
+    if (it == regions.begin()) return false;
+    --it;
+    if (address - it->second.region.base >= it->second.region.size) return false;
+    out = it->second.region;
+    if (checkedMs) *checkedMs = it->second.checkedMs;
+    return true;
+}
+
+void RegionMap::EraseRange(uintptr_t address, uintptr_t end) {
+    auto it = regions.upper_bound(address);
+    if (it != regions.begin()) {
+        auto prev = std::prev(it);
+        if (address - prev->second.region.base < prev->second.region.size) it = prev;
+    }
+    while (it != regions.end() && it->first < end) it = regions.erase(it);
+    MarkChanged();
+}
+
+void RegionMap::Insert(const MemoryRegion& region) {
+    if (region.size == 0) return;
+    uint64_t now = NowMs();
+    std::unique_lock<std::shared_mutex> g(m);
+    // 删除与新区域重叠的旧条目
+    uintptr_t end = region.base + region.size;
+    EraseRange(region.base, end < region.base ? UINTPTR_MAX : end);
+    regions[region.base] = { region, now };
+    MarkChanged();
+}
+
+void RegionMap::Invalidate(uintptr_t address, size_t size) {
+    std::unique_lock<std::shared_mutex> g(m);
+    uintptr_t end = address + (size ? size : 1);
+    EraseRange(address, end < address ? UINTPTR_MAX : end);
+}
+
+void RegionMap::Clear() {
+    std::unique_lock<std::shared_mutex> g(m);
+    regions.clear();
+    complete = false;
+    MarkChanged();
+}
+
+void RegionMap::Assign(const std::vector<MemoryRegion>& all) {
+    uint64_t now = NowMs();
+    std::unique_lock<std::shared_mutex> g(m);
+    regions.clear();
+    uintptr_t next = 0;
+    for (const auto &r : all) {
+        if (r.size == 0 || r.base < next) continue;
+        if (r.base > next) regions.emplace_hint(regions.end(), next, Entry{ { next, r.base - next, 0, 0 }, now });
+        regions.emplace_hint(regions.end(), r.base, Entry{ r, now });
+        next = r.base + r.size;
+        if (next < r.base) break;   // 到达地址空间末尾
+    }
+    if (next != 0 && next < UINTPTR_MAX) {
+        regions.emplace_hint(regions.end(), next, Entry{ { next, UINTPTR_MAX - next, 0, 0 }, now });
+    }
+    complete = true;
+    MarkChanged();
+}
+
+void RegionMap::BuildList() const {
+    listAll.clear();
+    listUsed.clear();
+    listAll.reserve(regions.size());
+    for (const auto &kv : regions) {
+        listAll.push_back(kv.second.region);
+        if (!IsFree(kv.second.region)) listUsed.push_back(kv.second.region);
+    }
+    listValid = true;
+}
+
+size_t RegionMap::List(size_t offset, size_t count, bool includeFree, std::vector<MemoryRegion>& out) const {
+    std::shared_lock<std::shared_mutex> g(m);
+    std::lock_guard<std::mutex> lg(listMutex);
+    if (!listValid) BuildList();
+    const std::vector<MemoryRegion> &list = includeFree ? listAll : listUsed;
+    out.clear();
+    if (offset < list.size()) {
+        auto first = list.begin() + offset;
+        out.assign(first, first + std::min(count, list.size() - offset));
+    }
+    return list.size();
+}
+
+size_t RegionMap::Count() const {
+    std::shared_lock<std::shared_mutex> g(m);
+    return regions.size();
+}
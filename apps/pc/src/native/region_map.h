@@ -0,0 +1,65 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+#include "memory_source.h"
+
+struct RegionMapOptions {
+    bool filterReads = true;    // 索引中不可读的范围直接拒绝，不进入内核
+    uint32_t refreshMs = 0;     // 定时完整重建的间隔，0 表示只按失败的读取增量刷新
+    uint32_t recheckMs = 250;   // 不可读的条目在此时间内直接使用，之后重新查询所在区域
+};
+
+/**
+ * 目标进程内存区域的索引，按基址排序，查找为 O(log n)。
+ * 打开进程时由 Assign 用完整的区域列表构建（其间的空洞记为未分配的条目），之后由平台层
+ * 查询（VirtualQueryEx）的结果逐个插入，写入失败等情况下按范围失效。
+ * 不含 RegionReadable 的条目表示不可读的区域；既没有 RegionCommitted 也没有 RegionReserved 的为未分配。
+ */
+class RegionMap {
+public:
+    // checkedMs 为条目最后一次从平台层查询的时间（NowMs）
+    bool Find(uintptr_t address, MemoryRegion& out, uint64_t* checkedMs = nullptr) const;
+    void Insert(const MemoryRegion& region);
+    void Invalidate(uintptr_t address, size_t size);
+    void Clear();
+
+    // 用按地址升序、互不重叠的完整列表替换索引；之后 Complete() 为 true，直到 Clear
+    void Assign(const std::vector<MemoryRegion>& all);
+    bool Complete() const { return complete.load(std::memory_order_relaxed); }
+
+    // 按地址升序分页复制条目，includeFree 为 false 时跳过未分配的空洞；返回符合条件的条目总数。
+    // 分页基于修改后第一次 List 时重建的有序副本，逐页取完整个列表为 O(n)
+    size_t List(size_t offset, size_t count, bool includeFree, std::vector<MemoryRegion>& out) const;
+    size_t Count() const;
+
+    static uint64_t NowMs();
+
+private:
+    struct Entry {
+        MemoryRegion region;
+        uint64_t checkedMs;
+    };
+
+    // 调用方持有写锁
+    void EraseRange(uintptr_t address, uintptr_t end);
+
+    // 调用方持有写锁
+    void MarkChanged() { listValid = false; }
+    // 调用方持有读锁和 listMutex
+    void BuildList() const;
+
+    mutable std::shared_mutex m;
+    std::map<uintptr_t, Entry> regions;
+    std::atomic<bool> complete{ false };
+
+    // List 的分页副本：修改索引时失效（持写锁），List 持读锁时在 listMutex 下按需重建
+    mutable std::mutex listMutex;
+    mutable std::vector<MemoryRegion> listAll;
+    mutable std::vector<MemoryRegion> listUsed;     // 不含未分配的空洞
+    mutable bool listValid = false;
+};
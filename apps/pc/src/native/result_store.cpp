@@ -0,0 +1,205 @@
+#include "result_store.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr size_t kMinSpillSize = 64 * 1024 * 1024;
+
+void PutVarint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v) | 0x80);
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+uint64_t GetVarint(const uint8_t*& p) {
+    uint64_t v = 0;
+    int shift = 0;
+    while (*p & 0x80) {
+        v |= static_cast<uint64_t>(*p++ & 0x7F) << shift;
+        shift += 7;
+    }
+    v |= static_cast<uint64_t>(*p++) << shift;
+    return v;
+}
+
+} // namespace
+
+// ---------------- SpillArena ----------------
+
+SpillArena::SpillArena(size_t memoryBudget) : used(0), budget(memoryBudget) {}
+
+bool SpillArena::Reserve(size_t need) {
+    if (!Spilled()) {
+        if (need <= budget) {
+            if (mem.size() < need) mem.resize(std::max(need, mem.size() * 2));
+            return true;
+        }
+        // 超出预算：迁移到临时文件，释放进程内存
+        if (!file.CreateTemp(std::max(need * 2, kMinSpillSize))) return false;
+        if (used) std::memcpy(file.Data(), mem.data(), used);
+        std::vector<uint8_t>().swap(mem);
+        return true;
+    }
+    if (need <= file.Size()) return true;
+    return file.Resize(std::max(need, file.Size() * 2));
+}
+
+uint64_t SpillArena::Append(const void* src, size_t len) {
+    uint64_t offset = used;
+    if (len == 0) return offset;
+    if (!Reserve(used + len)) {
+        // 临时文件不可用时退回到进程内存，保证结果不丢失
+        if (Spilled()) {
+            mem.assign(file.Data(), file.Data() + used);
+            file.Close();
+        }
+        mem.resize(used + len);
+    }
+    uint8_t* base = Spilled() ? file.Data() : mem.data();
+    std::memcpy(base + used, src, len);
+    used += len;
+    return offset;
+}
+
+const uint8_t* SpillArena::At(uint64_t offset) const {
+    return (Spilled() ? file.Data() : mem.data()) + offset;
+}
+
+void SpillArena::Clear() {
+    file.Close();
+    std::vector<uint8_t>().swap(mem);
+    used = 0;
+}
+
+// ---------------- ResultStore ----------------
+
+ResultStore::ResultStore(size_t valueSize, size_t alignment, size_t memoryBudget)
+    : valueSize(valueSize), alignment(alignment ? alignment : 1), total(0), arena(memoryBudget) {}
+
+void ResultStore::EncodeBlock(uintptr_t base, size_t span, size_t alignment, size_t valueSize,
+                              const uintptr_t* addrs, const uint8_t* vals, size_t count, EncodedBlock& out) {
+    if (alignment == 0) alignment = 1;
+    out.base = base;
+    out.span = static_cast<uint32_t>(span);
+    out.count = static_cast<uint32_t>(count);
+    out.addresses.clear();
+    out.values.assign(vals, vals + count * valueSize);
+    out.uniform = false;
+    if (count == 0) return;
+
+    size_t k = 1;
+    while (k < count && std::memcmp(vals, vals + k * valueSize, valueSize) == 0) ++k;
+    if (k == count) {
+        out.uniform = true;
+        out.values.resize(valueSize);
+    }
+
+    // 差分编码：首项为相对块基址的偏移，其后为以对齐单位计的间距
+    out.encoding = ResultStore::EncodingDelta;
+    PutVarint(out.addresses, addrs[0] - base);
+    for (size_t i = 1; i < count; ++i) {
+        PutVarint(out.addresses, (addrs[i] - addrs[i - 1]) / alignment);
+    }
+
+    // 位图更小时改用位图
+    uintptr_t alignedBase = base - base % alignment;
+    size_t slots = (base + span - alignedBase + alignment - 1) / alignment;
+    size_t bitmapBytes = (slots + 7) / 8;
+    if (bitmapBytes < out.addresses.size()) {
+        out.encoding = ResultStore::EncodingBitmap;
+        out.addresses.assign(bitmapBytes, 0);
+        for (size_t i = 0; i < count; ++i) {
+            size_t slot = (addrs[i] - alignedBase) / alignment;
+            out.addresses[slot >> 3] |= static_cast<uint8_t>(1u << (slot & 7));
+        }
+    }
+}
+
+void ResultStore::Append(const EncodedBlock& block) {
+    if (block.count == 0) return;
+    BlockInfo info;
+    info.base = block.base;
+    info.span = block.span;
+    info.count = block.count;
+    info.encoding = block.encoding;
+    info.uniform = block.uniform;
+    info.addrBytes = static_cast<uint32_t>(block.addresses.size());
+    info.addrOffset = arena.Append(block.addresses.data(), block.addresses.size());
+    info.valueOffset = arena.Append(block.values.data(), block.values.size());
+    info.firstIndex = total;
+    blocks.push_back(info);
+    total += block.count;
+}
+
+void ResultStore::DecodeBlock(size_t index, std::vector<uintptr_t>& addrs) const {
+    const BlockInfo &b = blocks[index];
+    addrs.clear();
+    addrs.reserve(b.count);
+    const uint8_t* p = arena.At(b.addrOffset);
+    if (b.encoding == EncodingBitmap) {
+        uintptr_t alignedBase = b.base - b.base % alignment;
+        for (size_t byte = 0; byte < b.addrBytes; ++byte) {
+            uint8_t bits = p[byte];
+            while (bits) {
+                unsigned bit = 0;
+                while (!((bits >> bit) & 1)) ++bit;
+                bits &= static_cast<uint8_t>(bits - 1);
+                addrs.push_back(alignedBase + (byte * 8 + bit) * alignment);
+            }
+        }
+        return;
+    }
+    uintptr_t addr = b.base + GetVarint(p);
+    addrs.push_back(addr);
+    for (uint32_t i = 1; i < b.count; ++i) {
+        addr += GetVarint(p) * alignment;
+        addrs.push_back(addr);
+    }
+}
+
+void ResultStore::DecodeValues(size_t index, std::vector<uint8_t>& vals) const {
+    const BlockInfo &b = blocks[index];
+    const uint8_t* p = arena.At(b.valueOffset);
+    if (!b.uniform) {
+        vals.assign(p, p + static_cast<size_t>(b.count) * valueSize);
+        return;
+    }
+    vals.resize(static_cast<size_t>(b.count) * valueSize);
+    for (uint32_t i = 0; i < b.count; ++i) std::memcpy(vals.data() + i * valueSize, p, valueSize);
+}
+
+size_t ResultStore::Read(size_t offset, size_t count, std::vector<uintptr_t>& addrs, std::vector<uint8_t>& vals) const {
+    addrs.clear();
+    vals.clear();
+    if (offset >= total || count == 0) return 0;
+
+    // 二分定位起始块
+    auto it = std::upper_bound(blocks.begin(), blocks.end(), offset,
+        [](size_t off, const BlockInfo& b) { return off < b.firstIndex; });
+    size_t index = static_cast<size_t>(it - blocks.begin()) - 1;
+
+    std::vector<uintptr_t> blockAddrs;
+    std::vector<uint8_t> blockVals;
+    while (index < blocks.size() && addrs.size() < count) {
+        const BlockInfo &b = blocks[index];
+        DecodeBlock(index, blockAddrs);
+        DecodeValues(index, blockVals);
+        size_t from = offset > b.firstIndex ? static_cast<size_t>(offset - b.firstIndex) : 0;
+        size_t n = std::min<size_t>(b.count - from, count - addrs.size());
+        addrs.insert(addrs.end(), blockAddrs.begin() + from, blockAddrs.begin() + from + n);
+        const uint8_t* v = blockVals.data() + from * valueSize;
+        vals.insert(vals.end(), v, v + n * valueSize);
+        ++index;
+    }
+    return addrs.size();
+}
+
+void ResultStore::Clear() {
+    blocks.clear();
+    blocks.shrink_to_fit();
+    arena.Clear();
+    total = 0;
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "mapped_file.h"
+
+/**
+ * 只追加的字节区：数据量小于预算时放在进程内存中，
+ * 超过预算后整体迁移到内存映射临时文件，后续追加直接写入映射区。
+ * 对外只暴露偏移量，迁移和扩容不会使已记录的位置失效。
+ */
+class SpillArena {
+public:
+    explicit SpillArena(size_t memoryBudget);
+
+    uint64_t Append(const void* src, size_t len);
+    const uint8_t* At(uint64_t offset) const;
+
+    size_t Size() const { return used; }
+    bool Spilled() const { return file.IsOpen(); }
+    void Clear();
+
+private:
+    bool Reserve(size_t need);
+
+    std::vector<uint8_t> mem;
+    MappedFile file;
+    size_t used;
+    size_t budget;
+};
+
+// 单个扫描块编码后的结果，由扫描线程独立生成后按顺序追加到 ResultStore
+struct EncodedBlock {
+    uintptr_t base = 0;
+    uint32_t span = 0;          // 块覆盖的字节数
+    uint32_t count = 0;
+    uint8_t encoding = 0;
+    bool uniform = false;       // 所有数值相同（如精确扫描），values 只存一份
+    std::vector<uint8_t> addresses;
+    std::vector<uint8_t> values;
+};
+
+/**
+ * 扫描结果存储。
+ * 地址按块编码：命中密集时使用位图（每个对齐槽 1 bit），稀疏时使用变长整数差分；
+ * 数值单独连续存放（结构体数组布局），顺序遍历时对缓存友好。
+ */
+class ResultStore {
+public:
+    static constexpr size_t kDefaultBudget = 256 * 1024 * 1024;
+
+    enum Encoding : uint8_t {
+        EncodingDelta = 0,
+        EncodingBitmap = 1,
+    };
+
+    ResultStore(size_t valueSize, size_t alignment, size_t memoryBudget = kDefaultBudget);
+
+    // addrs 必须升序且都位于 [base, base+span)
+    static void EncodeBlock(uintptr_t base, size_t span, size_t alignment, size_t valueSize,
+                            const uintptr_t* addrs, const uint8_t* vals, size_t count, EncodedBlock& out);
+
+    void Append(const EncodedBlock& block);
+
+    size_t Count() const { return total; }
+    size_t BlockCount() const { return blocks.size(); }
+    size_t ValueSize() const { return valueSize; }
+    size_t Alignment() const { return alignment; }
+    size_t BytesUsed() const { return arena.Size() + blocks.size() * sizeof(BlockInfo); }
+    bool Spilled() const { return arena.Spilled(); }
+
+    uintptr_t BlockBase(size_t index) const { return blocks[index].base; }
+    size_t BlockSpan(size_t index) const { return blocks[index].span; }
+
+    // 解码第 index 块的地址和数值
+    void DecodeBlock(size_t index, std::vector<uintptr_t>& addrs) const;
+    void DecodeValues(size_t index, std::vector<uint8_t>& vals) const;
+
+    // 分页读取：从第 offset 条开始最多 count 条，返回实际数量
+    size_t Read(size_t offset, size_t count, std::vector<uintptr_t>& addrs, std::vector<uint8_t>& vals) const;
+
+    void Clear();
+
+private:
+    struct BlockInfo {
+        uintptr_t base;
+        uint32_t span;
+        uint32_t count;
+        uint8_t encoding;
+        bool uniform;
+        uint64_t addrOffset;
+        uint32_t addrBytes;
+        uint64_t valueOffset;
+        uint64_t firstIndex;    // 本块第一条结果的全局序号，用于分页二分查找
+    };
+
+    size_t valueSize;
+    size_t alignment;
+    size_t total;
+    std::vector<BlockInfo> blocks;
+    SpillArena arena;
+};
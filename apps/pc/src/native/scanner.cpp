@@ -0,0 +1,271 @@
+#include "scanner.h"
+#include <algorithm>
+#include <cstring>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+constexpr size_t kPageSize = 0x1000;
+
+// 每个 worker 复用的读缓冲区，避免每块都重新分配 4MB
+std::vector<uint8_t>& ThreadBuffer(size_t size) {
+    thread_local std::vector<uint8_t> buf;
+    if (buf.size() < size) buf.resize(size);
+    return buf;
+}
+
+inline unsigned LowestBit(uint64_t mask) {
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward64(&idx, mask);
+    return static_cast<unsigned>(idx);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+}
+
+/**
+ * 比较 buf 中满足 (base + p) % align == 0 且 p < limit 的位置，命中的地址和数值追加到 addrs/vals。
+ * 比较内核一次生成整块的命中位图，这里只展开置位的位。
+ */
+void ScanChunk(const uint8_t* buf, size_t len, uintptr_t base, size_t limit, const ScanOptions& opts,
+               CompareOp op, const CompareArgs& args, std::vector<uintptr_t>& addrs, std::vector<uint8_t>& vals) {
+    const size_t valueSize = ValueTypeSize(opts.type);
+    const size_t align = opts.alignment;
+    if (len < valueSize) return;
+    size_t end = std::min(limit, len - valueSize + 1);
+    size_t first = (align - base % align) % align;
+    if (first >= end) return;
+    size_t n = (end - first + align - 1) / align;
+
+    thread_local std::vector<uint64_t> mask;
+    mask.resize((n + 63) / 64);
+    if (!CompareBuffer(opts.type, op, args, buf + first, nullptr, n, align, mask.data())) return;
+    for (size_t w = 0; w < mask.size(); ++w) {
+        uint64_t m = mask[w];
+        while (m) {
+            size_t j = LowestBit(m);
+            m &= m - 1;
+            size_t off = first + (w * 64 + j) * align;
+            addrs.push_back(base + off);
+            vals.insert(vals.end(), buf + off, buf + off + valueSize);
+        }
+    }
+}
+
+bool RegionMatches(const MemoryRegion& r, const ScanOptions& opts) {
+    if (!(r.flags & RegionReadable) || (r.flags & RegionGuard)) return false;
+    if (opts.writableOnly && !(r.flags & RegionWritable)) return false;
+    if (!opts.includeMapped && (r.flags & RegionMapped)) return false;
+    return true;
+}
+
+/**
+ * window 个块同时在处理时占用的内存：编码后的结果在整个窗口追加到结果存储之前都保留着，
+ * 参与执行的线程各有一个读缓冲和命中暂存。按块内每个对齐位置都命中（如未知初始值）估算。
+ */
+size_t WindowBytes(size_t window, size_t threads, size_t alignment, size_t valueSize) {
+    const size_t maxHits = Scanner::kChunkSize / alignment + 1;
+    const size_t perTask = maxHits * valueSize + maxHits / 8 + 1;
+    const size_t perThread = Scanner::kChunkSize + valueSize + maxHits * (sizeof(uintptr_t) + valueSize);
+    return window * perTask + std::min(window, threads) * perThread;
+}
+
+// 不超过预算一半的最大窗口（至少 1 块），剩余预算留给结果存储
+size_t FitWindow(size_t maxWindow, size_t threads, size_t alignment, size_t valueSize, size_t budget) {
+    size_t window = std::max<size_t>(maxWindow, 1);
+    while (window > 1 && WindowBytes(window, threads, alignment, valueSize) > budget / 2) --window;
+    return window;
+}
+
+size_t StoreBudget(size_t window, size_t threads, size_t alignment, size_t valueSize, size_t budget) {
+    return budget - std::min(budget, WindowBytes(window, threads, alignment, valueSize));
+}
+
+struct BusyScope {
+    std::atomic<bool>& flag;
+    explicit BusyScope(std::atomic<bool>& f) : flag(f) { flag = true; }
+    ~BusyScope() { flag = false; }
+};
+
+} // namespace
+
+Scanner::Scanner(ThreadPool& pool) : pool(pool) {}
+
+size_t Scanner::FirstScan(IMemorySource& src, const ScanOptions& opts, CompareOp op, const CompareArgs& args,
+                          const std::atomic<bool>* cancel) {
+    std::lock_guard<std::mutex> g(m);
+    BusyScope scope(busy);
+    options = opts;
+    const size_t valueSize = ValueTypeSize(opts.type);
+    if (options.alignment == 0) options.alignment = valueSize;
+    // 窗口缓冲计入 memoryBudget：预算紧张时缩小窗口，结果存储只使用剩余部分
+    const size_t threads = pool.Size() + 1;     // 调用方线程也参与执行
+    const size_t window = FitWindow(pool.Size() * kWindowFactor, threads, options.alignment, valueSize, options.memoryBudget);
+    store = std::make_unique<ResultStore>(valueSize, options.alignment,
+                                          StoreBudget(window, threads, options.alignment, valueSize, options.memoryBudget));
+
+    std::vector<MemoryRegion> regions;
+    if (!src.QueryRegions(regions)) return 0;
+
+    // 把区域切成固定大小的块；每块额外多读 valueSize-1 字节以覆盖跨块的值
+    struct Task { uintptr_t base; size_t size; size_t readSize; };
+    std::vector<Task> tasks;
+    for (const auto &r : regions) {
+        if (!RegionMatches(r, options)) continue;
+        uintptr_t lo = std::max(r.base, options.startAddress);
+        uintptr_t hi = std::min(r.base + r.size, options.endAddress);
+        for (uintptr_t b = lo; b < hi; b += kChunkSize) {
+            size_t size = std::min<size_t>(kChunkSize, hi - b);
+            size_t readSize = std::min<size_t>(size + valueSize - 1, r.base + r.size - b);
+            tasks.push_back({ b, size, readSize });
+        }
+    }
+
+    std::vector<EncodedBlock> encoded(std::min(window, tasks.size()));
+    for (size_t start = 0; start < tasks.size(); start += window) {
+        if (cancel && cancel->load()) {
+            store.reset();
+            return 0;
+        }
+        size_t n = std::min(window, tasks.size() - start);
+        pool.ParallelFor(n, [&](size_t i) {
+            const Task &t = tasks[start + i];
+            thread_local std::vector<uintptr_t> addrs;
+            thread_local std::vector<uint8_t> vals;
+            addrs.clear();
+            vals.clear();
+            std::vector<uint8_t> &buf = ThreadBuffer(t.readSize);
+            if (src.ReadMemory(t.base, buf.data(), t.readSize)) {
+                ScanChunk(buf.data(), t.readSize, t.base, t.size, options, op, args, addrs, vals);
+            } else {
+                // 整块读取失败时按页重试：相邻的可读页读到缓冲区的对应位置，连成一段扫描，
+                // 跨页的值不会丢失；只跳过读取失败的页
+                size_t off = 0;
+                while (off < t.size) {
+                    size_t end = off;
+                    size_t len = 0;
+                    while (end < t.readSize) {
+                        len = std::min(kPageSize - (t.base + end) % kPageSize, t.readSize - end);
+                        if (!src.ReadMemory(t.base + end, buf.data() + end, len)) break;
+                        end += len;
+                    }
+                    if (end > off) {
+                        ScanChunk(buf.data() + off, end - off, t.base + off, std::min(end, t.size) - off,
+                                  options, op, args, addrs, vals);
+                    }
+                    off = end + len;
+                }
+            }
+            ResultStore::EncodeBlock(t.base, t.size, options.alignment, valueSize,
+                                     addrs.data(), vals.data(), addrs.size(), encoded[i]);
+        });
+        for (size_t i = 0; i < n; ++i) store->Append(encoded[i]);
+    }
+    return store->Count();
+}
+
+size_t Scanner::NextScan(IMemorySource& src, CompareOp op, const CompareArgs& args, const std::atomic<bool>* cancel) {
+    std::lock_guard<std::mutex> g(m);
+    BusyScope scope(busy);
+    if (!store) return 0;
+    const size_t valueSize = ValueTypeSize(options.type);
+    const size_t threads = pool.Size() + 1;
+    const size_t window = FitWindow(pool.Size() * kWindowFactor, threads, options.alignment, valueSize, options.memoryBudget);
+    auto next = std::make_unique<ResultStore>(valueSize, options.alignment,
+                                              StoreBudget(window, threads, options.alignment, valueSize, options.memoryBudget));
+
+    // 按块顺序处理旧结果：当前值按序收集成连续数组，与上一轮的数值数组一起交给比较内核
+    const size_t blockCount = store->BlockCount();
+    std::vector<EncodedBlock> encoded(std::min(window, blockCount));
+    for (size_t start = 0; start < blockCount; start += window) {
+        if (cancel && cancel->load()) return store->Count();
+        size_t n = std::min(window, blockCount - start);
+        pool.ParallelFor(n, [&](size_t i) {
+            size_t index = start + i;
+            thread_local std::vector<uintptr_t> addrs;
+            thread_local std::vector<uint8_t> old;
+            thread_local std::vector<uint8_t> vals;
+            thread_local std::vector<uint8_t> readable;
+            thread_local std::vector<uint64_t> mask;
+            store->DecodeBlock(index, addrs);
+            if (CompareNeedsOld(op)) store->DecodeValues(index, old);
+            const size_t count = addrs.size();
+            vals.resize(count * valueSize);
+            readable.assign(count, 1);
+
+            uintptr_t lo = addrs.front();
+            size_t span = addrs.back() + valueSize - lo;
+            std::vector<uint8_t> &buf = ThreadBuffer(span);
+            if (src.ReadMemory(lo, buf.data(), span)) {
+                for (size_t k = 0; k < count; ++k) {
+                    std::memcpy(vals.data() + k * valueSize, buf.data() + (addrs[k] - lo), valueSize);
+                }
+            } else {
+                for (size_t k = 0; k < count; ++k) {
+                    readable[k] = src.ReadMemory(addrs[k], vals.data() + k * valueSize, valueSize) ? 1 : 0;
+                }
+            }
+
+            mask.resize((count + 63) / 64);
+            CompareBuffer(options.type, op, args, vals.data(), old.data(), count, valueSize, mask.data());
+            size_t kept = 0;
+            for (size_t k = 0; k < count; ++k) {
+                if (!((mask[k / 64] >> (k % 64)) & 1) || !readable[k]) continue;
+                addrs[kept] = addrs[k];
+                std::memmove(vals.data() + kept * valueSize, vals.data() + k * valueSize, valueSize);
+                ++kept;
+            }
+            addrs.resize(kept);
+            ResultStore::EncodeBlock(store->BlockBase(index), store->BlockSpan(index), options.alignment, valueSize,
+                                     addrs.data(), vals.data(), addrs.size(), encoded[i]);
+        });
+        for (size_t i = 0; i < n; ++i) next->Append(encoded[i]);
+    }
+    store = std::move(next);
+    return store->Count();
+}
+
+size_t Scanner::Count() const {
+    std::lock_guard<std::mutex> g(m);
+    return store ? store->Count() : 0;
+}
+
+ValueType Scanner::Type() const {
+    std::lock_guard<std::mutex> g(m);
+    return options.type;
+}
+
+size_t Scanner::BytesUsed() const {
+    std::lock_guard<std::mutex> g(m);
+    return store ? store->BytesUsed() : 0;
+}
+
+bool Scanner::Spilled() const {
+    std::lock_guard<std::mutex> g(m);
+    return store && store->Spilled();
+}
+
+size_t Scanner::GetResults(size_t offset, size_t count, std::vector<ScanHit>& out) const {
+    std::lock_guard<std::mutex> g(m);
+    out.clear();
+    if (!store) return 0;
+    std::vector<uintptr_t> addrs;
+    std::vector<uint8_t> vals;
+    size_t n = store->Read(offset, count, addrs, vals);
+    const size_t valueSize = store->ValueSize();
+    out.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        out[i].address = addrs[i];
+        out[i].value = 0;
+        std::memcpy(&out[i].value, vals.data() + i * valueSize, valueSize);
+    }
+    return n;
+}
+
+void Scanner::Reset() {
+    std::lock_guard<std::mutex> g(m);
+    store.reset();
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "compare_kernels.h"
+#include "memory_source.h"
+#include "result_store.h"
+#include "thread_pool.h"
+#include "value_type.h"
+
+struct ScanOptions {
+    ValueType type = ValueType::Int32;
+    size_t alignment = 0;           // 0 表示按类型大小对齐（快速扫描）
+    bool writableOnly = true;
+    bool includeMapped = false;
+    uintptr_t startAddress = 0;
+    uintptr_t endAddress = UINTPTR_MAX;
+    // 扫描的内存预算：并行窗口的缓冲按最密集的情况计入，剩余部分给结果，结果超出后转存到临时文件
+    size_t memoryBudget = ResultStore::kDefaultBudget;
+};
+
+struct ScanHit {
+    uintptr_t address;
+    uint64_t value;                 // 低位按小端存放原始字节
+};
+
+/**
+ * 数值扫描器：首次扫描遍历目标所有可读区域，按块并行读取，用比较内核生成命中位图；
+ * 再次扫描只重新读取上一轮的候选地址，与常量或上一轮记录的数值比较后过滤。
+ * 结果保存在 ResultStore 中，按块窗口处理，任何时刻只有一个窗口的结果是未压缩的。
+ */
+class Scanner {
+public:
+    // 单个任务处理的块大小，也是单次批量读取的上限
+    static constexpr size_t kChunkSize = 4 * 1024 * 1024;
+
+    explicit Scanner(ThreadPool& pool = ThreadPool::Shared());
+
+    // args 按 opts.type 解释，返回命中数量。首次扫描只支持与常量比较和 Any（未知初始值）；
+    // 再次扫描还支持与上一轮数值比较（Changed、Increased 等）。
+    // cancel 在每个窗口之间检查：首次扫描被取消时清空结果，再次扫描被取消时保留上一轮结果
+    size_t FirstScan(IMemorySource& src, const ScanOptions& opts, CompareOp op, const CompareArgs& args,
+                     const std::atomic<bool>* cancel = nullptr);
+    size_t NextScan(IMemorySource& src, CompareOp op, const CompareArgs& args, const std::atomic<bool>* cancel = nullptr);
+
+    // 扫描进行中（通常在异步线程上），此时其他调用会等待扫描结束
+    bool Busy() const { return busy.load(); }
+
+    size_t Count() const;
+    ValueType Type() const;
+    size_t BytesUsed() const;
+    bool Spilled() const;
+
+    // 分页获取结果，返回实际写入 out 的数量
+    size_t GetResults(size_t offset, size_t count, std::vector<ScanHit>& out) const;
+
+    void Reset();
+
+private:
+    // 每个窗口并行处理的块数最多为线程数 * kWindowFactor，memoryBudget 不足时减少
+    static constexpr size_t kWindowFactor = 4;
+
+    ThreadPool& pool;
+    mutable std::mutex m;
+    std::atomic<bool> busy{ false };
+    ScanOptions options;
+    std::unique_ptr<ResultStore> store;
+};
@@ -0,0 +1,326 @@
+#include "snapshot.h"
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include "thread_pool.h"
+
+namespace {
+
+constexpr size_t kPageSize = 0x1000;
+constexpr size_t kChunkSize = 1024 * 1024;
+const char kSnapshotMagic[4] = { 'X', 'S', 'N', 'P' };
+constexpr uint32_t kSnapshotVersion = 1;
+
+// 文件头占第一页：
+// "XSNP" | version | pointerSize | regionCount | moduleCount | reserved:u32
+// | createdAt:u64 | dataBytes:u64 | indexOffset:u64 | indexSize:u64
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t pointerSize;
+    uint32_t regionCount;
+    uint32_t moduleCount;
+    uint32_t reserved;
+    uint64_t createdAt;
+    uint64_t dataBytes;
+    uint64_t indexOffset;
+    uint64_t indexSize;
+};
+
+// 索引位于数据之后：regionCount 个 SegmentRecord，然后是模块表
+struct SegmentRecord {
+    uint64_t base;
+    uint64_t size;
+    uint64_t offset;
+    uint32_t flags;
+    uint32_t protect;
+};
+
+template<typename T>
+void Append(std::vector<uint8_t>& out, const T& v) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&v);
+    out.insert(out.end(), p, p + sizeof(T));
+}
+
+void AppendWide(std::vector<uint8_t>& out, const std::wstring& s) {
+    Append(out, static_cast<uint32_t>(s.size()));
+    for (wchar_t c : s) Append(out, static_cast<uint16_t>(c));
+}
+
+template<typename T>
+bool ReadAt(const uint8_t* data, size_t size, size_t& off, T& v) {
+    if (off + sizeof(T) > size) return false;
+    std::memcpy(&v, data + off, sizeof(T));
+    off += sizeof(T);
+    return true;
+}
+
+bool ReadWide(const uint8_t* data, size_t size, size_t& off, std::wstring& s) {
+    uint32_t len = 0;
+    if (!ReadAt(data, size, off, len) || off + static_cast<size_t>(len) * 2 > size) return false;
+    s.resize(len);
+    for (uint32_t i = 0; i < len; ++i) {
+        uint16_t c;
+        std::memcpy(&c, data + off + i * 2, 2);
+        s[i] = static_cast<wchar_t>(c);
+    }
+    off += static_cast<size_t>(len) * 2;
+    return true;
+}
+
+// 顺序写入文件并记录位置，段按页对齐开始
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(std::FILE* f) : f(f), pos(0), ok(true) {}
+
+    void Write(const void* p, size_t n) {
+        if (ok && n) ok = std::fwrite(p, 1, n, f) == n;
+        pos += n;
+    }
+
+    void PadToPage() {
+        static const uint8_t kZero[kPageSize] = {};
+        size_t pad = (kPageSize - pos % kPageSize) % kPageSize;
+        Write(kZero, pad);
+    }
+
+    // 追加一段连续数据；与上一段地址相接且属性相同时合并
+    void AddData(const MemoryRegion& region, uintptr_t address, const uint8_t* p, size_t n) {
+        if (segments.empty() || segments.back().base + segments.back().size != address
+            || segments.back().flags != region.flags || segments.back().protect != region.protect) {
+            PadToPage();
+            segments.push_back({ address, 0, pos, region.flags, region.protect });
+        }
+        Write(p, n);
+        segments.back().size += n;
+    }
+
+    std::FILE* f;
+    uint64_t pos;
+    bool ok;
+    std::vector<SegmentRecord> segments;
+};
+
+} // namespace
+
+bool CaptureSnapshot(IMemorySource& src, const ModuleTable* modules, const std::string& path,
+                     const SnapshotOptions& opts, uint64_t* bytes, const std::atomic<bool>* cancel) {
+    std::vector<MemoryRegion> regions;
+    if (!src.QueryRegions(regions)) return false;
+    std::sort(regions.begin(), regions.end(), [](const MemoryRegion& a, const MemoryRegion& b) { return a.base < b.base; });
+
+    struct Chunk { size_t region; uintptr_t base; size_t size; };
+    std::vector<Chunk> chunks;
+    for (size_t i = 0; i < regions.size(); ++i) {
+        const MemoryRegion &r = regions[i];
+        if (!(r.flags & RegionReadable) || (r.flags & RegionGuard)) continue;
+        if (opts.writableOnly && !(r.flags & RegionWritable)) continue;
+        if (!opts.includeMapped && (r.flags & RegionMapped)) continue;
+        for (uintptr_t b = r.base; b < r.base + r.size; b += kChunkSize) {
+            chunks.push_back({ i, b, std::min<size_t>(kChunkSize, r.base + r.size - b) });
+        }
+    }
+
+    std::FILE* f = OpenFileUtf8(path, "wb");
+    if (!f) return false;
+    SnapshotWriter w(f);
+    Header header = {};
+    w.Write(&header, sizeof(header));   // 占位，最后回写
+
+    // 按窗口并行读取，再按地址顺序写入；整块读取失败时逐页重试，不可读的页不写入
+    ThreadPool &pool = ThreadPool::Shared();
+    const size_t window = std::max<size_t>(pool.Size() * 2, 1);
+    struct Slot {
+        std::vector<uint8_t> buf;
+        std::vector<uint8_t> pageOk;
+    };
+    std::vector<Slot> slots(std::min(window, chunks.size()));
+    for (size_t start = 0; start < chunks.size() && w.ok; start += window) {
+        if (cancel && cancel->load()) { w.ok = false; break; }
+        size_t n = std::min(window, chunks.size() - start);
+        pool.ParallelFor(n, [&](size_t i) {
+            const Chunk &c = chunks[start + i];
+            Slot &s = slots[i];
+            s.buf.resize(c.size);
+            size_t pages = (c.size + kPageSize - 1) / kPageSize;
+            if (src.ReadMemory(c.base, s.buf.data(), c.size)) {
+                s.pageOk.assign(pages, 1);
+                return;
+            }
+            s.pageOk.assign(pages, 0);
+            for (size_t k = 0; k < pages; ++k) {
+                size_t off = k * kPageSize;
+                size_t len = std::min(kPageSize, c.size - off);
+                s.pageOk[k] = src.ReadMemory(c.base + off, s.buf.data() + off, len) ? 1 : 0;
+            }
+        });
+        for (size_t i = 0; i < n; ++i) {
+            const Chunk &c = chunks[start + i];
+            const Slot &s = slots[i];
+            size_t k = 0;
+            while (k < s.pageOk.size()) {
+                if (!s.pageOk[k]) { ++k; continue; }
+                size_t e = k;
+                while (e < s.pageOk.size() && s.pageOk[e]) ++e;
+                size_t off = k * kPageSize;
+                size_t len = std::min(e * kPageSize, c.size) - off;
+                w.AddData(regions[c.region], c.base + off, s.buf.data() + off, len);
+                k = e;
+            }
+        }
+    }
+
+    uint64_t dataBytes = 0;
+    for (const auto &s : w.segments) dataBytes += s.size;
+
+    std::vector<uint8_t> index;
+    for (const auto &s : w.segments) Append(index, s);
+    uint32_t moduleCount = 0;
+    if (modules) {
+        for (const auto &m : modules->Modules()) {
+            Append(index, static_cast<uint64_t>(m.base));
+            Append(index, static_cast<uint64_t>(m.size));
+            AppendWide(index, m.name);
+            AppendWide(index, m.path);
+            Append(index, static_cast<uint32_t>(m.sections.size()));
+            for (const auto &sec : m.sections) {
+                Append(index, static_cast<uint32_t>(sec.name.size()));
+                index.insert(index.end(), sec.name.begin(), sec.name.end());
+                Append(index, sec.rva);
+                Append(index, sec.size);
+                Append(index, sec.characteristics);
+            }
+            ++moduleCount;
+        }
+    }
+    w.PadToPage();
+    const uint64_t indexOffset = w.pos;
+    w.Write(index.data(), index.size());
+
+    std::memcpy(header.magic, kSnapshotMagic, 4);
+    header.version = kSnapshotVersion;
+    header.pointerSize = sizeof(uintptr_t);
+    header.regionCount = static_cast<uint32_t>(w.segments.size());
+    header.moduleCount = moduleCount;
+    header.createdAt = static_cast<uint64_t>(std::time(nullptr));
+    header.dataBytes = dataBytes;
+    header.indexOffset = indexOffset;
+    header.indexSize = index.size();
+    bool ok = w.ok && std::fseek(f, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, f) == 1;
+    ok = std::fclose(f) == 0 && ok;
+    if (!ok) {
+        std::remove(path.c_str());
+        return false;
+    }
+    if (bytes) *bytes = dataBytes;
+    return true;
+}
+
+// ---------------- SnapshotSource ----------------
+
+SnapshotSource::SnapshotSource() : generation(0) {}
+
+void SnapshotSource::Close() {
+    file.Close();
+    segments.clear();
+    modules.reset();
+    info = SnapshotInfo();
+}
+
+bool SnapshotSource::Open(const std::string& path) {
+    Close();
+    if (!file.OpenRead(path)) return false;
+    const uint8_t* data = file.Data();
+    const size_t size = file.Size();
+
+    Header h;
+    size_t off = 0;
+    bool ok = ReadAt(data, size, off, h) && std::memcmp(h.magic, kSnapshotMagic, 4) == 0
+        && h.version == kSnapshotVersion && h.pointerSize == sizeof(uintptr_t)
+        && h.indexOffset <= size && h.indexSize <= size - h.indexOffset;
+    const size_t end = ok ? static_cast<size_t>(h.indexOffset + h.indexSize) : 0;
+    off = static_cast<size_t>(h.indexOffset);
+
+    std::vector<ModuleInfo> mods;
+    for (uint32_t i = 0; ok && i < h.regionCount; ++i) {
+        SegmentRecord r;
+        ok = ReadAt(data, end, off, r) && r.offset <= h.indexOffset && r.size <= h.indexOffset - r.offset;
+        if (ok) segments.push_back({ static_cast<uintptr_t>(r.base), static_cast<size_t>(r.size), r.offset, r.flags, r.protect });
+    }
+    for (uint32_t i = 0; ok && i < h.moduleCount; ++i) {
+        ModuleInfo m;
+        uint64_t base = 0, msize = 0;
+        uint32_t sectionCount = 0;
+        ok = ReadAt(data, end, off, base) && ReadAt(data, end, off, msize)
+            && ReadWide(data, end, off, m.name) && ReadWide(data, end, off, m.path)
+            && ReadAt(data, end, off, sectionCount);
+        for (uint32_t k = 0; ok && k < sectionCount; ++k) {
+            ModuleSection sec;
+            uint32_t nameLen = 0;
+            ok = ReadAt(data, end, off, nameLen) && off + nameLen <= end;
+            if (!ok) break;
+            sec.name.assign(reinterpret_cast<const char*>(data + off), nameLen);
+            off += nameLen;
+            ok = ReadAt(data, end, off, sec.rva) && ReadAt(data, end, off, sec.size)
+                && ReadAt(data, end, off, sec.characteristics);
+            if (ok) m.sections.push_back(std::move(sec));
+        }
+        m.base = static_cast<uintptr_t>(base);
+        m.size = static_cast<size_t>(msize);
+        if (ok) mods.push_back(std::move(m));
+    }
+    if (!ok) {
+        Close();
+        return false;
+    }
+
+    std::sort(segments.begin(), segments.end(), [](const Segment& a, const Segment& b) { return a.base < b.base; });
+    // 每次打开使用新的代号，使基于旧快照缓存的指针解析结果失效
+    static std::atomic<uint64_t> nextGeneration{ 1 };
+    generation = nextGeneration++;
+    modules = std::make_shared<const ModuleTable>(std::move(mods), generation);
+    info.createdAt = h.createdAt;
+    info.pointerSize = h.pointerSize;
+    info.regionCount = segments.size();
+    info.moduleCount = h.moduleCount;
+    info.bytes = h.dataBytes;
+    return true;
+}
+
+const SnapshotSource::Segment* SnapshotSource::FindSegment(uintptr_t address) const {
+    auto it = std::upper_bound(segments.begin(), segments.end(), address,
+        [](uintptr_t a, const Segment& s) { return a < s.base; });
+    if (it == segments.begin()) return nullptr;
+    --it;
+    return address - it->base < it->size ? &*it : nullptr;
+}
+
+bool SnapshotSource::QueryRegions(std::vector<MemoryRegion>& out) {
+    out.clear();
+    if (!IsOpen()) return false;
+    out.reserve(segments.size());
+    for (const auto &s : segments) out.push_back({ s.base, s.size, s.flags, s.protect });
+    return true;
+}
+
+const uint8_t* SnapshotSource::Data(uintptr_t address, size_t size) const {
+    const Segment* s = FindSegment(address);
+    if (!s || size > s->size - (address - s->base)) return nullptr;
+    return file.Data() + s->offset + (address - s->base);
+}
+
+bool SnapshotSource::ReadMemory(uintptr_t address, void* buffer, size_t size) {
+    // 读取可以跨越地址相接的多个段
+    uint8_t* out = static_cast<uint8_t*>(buffer);
+    while (size > 0) {
+        const Segment* s = FindSegment(address);
+        if (!s) return false;
+        size_t off = address - s->base;
+        size_t n = std::min(size, s->size - off);
+        std::memcpy(out, file.Data() + s->offset + off, n);
+        out += n;
+        address += n;
+        size -= n;
+    }
+    return true;
+}
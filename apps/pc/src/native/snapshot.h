@@ -0,0 +1,69 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "mapped_file.h"
+#include "memory_source.h"
+#include "module_map.h"
+
+struct SnapshotOptions {
+    bool writableOnly = false;      // 只保存可写区域（数据段/堆/栈），体积小很多
+    bool includeMapped = true;
+};
+
+struct SnapshotInfo {
+    uint64_t createdAt = 0;         // Unix 时间（秒）
+    uint32_t pointerSize = 0;
+    size_t regionCount = 0;
+    size_t moduleCount = 0;
+    uint64_t bytes = 0;             // 区域数据总字节数
+};
+
+// 把 src 中可读区域和模块表写入快照文件，bytes 返回区域数据字节数；失败或取消返回 false
+bool CaptureSnapshot(IMemorySource& src, const ModuleTable* modules, const std::string& path,
+                     const SnapshotOptions& opts, uint64_t* bytes = nullptr,
+                     const std::atomic<bool>* cancel = nullptr);
+
+/**
+ * 只读快照：以内存映射方式打开快照文件，按 IMemorySource 提供区域枚举、读取和模块表，
+ * 扫描、指针解析等代码不需要修改即可离线运行在冻结的镜像上。
+ * 区域数据按页对齐存放，Data() 直接返回映射内的指针（零拷贝）。
+ * 打开后只读，可在多个线程中并发读取。
+ */
+class SnapshotSource : public IMemorySource {
+public:
+    SnapshotSource();
+
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return file.IsOpen(); }
+    const SnapshotInfo& Info() const { return info; }
+
+    bool QueryRegions(std::vector<MemoryRegion>& out) override;
+    bool ReadMemory(uintptr_t address, void* buffer, size_t size) override;
+    std::shared_ptr<const ModuleTable> GetModules() override { return modules; }
+    uint64_t ModuleGeneration() const override { return generation; }
+
+    // [address, address+size) 位于同一段数据内时返回映射内的指针，否则返回 nullptr
+    const uint8_t* Data(uintptr_t address, size_t size) const;
+
+private:
+    struct Segment {
+        uintptr_t base;
+        size_t size;
+        uint64_t offset;    // 文件内偏移
+        uint32_t flags;
+        uint32_t protect;
+    };
+
+    const Segment* FindSegment(uintptr_t address) const;
+
+    MappedFile file;
+    std::vector<Segment> segments;      // 按地址升序
+    std::shared_ptr<const ModuleTable> modules;
+    SnapshotInfo info;
+    uint64_t generation;
+};
@@ -0,0 +1,200 @@
+#include "stats.h"
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+const char* StatOpName(StatOp op) {
+    switch (op) {
+    case StatRead: return "read";
+    case StatWrite: return "write";
+    case StatProtect: return "protect";
+    case StatNapiCall: return "napi";
+    case StatLockTick: return "lockTick";
+    default: return "unknown";
+    }
+}
+
+const char* StatCounterName(StatCounter c) {
+    switch (c) {
+    case StatLockWrites: return "lockWrites";
+    case StatLockSkipped: return "lockSkipped";
+    case StatLockFailures: return "lockFailures";
+    case StatCacheHits: return "cacheHits";
+    case StatCacheMisses: return "cacheMisses";
+    default: return "unknown";
+    }
+}
+
+uint64_t StatPercentileNs(const StatOpSummary& s, double p) {
+    uint64_t total = 0;
+    for (size_t i = 0; i < kStatBuckets; ++i) total += s.hist[i];
+    if (total == 0) return 0;
+    uint64_t rank = static_cast<uint64_t>(p * static_cast<double>(total));
+    if (rank >= total) rank = total - 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kStatBuckets; ++i) {
+        seen += s.hist[i];
+        if (seen > rank) return (2ull << i) - 1;
+    }
+    return UINT64_MAX;
+}
+
+#if TRAINER_STATS
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+inline size_t BucketOf(uint64_t ns) {
+    if (ns == 0) return 0;
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanReverse64(&idx, ns);
+    size_t b = idx;
+#else
+    size_t b = 63 - static_cast<size_t>(__builtin_clzll(ns));
+#endif
+    return std::min(b, kStatBuckets - 1);
+}
+
+// 只由所属线程写入，relaxed 的读+写即可，不需要原子读改写
+inline void Bump(std::atomic<uint64_t>& a, uint64_t n) {
+    a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+struct OpCell {
+    std::atomic<uint64_t> calls{ 0 };
+    std::atomic<uint64_t> failures{ 0 };
+    std::atomic<uint64_t> bytes{ 0 };
+    std::atomic<uint64_t> totalNs{ 0 };
+    std::atomic<uint64_t> hist[kStatBuckets] = {};
+};
+
+struct ThreadBlock {
+    OpCell ops[StatOpCount];
+    std::atomic<uint64_t> counters[StatCounterCount] = {};
+};
+
+void Accumulate(const ThreadBlock& b, StatsSnapshot& out) {
+    for (size_t i = 0; i < StatOpCount; ++i) {
+        const OpCell &c = b.ops[i];
+        StatOpSummary &s = out.ops[i];
+        s.calls += c.calls.load(std::memory_order_relaxed);
+        s.failures += c.failures.load(std::memory_order_relaxed);
+        s.bytes += c.bytes.load(std::memory_order_relaxed);
+        s.totalNs += c.totalNs.load(std::memory_order_relaxed);
+        for (size_t k = 0; k < kStatBuckets; ++k) s.hist[k] += c.hist[k].load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < StatCounterCount; ++i) out.counters[i] += b.counters[i].load(std::memory_order_relaxed);
+}
+
+void Subtract(StatsSnapshot& a, const StatsSnapshot& b) {
+    for (size_t i = 0; i < StatOpCount; ++i) {
+        StatOpSummary &s = a.ops[i];
+        const StatOpSummary &base = b.ops[i];
+        s.calls -= base.calls;
+        s.failures -= base.failures;
+        s.bytes -= base.bytes;
+        s.totalNs -= base.totalNs;
+        for (size_t k = 0; k < kStatBuckets; ++k) s.hist[k] -= base.hist[k];
+    }
+    for (size_t i = 0; i < StatCounterCount; ++i) a.counters[i] -= b.counters[i];
+}
+
+// 全局登记表；有意不析构，线程退出时（包括进程退出阶段）仍可安全访问
+struct Registry {
+    std::mutex m;
+    std::vector<ThreadBlock*> live;
+    ThreadBlock retired;            // 已退出线程的累计
+    StatsSnapshot baseline;         // 上次重置时的汇总
+    Clock::time_point resetAt;
+
+    Registry() : resetAt(Clock::now()) { std::memset(&baseline, 0, sizeof(baseline)); }
+
+    // 调用方持有 m
+    void Sum(StatsSnapshot& out) {
+        std::memset(&out, 0, sizeof(out));
+        Accumulate(retired, out);
+        for (ThreadBlock* b : live) Accumulate(*b, out);
+    }
+};
+
+Registry& Reg() {
+    static Registry* r = new Registry();
+    return *r;
+}
+
+struct ThreadHolder {
+    ThreadBlock* block = nullptr;
+
+    ThreadBlock& Get() {
+        if (!block) {
+            block = new ThreadBlock();
+            Registry &r = Reg();
+            std::lock_guard<std::mutex> g(r.m);
+            r.live.push_back(block);
+        }
+        return *block;
+    }
+
+    ~ThreadHolder() {
+        if (!block) return;
+        Registry &r = Reg();
+        std::lock_guard<std::mutex> g(r.m);
+        for (size_t i = 0; i < StatOpCount; ++i) {
+            OpCell &dst = r.retired.ops[i];
+            const OpCell &src = block->ops[i];
+            Bump(dst.calls, src.calls.load(std::memory_order_relaxed));
+            Bump(dst.failures, src.failures.load(std::memory_order_relaxed));
+            Bump(dst.bytes, src.bytes.load(std::memory_order_relaxed));
+            Bump(dst.totalNs, src.totalNs.load(std::memory_order_relaxed));
+            for (size_t k = 0; k < kStatBuckets; ++k) Bump(dst.hist[k], src.hist[k].load(std::memory_order_relaxed));
+        }
+        for (size_t i = 0; i < StatCounterCount; ++i) {
+            Bump(r.retired.counters[i], block->counters[i].load(std::memory_order_relaxed));
+        }
+        r.live.erase(std::remove(r.live.begin(), r.live.end(), block), r.live.end());
+        delete block;
+    }
+};
+
+thread_local ThreadHolder holder;
+
+} // namespace
+
+void StatRecord(StatOp op, uint64_t bytes, uint64_t ns, bool ok) {
+    OpCell &c = holder.Get().ops[op];
+    Bump(c.calls, 1);
+    if (!ok) Bump(c.failures, 1);
+    Bump(c.bytes, bytes);
+    Bump(c.totalNs, ns);
+    Bump(c.hist[BucketOf(ns)], 1);
+}
+
+void StatAdd(StatCounter c, uint64_t n) {
+    Bump(holder.Get().counters[c], n);
+}
+
+bool StatsCollect(StatsSnapshot& out) {
+    Registry &r = Reg();
+    std::lock_guard<std::mutex> g(r.m);
+    r.Sum(out);
+    Subtract(out, r.baseline);
+    out.elapsedSec = std::chrono::duration<double>(Clock::now() - r.resetAt).count();
+    out.threads = r.live.size();
+    return true;
+}
+
+void StatsReset() {
+    Registry &r = Reg();
+    std::lock_guard<std::mutex> g(r.m);
+    r.Sum(r.baseline);
+    r.resetAt = Clock::now();
+}
+
+#endif
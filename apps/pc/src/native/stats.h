@@ -0,0 +1,94 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// 由构建配置定义 TRAINER_STATS=1 启用（默认关闭，基准测试/开发时用 npm run build:native:stats 构建）；
+// 未启用时下面的宏全部展开为空
+#ifndef TRAINER_STATS
+#define TRAINER_STATS 0
+#endif
+
+// 计时的操作类别
+enum StatOp : uint32_t {
+    StatRead = 0,       // ReadProcessMemory / process_vm_readv（分散读取按一次调用计）
+    StatWrite,          // WriteProcessMemory / process_vm_writev
+    StatProtect,        // VirtualProtectEx（修改与恢复各计一次）
+    StatNapiCall,       // JS -> native 的同步调用
+    StatLockTick,       // 锁定调度线程每个 tick 的处理
+    StatOpCount
+};
+
+// 只计数不计时的事件
+enum StatCounter : uint32_t {
+    StatLockWrites = 0,
+    StatLockSkipped,
+    StatLockFailures,
+    StatCacheHits,      // 页缓存命中的块查找
+    StatCacheMisses,    // 需要从目标进程读取的块
+    StatCounterCount
+};
+
+// 延迟直方图：第 i 个桶统计 [2^i, 2^(i+1)) 纳秒，最后一个桶包含更长的耗时
+constexpr size_t kStatBuckets = 32;
+
+struct StatOpSummary {
+    uint64_t calls;
+    uint64_t failures;
+    uint64_t bytes;
+    uint64_t totalNs;
+    uint64_t hist[kStatBuckets];
+};
+
+struct StatsSnapshot {
+    StatOpSummary ops[StatOpCount];
+    uint64_t counters[StatCounterCount];
+    double elapsedSec;      // 距上次重置的时间
+    size_t threads;         // 曾记录过数据且仍存活的线程数
+};
+
+const char* StatOpName(StatOp op);
+// 按直方图估计的百分位延迟（所在桶的上界，纳秒）
+uint64_t StatPercentileNs(const StatOpSummary& s, double p);
+const char* StatCounterName(StatCounter c);
+
+#if TRAINER_STATS
+
+/**
+ * 每个线程写自己的计数块（单写者，relaxed 读改写，无锁前缀），
+ * 汇总时遍历所有线程块求和；线程退出时把数据并入全局累计。
+ * 重置只记录当前汇总作为基线，不修改其他线程的计数，因此无需同步。
+ */
+void StatRecord(StatOp op, uint64_t bytes, uint64_t ns, bool ok);
+void StatAdd(StatCounter c, uint64_t n);
+
+// 汇总自上次重置以来的数据
+bool StatsCollect(StatsSnapshot& out);
+void StatsReset();
+
+class StatTimer {
+public:
+    StatTimer() : start(std::chrono::steady_clock::now()) {}
+    uint64_t ElapsedNs() const {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+
+private:
+    std::chrono::steady_clock::time_point start;
+};
+
+#define STAT_TIMER(name) StatTimer name
+#define STAT_RECORD(op, timer, bytes, ok) StatRecord((op), (bytes), (timer).ElapsedNs(), (ok))
+#define STAT_ADD(counter, n) StatAdd((counter), (n))
+
+#else
+
+inline bool StatsCollect(StatsSnapshot&) { return false; }
+inline void StatsReset() {}
+
+#define STAT_TIMER(name) ((void)0)
+#define STAT_RECORD(op, timer, bytes, ok) ((void)0)
+#define STAT_ADD(counter, n) ((void)0)
+
+#endif
@@ -0,0 +1,492 @@
+#include "string_search.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include "cpu_features.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define STR_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define STR_TARGET_AVX2
+#else
+#define STR_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+
+// 大小写折叠区间：[lo, hi] 内（step 为 2 时只取与 lo 同奇偶的码点）的大写字母 + delta 为小写
+struct FoldRange {
+    uint32_t lo, hi;
+    int32_t delta;
+    uint32_t step;
+};
+
+const FoldRange kAsciiFold[] = {
+    { 0x41, 0x5A, 0x20, 1 },
+};
+
+const FoldRange kUnicodeFold[] = {
+    { 0x41, 0x5A, 0x20, 1 },
+    { 0xC0, 0xD6, 0x20, 1 },        // Latin-1
+    { 0xD8, 0xDE, 0x20, 1 },
+    { 0x100, 0x12E, 1, 2 },         // Latin Extended-A
+    { 0x132, 0x136, 1, 2 },
+    { 0x139, 0x147, 1, 2 },
+    { 0x14A, 0x176, 1, 2 },
+    { 0x178, 0x178, -0x79, 1 },
+    { 0x179, 0x17D, 1, 2 },
+    { 0x386, 0x386, 0x26, 1 },      // 希腊
+    { 0x388, 0x38A, 0x25, 1 },
+    { 0x38C, 0x38C, 0x40, 1 },
+    { 0x38E, 0x38F, 0x3F, 1 },
+    { 0x391, 0x3A1, 0x20, 1 },
+    { 0x3A3, 0x3AB, 0x20, 1 },
+    { 0x3C2, 0x3C2, 1, 1 },         // 词尾 sigma
+    { 0x400, 0x40F, 0x50, 1 },      // 西里尔
+    { 0x410, 0x42F, 0x20, 1 },
+    { 0x460, 0x480, 1, 2 },
+    { 0x48A, 0x4BE, 1, 2 },
+    { 0xFF21, 0xFF3A, 0x20, 1 },    // 全角
+};
+
+template<size_t N>
+uint32_t FoldWith(const FoldRange (&table)[N], uint32_t cp) {
+    for (const FoldRange& r : table) {
+        if (cp >= r.lo && cp <= r.hi && (cp - r.lo) % r.step == 0) return cp + r.delta;
+    }
+    return cp;
+}
+
+// 折叠后等于 FoldCase(cp) 的全部码点
+void CaseVariants(uint32_t cp, bool unicode, std::vector<uint32_t>& out) {
+    uint32_t lower = FoldCase(cp, unicode);
+    out.assign(1, lower);
+    auto add = [&](const FoldRange& r) {
+        uint32_t u = lower - r.delta;
+        if (u >= r.lo && u <= r.hi && (u - r.lo) % r.step == 0 && std::find(out.begin(), out.end(), u) == out.end()) {
+            out.push_back(u);
+        }
+    };
+    if (unicode) for (const FoldRange& r : kUnicodeFold) add(r);
+    else for (const FoldRange& r : kAsciiFold) add(r);
+}
+
+bool DecodeUtf8(const std::string& s, std::vector<uint32_t>& out) {
+    out.clear();
+    size_t i = 0;
+    while (i < s.size()) {
+        uint32_t cp;
+        size_t n = 0;
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        if (c < 0x80) { cp = c; n = 1; }
+        else if ((c & 0xE0) == 0xC0) { cp = c & 0x1F; n = 2; }
+        else if ((c & 0xF0) == 0xE0) { cp = c & 0x0F; n = 3; }
+        else if ((c & 0xF8) == 0xF0) { cp = c & 0x07; n = 4; }
+        else return false;
+        if (i + n > s.size()) return false;
+        for (size_t k = 1; k < n; ++k) {
+            unsigned char cc = static_cast<unsigned char>(s[i + k]);
+            if ((cc & 0xC0) != 0x80) return false;
+            cp = (cp << 6) | (cc & 0x3F);
+        }
+        out.push_back(cp);
+        i += n;
+    }
+    return true;
+}
+
+// 解码 p 处的一个字符，返回字节数，非法时返回 0
+size_t DecodeUtf8At(const uint8_t* p, size_t avail, uint32_t& cp) {
+    if (!avail) return 0;
+    uint8_t c = p[0];
+    size_t n;
+    if (c < 0x80) { cp = c; return 1; }
+    else if ((c & 0xE0) == 0xC0) { cp = c & 0x1F; n = 2; }
+    else if ((c & 0xF0) == 0xE0) { cp = c & 0x0F; n = 3; }
+    else if ((c & 0xF8) == 0xF0) { cp = c & 0x07; n = 4; }
+    else return 0;
+    if (n > avail) return 0;
+    for (size_t k = 1; k < n; ++k) {
+        if ((p[k] & 0xC0) != 0x80) return 0;
+        cp = (cp << 6) | (p[k] & 0x3F);
+    }
+    return n;
+}
+
+size_t DecodeUtf16At(const uint8_t* p, size_t avail, uint32_t& cp) {
+    if (avail < 2) return 0;
+    uint32_t u = p[0] | (p[1] << 8);
+    if (u < 0xD800 || u > 0xDFFF) { cp = u; return 2; }
+    if (u > 0xDBFF || avail < 4) return 0;
+    uint32_t l = p[2] | (p[3] << 8);
+    if (l < 0xDC00 || l > 0xDFFF) return 0;
+    cp = 0x10000 + ((u - 0xD800) << 10) + (l - 0xDC00);
+    return 4;
+}
+
+size_t DecodeAt(uint8_t encoding, const uint8_t* p, size_t avail, uint32_t& cp) {
+    return encoding == EncodingUtf8 ? DecodeUtf8At(p, avail, cp) : DecodeUtf16At(p, avail, cp);
+}
+
+void EncodeChar(uint8_t encoding, uint32_t cp, std::vector<uint8_t>& out) {
+    out.clear();
+    if (encoding == EncodingUtf16LE) {
+        auto unit = [&](uint32_t u) { out.push_back(static_cast<uint8_t>(u)); out.push_back(static_cast<uint8_t>(u >> 8)); };
+        if (cp < 0x10000) {
+            unit(cp);
+        } else {
+            unit(0xD800 + ((cp - 0x10000) >> 10));
+            unit(0xDC00 + ((cp - 0x10000) & 0x3FF));
+        }
+    } else if (cp < 0x80) {
+        out.push_back(static_cast<uint8_t>(cp));
+    } else if (cp < 0x800) {
+        out.push_back(static_cast<uint8_t>(0xC0 | (cp >> 6)));
+        out.push_back(static_cast<uint8_t>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        out.push_back(static_cast<uint8_t>(0xE0 | (cp >> 12)));
+        out.push_back(static_cast<uint8_t>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<uint8_t>(0x80 | (cp & 0x3F)));
+    } else {
+        out.push_back(static_cast<uint8_t>(0xF0 | (cp >> 18)));
+        out.push_back(static_cast<uint8_t>(0x80 | ((cp >> 12) & 0x3F)));
+        out.push_back(static_cast<uint8_t>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<uint8_t>(0x80 | (cp & 0x3F)));
+    }
+}
+
+// 一种编码下的查询模式
+struct Needle {
+    uint8_t encoding;
+    std::vector<uint8_t> bytes;                 // 查询原样编码，区分大小写时直接比较
+    std::vector<std::vector<uint8_t>> sets;     // 每个字节位置允许的取值（含大小写变体）
+    std::vector<uint32_t> folded;               // 折叠后的码点，不区分大小写时逐字符确认
+    bool anchored = false;                      // 没有合适的锚点时逐位置确认
+    uint32_t o1 = 0, o2 = 0;
+    uint8_t a[2] = { 0, 0 };
+    uint8_t b[2] = { 0, 0 };
+};
+
+// 0x00 和空格在文本附近极常见，尽量不作为锚点
+int AnchorCost(const std::vector<uint8_t>& set) {
+    int cost = static_cast<int>(set.size());
+    for (uint8_t v : set) {
+        if (v == 0x00) cost += 100;
+        else if (v == 0x20) cost += 10;
+    }
+    return cost;
+}
+
+bool BuildNeedle(const std::vector<uint32_t>& cps, uint8_t encoding, StringCase caseMode, Needle& n) {
+    n.encoding = encoding;
+    std::vector<uint32_t> variants;
+    std::vector<uint8_t> enc, venc;
+    bool unicode = caseMode == StringCase::Unicode;
+    for (uint32_t cp : cps) {
+        if (cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return false;
+        EncodeChar(encoding, cp, enc);
+        size_t at = n.bytes.size();
+        n.bytes.insert(n.bytes.end(), enc.begin(), enc.end());
+        n.sets.resize(n.bytes.size());
+        if (caseMode == StringCase::Sensitive) variants.assign(1, cp);
+        else CaseVariants(cp, unicode, variants);
+        n.folded.push_back(caseMode == StringCase::Sensitive ? cp : FoldCase(cp, unicode));
+        for (uint32_t v : variants) {
+            EncodeChar(encoding, v, venc);
+            if (venc.size() != enc.size()) continue;   // 编码长度不同的变体不参与（折叠表中不存在这种情况）
+            for (size_t k = 0; k < venc.size(); ++k) {
+                auto &set = n.sets[at + k];
+                if (std::find(set.begin(), set.end(), venc[k]) == set.end()) set.push_back(venc[k]);
+            }
+        }
+        for (size_t k = 0; k < enc.size(); ++k) {
+            auto &set = n.sets[at + k];
+            if (std::find(set.begin(), set.end(), enc[k]) == set.end()) set.push_back(enc[k]);
+        }
+    }
+    if (n.bytes.empty()) return false;
+
+    // 选两个代价最小、取值不超过两个的位置作锚点，代价相同时第二个尽量远离第一个
+    int best1 = -1, best2 = -1;
+    for (size_t k = 0; k < n.sets.size(); ++k) {
+        if (n.sets[k].size() > 2) continue;
+        if (best1 < 0 || AnchorCost(n.sets[k]) < AnchorCost(n.sets[best1])) best1 = static_cast<int>(k);
+    }
+    if (best1 < 0) return true;
+    for (size_t k = 0; k < n.sets.size(); ++k) {
+        if (static_cast<int>(k) == best1 || n.sets[k].size() > 2) continue;
+        int c = AnchorCost(n.sets[k]);
+        if (best2 < 0 || c < AnchorCost(n.sets[best2]) ||
+            (c == AnchorCost(n.sets[best2]) && std::abs(static_cast<int>(k) - best1) > std::abs(best2 - best1))) {
+            best2 = static_cast<int>(k);
+        }
+    }
+    if (best2 < 0) best2 = best1;
+    n.anchored = true;
+    n.o1 = static_cast<uint32_t>(best1);
+    n.o2 = static_cast<uint32_t>(best2);
+    const auto &s1 = n.sets[best1], &s2 = n.sets[best2];
+    n.a[0] = s1[0];
+    n.a[1] = s1.size() > 1 ? s1[1] : s1[0];
+    n.b[0] = s2[0];
+    n.b[1] = s2.size() > 1 ? s2[1] : s2[0];
+    return true;
+}
+
+// 确认 p 处是否匹配，返回匹配的字节数，不匹配返回 0
+size_t Verify(const Needle& n, StringCase caseMode, const uint8_t* p, size_t avail) {
+    if (caseMode == StringCase::Sensitive) {
+        return avail >= n.bytes.size() && std::memcmp(p, n.bytes.data(), n.bytes.size()) == 0 ? n.bytes.size() : 0;
+    }
+    bool unicode = caseMode == StringCase::Unicode;
+    size_t pos = 0;
+    for (uint32_t q : n.folded) {
+        uint32_t cp;
+        size_t len = DecodeAt(n.encoding, p + pos, avail - pos, cp);
+        if (!len || FoldCase(cp, unicode) != q) return 0;
+        pos += len;
+    }
+    return pos;
+}
+
+inline unsigned LowestBit32(uint32_t v) {
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward(&idx, v);
+    return idx;
+#else
+    return static_cast<unsigned>(__builtin_ctz(v));
+#endif
+}
+
+// 对每个 data[i+o1] ∈ a 且 data[i+o2] ∈ b 的 i ∈ [0, count) 调用 fn(i)
+template<typename F>
+void FilterScalar(const uint8_t* data, size_t count, const Needle& n, F&& fn) {
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t x = data[i + n.o1], y = data[i + n.o2];
+        if ((x == n.a[0] || x == n.a[1]) && (y == n.b[0] || y == n.b[1])) fn(i);
+    }
+}
+
+#ifdef STR_X86
+template<typename F>
+void FilterSse2(const uint8_t* data, size_t count, const Needle& n, F&& fn) {
+    const __m128i a0 = _mm_set1_epi8(static_cast<char>(n.a[0])), a1 = _mm_set1_epi8(static_cast<char>(n.a[1]));
+    const __m128i b0 = _mm_set1_epi8(static_cast<char>(n.b[0])), b1 = _mm_set1_epi8(static_cast<char>(n.b[1]));
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + n.o1));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + n.o2));
+        __m128i mx = _mm_or_si128(_mm_cmpeq_epi8(x, a0), _mm_cmpeq_epi8(x, a1));
+        __m128i my = _mm_or_si128(_mm_cmpeq_epi8(y, b0), _mm_cmpeq_epi8(y, b1));
+        uint32_t bits = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(mx, my)));
+        while (bits) {
+            fn(i + LowestBit32(bits));
+            bits &= bits - 1;
+        }
+    }
+    FilterScalar(data + i, count - i, n, [&](size_t k) { fn(i + k); });
+}
+
+template<typename F>
+STR_TARGET_AVX2 void FilterAvx2(const uint8_t* data, size_t count, const Needle& n, F&& fn) {
+    const __m256i a0 = _mm256_set1_epi8(static_cast<char>(n.a[0])), a1 = _mm256_set1_epi8(static_cast<char>(n.a[1]));
+    const __m256i b0 = _mm256_set1_epi8(static_cast<char>(n.b[0])), b1 = _mm256_set1_epi8(static_cast<char>(n.b[1]));
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + n.o1));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + n.o2));
+        __m256i mx = _mm256_or_si256(_mm256_cmpeq_epi8(x, a0), _mm256_cmpeq_epi8(x, a1));
+        __m256i my = _mm256_or_si256(_mm256_cmpeq_epi8(y, b0), _mm256_cmpeq_epi8(y, b1));
+        uint32_t bits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(mx, my)));
+        while (bits) {
+            fn(i + LowestBit32(bits));
+            bits &= bits - 1;
+        }
+    }
+    FilterScalar(data + i, count - i, n, [&](size_t k) { fn(i + k); });
+}
+#endif
+
+template<typename F>
+void FilterCandidates(const uint8_t* data, size_t count, const Needle& n, F&& fn) {
+    if (!n.anchored) {
+        for (size_t i = 0; i < count; ++i) fn(i);
+        return;
+    }
+#ifdef STR_X86
+    if (GetCpuFeatures().avx2) FilterAvx2(data, count, n, fn);
+    else FilterSse2(data, count, n, fn);
+#else
+    FilterScalar(data, count, n, fn);
+#endif
+}
+
+} // namespace
+
+uint32_t FoldCase(uint32_t cp, bool unicode) {
+    return unicode ? FoldWith(kUnicodeFold, cp) : FoldWith(kAsciiFold, cp);
+}
+
+std::string DecodeText(const uint8_t* data, size_t size, uint8_t encoding) {
+    std::string out;
+    std::vector<uint8_t> enc;
+    size_t i = 0;
+    if (encoding == EncodingUtf8) {
+        while (i < size && (data[i] & 0xC0) == 0x80) ++i;
+    }
+    while (i < size) {
+        uint32_t cp;
+        size_t n = DecodeAt(encoding, data + i, size - i, cp);
+        if (!n) {
+            cp = 0xFFFD;
+            n = encoding == EncodingUtf8 ? 1 : 2;
+        } else if (cp < 0x20 || cp == 0x7F) {
+            cp = '.';
+        }
+        EncodeChar(EncodingUtf8, cp, enc);
+        out.append(enc.begin(), enc.end());
+        i += n;
+    }
+    return out;
+}
+
+StringSearcher::StringSearcher(ThreadPool& pool) : pool(pool) {}
+
+size_t StringSearcher::Search(IMemorySource& src, const std::string& query, const StringSearchOptions& opts,
+                              const std::atomic<bool>* cancel) {
+    std::lock_guard<std::mutex> g(m);
+    busy = true;
+    results.clear();
+    truncated = false;
+    struct BusyReset {
+        std::atomic<bool>& flag;
+        ~BusyReset() { flag = false; }
+    } reset{ busy };
+
+    std::vector<uint32_t> cps;
+    if (!DecodeUtf8(query, cps) || cps.empty()) return 0;
+    std::vector<Needle> needles;
+    for (uint8_t enc : { EncodingUtf8, EncodingUtf16LE }) {
+        if (!(opts.encodings & enc)) continue;
+        needles.emplace_back();
+        if (!BuildNeedle(cps, enc, opts.caseMode, needles.back())) return 0;
+    }
+    if (needles.empty()) return 0;
+    size_t maxLen = 0;
+    for (const Needle& n : needles) maxLen = std::max(maxLen, n.bytes.size());
+
+    std::vector<MemoryRegion> regions;
+    if (!src.QueryRegions(regions)) return 0;
+
+    // 每块只报告起点在 [base, base+size) 内的匹配；读取范围向两侧扩展以覆盖跨块的匹配和上下文
+    struct Task { uintptr_t base; size_t size; uintptr_t readLo; uintptr_t readHi; };
+    std::vector<Task> tasks;
+    const size_t ctx = opts.contextBytes & ~1u;
+    for (const auto &r : regions) {
+        if (!(r.flags & RegionReadable) || (r.flags & RegionGuard)) continue;
+        if (opts.writableOnly && !(r.flags & RegionWritable)) continue;
+        if (!opts.includeMapped && (r.flags & RegionMapped)) continue;
+        uintptr_t lo = std::max(r.base, opts.startAddress);
+        uintptr_t hi = std::min(r.base + r.size, opts.endAddress);
+        for (uintptr_t b = lo; b < hi; b += kChunkSize) {
+            size_t size = std::min<size_t>(kChunkSize, hi - b);
+            uintptr_t readLo = b - std::min<uintptr_t>(ctx, b - r.base);
+            uintptr_t readHi = std::min<uintptr_t>(b + size + maxLen - 1 + ctx, r.base + r.size);
+            tasks.push_back({ b, size, readLo, readHi });
+        }
+    }
+
+    const size_t window = pool.Size() * kWindowFactor;
+    std::vector<std::vector<StringMatch>> found(std::min(window, tasks.size()));
+    for (size_t start = 0; start < tasks.size() && !truncated; start += window) {
+        if (cancel && cancel->load()) {
+            results.clear();
+            return 0;
+        }
+        size_t n = std::min(window, tasks.size() - start);
+        const size_t quota = opts.maxResults - results.size();
+        pool.ParallelFor(n, [&](size_t i) {
+            const Task &t = tasks[start + i];
+            std::vector<StringMatch> &out = found[i];
+            out.clear();
+            thread_local std::vector<uint8_t> buf;
+            size_t len = t.readHi - t.readLo;
+            buf.resize(len);
+            if (!src.ReadMemory(t.readLo, buf.data(), len)) {
+                // 整块读取失败时按页重试，不可读的页填零（查询不含 NUL 时不会匹配到）
+                bool any = false;
+                for (uintptr_t p = t.readLo; p < t.readHi;) {
+                    size_t n = std::min<size_t>(0x1000 - (p & 0xFFF), t.readHi - p);
+                    uint8_t* dst = buf.data() + (p - t.readLo);
+                    if (src.ReadMemory(p, dst, n)) any = true;
+                    else std::memset(dst, 0, n);
+                    p += n;
+                }
+                if (!any) return;
+            }
+            const size_t from = t.base - t.readLo;
+            const size_t to = from + t.size;        // 起点上限（不含）
+            for (const Needle &nd : needles) {
+                if (len < from + nd.bytes.size()) continue;
+                size_t count = std::min(to, len - nd.bytes.size() + 1) - from;
+                FilterCandidates(buf.data() + from, count, nd, [&](size_t k) {
+                    if (out.size() > quota) return;
+                    size_t off = from + k;
+                    if (nd.encoding == EncodingUtf16LE && opts.utf16Aligned && ((t.readLo + off) & 1)) return;
+                    size_t mlen = Verify(nd, opts.caseMode, buf.data() + off, len - off);
+                    if (!mlen) return;
+                    size_t before = std::min(ctx, off);
+                    size_t after = std::min<size_t>(ctx, len - off - mlen);
+                    StringMatch match;
+                    match.address = t.readLo + off;
+                    match.length = static_cast<uint32_t>(mlen);
+                    match.encoding = nd.encoding;
+                    match.before = static_cast<uint32_t>(before);
+                    match.context.assign(buf.data() + off - before, buf.data() + off + mlen + after);
+                    out.push_back(std::move(match));
+                });
+            }
+            // 两种编码的匹配各自有序，合并为按地址升序
+            std::sort(out.begin(), out.end(), [](const StringMatch& x, const StringMatch& y) { return x.address < y.address; });
+        });
+        for (size_t i = 0; i < n && !truncated; ++i) {
+            for (auto &match : found[i]) {
+                if (results.size() >= opts.maxResults) {
+                    truncated = true;
+                    break;
+                }
+                results.push_back(std::move(match));
+            }
+        }
+    }
+    return results.size();
+}
+
+size_t StringSearcher::Count() const {
+    std::lock_guard<std::mutex> g(m);
+    return results.size();
+}
+
+bool StringSearcher::Truncated() const {
+    std::lock_guard<std::mutex> g(m);
+    return truncated;
+}
+
+size_t StringSearcher::GetResults(size_t offset, size_t count, std::vector<StringMatch>& out) const {
+    std::lock_guard<std::mutex> g(m);
+    out.clear();
+    if (offset >= results.size()) return 0;
+    size_t end = std::min(results.size(), offset + count);
+    out.assign(results.begin() + offset, results.begin() + end);
+    return out.size();
+}
+
+void StringSearcher::Reset() {
+    std::lock_guard<std::mutex> g(m);
+    results.clear();
+    truncated = false;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "memory_source.h"
+#include "thread_pool.h"
+
+enum StringEncoding : uint8_t {
+    EncodingUtf8    = 1u << 0,
+    EncodingUtf16LE = 1u << 1,
+};
+
+enum class StringCase : uint8_t {
+    Sensitive,
+    Ascii,          // 只忽略 ASCII 字母大小写
+    Unicode,        // 另外忽略拉丁、希腊、西里尔和全角字母的大小写（一对一的简单折叠）
+};
+
+struct StringSearchOptions {
+    uint8_t encodings = EncodingUtf8 | EncodingUtf16LE;
+    StringCase caseMode = StringCase::Sensitive;
+    bool utf16Aligned = true;       // UTF-16 只在偶数地址匹配
+    bool writableOnly = false;
+    bool includeMapped = false;
+    uintptr_t startAddress = 0;
+    uintptr_t endAddress = UINTPTR_MAX;
+    uint32_t contextBytes = 32;     // 匹配前后各保留的原始字节数
+    size_t maxResults = 100000;
+};
+
+struct StringMatch {
+    uintptr_t address;
+    uint32_t length;                // 匹配的字节数
+    uint8_t encoding;               // EncodingUtf8 / EncodingUtf16LE
+    uint32_t before;                // context 中匹配之前的字节数
+    std::vector<uint8_t> context;   // 匹配及前后的原始字节（不跨越区域边界）
+};
+
+/**
+ * 文本搜索：把查询按各编码展开为字节模式，在所有可读区域上按块并行读取。
+ * 候选位置用 SIMD 同时比较两个锚点字节（每个锚点最多两个取值，覆盖大小写变体），
+ * 再逐字符解码、折叠大小写后确认。结果按地址升序保存，分页读取。
+ */
+class StringSearcher {
+public:
+    static constexpr size_t kChunkSize = 4 * 1024 * 1024;
+
+    explicit StringSearcher(ThreadPool& pool = ThreadPool::Shared());
+
+    // query 为 UTF-8；返回匹配数量，查询为空或无法编码时返回 0。被取消时清空结果
+    size_t Search(IMemorySource& src, const std::string& query, const StringSearchOptions& opts,
+                  const std::atomic<bool>* cancel = nullptr);
+
+    bool Busy() const { return busy.load(); }
+    size_t Count() const;
+    bool Truncated() const;         // 匹配数超过 maxResults 时只保留前面的部分
+    size_t GetResults(size_t offset, size_t count, std::vector<StringMatch>& out) const;
+    void Reset();
+
+private:
+    static constexpr size_t kWindowFactor = 4;
+
+    ThreadPool& pool;
+    mutable std::mutex m;
+    std::atomic<bool> busy{ false };
+    std::vector<StringMatch> results;
+    bool truncated = false;
+};
+
+// 把目标中的原始文本解码为 UTF-8：非法序列替换为 U+FFFD，控制字符替换为 '.'；
+// UTF-8 开头不完整的字符被跳过
+std::string DecodeText(const uint8_t* data, size_t size, uint8_t encoding);
+
+// 简单大小写折叠（转为小写），unicode 为 false 时只处理 ASCII
+uint32_t FoldCase(uint32_t cp, bool unicode);
@@ -0,0 +1,213 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "aob_scanner.h"
+#include "aob_search.h"
+#include "local_source.h"
+#include "test.h"
+
+namespace {
+
+// 逐位置调用 MatchAt 的参考实现
+std::vector<AobMatch> ReferenceScan(const std::vector<Signature>& sigs, const uint8_t* data, size_t len, uintptr_t base) {
+    std::vector<AobMatch> out;
+    for (size_t i = 0; i < len; ++i) {
+        for (uint32_t s = 0; s < sigs.size(); ++s) {
+            if (sigs[s].Size() <= len - i && sigs[s].MatchAt(data + i)) out.push_back({ s, base + i });
+        }
+    }
+    return out;
+}
+
+void Sort(std::vector<AobMatch>& v) {
+    std::sort(v.begin(), v.end(), [](const AobMatch& a, const AobMatch& b) {
+        return a.address != b.address ? a.address < b.address : a.signature < b.signature;
+    });
+}
+
+bool Same(std::vector<AobMatch> a, std::vector<AobMatch> b) {
+    Sort(a);
+    Sort(b);
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].signature != b[i].signature || a[i].address != b[i].address) return false;
+    }
+    return true;
+}
+
+// 随机数据中按固定间隔写入特征码的实例，其中一处正好跨越 boundary
+std::vector<uint8_t> MakeData(size_t size, const std::vector<Signature>& sigs, size_t boundary) {
+    std::mt19937 rng(42);
+    std::vector<uint8_t> data(size);
+    for (auto &b : data) b = static_cast<uint8_t>(rng() & 0xFF);
+    size_t pos = 100;
+    for (size_t round = 0; pos + 64 < size; ++round) {
+        const Signature &s = sigs[round % sigs.size()];
+        for (size_t k = 0; k < s.Size(); ++k) {
+            data[pos + k] = static_cast<uint8_t>((s.bytes[k] & s.mask[k]) | (data[pos + k] & ~s.mask[k]));
+        }
+        pos += 997;
+    }
+    const Signature &s = sigs[0];
+    size_t at = boundary - s.Size() / 2;
+    for (size_t k = 0; k < s.Size(); ++k) data[at + k] = static_cast<uint8_t>((s.bytes[k] & s.mask[k]) | (data[at + k] & ~s.mask[k]));
+    return data;
+}
+
+std::vector<Signature> ParseAll(const std::vector<const char*>& texts) {
+    std::vector<Signature> sigs;
+    for (const char* t : texts) {
+        Signature s;
+        CHECK(Signature::Parse(t, s));
+        sigs.push_back(s);
+    }
+    return sigs;
+}
+
+// 按 chunk 分块、每块多带 MaxLength-1 字节扫描，与整段参考结果比较
+void CheckChunked(const std::vector<Signature>& sigs, AobScanner::SimdLevel level) {
+    AobScanner scanner;
+    for (const auto &s : sigs) scanner.Add(s);
+    scanner.Build();
+    scanner.SetSimd(level);
+
+    const size_t chunk = 0x1000;
+    std::vector<uint8_t> data = MakeData(16 * chunk, sigs, 5 * chunk);
+    const uintptr_t base = 0x140000000ull & UINTPTR_MAX;
+    std::vector<AobMatch> expected = ReferenceScan(sigs, data.data(), data.size(), base);
+
+    std::vector<AobMatch> whole;
+    scanner.Scan(data.data(), data.size(), data.size(), base, whole);
+    CHECK(Same(whole, expected));
+
+    std::vector<AobMatch> chunked;
+    const size_t overlap = scanner.MaxLength() - 1;
+    for (size_t off = 0; off < data.size(); off += chunk) {
+        size_t size = std::min(chunk, data.size() - off);
+        size_t readSize = std::min(size + overlap, data.size() - off);
+        scanner.Scan(data.data() + off, readSize, size, base + off, chunked);
+    }
+    CHECK(Same(chunked, expected));
+
+    bool crossing = false;
+    for (const auto &m : chunked) crossing |= m.signature == 0 && m.address == base + 5 * chunk - sigs[0].Size() / 2;
+    CHECK(crossing);
+}
+
+const AobScanner::SimdLevel kLevels[] = { AobScanner::SimdLevel::Scalar, AobScanner::SimdLevel::SSE2, AobScanner::SimdLevel::AVX2 };
+
+} // namespace
+
+TEST(SignatureParse) {
+    Signature s;
+    CHECK(Signature::Parse("48 8B 05 ?? ? 4? ?8", s));
+    CHECK_EQ(s.Size(), 7u);
+    CHECK_EQ(s.mask[3], 0x00);
+    CHECK_EQ(s.mask[5], 0xF0);
+    CHECK_EQ(s.mask[6], 0x0F);
+    CHECK(s.ToString() == "48 8B 05 ?? ?? 4? ?8");
+    CHECK(!Signature::Parse("48 8G", s));
+    CHECK(!Signature::Parse("?? ??", s));
+
+    const uint8_t code[] = { 0x48, 0x8B, 0x05, 0x11, 0x22, 0x4C, 0x28 };
+    Signature t;
+    Signature::Parse("48 8B 05 ?? ?? 4? ?8", t);
+    CHECK(t.MatchAt(code));
+}
+
+TEST(AobDirectMatchesReference) {
+    auto sigs = ParseAll({ "48 8B 05 ?? ?? ?? ?? 8B 4? 08", "E8 ?? ?? ?? ?? 90" });
+    for (auto level : kLevels) {
+        if (level > AobScanner::DetectSimd()) continue;
+        CheckChunked(sigs, level);
+    }
+}
+
+TEST(AobAutomatonMatchesReference) {
+    // 超过 kDirectLimit 个特征码时使用 Aho-Corasick
+    auto sigs = ParseAll({ "48 89 5C 24 ?? 57 48 83 EC 20", "40 53 48 83 EC ?? 8B D9", "F3 0F 10 ?? ?? ?? ?? ?? 0F 2F",
+                           "C7 05 ?? ?? ?? ?? 01 00 00 00", "E9 ?? ?? ?? ?? CC CC", "89 4? 24 ?8 DE AD BE EF" });
+    CHECK(sigs.size() > AobScanner::kDirectLimit);
+    for (auto level : kLevels) {
+        if (level > AobScanner::DetectSimd()) continue;
+        CheckChunked(sigs, level);
+    }
+}
+
+TEST(AobFindSignaturesInModule) {
+    LocalSource src;
+    const size_t size = 3 * 1024 * 1024;   // 大于 FindSignatures 的 1MB 分块
+    uint8_t* image = src.AddRegion(size, RegionReadable | RegionExecutable | RegionCommitted | RegionImage);
+    const uint8_t pattern[] = { 0xDE, 0xC0, 0xAD, 0x0B, 0x12, 0x34 };
+    const size_t at[] = { 0x2000, 1024 * 1024 - 3, 2 * 1024 * 1024 + 0x777 };
+    for (size_t off : at) std::memcpy(image + off, pattern, sizeof(pattern));
+
+    ModuleInfo mod;
+    mod.name = L"game.exe";
+    mod.base = reinterpret_cast<uintptr_t>(image);
+    mod.size = size;
+
+    Signature sig;
+    CHECK(Signature::Parse("DE C0 AD 0B ?? 34", sig));
+    SignatureCache cache;
+    AobSearchOptions opts;
+    std::vector<std::vector<uintptr_t>> results;
+    CHECK(FindSignatures(src, mod, { sig }, opts, &cache, results));
+    CHECK_EQ(results.size(), 1u);
+    CHECK_EQ(results[0].size(), 3u);
+    for (size_t i = 0; i < results[0].size() && i < 3; ++i) CHECK_EQ(results[0][i], mod.base + at[i]);
+    CHECK_EQ(cache.Size(), 1u);
+
+    // 第二次命中缓存：清掉内存中的实例也应返回相同的地址
+    std::memset(image + at[0], 0, sizeof(pattern));
+    CHECK(FindSignatures(src, mod, { sig }, opts, &cache, results));
+    CHECK_EQ(results[0].size(), 3u);
+    opts.useCache = false;
+    CHECK(FindSignatures(src, mod, { sig }, opts, &cache, results));
+    CHECK_EQ(results[0].size(), 2u);
+}
+
+TEST(AobFindSignaturesAcrossUnreadablePages) {
+    LocalSource src;
+    const size_t size = 2 * 1024 * 1024;
+    uint8_t* image = src.AddRegion(size, RegionReadable | RegionExecutable | RegionCommitted | RegionImage);
+    const uint8_t pattern[] = { 0xDE, 0xC0, 0xAD, 0x0B, 0x12, 0x34 };
+    // 第一块中有一页不可读，整块读取失败后按页读取：跨页边界的实例仍应找到
+    const size_t page = LocalSource::kPageSize;
+    const size_t at[] = { 0x3000 - 2, 0x8000 + 0x10, 1024 * 1024 - 3 };
+    for (size_t off : at) std::memcpy(image + off, pattern, sizeof(pattern));
+    src.MarkUnreadable(image + 5 * page);
+
+    ModuleInfo mod;
+    mod.name = L"game.exe";
+    mod.base = reinterpret_cast<uintptr_t>(image);
+    mod.size = size;
+
+    Signature sig;
+    CHECK(Signature::Parse("DE C0 AD 0B ?? 34", sig));
+    SignatureCache cache;
+    AobSearchOptions opts;
+    opts.codeOnly = true;   // 没有节信息，扫描整个映像
+    std::vector<std::vector<uintptr_t>> results;
+    CHECK(FindSignatures(src, mod, { sig }, opts, &cache, results));
+    CHECK_EQ(results[0].size(), 3u);
+    for (size_t i = 0; i < results[0].size() && i < 3; ++i) CHECK_EQ(results[0][i], mod.base + at[i]);
+    // 有页没有读到，结果不写入缓存
+    CHECK_EQ(cache.Size(), 0u);
+
+    // 全部可读后写入缓存；没有可执行节时与整映像扫描共用缓存键
+    LocalSource full;
+    uint8_t* image2 = full.AddRegion(size, RegionReadable | RegionExecutable | RegionCommitted | RegionImage);
+    std::memcpy(image2, image, size);
+    mod.base = reinterpret_cast<uintptr_t>(image2);
+    CHECK(FindSignatures(full, mod, { sig }, opts, &cache, results));
+    CHECK_EQ(cache.Size(), 1u);
+    std::memset(image2 + at[0], 0, sizeof(pattern));
+    opts.codeOnly = false;
+    CHECK(FindSignatures(full, mod, { sig }, opts, &cache, results));
+    CHECK_EQ(results[0].size(), 3u);
+    CHECK_EQ(cache.Size(), 1u);
+}
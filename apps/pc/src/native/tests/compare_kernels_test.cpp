@@ -0,0 +1,122 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+#include "compare_kernels.h"
+#include "test.h"
+
+namespace {
+
+const CompareOp kOps[] = {
+    CompareOp::Any, CompareOp::Equal, CompareOp::NotEqual, CompareOp::Greater, CompareOp::Less,
+    CompareOp::Between, CompareOp::Approx, CompareOp::Changed, CompareOp::Unchanged, CompareOp::Increased,
+    CompareOp::Decreased, CompareOp::IncreasedBy, CompareOp::DecreasedBy,
+};
+
+const ValueType kTypes[] = {
+    ValueType::Int8, ValueType::Int16, ValueType::Int32, ValueType::Int64, ValueType::UInt8,
+    ValueType::UInt16, ValueType::UInt32, ValueType::UInt64, ValueType::Float, ValueType::Double,
+};
+
+template<typename T>
+void Store(uint8_t* p, T v) { std::memcpy(p, &v, sizeof(T)); }
+
+// 随机值中混入类型边界、与参数相等的值和（浮点的）NaN/Inf，旧值一半与新值相同、一半相差 a
+template<typename T>
+void Fill(std::mt19937_64& rng, uint8_t* cur, uint8_t* old, size_t n, size_t stride, T a) {
+    const T special[] = {
+        std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max(), static_cast<T>(0), a,
+        std::numeric_limits<T>::has_quiet_NaN ? std::numeric_limits<T>::quiet_NaN() : static_cast<T>(1),
+        std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : static_cast<T>(2),
+    };
+    for (size_t i = 0; i < n; ++i) {
+        T v;
+        uint64_t r = rng();
+        if (r % 5 == 0) v = special[(r >> 8) % 6];
+        else if (std::is_floating_point<T>::value) v = static_cast<T>(static_cast<int64_t>(r >> 40) % 200) / 4;
+        else v = static_cast<T>(r >> 8);
+        T o = v;
+        switch ((r >> 16) % 4) {
+            case 0: o = static_cast<T>(v - a); break;
+            case 1: o = static_cast<T>(v + a); break;
+            case 2: o = static_cast<T>(rng()); break;
+        }
+        Store(cur + i * stride, v);
+        if (old) Store(old + i * stride, o);
+    }
+}
+
+template<typename T>
+void CheckType(ValueType type, std::mt19937_64& rng) {
+    const size_t n = 1000 + 37;     // 覆盖向量尾部
+    for (size_t stride : { sizeof(T), sizeof(T) + 1, size_t(8) }) {
+        if (stride < sizeof(T)) continue;
+        std::vector<uint8_t> cur(n * stride + 8), old(n * stride + 8);
+        T a = static_cast<T>(std::is_floating_point<T>::value ? 2.5 : 3);
+        T b = static_cast<T>(std::is_floating_point<T>::value ? 0.75 : 9);
+        Fill<T>(rng, cur.data(), old.data(), n, stride, a);
+        CompareArgs args;
+        std::memcpy(&args.a, &a, sizeof(T));
+        std::memcpy(&args.b, &b, sizeof(T));
+
+        for (CompareOp op : kOps) {
+            std::vector<uint64_t> expected((n + 63) / 64), actual((n + 63) / 64);
+            ForceCompareIsa(CompareIsa::Scalar);
+            size_t want = CompareBuffer(type, op, args, cur.data(), old.data(), n, stride, expected.data());
+            for (CompareIsa isa : { CompareIsa::Sse42, CompareIsa::Avx2 }) {
+                if (ForceCompareIsa(isa) != isa) continue;
+                std::fill(actual.begin(), actual.end(), ~0ull);
+                size_t got = CompareBuffer(type, op, args, cur.data(), old.data(), n, stride, actual.data());
+                bool same = got == want && actual == expected;
+                if (!same) {
+                    test::Fail(__FILE__, __LINE__, std::string("kernel mismatch: ") + CompareIsaName(isa)
+                               + " type=" + std::to_string(static_cast<int>(type)) + " op=" + std::to_string(static_cast<int>(op))
+                               + " stride=" + std::to_string(stride));
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+TEST(CompareKernelsMatchScalar) {
+    CompareIsa saved = ActiveCompareIsa();
+    std::mt19937_64 rng(7);
+    for (ValueType type : kTypes) {
+        DispatchValueType(type, [&](auto tag) { CheckType<decltype(tag)>(type, rng); });
+    }
+    ForceCompareIsa(saved);
+}
+
+TEST(CompareKernelsSemantics) {
+    CompareIsa saved = ActiveCompareIsa();
+    for (CompareIsa isa : { CompareIsa::Scalar, CompareIsa::Sse42, CompareIsa::Avx2 }) {
+        if (ForceCompareIsa(isa) != isa) continue;
+        const int32_t cur[] = { 5, -3, 100, 7, 2147483647 };
+        const int32_t old[] = { 5, -8, 90, 9, -2147483647 - 1 };
+        uint64_t mask = 0;
+        CompareArgs args;
+        args.a = 5;
+        CHECK_EQ(CompareBuffer(ValueType::Int32, CompareOp::Equal, args, reinterpret_cast<const uint8_t*>(cur), nullptr, 5, 4, &mask), 1u);
+        CHECK_EQ(mask, 1u);
+        CHECK_EQ(CompareBuffer(ValueType::Int32, CompareOp::IncreasedBy, args, reinterpret_cast<const uint8_t*>(cur),
+                               reinterpret_cast<const uint8_t*>(old), 5, 4, &mask), 1u);
+        CHECK_EQ(mask, 2u);
+        // INT32_MIN - 1 回绕为 INT32_MAX
+        args.a = 1;
+        CHECK_EQ(CompareBuffer(ValueType::Int32, CompareOp::DecreasedBy, args, reinterpret_cast<const uint8_t*>(cur),
+                               reinterpret_cast<const uint8_t*>(old), 5, 4, &mask), 1u);
+        CHECK_EQ(mask, 16u);
+
+        const float f[] = { 1.0f, std::nanf(""), 1.2f, -1.0f };
+        float target = 1.1f, eps = 0.15f;
+        std::memcpy(&args.a, &target, 4);
+        std::memcpy(&args.b, &eps, 4);
+        CHECK_EQ(CompareBuffer(ValueType::Float, CompareOp::Approx, args, reinterpret_cast<const uint8_t*>(f), nullptr, 4, 4, &mask), 2u);
+        CHECK_EQ(mask, 5u);
+    }
+    ForceCompareIsa(saved);
+}
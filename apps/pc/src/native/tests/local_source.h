@@ -0,0 +1,72 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "memory_source.h"
+#include "module_map.h"
+
+/**
+ * 测试用的目标内存：把本进程中的缓冲区登记为区域，地址即缓冲区的真实地址，
+ * 指针类数据可以直接写成本进程内的指针。可以把个别页标记为不可读，模拟部分可读的区域。
+ */
+class LocalSource : public IMemorySource {
+public:
+    static constexpr size_t kPageSize = 0x1000;
+
+    // 分配按页对齐的区域并清零，返回其起始地址
+    uint8_t* AddRegion(size_t size, uint32_t flags = RegionReadable | RegionWritable | RegionCommitted | RegionPrivate) {
+        size_t pages = (size + kPageSize - 1) / kPageSize;
+        auto block = std::make_unique<uint8_t[]>((pages + 1) * kPageSize);
+        uintptr_t raw = reinterpret_cast<uintptr_t>(block.get());
+        uint8_t* base = reinterpret_cast<uint8_t*>((raw + kPageSize - 1) & ~(kPageSize - 1));
+        std::memset(base, 0, pages * kPageSize);
+        regions.push_back({ reinterpret_cast<uintptr_t>(base), pages * kPageSize, flags, 0 });
+        storage.push_back(std::move(block));
+        std::sort(regions.begin(), regions.end(), [](const MemoryRegion& a, const MemoryRegion& b) { return a.base < b.base; });
+        return base;
+    }
+
+    // 读取 [address, address+kPageSize) 所在页时失败
+    void MarkUnreadable(const void* page) {
+        unreadable.push_back(reinterpret_cast<uintptr_t>(page) & ~(kPageSize - 1));
+    }
+
+    void SetModules(std::vector<ModuleInfo> list) {
+        modules = std::make_shared<ModuleTable>(std::move(list), ++generation);
+    }
+
+    bool QueryRegions(std::vector<MemoryRegion>& out) override {
+        out = regions;
+        return true;
+    }
+
+    bool ReadMemory(uintptr_t address, void* buffer, size_t size) override {
+        if (size == 0) return true;
+        const MemoryRegion* r = Find(address);
+        if (!r || size > r->base + r->size - address) return false;
+        for (uintptr_t page : unreadable) {
+            if (page < address + size && address < page + kPageSize) return false;
+        }
+        std::memcpy(buffer, reinterpret_cast<const void*>(address), size);
+        return true;
+    }
+
+    std::shared_ptr<const ModuleTable> GetModules() override { return modules; }
+    uint64_t ModuleGeneration() const override { return generation; }
+
+private:
+    const MemoryRegion* Find(uintptr_t address) const {
+        for (const auto &r : regions) {
+            if (address - r.base < r.size) return &r;
+        }
+        return nullptr;
+    }
+
+    std::vector<std::unique_ptr<uint8_t[]>> storage;
+    std::vector<MemoryRegion> regions;
+    std::vector<uintptr_t> unreadable;
+    std::shared_ptr<const ModuleTable> modules;
+    uint64_t generation = 0;
+};
@@ -0,0 +1,73 @@
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "local_source.h"
+#include "pointer_resolver.h"
+#include "test.h"
+
+namespace {
+
+void PutPtr(uint8_t* at, const void* value) {
+    uintptr_t v = reinterpret_cast<uintptr_t>(value);
+    std::memcpy(at, &v, sizeof(v));
+}
+
+uintptr_t Addr(const void* p) { return reinterpret_cast<uintptr_t>(p); }
+
+} // namespace
+
+TEST(PointerResolverRevalidatesEveryLevel) {
+    LocalSource src;
+    uint8_t* image = src.AddRegion(0x1000, RegionReadable | RegionWritable | RegionCommitted | RegionImage);
+    uint8_t* heap = src.AddRegion(0x10000);
+    ModuleInfo mod;
+    mod.name = L"game.exe";
+    mod.base = Addr(image);
+    mod.size = 0x1000;
+    src.SetModules({ mod });
+
+    // game.exe+0x10 -> A，[A+0x8] -> B，[B+0x20] -> C，结果为 C+0x4
+    uint8_t* a = heap + 0x100;
+    uint8_t* b = heap + 0x1000;
+    uint8_t* c = heap + 0x2000;
+    PutPtr(image + 0x10, a);
+    PutPtr(a + 0x8, b);
+    PutPtr(b + 0x20, c);
+
+    PointerPath path;
+    path.hasModule = true;
+    path.module = L"GAME.EXE";
+    path.baseOffset = 0x10;
+    path.offsets = { 0x8, 0x20, 0x4 };
+
+    PointerResolver resolver(src);
+    int handle = resolver.Compile(path);
+    uintptr_t out = 0;
+    CHECK(resolver.Resolve(handle, out));
+    CHECK_EQ(out, Addr(c + 0x4));
+
+    // 中间一级 B 被重新分配，旧内存中的 [B+0x20] 仍保留原值：缓存不能再被复用
+    uint8_t* moved = heap + 0x3000;
+    uint8_t* c2 = heap + 0x4000;
+    PutPtr(moved + 0x20, c2);
+    PutPtr(a + 0x8, moved);
+    CHECK(resolver.Resolve(handle, out));
+    CHECK_EQ(out, Addr(c2 + 0x4));
+
+    std::vector<uintptr_t> outs;
+    std::vector<uint8_t> ok;
+    int other = resolver.Compile(path);
+    resolver.ResolveMany({ handle, other }, outs, ok);
+    CHECK(ok[0] && ok[1] && outs[0] == Addr(c2 + 0x4) && outs[1] == outs[0]);
+    PutPtr(a + 0x8, b);
+    resolver.ResolveMany({ handle, other }, outs, ok);
+    CHECK(ok[0] && ok[1] && outs[0] == Addr(c + 0x4) && outs[1] == outs[0]);
+
+    // 路径中断时解析失败
+    PutPtr(image + 0x10, nullptr);
+    CHECK(!resolver.Resolve(handle, out));
+    resolver.ResolveMany({ handle }, outs, ok);
+    CHECK(!ok[0]);
+    uintptr_t direct = 0;
+    CHECK(!resolver.ResolvePath(path, direct));
+}
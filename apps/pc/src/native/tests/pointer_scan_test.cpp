@@ -0,0 +1,154 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "local_source.h"
+#include "pointer_map.h"
+#include "pointer_scan.h"
+#include "test.h"
+
+namespace {
+
+std::string TempPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+void PutPtr(uint8_t* at, const void* value) {
+    uintptr_t v = reinterpret_cast<uintptr_t>(value);
+    std::memcpy(at, &v, sizeof(v));
+}
+
+uint64_t Addr(const void* p) { return reinterpret_cast<uintptr_t>(p); }
+
+/**
+ * 合成堆：game.exe+0x40 -> A，[A+0x18] -> B，[B+0x30] -> C，目标为 C+0x10；
+ * 另有 game.exe+0x80 直接指向 C。其余内存全为 0，不会产生额外的指针。
+ */
+struct SyntheticHeap {
+    LocalSource src;
+    uint8_t* image;
+    uint8_t* heap;
+    uint8_t* a;
+    uint8_t* b;
+    uint8_t* c;
+    uint64_t target;
+
+    SyntheticHeap() {
+        image = src.AddRegion(0x2000, RegionReadable | RegionWritable | RegionCommitted | RegionImage);
+        heap = src.AddRegion(0x10000);
+        a = heap + 0x100;
+        b = heap + 0x2000;
+        c = heap + 0x5000;
+        target = Addr(c + 0x10);
+        PutPtr(image + 0x40, a);
+        PutPtr(a + 0x18, b);
+        PutPtr(b + 0x30, c);
+        PutPtr(image + 0x80, c);
+
+        ModuleInfo mod;
+        mod.name = L"game.exe";
+        mod.base = reinterpret_cast<uintptr_t>(image);
+        mod.size = 0x2000;
+        src.SetModules({ mod });
+    }
+};
+
+bool HasChain(const std::vector<PointerChain>& chains, uint64_t baseOffset, const std::vector<uint32_t>& offsets) {
+    for (const auto &c : chains) {
+        if (c.baseOffset != baseOffset || c.depth != offsets.size()) continue;
+        if (std::equal(offsets.begin(), offsets.end(), c.offsets)) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+TEST(PointerMapBuildAndQuery) {
+    SyntheticHeap h;
+    ThreadPool pool(3);
+    PointerMap map(pool);
+    CHECK(map.Build(h.src, h.src.GetModules().get(), PointerMapOptions()));
+    CHECK_EQ(map.Count(), 4u);
+
+    size_t first, last;
+    map.FindRange(Addr(h.c), Addr(h.c), first, last);
+    CHECK_EQ(last - first, 2u);
+    for (size_t i = first; i < last; ++i) CHECK_EQ(map.ValueAt(i), Addr(h.c));
+    map.FindRange(Addr(h.b) - 0x10, Addr(h.b) + 0x10, first, last);
+    CHECK_EQ(last - first, 1u);
+    CHECK_EQ(map.LocationAt(first), Addr(h.a + 0x18));
+
+    CHECK_EQ(map.FindModule(Addr(h.image + 0x40)), 0);
+    CHECK_EQ(map.FindModule(Addr(h.heap)), -1);
+
+    const std::string path = TempPath("xmodder_pointer_map_test.ptrmap");
+    CHECK(map.Save(path));
+    PointerMap loaded(pool);
+    CHECK(loaded.Load(path));
+    CHECK_EQ(loaded.Count(), map.Count());
+    for (size_t i = 0; i < map.Count(); ++i) {
+        CHECK_EQ(loaded.ValueAt(i), map.ValueAt(i));
+        CHECK_EQ(loaded.LocationAt(i), map.LocationAt(i));
+    }
+    CHECK(loaded.Modules().size() == 1 && loaded.Modules()[0].name == L"game.exe");
+    loaded.Clear();
+    std::remove(path.c_str());
+}
+
+TEST(PointerScanFindsChains) {
+    SyntheticHeap h;
+    ThreadPool pool(3);
+    PointerScanner scanner(pool);
+    CHECK(scanner.BuildMap(h.src, h.src.GetModules().get(), PointerMapOptions()));
+
+    PointerScanOptions opts;
+    opts.maxDepth = 4;
+    opts.maxOffset = 0x100;
+    CHECK_EQ(scanner.Scan(h.target, opts), 2u);
+    std::vector<PointerChain> chains;
+    scanner.GetResults(0, 10, chains);
+    CHECK(HasChain(chains, 0x40, { 0x18, 0x30, 0x10 }));
+    CHECK(HasChain(chains, 0x80, { 0x10 }));
+    CHECK(scanner.ModuleName(0) == L"game.exe");
+
+    // 深度不够时找不到三级路径
+    opts.maxDepth = 2;
+    CHECK_EQ(scanner.Scan(h.target, opts), 1u);
+
+    // 保存/加载结果后与新一轮扫描求交集
+    opts.maxDepth = 4;
+    CHECK_EQ(scanner.Scan(h.target, opts), 2u);
+    const std::string path = TempPath("xmodder_pointer_scan_test.ptrs");
+    CHECK(scanner.SaveResults(path));
+    PointerScanner other(pool);
+    CHECK(other.LoadResults(path));
+    CHECK_EQ(other.Count(), 2u);
+    std::remove(path.c_str());
+
+    PutPtr(h.image + 0x80, nullptr);
+    CHECK(scanner.BuildMap(h.src, h.src.GetModules().get(), PointerMapOptions()));
+    opts.intersect = true;
+    CHECK_EQ(scanner.Scan(h.target, opts), 1u);
+    scanner.GetResults(0, 10, chains);
+    CHECK(HasChain(chains, 0x40, { 0x18, 0x30, 0x10 }));
+}
+
+TEST(PointerScanFilter) {
+    SyntheticHeap h;
+    PointerScanner scanner;
+    CHECK(scanner.BuildMap(h.src, h.src.GetModules().get(), PointerMapOptions()));
+    PointerScanOptions opts;
+    opts.maxOffset = 0x100;
+    CHECK_EQ(scanner.Scan(h.target, opts), 2u);
+
+    // 中间对象 B 被"重新分配"：只有直接指向 C 的路径仍然有效
+    uint8_t* moved = h.heap + 0x8000;
+    PutPtr(h.a + 0x18, moved);
+    CHECK_EQ(scanner.Filter(h.src, h.src.GetModules().get(), h.target), 1u);
+    std::vector<PointerChain> chains;
+    scanner.GetResults(0, 10, chains);
+    CHECK(HasChain(chains, 0x80, { 0x10 }));
+    CHECK_EQ(scanner.Filter(h.src, nullptr, h.target), 0u);
+}
@@ -0,0 +1,49 @@
+#include <cstdint>
+#include <vector>
+#include "region_map.h"
+#include "test.h"
+
+namespace {
+
+constexpr uint32_t kUsed = RegionReadable | RegionCommitted | RegionPrivate;
+
+} // namespace
+
+TEST(RegionMapListPages) {
+    // 100 个已提交区域，彼此之间隔一页空洞
+    std::vector<MemoryRegion> all;
+    for (uintptr_t i = 0; i < 100; ++i) all.push_back({ 0x10000 + i * 0x2000, 0x1000, kUsed, 0 });
+    RegionMap map;
+    map.Assign(all);
+
+    std::vector<MemoryRegion> page, listed;
+    size_t total = 0;
+    for (size_t offset = 0;; offset += 7) {
+        total = map.List(offset, 7, false, page);
+        if (page.empty()) break;
+        listed.insert(listed.end(), page.begin(), page.end());
+    }
+    CHECK_EQ(total, 100u);
+    CHECK_EQ(listed.size(), 100u);
+    for (size_t i = 0; i < listed.size() && i < all.size(); ++i) CHECK_EQ(listed[i].base, all[i].base);
+
+    // 含空洞：首尾的未分配范围加上 99 个间隙
+    CHECK_EQ(map.List(0, 0, true, page), map.Count());
+    CHECK_EQ(map.Count(), 201u);
+    CHECK_EQ(map.List(1, 2, true, page), 201u);
+    CHECK_EQ(page.size(), 2u);
+    if (page.size() == 2) {
+        CHECK_EQ(page[0].base, all[0].base);
+        CHECK_EQ(page[1].base, all[0].base + 0x1000);
+    }
+    CHECK_EQ(map.List(500, 10, true, page), 201u);
+    CHECK(page.empty());
+
+    // 修改后分页反映新的内容
+    map.Invalidate(all[3].base, 0x1000);
+    CHECK_EQ(map.List(3, 1, false, page), 99u);
+    if (page.size() == 1) CHECK_EQ(page[0].base, all[4].base);
+    map.Insert(all[3]);
+    CHECK_EQ(map.List(3, 1, false, page), 100u);
+    if (page.size() == 1) CHECK_EQ(page[0].base, all[3].base);
+}
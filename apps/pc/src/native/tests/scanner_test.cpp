@@ -0,0 +1,170 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "local_source.h"
+#include "scanner.h"
+#include "snapshot.h"
+#include "test.h"
+
+namespace {
+
+std::string TempPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+template<typename T>
+void Put(uint8_t* p, T v) { std::memcpy(p, &v, sizeof(T)); }
+
+CompareArgs Args(uint64_t a, uint64_t b = 0) {
+    CompareArgs args;
+    args.a = a;
+    args.b = b;
+    return args;
+}
+
+} // namespace
+
+TEST(ScannerFirstAndNextScan) {
+    LocalSource src;
+    uint8_t* heap = src.AddRegion(3 * Scanner::kChunkSize);    // 多个块，覆盖并行窗口
+    const size_t offsets[] = { 0, 0x40, 0x1000, Scanner::kChunkSize - 4, Scanner::kChunkSize, 2 * Scanner::kChunkSize + 8 };
+    for (size_t off : offsets) Put<int32_t>(heap + off, 1234567);
+    Put<int32_t>(heap + 0x81, 1234567);     // 未对齐，快速扫描不应命中
+
+    ThreadPool pool(4);
+    Scanner scanner(pool);
+    ScanOptions opts;
+    opts.type = ValueType::Int32;
+    CHECK_EQ(scanner.FirstScan(src, opts, CompareOp::Equal, Args(1234567)), sizeof(offsets) / sizeof(offsets[0]));
+
+    std::vector<ScanHit> hits;
+    CHECK_EQ(scanner.GetResults(0, 100, hits), sizeof(offsets) / sizeof(offsets[0]));
+    for (size_t i = 0; i < hits.size(); ++i) {
+        CHECK_EQ(hits[i].address, reinterpret_cast<uintptr_t>(heap + offsets[i]));
+        CHECK_EQ(hits[i].value, 1234567u);
+    }
+
+    // 再次扫描：改掉两个值，Changed 只留下它们，再按 IncreasedBy 过滤
+    Put<int32_t>(heap + 0x40, 1234600);
+    Put<int32_t>(heap + Scanner::kChunkSize, 1234570);
+    CHECK_EQ(scanner.NextScan(src, CompareOp::Changed, Args(0)), 2u);
+    Put<int32_t>(heap + 0x40, 1234610);
+    Put<int32_t>(heap + Scanner::kChunkSize, 1234575);
+    CHECK_EQ(scanner.NextScan(src, CompareOp::IncreasedBy, Args(5)), 1u);
+    CHECK_EQ(scanner.GetResults(0, 10, hits), 1u);
+    CHECK_EQ(hits[0].address, reinterpret_cast<uintptr_t>(heap + Scanner::kChunkSize));
+    CHECK_EQ(hits[0].value, 1234575u);
+}
+
+TEST(ScannerUnalignedAndAny) {
+    LocalSource src;
+    uint8_t* heap = src.AddRegion(0x3000);
+    Put<int16_t>(heap + 0x101, -7);
+    Put<int16_t>(heap + 0x2FFF - 1, -7);
+
+    ThreadPool pool(2);
+    Scanner scanner(pool);
+    ScanOptions opts;
+    opts.type = ValueType::Int16;
+    opts.alignment = 1;
+    CHECK_EQ(scanner.FirstScan(src, opts, CompareOp::Equal, Args(static_cast<uint16_t>(-7))), 2u);
+
+    // 未知初始值：每个对齐位置都是候选
+    opts.alignment = 0;
+    CHECK_EQ(scanner.FirstScan(src, opts, CompareOp::Any, Args(0)), 0x3000u / 2);
+    CHECK_EQ(scanner.NextScan(src, CompareOp::Unchanged, Args(0)), 0x3000u / 2);
+}
+
+TEST(ScannerSkipsUnreadablePagesOnly) {
+    LocalSource src;
+    uint8_t* heap = src.AddRegion(0x8000);
+    src.MarkUnreadable(heap + 0x5000);
+    Put<uint32_t>(heap + 0x1FFE, 0xCAFEBABE);      // 跨页，两页都可读
+    Put<uint32_t>(heap + 0x4000, 0xCAFEBABE);
+    Put<uint32_t>(heap + 0x5010, 0xCAFEBABE);      // 不可读的页
+    Put<uint32_t>(heap + 0x6000, 0xCAFEBABE);
+
+    Scanner scanner;
+    ScanOptions opts;
+    opts.type = ValueType::UInt32;
+    opts.alignment = 1;
+    CHECK_EQ(scanner.FirstScan(src, opts, CompareOp::Equal, Args(0xCAFEBABE)), 3u);
+}
+
+TEST(ScannerOnSnapshot) {
+    LocalSource src;
+    uint8_t* heap = src.AddRegion(0x10000);
+    uint8_t* code = src.AddRegion(0x2000, RegionReadable | RegionExecutable | RegionCommitted | RegionImage);
+    Put<double>(heap + 0x100, 2.5);
+    Put<double>(heap + 0x8000, 2.5);
+    Put<double>(code + 0x10, 2.5);     // 只读区域，writableOnly 时不扫描
+
+    const std::string first = TempPath("xmodder_scanner_test_1.snap");
+    const std::string second = TempPath("xmodder_scanner_test_2.snap");
+    uint64_t bytes = 0;
+    CHECK(CaptureSnapshot(src, nullptr, first, SnapshotOptions(), &bytes));
+    CHECK_EQ(bytes, 0x12000u);
+    Put<double>(heap + 0x8000, 3.0);
+    CHECK(CaptureSnapshot(src, nullptr, second, SnapshotOptions()));
+
+    SnapshotSource before, after;
+    CHECK(before.Open(first));
+    CHECK(after.Open(second));
+    CHECK_EQ(before.Info().regionCount, 2u);
+
+    double value = 0;
+    CHECK(before.ReadMemory(reinterpret_cast<uintptr_t>(heap + 0x8000), &value, sizeof(value)));
+    CHECK(value == 2.5);
+    CHECK(before.Data(reinterpret_cast<uintptr_t>(heap + 0x100), 8) != nullptr);
+    CHECK(!before.ReadMemory(reinterpret_cast<uintptr_t>(heap + 0x10000 - 4), &value, sizeof(value)));
+
+    Scanner scanner;
+    ScanOptions opts;
+    opts.type = ValueType::Double;
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    CHECK_EQ(scanner.FirstScan(before, opts, CompareOp::Equal, Args(bits)), 2u);
+    CHECK_EQ(scanner.NextScan(after, CompareOp::Increased, Args(0)), 1u);
+    std::vector<ScanHit> hits;
+    scanner.GetResults(0, 10, hits);
+    CHECK(hits.size() == 1 && hits[0].address == reinterpret_cast<uintptr_t>(heap + 0x8000));
+
+    opts.writableOnly = false;
+    CHECK_EQ(scanner.FirstScan(before, opts, CompareOp::Equal, Args(bits)), 3u);
+
+    before.Close();
+    after.Close();
+    std::remove(first.c_str());
+    std::remove(second.c_str());
+}
+
+TEST(ScannerCancel) {
+    LocalSource src;
+    src.AddRegion(Scanner::kChunkSize);
+    Scanner scanner;
+    ScanOptions opts;
+    std::atomic<bool> cancel{ true };
+    CHECK_EQ(scanner.FirstScan(src, opts, CompareOp::Any, Args(0), &cancel), 0u);
+    CHECK_EQ(scanner.Count(), 0u);
+}
+
+TEST(ScannerTightBudget) {
+    LocalSource src;
+    uint8_t* heap = src.AddRegion(4 * Scanner::kChunkSize);
+    for (size_t off = 0; off < 4 * Scanner::kChunkSize; off += 0x100) Put<int32_t>(heap + off, 99);
+
+    // 预算小于一个窗口：窗口缩到 1 块，结果全部转存到临时文件，数量不变
+    ThreadPool pool(8);
+    Scanner scanner(pool);
+    ScanOptions opts;
+    opts.memoryBudget = 1024 * 1024;
+    CHECK_EQ(scanner.FirstScan(src, opts, CompareOp::Any, Args(0)), Scanner::kChunkSize);
+    CHECK(scanner.Spilled());
+    CHECK_EQ(scanner.NextScan(src, CompareOp::Equal, Args(99)), 4 * Scanner::kChunkSize / 0x100);
+    std::vector<ScanHit> hits;
+    scanner.GetResults(100, 1, hits);
+    CHECK(hits.size() == 1 && hits[0].address == reinterpret_cast<uintptr_t>(heap + 100 * 0x100));
+}
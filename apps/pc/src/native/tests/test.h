@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+// 原生层单元测试的最小框架：TEST 注册用例，CHECK / CHECK_EQ 失败时记录位置并继续执行
+namespace test {
+
+struct Case {
+    const char* name;
+    void (*fn)();
+};
+
+inline std::vector<Case>& Registry() {
+    static std::vector<Case> cases;
+    return cases;
+}
+
+inline int& Failures() {
+    static int failures = 0;
+    return failures;
+}
+
+struct Registrar {
+    Registrar(const char* name, void (*fn)()) { Registry().push_back({ name, fn }); }
+};
+
+inline void Fail(const char* file, int line, const std::string& what) {
+    ++Failures();
+    std::fprintf(stderr, "  %s:%d: %s\n", file, line, what.c_str());
+}
+
+} // namespace test
+
+#define TEST(name) \
+    static void name(); \
+    static test::Registrar name##_registrar(#name, name); \
+    static void name()
+
+#define CHECK(cond) \
+    do { if (!(cond)) test::Fail(__FILE__, __LINE__, "CHECK(" #cond ")"); } while (0)
+
+#define CHECK_EQ(a, b) \
+    do { \
+        auto&& check_a_ = (a); \
+        auto&& check_b_ = (b); \
+        if (!(check_a_ == check_b_)) { \
+            test::Fail(__FILE__, __LINE__, "CHECK_EQ(" #a ", " #b "): " + std::to_string(check_a_) + \
+                       " != " + std::to_string(check_b_)); \
+        } \
+    } while (0)
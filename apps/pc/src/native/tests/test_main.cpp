@@ -0,0 +1,23 @@
+// 原生层单元测试入口：不依赖目标进程和 Node，直接在本进程的缓冲区和临时文件上运行各引擎。
+//
+//   node-gyp build 后运行 build/Release/native_test [名称子串]，只执行名称包含该子串的用例
+#include <cstdio>
+#include <cstring>
+#include "test.h"
+
+int main(int argc, char** argv) {
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+    int run = 0;
+    int failedCases = 0;
+    for (const auto &c : test::Registry()) {
+        if (filter && !std::strstr(c.name, filter)) continue;
+        int before = test::Failures();
+        c.fn();
+        ++run;
+        bool ok = test::Failures() == before;
+        if (!ok) ++failedCases;
+        std::fprintf(stderr, "[%s] %s\n", ok ? "PASS" : "FAIL", c.name);
+    }
+    std::fprintf(stderr, "%d run, %d failed\n", run, failedCases);
+    return failedCases ? 1 : 0;
+}
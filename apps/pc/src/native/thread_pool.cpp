@@ -0,0 +1,142 @@
+#include "thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <exception>
+
+namespace {
+// 当前线程所属的线程池及其队列下标，非 worker 线程为 nullptr
+thread_local ThreadPool* tlsPool = nullptr;
+thread_local size_t tlsIndex = 0;
+}
+
+ThreadPool::ThreadPool(size_t threadCount) : pending(0), nextQueue(0), stopping(false) {
+    if (threadCount == 0) {
+        threadCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < threadCount; ++i) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (size_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back([this, i]() { WorkerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> g(sleepMutex);
+        stopping = true;
+    }
+    sleepCv.notify_all();
+    for (auto &t : threads) {
+        if (t.joinable()) t.join();
+    }
+}
+
+ThreadPool& ThreadPool::Shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+    // worker 线程提交的任务放回自己的队列，保持局部性；外部线程轮流分配
+    size_t idx = (tlsPool == this) ? tlsIndex : nextQueue.fetch_add(1) % queues.size();
+    {
+        std::lock_guard<std::mutex> g(sleepMutex);
+        pending.fetch_add(1);
+    }
+    {
+        std::lock_guard<std::mutex> g(queues[idx]->m);
+        queues[idx]->tasks.push_back(std::move(task));
+    }
+    sleepCv.notify_one();
+}
+
+bool ThreadPool::TryPop(size_t self, std::function<void()>& out) {
+    WorkQueue &q = *queues[self];
+    std::lock_guard<std::mutex> g(q.m);
+    if (q.tasks.empty()) return false;
+    out = std::move(q.tasks.back());
+    q.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::TrySteal(size_t self, std::function<void()>& out) {
+    size_t n = queues.size();
+    for (size_t k = 1; k <= n; ++k) {
+        WorkQueue &q = *queues[(self + k) % n];
+        std::lock_guard<std::mutex> g(q.m);
+        if (q.tasks.empty()) continue;
+        out = std::move(q.tasks.front());
+        q.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::WorkerLoop(size_t index) {
+    tlsPool = this;
+    tlsIndex = index;
+    std::function<void()> task;
+    while (true) {
+        if (TryPop(index, task) || TrySteal(index, task)) {
+            pending.fetch_sub(1);
+            task();
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lk(sleepMutex);
+        sleepCv.wait(lk, [this]() { return stopping.load() || pending.load() > 0; });
+        if (stopping && pending.load() == 0) return;
+    }
+}
+
+void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& fn) {
+    if (count == 0) return;
+
+    struct Batch {
+        std::atomic<size_t> remaining;
+        std::mutex m;
+        std::condition_variable cv;
+        std::exception_ptr error;   // 第一个抛出的异常，由调用方线程重新抛出
+    };
+    // 无论 fn 是否抛出都要计数，否则调用方会一直等待
+    struct Done {
+        Batch& batch;
+        ~Done() {
+            if (batch.remaining.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> g(batch.m);
+                batch.cv.notify_all();
+            }
+        }
+    };
+    auto batch = std::make_shared<Batch>();
+    batch->remaining = count;
+
+    for (size_t i = 0; i < count; ++i) {
+        Submit([batch, &fn, i]() {
+            Done done{ *batch };
+            try {
+                fn(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> g(batch->m);
+                if (!batch->error) batch->error = std::current_exception();
+            }
+        });
+    }
+
+    // 调用方在等待期间帮忙执行任务，避免在 worker 内嵌套调用时死锁
+    size_t self = (tlsPool == this) ? tlsIndex : 0;
+    std::function<void()> task;
+    while (batch->remaining.load() > 0) {
+        if ((tlsPool == this && TryPop(self, task)) || TrySteal(self, task)) {
+            pending.fetch_sub(1);
+            task();
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lk(batch->m);
+        batch->cv.wait_for(lk, std::chrono::milliseconds(1), [&]() { return batch->remaining.load() == 0; });
+    }
+    std::lock_guard<std::mutex> g(batch->m);
+    if (batch->error) std::rethrow_exception(batch->error);
+}
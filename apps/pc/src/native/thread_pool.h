@@ -0,0 +1,49 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 工作窃取线程池：每个 worker 有自己的双端队列，
+// 自己从尾部取任务，空闲时从其他 worker 的头部窃取。
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void Submit(std::function<void()> task);
+
+    // 并行执行 fn(0..count-1) 并等待全部完成；等待期间调用方线程也会参与执行。
+    // fn 抛出异常时其余项照常执行，完成后在调用方线程重新抛出第一个异常
+    void ParallelFor(size_t count, const std::function<void(size_t)>& fn);
+
+    size_t Size() const { return threads.size(); }
+
+    // 扫描等重负载共用的进程级线程池
+    static ThreadPool& Shared();
+
+private:
+    struct WorkQueue {
+        std::mutex m;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool TryPop(size_t self, std::function<void()>& out);
+    bool TrySteal(size_t self, std::function<void()>& out);
+    void WorkerLoop(size_t index);
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> threads;
+    std::mutex sleepMutex;
+    std::condition_variable sleepCv;
+    std::atomic<size_t> pending;
+    std::atomic<size_t> nextQueue;
+    std::atomic<bool> stopping;
+};
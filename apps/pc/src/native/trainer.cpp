@@ -2,10 +2,92 @@
 #include "memory.h"
 #include "process.h"
 #include "helper.h"
+#include "scanner.h"
+#include "batch_read.h"
+#include "pointer_resolver.h"
+#include "async_queue.h"
+#include "watch_engine.h"
+#include "aob_search.h"
+#include "pointer_scan.h"
+#include "snapshot.h"
+#include "stats.h"
+#include "process_watcher.h"
+#include "cheat_table.h"
+#include "gather.h"
+#include "change_tracker.h"
+#include "string_search.h"
+#include <cstring>
+#include <mutex>
 #include <vector>
 #include <string>
+#include <unordered_map>
 
-static IMemory imem;
+/**
+ * 会话：一个附加目标的全部状态。每个会话拥有自己的进程句柄与缓存（IMemory）、锁定调度线程、
+ * 指针解析器、写入事务、监视线程，以及数值/字符串扫描、变化跟踪、特征码缓存、指针扫描和快照，
+ * 会话之间不共享锁和扫描结果，可以并行驱动多个进程。
+ * 模块级接口作用于默认会话；JS 的 Session 对象各自持有一个会话，随对象回收而关闭。
+ */
+struct Session {
+    explicit Session(int id)
+        : id(id), resolver(mem), watcher(mem, resolver), nextTxnId(1), tables(mem, resolver), snapshotResolver(snapshot) {}
+
+    int id;
+    // 回调相关成员放在最前，最后析构：监视线程停止前仍可能访问它们
+    std::mutex watchCallbackMutex;
+    Napi::ThreadSafeFunction watchCallback;
+    bool hasWatchCallback = false;
+
+    IMemory mem;
+    PointerResolver resolver;
+    WatchEngine watcher;
+    std::unordered_map<int, WriteTransaction> writeTxns;
+    int nextTxnId;
+    std::unordered_map<int, int> watchHandles;   // watch id -> 预编译指针句柄
+    CheatTableSet tables;                        // 放在解析器之后，先于它析构
+
+    SnapshotSource snapshot;
+    PointerResolver snapshotResolver;
+    Scanner scanner;
+    ChangeTracker changeTracker;
+    StringSearcher stringSearcher;
+    SignatureCache aobCache;
+    PointerScanner pointerScanner;
+    AsyncQueue asyncQueue;                       // 放在最后，最先析构：工作线程可能仍在使用上面的成员
+};
+
+static Session defaultSession(0);
+static IMemory& imem = defaultSession.mem;
+static PointerResolver& resolver = defaultSession.resolver;
+// 存活的会话，只在 JS 线程访问；回调排队期间会话可能已被回收，投递时按 id 查找
+static std::unordered_map<int, Session*> sessions = { { 0, &defaultSession } };
+static int nextSessionId = 1;
+static CancelTokens cancelTokens;
+static ProcessWatcher processWatcher;
+static std::mutex processCallbackMutex;
+static Napi::ThreadSafeFunction processCallback;
+static bool hasProcessCallback = false;
+
+// 会话打开快照后，它的只读接口（读取、扫描、模块查询、一次性指针解析）改为从快照读取；
+// 写入、锁定、监视和预编译指针仍然作用于在线进程
+static bool UsesSnapshot(const Session& s) {
+    return s.snapshot.IsOpen();
+}
+
+static IMemorySource& Source(Session& s) {
+    if (UsesSnapshot(s)) return s.snapshot;
+    return s.mem;
+}
+
+static PointerResolver& SourceResolver(Session& s) {
+    return UsesSnapshot(s) ? s.snapshotResolver : s.resolver;
+}
+
+static bool SourceReadBytes(Session& s, uintptr_t addr, std::vector<uint8_t>& out, size_t size) {
+    if (!UsesSnapshot(s)) return s.mem.ReadBytes(addr, out, size);
+    out.resize(size);
+    return s.snapshot.ReadMemory(addr, out.data(), size);
+}
 
 // open by pid
 Napi::Boolean OpenByPid(const Napi::CallbackInfo& info) {
@@ -13,6 +95,7 @@ Napi::Boolean OpenByPid(const Napi::CallbackInfo& info) {
     if (info.Length() < 1) return Napi::Boolean::New(env, false);
     uint32_t pid = info[0].As<Napi::Number>().Uint32Value();
     bool ok = imem.OpenProcessByPid(pid);
+    resolver.Invalidate();
     return Napi::Boolean::New(env, ok);
 }
 
@@ -22,131 +105,674 @@ Napi::Number OpenByName(const Napi::CallbackInfo& info) {
     if (info.Length() < 1) return Napi::Number::New(env, 0);
     std::string name = info[0].As<Napi::String>().Utf8Value();
     std::wstring wname = Utf8ToWstring(name);
-    uint32_t pid = imem.OpenProcessByName(wname);
+    // 进程表由监视器维护，不再每次遍历全部进程
+    uint32_t pid = processWatcher.FindPidByName(wname);
+    if (pid) pid = imem.OpenProcessByPid(pid);
+    resolver.Invalidate();
     return Napi::Number::New(env, pid);
 }
 
 Napi::Boolean CloseProc(const Napi::CallbackInfo& info) {
     imem.CloseProcess();
+    resolver.Invalidate();
     return Napi::Boolean::New(info.Env(), true);
 }
 
 // get module base
-Napi::Value GetModuleBase(const Napi::CallbackInfo& info) {
+static Napi::Value GetModuleBase(Session& s, const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     if (info.Length() < 1) return env.Null();
     std::string modName = info[0].As<Napi::String>().Utf8Value();
     std::wstring wmod = Utf8ToWstring(modName);
-    uintptr_t base = imem.GetModuleBaseAddress(wmod);
+    uintptr_t base = Source(s).GetModuleBaseAddress(wmod);
     // return BigInt
     return Napi::BigInt::New(env, static_cast<uint64_t>(base));
 }
 
-// resolve pointer: ["base.dll+0x123", "0x20", ...]
-Napi::Value ResolvePointer(const Napi::CallbackInfo& info) {
+// list modules: -> [{ name, path, base: BigInt, size, sections: [{ name, base: BigInt, size }] }]
+static Napi::Value ListModules(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto table = Source(s).GetModules();
+    if (!table) return Napi::Array::New(env);
+    const auto &mods = table->Modules();
+    Napi::Array arr = Napi::Array::New(env, mods.size());
+    for (size_t i = 0; i < mods.size(); ++i) {
+        const ModuleInfo &m = mods[i];
+        Napi::Object o = Napi::Object::New(env);
+        o.Set("name", Napi::String::New(env, WstringToUtf8(m.name)));
+        o.Set("path", Napi::String::New(env, WstringToUtf8(m.path)));
+        o.Set("base", Napi::BigInt::New(env, static_cast<uint64_t>(m.base)));
+        o.Set("size", Napi::Number::New(env, static_cast<double>(m.size)));
+        Napi::Array secs = Napi::Array::New(env, m.sections.size());
+        for (size_t k = 0; k < m.sections.size(); ++k) {
+            const ModuleSection &sec = m.sections[k];
+            Napi::Object so = Napi::Object::New(env);
+            so.Set("name", Napi::String::New(env, sec.name));
+            so.Set("base", Napi::BigInt::New(env, static_cast<uint64_t>(m.base + sec.rva)));
+            so.Set("size", Napi::Number::New(env, sec.size));
+            secs.Set(static_cast<uint32_t>(k), so);
+        }
+        o.Set("sections", secs);
+        arr.Set(static_cast<uint32_t>(i), o);
+    }
+    return arr;
+}
+
+// address -> { module, offset: BigInt } | null；参数为数组时返回等长数组
+static Napi::Value LookupAddress(Session& s, const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     if (info.Length() < 1) return env.Null();
+    auto table = Source(s).GetModules();
 
-    uintptr_t base = 0;
-    std::vector<uint64_t> offsets;
+    auto lookup = [&](const Napi::Value& v) -> Napi::Value {
+        uintptr_t addr = 0;
+        if (!table || !JsValueToAddress(v, addr)) return env.Null();
+        const ModuleInfo* m = table->FindByAddress(addr);
+        if (!m) return env.Null();
+        Napi::Object o = Napi::Object::New(env);
+        o.Set("module", Napi::String::New(env, WstringToUtf8(m->name)));
+        o.Set("offset", Napi::BigInt::New(env, static_cast<uint64_t>(addr - m->base)));
+        return o;
+    };
 
-    if (!info[0].IsArray()) return env.Null();
-    Napi::Array arr = info[0].As<Napi::Array>();
+    if (!info[0].IsArray()) return lookup(info[0]);
+    Napi::Array in = info[0].As<Napi::Array>();
+    Napi::Array out = Napi::Array::New(env, in.Length());
+    for (uint32_t i = 0; i < in.Length(); ++i) out.Set(i, lookup(in.Get(i)));
+    return out;
+}
+
+// "0x1A" / "26" -> uint64
+static bool ParseNumberString(const std::string& s, uint64_t& out) {
+    try {
+        if (s.find("0x") == 0 || s.find("0X") == 0) {
+            out = std::stoull(s, nullptr, 16);
+        } else {
+            out = std::stoull(s, nullptr, 10);
+        }
+    } catch (...) {
+        return false;
+    }
+    return true;
+}
+
+// parse pointer path: ["base.dll+0x123", "0x20", ...]
+static bool ParsePointerPath(const Napi::Value& value, PointerPath& path) {
+    if (!value.IsArray()) return false;
+    Napi::Array arr = value.As<Napi::Array>();
     uint32_t len = arr.Length();
-    if (len == 0) return env.Null();
+    if (len == 0) return false;
 
     // Parse base address
     Napi::Value v0 = arr.Get((uint32_t)0);
     if (v0.IsString()) {
         std::string baseStr = v0.As<Napi::String>().Utf8Value();
         size_t plusPos = baseStr.find('+');
+        path.hasModule = true;
         if (plusPos != std::string::npos) {
             // Format: "module.exe+offset"
-            std::string modName = baseStr.substr(0, plusPos);
-            std::string offsetStr = baseStr.substr(plusPos + 1);
-            std::wstring wmod = Utf8ToWstring(modName);
-            uintptr_t modBase = imem.GetModuleBaseAddress(wmod);
-            if (modBase == 0) return env.Null(); // Module not found
-
-            uint64_t off = 0;
-            try {
-                if (offsetStr.find("0x") == 0 || offsetStr.find("0X") == 0) {
-                    off = std::stoull(offsetStr, nullptr, 16);
-                } else {
-                    off = std::stoull(offsetStr, nullptr, 10);
-                }
-            } catch (...) {
-                return env.Null(); // Invalid offset format
-            }
-            base = modBase + off;
+            path.module = Utf8ToWstring(baseStr.substr(0, plusPos));
+            if (!ParseNumberString(baseStr.substr(plusPos + 1), path.baseOffset)) return false; // Invalid offset format
         } else {
             // Only module name
-            std::wstring wmod = Utf8ToWstring(baseStr);
-            base = imem.GetModuleBaseAddress(wmod);
-            if (base == 0) return env.Null(); // Module not found
+            path.module = Utf8ToWstring(baseStr);
+            path.baseOffset = 0;
         }
-    } else if (!JsValueToAddress(v0, base)) {
-        return env.Null();
+    } else {
+        uintptr_t base = 0;
+        if (!JsValueToAddress(v0, base)) return false;
+        path.hasModule = false;
+        path.baseOffset = base;
     }
 
     // Parse offsets
+    path.offsets.clear();
     for (uint32_t i = 1; i < len; ++i) {
         Napi::Value v = arr.Get(i);
+        uint64_t val = 0;
         if (v.IsString()) {
-            std::string s = v.As<Napi::String>().Utf8Value();
-            uint64_t val = 0;
-            try {
-                if (s.find("0x") == 0 || s.find("0X") == 0) {
-                    val = std::stoull(s, nullptr, 16);
-                } else {
-                    val = std::stoull(s, nullptr, 10);
-                }
-            } catch (...) {
-                val = 0; // Default to 0 for invalid format
-            }
-            offsets.push_back(val);
+            if (!ParseNumberString(v.As<Napi::String>().Utf8Value(), val)) val = 0; // Default to 0 for invalid format
         } else if (v.IsBigInt()) {
             bool lossless;
-            uint64_t val = v.As<Napi::BigInt>().Uint64Value(&lossless);
-            offsets.push_back(val);
+            val = v.As<Napi::BigInt>().Uint64Value(&lossless);
         } else if (v.IsNumber()) {
-            double d = v.As<Napi::Number>().DoubleValue();
-            offsets.push_back(static_cast<uint64_t>(d));
-        } else {
-            offsets.push_back(0);
+            val = static_cast<uint64_t>(v.As<Napi::Number>().DoubleValue());
         }
+        path.offsets.push_back(val);
     }
+    return true;
+}
+
+// resolve pointer: ["base.dll+0x123", "0x20", ...]
+static Napi::Value ResolvePointer(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1) return env.Null();
+
+    PointerPath path;
+    if (!ParsePointerPath(info[0], path)) return env.Null();
 
     uintptr_t outAddr = 0;
-    bool ok = imem.ResolvePointerPath(base, offsets, outAddr);
+    bool ok = SourceResolver(s).ResolvePath(path, outAddr);
     if (!ok) return env.Null();
     return Napi::BigInt::New(env, static_cast<uint64_t>(outAddr));
 }
 
+// compile pointer: same path format as resolvePointer -> handle (>0)
+// 之后每次解析一次批量读取整条链上的各级指针，与缓存一致时复用，否则重新逐级解析
+static Napi::Value CompilePointer(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1) return env.Null();
+    PointerPath path;
+    if (!ParsePointerPath(info[0], path)) return env.Null();
+    return Napi::Number::New(env, s.resolver.Compile(path));
+}
+
+static Napi::Value ResolveCompiled(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsNumber()) return env.Null();
+    uintptr_t outAddr = 0;
+    if (!s.resolver.Resolve(info[0].As<Napi::Number>().Int32Value(), outAddr)) return env.Null();
+    return Napi::BigInt::New(env, static_cast<uint64_t>(outAddr));
+}
+
+// resolve many: (handles[]) -> BigUint64Array，解析失败的项为 0
+static Napi::Value ResolveMany(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsArray()) return env.Null();
+    Napi::Array arr = info[0].As<Napi::Array>();
+    std::vector<int> handles(arr.Length());
+    for (uint32_t i = 0; i < arr.Length(); ++i) {
+        handles[i] = arr.Get(i).As<Napi::Number>().Int32Value();
+    }
+    std::vector<uintptr_t> addrs;
+    std::vector<uint8_t> ok;
+    s.resolver.ResolveMany(handles, addrs, ok);
+    Napi::BigUint64Array res = Napi::BigUint64Array::New(env, handles.size());
+    for (size_t i = 0; i < handles.size(); ++i) {
+        res[i] = ok[i] ? static_cast<uint64_t>(addrs[i]) : 0;
+    }
+    return res;
+}
+
+static Napi::Value ReleasePointer(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsNumber()) return Napi::Boolean::New(env, false);
+    return Napi::Boolean::New(env, s.resolver.Release(info[0].As<Napi::Number>().Int32Value()));
+}
+
+static Napi::Value InvalidatePointers(Session& s, const Napi::CallbackInfo& info) {
+    s.resolver.Invalidate();
+    return Napi::Boolean::New(info.Env(), true);
+}
+
 // read/write
-Napi::Value ReadBytes(const Napi::CallbackInfo& info) {
+static Napi::Value ReadBytes(Session& s, const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     uintptr_t addr = 0;
     if (!JsValueToAddress(info[0], addr)) return env.Null();
     size_t size = info[1].As<Napi::Number>().Uint32Value();
     std::vector<uint8_t> buf;
-    if (!imem.ReadBytes(addr, buf, size)) return env.Null();
+    if (!SourceReadBytes(s, addr, buf, size)) return env.Null();
     // return Buffer
     return Napi::Buffer<uint8_t>::Copy(env, buf.data(), buf.size());
 }
 
-Napi::Boolean WriteBytes(const Napi::CallbackInfo& info) {
+// readBytesPartial(addr, size) -> { data: Buffer, bytes, ranges: [{ offset, size }] } | null
+// 按区域边界拆分读取，不可读的部分填 0，ranges 为成功读取的段；快照只能整段读取
+static Napi::Value ReadBytesPartial(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    uintptr_t addr = 0;
+    if (info.Length() < 2 || !JsValueToAddress(info[0], addr) || !info[1].IsNumber()) return env.Null();
+    size_t size = info[1].As<Napi::Number>().Uint32Value();
+    Napi::Buffer<uint8_t> data = Napi::Buffer<uint8_t>::New(env, size);
+    std::vector<ReadSpan> valid;
+    size_t bytes = 0;
+    if (UsesSnapshot(s)) {
+        if (s.snapshot.ReadMemory(addr, data.Data(), size)) {
+            valid.push_back({ addr, data.Data(), size });
+            bytes = size;
+        } else {
+            std::memset(data.Data(), 0, size);
+        }
+    } else {
+        bytes = s.mem.ReadPartial(addr, data.Data(), size, &valid);
+    }
+    Napi::Array ranges = Napi::Array::New(env, valid.size());
+    for (size_t i = 0; i < valid.size(); ++i) {
+        Napi::Object o = Napi::Object::New(env);
+        o.Set("offset", Napi::Number::New(env, static_cast<double>(valid[i].address - addr)));
+        o.Set("size", Napi::Number::New(env, static_cast<double>(valid[i].size)));
+        ranges.Set(static_cast<uint32_t>(i), o);
+    }
+    Napi::Object res = Napi::Object::New(env);
+    res.Set("data", data);
+    res.Set("bytes", Napi::Number::New(env, static_cast<double>(bytes)));
+    res.Set("ranges", ranges);
+    return res;
+}
+
+static Napi::Value WriteBytes(Session& s, const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     uintptr_t addr = 0;
     if (!JsValueToAddress(info[0], addr)) return Napi::Boolean::New(env, false);
     if (!info[1].IsBuffer()) return Napi::Boolean::New(env, false);
     Napi::Buffer<uint8_t> buf = info[1].As<Napi::Buffer<uint8_t>>();
-    bool ok = imem.WriteBytes(addr, buf.Data(), buf.Length());
+    bool ok = s.mem.WriteBytes(addr, buf.Data(), buf.Length());
+    return Napi::Boolean::New(env, ok);
+}
+
+// readMany 的参数解析：addresses/sizes -> 按输入顺序紧密排列的请求，total 为总字节数
+static bool ParseReadRequests(const Napi::Value& addresses, const Napi::Value& sizeArg,
+                              std::vector<ReadRequest>& reqs, size_t& total) {
+    reqs.clear();
+    if (addresses.IsTypedArray() && addresses.As<Napi::TypedArray>().TypedArrayType() == napi_biguint64_array) {
+        Napi::BigUint64Array a = addresses.As<Napi::BigUint64Array>();
+        for (size_t i = 0; i < a.ElementLength(); ++i) {
+            reqs.push_back({ static_cast<uintptr_t>(a[i]), 0, 0 });
+        }
+    } else if (addresses.IsArray()) {
+        Napi::Array a = addresses.As<Napi::Array>();
+        uint32_t len = a.Length();
+        for (uint32_t i = 0; i < len; ++i) {
+            uintptr_t addr = 0;
+            if (!JsValueToAddress(a.Get(i), addr)) return false;
+            reqs.push_back({ addr, 0, 0 });
+        }
+    } else {
+        return false;
+    }
+
+    total = 0;
+    for (size_t i = 0; i < reqs.size(); ++i) {
+        uint32_t size = 0;
+        if (sizeArg.IsNumber()) {
+            size = sizeArg.As<Napi::Number>().Uint32Value();
+        } else if (sizeArg.IsTypedArray() && sizeArg.As<Napi::TypedArray>().TypedArrayType() == napi_uint32_array) {
+            Napi::Uint32Array sizes = sizeArg.As<Napi::Uint32Array>();
+            if (i >= sizes.ElementLength()) return false;
+            size = sizes[i];
+        } else if (sizeArg.IsArray()) {
+            Napi::Array sizes = sizeArg.As<Napi::Array>();
+            if (i >= sizes.Length()) return false;
+            size = sizes.Get(static_cast<uint32_t>(i)).As<Napi::Number>().Uint32Value();
+        } else {
+            return false;
+        }
+        reqs[i].size = size;
+        reqs[i].outOffset = total;
+        total += size;
+    }
+    return true;
+}
+
+// readMany(addresses, sizes, out, okBits?) -> okBits
+// addresses: Array<BigInt|Number> | BigUint64Array；sizes: Array<Number> | Uint32Array | Number（统一大小）
+// 结果按输入顺序紧密排列写入调用方提供的 out Buffer，返回逐项成功位图
+static Napi::Value ReadMany(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 3 || !info[2].IsBuffer()) return env.Null();
+
+    thread_local std::vector<ReadRequest> reqs;
+    size_t total = 0;
+    if (!ParseReadRequests(info[0], info[1], reqs, total)) return env.Null();
+
+    Napi::Buffer<uint8_t> out = info[2].As<Napi::Buffer<uint8_t>>();
+    if (out.Length() < total) return env.Null();
+
+    size_t bitBytes = (reqs.size() + 7) / 8;
+    Napi::Buffer<uint8_t> okBits;
+    if (info.Length() > 3 && info[3].IsBuffer() && info[3].As<Napi::Buffer<uint8_t>>().Length() >= bitBytes) {
+        okBits = info[3].As<Napi::Buffer<uint8_t>>();
+    } else {
+        okBits = Napi::Buffer<uint8_t>::New(env, bitBytes);
+    }
+    ReadBatch(Source(s), reqs.data(), reqs.size(), out.Data(), okBits.Data());
+    return okBits;
+}
+
+// 类型参数：IDataType 名称（"int32"）或 valueTypes 中的数字标签
+static bool ParseTypeArg(const Napi::Value& value, ValueType& out) {
+    if (value.IsNumber()) {
+        uint32_t tag = value.As<Napi::Number>().Uint32Value();
+        if (tag > static_cast<uint32_t>(ValueType::Double)) return false;
+        out = static_cast<ValueType>(tag);
+        return true;
+    }
+    return value.IsString() && ParseValueType(value.As<Napi::String>().Utf8Value(), out);
+}
+
+// 第 i 项的类型：types 为单个类型时所有项共用
+static bool ParseTypeAt(const Napi::Value& types, uint32_t i, ValueType& out) {
+    if (types.IsArray()) {
+        Napi::Array a = types.As<Napi::Array>();
+        return i < a.Length() && ParseTypeArg(a.Get(i), out);
+    }
+    return ParseTypeArg(types, out);
+}
+
+// 目标参数：地址（BigInt/Number）或指针路径数组，路径在 native 侧直接解析
+static bool ResolveTarget(Session& s, const Napi::Value& target, uintptr_t& addr) {
+    if (target.IsArray()) {
+        PointerPath path;
+        return ParsePointerPath(target, path) && SourceResolver(s).ResolvePath(path, addr);
+    }
+    return JsValueToAddress(target, addr);
+}
+
+// readValue(target, type) -> Number | BigInt | null，64 位整数返回 BigInt
+static Napi::Value ReadValue(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    ValueType type;
+    uintptr_t addr = 0;
+    if (info.Length() < 2 || !ParseTypeArg(info[1], type) || !ResolveTarget(s, info[0], addr)) return env.Null();
+    uint64_t raw = 0;
+    if (!Source(s).ReadMemory(addr, &raw, ValueTypeSize(type))) return env.Null();
+    return TypedToJsValue(env, type, &raw);
+}
+
+// writeValue(target, type, value) -> bool，64 位整数传 BigInt 时不损失精度
+static Napi::Value WriteValue(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    ValueType type;
+    uintptr_t addr = 0;
+    uint64_t raw = 0;
+    if (info.Length() < 3 || !ParseTypeArg(info[1], type) || !JsValueToTyped(info[2], type, raw) ||
+        !ResolveTarget(s, info[0], addr)) {
+        return Napi::Boolean::New(env, false);
+    }
+    bool ok = s.mem.WriteBytes(addr, reinterpret_cast<const uint8_t*>(&raw), ValueTypeSize(type));
     return Napi::Boolean::New(env, ok);
 }
 
+// readValues(targets, type | types) -> Array<Number | BigInt | null>
+// 所有项合并为一次 ReadBatch，相邻地址共用一次读取
+static Napi::Value ReadValues(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 2 || !info[0].IsArray()) return env.Null();
+    Napi::Array targets = info[0].As<Napi::Array>();
+    uint32_t count = targets.Length();
+
+    thread_local std::vector<ReadRequest> reqs;
+    thread_local std::vector<ValueType> types;
+    thread_local std::vector<uint32_t> slots;
+    thread_local std::vector<uint64_t> values;
+    thread_local std::vector<uint8_t> bits;
+    reqs.clear();
+    types.assign(count, ValueType::Int32);
+    slots.assign(count, UINT32_MAX);
+    values.assign(count, 0);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (!ParseTypeAt(info[1], i, types[i])) return env.Null();
+        uintptr_t addr = 0;
+        if (!ResolveTarget(s, targets.Get(i), addr)) continue;
+        slots[i] = static_cast<uint32_t>(reqs.size());
+        reqs.push_back({ addr, static_cast<uint32_t>(ValueTypeSize(types[i])), i * 8 });
+    }
+    bits.assign((reqs.size() + 7) / 8, 0);
+    ReadBatch(Source(s), reqs.data(), reqs.size(), reinterpret_cast<uint8_t*>(values.data()), bits.data());
+
+    Napi::Array res = Napi::Array::New(env, count);
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t k = slots[i];
+        bool ok = k != UINT32_MAX && (bits[k / 8] >> (k % 8)) & 1;
+        res.Set(i, ok ? TypedToJsValue(env, types[i], &values[i]) : env.Null());
+    }
+    return res;
+}
+
+// writeValues(targets, type | types, values) -> okBits Buffer | null
+// 通过写入事务提交，同一页内的写入只修改一次保护属性
+static Napi::Value WriteValues(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 3 || !info[0].IsArray() || !info[2].IsArray()) return env.Null();
+    Napi::Array targets = info[0].As<Napi::Array>();
+    Napi::Array values = info[2].As<Napi::Array>();
+    uint32_t count = targets.Length();
+    if (values.Length() < count) return env.Null();
+
+    thread_local WriteTransaction txn;
+    thread_local std::vector<uint32_t> slots;
+    thread_local std::vector<uint8_t> bits;
+    txn.Clear();
+    slots.assign(count, UINT32_MAX);
+    for (uint32_t i = 0; i < count; ++i) {
+        ValueType type;
+        if (!ParseTypeAt(info[1], i, type)) return env.Null();
+        uintptr_t addr = 0;
+        uint64_t raw = 0;
+        if (!JsValueToTyped(values.Get(i), type, raw) || !ResolveTarget(s, targets.Get(i), addr)) continue;
+        slots[i] = static_cast<uint32_t>(txn.Count());
+        txn.Add(addr, &raw, ValueTypeSize(type));
+    }
+    s.mem.CommitWrites(txn, bits);
+
+    Napi::Buffer<uint8_t> okBits = Napi::Buffer<uint8_t>::New(env, (count + 7) / 8);
+    std::memset(okBits.Data(), 0, okBits.Length());
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t k = slots[i];
+        if (k != UINT32_MAX && k / 8 < bits.size() && (bits[k / 8] >> (k % 8)) & 1) okBits.Data()[i / 8] |= 1 << (i % 8);
+    }
+    return okBits;
+}
+
+// gather layout: { mode?: "array" | "pointerArray" | "list", count, stride?, next?, size?,
+//                  fields: [{ name, offset, type, deref?: [offsets...] }] }
+static bool ParseGatherLayout(const Napi::Value& value, GatherLayout& layout) {
+    if (!value.IsObject()) return false;
+    Napi::Object o = value.As<Napi::Object>();
+    Napi::Value mode = o.Get("mode");
+    if (mode.IsString()) {
+        std::string m = mode.As<Napi::String>().Utf8Value();
+        if (m == "array") layout.mode = GatherMode::Array;
+        else if (m == "pointerArray") layout.mode = GatherMode::PointerArray;
+        else if (m == "list") layout.mode = GatherMode::List;
+        else return false;
+    }
+    if (!o.Get("count").IsNumber()) return false;
+    layout.count = o.Get("count").As<Napi::Number>().Uint32Value();
+    if (o.Get("stride").IsNumber()) layout.stride = o.Get("stride").As<Napi::Number>().Uint32Value();
+    if (o.Get("next").IsNumber()) layout.nextOffset = o.Get("next").As<Napi::Number>().Uint32Value();
+    if (o.Get("size").IsNumber()) layout.structSize = o.Get("size").As<Napi::Number>().Uint32Value();
+
+    if (!o.Get("fields").IsArray()) return false;
+    Napi::Array fields = o.Get("fields").As<Napi::Array>();
+    layout.fields.resize(fields.Length());
+    for (uint32_t i = 0; i < fields.Length(); ++i) {
+        if (!fields.Get(i).IsObject()) return false;
+        Napi::Object f = fields.Get(i).As<Napi::Object>();
+        GatherField& field = layout.fields[i];
+        if (!f.Get("name").IsString() || !f.Get("offset").IsNumber() || !ParseTypeArg(f.Get("type"), field.type)) return false;
+        field.name = f.Get("name").As<Napi::String>().Utf8Value();
+        field.offset = f.Get("offset").As<Napi::Number>().Uint32Value();
+        Napi::Value deref = f.Get("deref");
+        if (deref.IsArray()) {
+            Napi::Array d = deref.As<Napi::Array>();
+            for (uint32_t k = 0; k < d.Length(); ++k) {
+                uint64_t off = 0;
+                Napi::Value v = d.Get(k);
+                if (v.IsString()) {
+                    if (!ParseNumberString(v.As<Napi::String>().Utf8Value(), off)) return false;
+                } else if (v.IsNumber()) {
+                    off = static_cast<uint64_t>(v.As<Napi::Number>().DoubleValue());
+                } else {
+                    return false;
+                }
+                field.deref.push_back(off);
+            }
+        }
+    }
+    return true;
+}
+
+// 列数据 -> 对应类型的 TypedArray（int64/uint64 为 BigInt64Array/BigUint64Array）
+static Napi::Value ColumnToTypedArray(Napi::Env env, ValueType type, const std::vector<uint8_t>& col, size_t count) {
+    return DispatchValueType(type, [&](auto tag) -> Napi::Value {
+        using T = decltype(tag);
+        Napi::ArrayBuffer buf = Napi::ArrayBuffer::New(env, col.size());
+        if (!col.empty()) std::memcpy(buf.Data(), col.data(), col.size());
+        return Napi::TypedArrayOf<T>::New(env, count, buf, 0);
+    });
+}
+
+// gather(target, layout) -> { count, addresses: BigUint64Array, valid: Uint8Array, fields: { name: TypedArray } } | null
+static Napi::Value GatherStructs(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    GatherLayout layout;
+    uintptr_t base = 0;
+    if (info.Length() < 2 || !ParseGatherLayout(info[1], layout) || !ResolveTarget(s, info[0], base)) return env.Null();
+    thread_local GatherResult result;
+    if (!Gather(Source(s), base, layout, result)) return env.Null();
+
+    size_t count = result.count;
+    Napi::Object res = Napi::Object::New(env);
+    res.Set("count", Napi::Number::New(env, static_cast<double>(count)));
+    Napi::BigUint64Array addrs = Napi::BigUint64Array::New(env, count);
+    Napi::Uint8Array valid = Napi::Uint8Array::New(env, count);
+    for (size_t i = 0; i < count; ++i) {
+        addrs[i] = static_cast<uint64_t>(result.addresses[i]);
+        valid[i] = result.valid[i];
+    }
+    res.Set("addresses", addrs);
+    res.Set("valid", valid);
+    Napi::Object fields = Napi::Object::New(env);
+    for (size_t j = 0; j < layout.fields.size(); ++j) {
+        fields.Set(layout.fields[j].name, ColumnToTypedArray(env, layout.fields[j].type, result.columns[j], count));
+    }
+    res.Set("fields", fields);
+    return res;
+}
+
+// write transactions: beginWrites() -> id; addWrite(id, addr, Buffer) -> bool; commitWrites(id) -> okBits Buffer | null
+static Napi::Value BeginWrites(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    int id = s.nextTxnId++;
+    s.writeTxns[id];
+    return Napi::Number::New(env, id);
+}
+
+static Napi::Value AddWrite(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 3 || !info[0].IsNumber() || !info[2].IsBuffer()) return Napi::Boolean::New(env, false);
+    auto it = s.writeTxns.find(info[0].As<Napi::Number>().Int32Value());
+    if (it == s.writeTxns.end()) return Napi::Boolean::New(env, false);
+    uintptr_t addr = 0;
+    if (!JsValueToAddress(info[1], addr)) return Napi::Boolean::New(env, false);
+    Napi::Buffer<uint8_t> buf = info[2].As<Napi::Buffer<uint8_t>>();
+    if (buf.Length() == 0) return Napi::Boolean::New(env, false);
+    it->second.Add(addr, buf.Data(), buf.Length());
+    return Napi::Boolean::New(env, true);
+}
+
+static Napi::Value CommitWrites(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsNumber()) return env.Null();
+    auto it = s.writeTxns.find(info[0].As<Napi::Number>().Int32Value());
+    if (it == s.writeTxns.end()) return env.Null();
+    std::vector<uint8_t> bits;
+    s.mem.CommitWrites(it->second, bits);
+    s.writeTxns.erase(it);
+    return Napi::Buffer<uint8_t>::Copy(env, bits.data(), bits.size());
+}
+
+// read cache: setReadCache({ enabled, pageSize, maxPages, maxAgeMs }) -> bool; nextReadEpoch() -> epoch
+static Napi::Value SetReadCache(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1) return Napi::Boolean::New(env, false);
+    PageCacheOptions opts = s.mem.ReadCacheOptions();
+    if (info[0].IsBoolean()) {
+        opts.enabled = info[0].As<Napi::Boolean>().Value();
+    } else if (info[0].IsObject()) {
+        Napi::Object o = info[0].As<Napi::Object>();
+        opts.enabled = !o.Has("enabled") || o.Get("enabled").ToBoolean().Value();
+        if (o.Has("pageSize")) opts.pageSize = o.Get("pageSize").As<Napi::Number>().Uint32Value();
+        if (o.Has("maxPages")) opts.maxPages = o.Get("maxPages").As<Napi::Number>().Uint32Value();
+        if (o.Has("maxAgeMs")) opts.maxAgeMs = o.Get("maxAgeMs").As<Napi::Number>().Uint32Value();
+    } else {
+        return Napi::Boolean::New(env, false);
+    }
+    return Napi::Boolean::New(env, s.mem.ConfigureReadCache(opts));
+}
+
+static Napi::Value NextReadEpoch(Session& s, const Napi::CallbackInfo& info) {
+    return Napi::Number::New(info.Env(), static_cast<double>(s.mem.NextReadEpoch()));
+}
+
+// region map（只作用于在线进程）:
+// getRegions(offset?, count?, includeFree?) -> { total, regions: [{ base, size, state, type, protect, readable, writable, executable, guard }] }
+static const char* RegionStateName(uint32_t flags) {
+    if (flags & RegionCommitted) return "commit";
+    if (flags & RegionReserved) return "reserve";
+    return "free";
+}
+
+static const char* RegionTypeName(uint32_t flags) {
+    if (flags & RegionImage) return "image";
+    if (flags & RegionMapped) return "mapped";
+    if (flags & RegionPrivate) return "private";
+    return "";
+}
+
+static Napi::Value GetRegions(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    size_t offset = info.Length() > 0 && info[0].IsNumber() ? info[0].As<Napi::Number>().Uint32Value() : 0;
+    size_t count = info.Length() > 1 && info[1].IsNumber() ? info[1].As<Napi::Number>().Uint32Value() : 256;
+    bool includeFree = info.Length() > 2 && info[2].ToBoolean().Value();
+    std::vector<MemoryRegion> list;
+    size_t total = s.mem.ListRegions(offset, count, includeFree, list);
+    Napi::Array arr = Napi::Array::New(env, list.size());
+    for (size_t i = 0; i < list.size(); ++i) {
+        const MemoryRegion &r = list[i];
+        Napi::Object o = Napi::Object::New(env);
+        o.Set("base", Napi::BigInt::New(env, static_cast<uint64_t>(r.base)));
+        o.Set("size", Napi::Number::New(env, static_cast<double>(r.size)));
+        o.Set("state", Napi::String::New(env, RegionStateName(r.flags)));
+        o.Set("type", Napi::String::New(env, RegionTypeName(r.flags)));
+        o.Set("protect", Napi::Number::New(env, r.protect));
+        o.Set("readable", Napi::Boolean::New(env, (r.flags & RegionReadable) != 0));
+        o.Set("writable", Napi::Boolean::New(env, (r.flags & RegionWritable) != 0));
+        o.Set("executable", Napi::Boolean::New(env, (r.flags & RegionExecutable) != 0));
+        o.Set("guard", Napi::Boolean::New(env, (r.flags & RegionGuard) != 0));
+        arr.Set(static_cast<uint32_t>(i), o);
+    }
+    Napi::Object res = Napi::Object::New(env);
+    res.Set("total", Napi::Number::New(env, static_cast<double>(total)));
+    res.Set("regions", arr);
+    return res;
+}
+
+// refreshRegions() -> 条目数（完整重建，失败时为 0）
+static Napi::Value RefreshRegions(Session& s, const Napi::CallbackInfo& info) {
+    return Napi::Number::New(info.Env(), static_cast<double>(s.mem.RefreshRegions()));
+}
+
+// setRegionMap({ filterReads, refreshMs, recheckMs }) -> bool
+static Napi::Value SetRegionMap(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsObject()) return Napi::Boolean::New(env, false);
+    RegionMapOptions opts = s.mem.RegionMapSettings();
+    Napi::Object o = info[0].As<Napi::Object>();
+    if (o.Has("filterReads")) opts.filterReads = o.Get("filterReads").ToBoolean().Value();
+    if (o.Has("refreshMs")) opts.refreshMs = o.Get("refreshMs").As<Napi::Number>().Uint32Value();
+    if (o.Has("recheckMs")) opts.recheckMs = o.Get("recheckMs").As<Napi::Number>().Uint32Value();
+    return Napi::Boolean::New(env, s.mem.ConfigureRegionMap(opts));
+}
+
+// getRegionMapStats() -> { entries, complete, rebuilds, queries, filtered, ageMs }
+static Napi::Value GetRegionMapStats(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    RegionMapStats st = s.mem.GetRegionMapStats();
+    Napi::Object res = Napi::Object::New(env);
+    res.Set("entries", Napi::Number::New(env, static_cast<double>(st.entries)));
+    res.Set("complete", Napi::Boolean::New(env, st.complete));
+    res.Set("rebuilds", Napi::Number::New(env, static_cast<double>(st.rebuilds)));
+    res.Set("queries", Napi::Number::New(env, static_cast<double>(st.queries)));
+    res.Set("filtered", Napi::Number::New(env, static_cast<double>(st.filtered)));
+    res.Set("ageMs", Napi::Number::New(env, static_cast<double>(st.ageMs)));
+    return res;
+}
+
 // lock/unlock
-Napi::Number LockMemory(const Napi::CallbackInfo& info) {
+static Napi::Value LockMemory(Session& s, const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     if (info.Length() < 3) return Napi::Number::New(env, -1);
     uintptr_t addr = 0;
@@ -154,36 +780,166 @@ Napi::Number LockMemory(const Napi::CallbackInfo& info) {
     if (!info[1].IsBuffer()) return Napi::Number::New(env, -1);
     Napi::Buffer<uint8_t> buf = info[1].As<Napi::Buffer<uint8_t>>();
     int freq = info[2].As<Napi::Number>().Int32Value();
-    SIZE_T size = buf.Length();
+    bool compareFirst = info.Length() > 3 && info[3].ToBoolean().Value();
+    size_t size = buf.Length();
     std::vector<uint8_t> data(buf.Data(), buf.Data() + buf.Length());
-    int id = imem.LockMemory(addr, data, size, freq);
+    int id = s.mem.LockMemory(addr, data, size, freq, compareFirst);
     return Napi::Number::New(env, id);
 }
 
-Napi::Boolean UnlockMemory(const Napi::CallbackInfo& info) {
+// lockValue(target, type, value, freqMs?, compareFirst?) -> lock id (-1 失败)
+// 值按 type 校验并编码（同 writeValue）；target 为地址或指针路径，路径总是在在线进程中解析
+static Napi::Value LockValue(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    ValueType type;
+    uint64_t raw = 0;
+    if (info.Length() < 3 || !ParseTypeArg(info[1], type) || !JsValueToTyped(info[2], type, raw)) {
+        return Napi::Number::New(env, -1);
+    }
+    uintptr_t addr = 0;
+    if (info[0].IsArray()) {
+        PointerPath path;
+        if (!ParsePointerPath(info[0], path) || !s.resolver.ResolvePath(path, addr)) return Napi::Number::New(env, -1);
+    } else if (!JsValueToAddress(info[0], addr)) {
+        return Napi::Number::New(env, -1);
+    }
+    int freq = info.Length() > 3 && info[3].IsNumber() ? info[3].As<Napi::Number>().Int32Value() : 200;
+    bool compareFirst = info.Length() > 4 && info[4].ToBoolean().Value();
+    size_t size = ValueTypeSize(type);
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&raw);
+    std::vector<uint8_t> data(bytes, bytes + size);
+    return Napi::Number::New(env, s.mem.LockMemory(addr, data, size, freq, compareFirst));
+}
+
+static Napi::Value UnlockMemory(Session& s, const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     if (info.Length() < 1) return Napi::Boolean::New(env, false);
     int id = info[0].As<Napi::Number>().Int32Value();
-    bool ok = imem.UnlockMemory(id);
+    bool ok = s.mem.UnlockMemory(id);
     return Napi::Boolean::New(env, ok);
 }
 
+// lock stats: (lockId) -> { writes, skipped, failures, avgJitterUs, maxJitterUs, writesPerSec } | null
+static Napi::Value GetLockStats(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsNumber()) return env.Null();
+    LockStats st;
+    if (!s.mem.Locks().GetStats(info[0].As<Napi::Number>().Int32Value(), st)) return env.Null();
+    Napi::Object res = Napi::Object::New(env);
+    res.Set("writes", Napi::Number::New(env, static_cast<double>(st.writes)));
+    res.Set("skipped", Napi::Number::New(env, static_cast<double>(st.skipped)));
+    res.Set("failures", Napi::Number::New(env, static_cast<double>(st.failures)));
+    res.Set("avgJitterUs", Napi::Number::New(env, st.avgJitterUs));
+    res.Set("maxJitterUs", Napi::Number::New(env, st.maxJitterUs));
+    res.Set("writesPerSec", Napi::Number::New(env, st.writesPerSec));
+    return res;
+}
+
+// cheat table entry: { pointer, type, value?, lock?, freq?, group? }
+static bool ParseCheatEntry(const Napi::Value& value, CheatEntry& e) {
+    if (!value.IsObject()) return false;
+    Napi::Object o = value.As<Napi::Object>();
+    if (!ParsePointerPath(o.Get("pointer"), e.path) || !ParseTypeArg(o.Get("type"), e.type)) return false;
+    Napi::Value v = o.Get("value");
+    e.hasValue = !v.IsUndefined() && !v.IsNull();
+    if (e.hasValue && !JsValueToTyped(v, e.type, e.value)) return false;
+    e.lock = o.Get("lock").ToBoolean().Value();
+    Napi::Value freq = o.Get("freq");
+    if (freq.IsNumber()) e.freqMs = freq.As<Napi::Number>().Uint32Value();
+    Napi::Value group = o.Get("group");
+    if (group.IsString()) e.group = group.As<Napi::String>().Utf8Value();
+    return true;
+}
+
+// (tableId, group?) -> 表与分组编号，分组为空或省略时作用于整表
+static CheatTable* TableArgs(Session& s, const Napi::CallbackInfo& info, int& group) {
+    if (info.Length() < 1 || !info[0].IsNumber()) return nullptr;
+    CheatTable* table = s.tables.Get(info[0].As<Napi::Number>().Int32Value());
+    if (!table) return nullptr;
+    std::string name;
+    if (info.Length() > 1 && info[1].IsString()) name = info[1].As<Napi::String>().Utf8Value();
+    return table->FindGroup(name, group) ? table : nullptr;
+}
+
+// loadTable(entries[]) -> tableId | null；定义未变化时返回已编译的表（需对应次数的 releaseTable）
+static Napi::Value LoadTable(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsArray()) return env.Null();
+    Napi::Array arr = info[0].As<Napi::Array>();
+    std::vector<CheatEntry> entries(arr.Length());
+    for (uint32_t i = 0; i < arr.Length(); ++i) {
+        if (!ParseCheatEntry(arr.Get(i), entries[i])) return env.Null();
+    }
+    return Napi::Number::New(env, s.tables.Load(entries));
+}
+
+// applyTable(tableId, group?) -> okBits Buffer | null，按表中顺序逐位标记写入成功
+static Napi::Value ApplyTable(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    int group;
+    CheatTable* table = TableArgs(s, info, group);
+    if (!table) return env.Null();
+    std::vector<uint8_t> bits;
+    table->Apply(group, bits);
+    return Napi::Buffer<uint8_t>::Copy(env, bits.data(), bits.size());
+}
+
+// readTable(tableId, group?) -> Array<Number | BigInt | null>，长度为整表项数，未选中或读取失败的项为 null
+static Napi::Value ReadTable(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    int group;
+    CheatTable* table = TableArgs(s, info, group);
+    if (!table) return env.Null();
+    std::vector<uint64_t> values;
+    std::vector<uint8_t> bits;
+    table->Read(group, values, bits);
+    Napi::Array res = Napi::Array::New(env, table->Count());
+    for (uint32_t i = 0; i < table->Count(); ++i) {
+        bool ok = (bits[i / 8] >> (i % 8)) & 1;
+        res.Set(i, ok ? TypedToJsValue(env, table->TypeAt(i), &values[i]) : env.Null());
+    }
+    return res;
+}
+
+// lockTable(tableId, group?, freqMs?) -> 锁定数量；unlockTable(tableId, group?) -> 解除数量
+static Napi::Value LockTable(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    int group;
+    CheatTable* table = TableArgs(s, info, group);
+    if (!table) return Napi::Number::New(env, -1);
+    int freq = info.Length() > 2 && info[2].IsNumber() ? info[2].As<Napi::Number>().Int32Value() : 0;
+    return Napi::Number::New(env, static_cast<double>(table->Lock(group, freq)));
+}
+
+static Napi::Value UnlockTable(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    int group;
+    CheatTable* table = TableArgs(s, info, group);
+    if (!table) return Napi::Number::New(env, -1);
+    return Napi::Number::New(env, static_cast<double>(table->Unlock(group)));
+}
+
+static Napi::Value ReleaseTable(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsNumber()) return Napi::Boolean::New(env, false);
+    return Napi::Boolean::New(env, s.tables.Release(info[0].As<Napi::Number>().Int32Value()));
+}
+
 // shellcode injection: arg0 Buffer shellcode
-Napi::Value InjectShellcode(const Napi::CallbackInfo& info) {
+static Napi::Value InjectShellcode(Session& s, const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     if (info.Length() < 1) return env.Null();
     if (!info[0].IsBuffer()) return env.Null();
     Napi::Buffer<uint8_t> buf = info[0].As<Napi::Buffer<uint8_t>>();
     std::vector<uint8_t> sc(buf.Data(), buf.Data() + buf.Length());
     uintptr_t remote_addr = 0;
-    HANDLE hThread = nullptr;
-    bool ok = imem.InjectShellcode(sc, remote_addr, hThread);
+    uint32_t tid = 0;
+    bool ok = s.mem.InjectShellcode(sc, remote_addr, tid);
     if (!ok) return env.Null();
     Napi::Object res = Napi::Object::New(env);
     res.Set("remote_addr", Napi::BigInt::New(env, static_cast<uint64_t>(remote_addr)));
-    // we cannot return HANDLE cross-process safely; return thread id if needed
-    DWORD tid = GetThreadId(hThread);
-    res.Set("threadId", Napi::Number::New(env, (uint32_t)tid));
+    // we cannot return HANDLE cross-process safely; return thread id instead
+    res.Set("threadId", Napi::Number::New(env, tid));
     return res;
 }
 
@@ -198,22 +954,1369 @@ Napi::Boolean IsProcessRunning(const Napi::CallbackInfo& info) {
     std::wstring wExeName = Utf8ToWstring(exeName);
     std::wstring wExePath = Utf8ToWstring(exePath);
     
-    bool isRunning = IsRunning(wExeName, wExePath);
+    bool isRunning = processWatcher.IsRunning(wExeName, wExePath);
     return Napi::Boolean::New(env, isRunning);
 }
 
-Napi::Object Init(Napi::Env env, Napi::Object exports) {
-    exports.Set("isRunning", Napi::Function::New(env, IsProcessRunning));
-    exports.Set("openByPid", Napi::Function::New(env, OpenByPid));
-    exports.Set("openByName", Napi::Function::New(env, OpenByName));
-    exports.Set("close", Napi::Function::New(env, CloseProc));
-    exports.Set("getModuleBase", Napi::Function::New(env, GetModuleBase));
-    exports.Set("resolvePointer", Napi::Function::New(env, ResolvePointer));
-    exports.Set("readBytes", Napi::Function::New(env, ReadBytes));
-    exports.Set("writeBytes", Napi::Function::New(env, WriteBytes));
-    exports.Set("lockMemory", Napi::Function::New(env, LockMemory));
-    exports.Set("unlockMemory", Napi::Function::New(env, UnlockMemory));
-    exports.Set("injectShellcode", Napi::Function::New(env, InjectShellcode));
+// ---------------- process watch ----------------
+
+// 在 JS 线程取走累积的事件：[{ id, type: 'started' | 'exited', pid, exeName }]
+static void DeliverProcessEvents(Napi::Env env, Napi::Function callback) {
+    std::vector<ProcessEvent> events;
+    processWatcher.TakeEvents(events);
+    if (events.empty() || callback.IsEmpty()) return;
+    Napi::Array arr = Napi::Array::New(env, events.size());
+    for (size_t i = 0; i < events.size(); ++i) {
+        const ProcessEvent &e = events[i];
+        Napi::Object o = Napi::Object::New(env);
+        o.Set("id", Napi::Number::New(env, e.targetId));
+        o.Set("type", Napi::String::New(env, e.started ? "started" : "exited"));
+        o.Set("pid", Napi::Number::New(env, e.pid));
+        o.Set("exeName", Napi::String::New(env, WstringToUtf8(e.exeName)));
+        arr.Set(static_cast<uint32_t>(i), o);
+    }
+    callback.Call({ arr });
+}
+
+// setProcessCallback(fn | null)：登记的目标进程启动或退出时调用 fn(events)
+Napi::Boolean SetProcessCallback(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    std::lock_guard<std::mutex> g(processCallbackMutex);
+    if (hasProcessCallback) {
+        processCallback.Release();
+        hasProcessCallback = false;
+    }
+    if (info.Length() < 1 || !info[0].IsFunction()) return Napi::Boolean::New(env, true);
+    processCallback = Napi::ThreadSafeFunction::New(env, info[0].As<Napi::Function>(), "xmodder-process", 0, 1);
+    processCallback.Unref(env);
+    hasProcessCallback = true;
+    processWatcher.SetNotify([]() {
+        std::lock_guard<std::mutex> g(processCallbackMutex);
+        if (hasProcessCallback) processCallback.NonBlockingCall(DeliverProcessEvents);
+    });
+    processCallback.NonBlockingCall(DeliverProcessEvents);
+    return Napi::Boolean::New(env, true);
+}
+
+// watchProcess(exeName, exePath?) -> id (-1 失败)；exePath 省略时只比较名称
+Napi::Number WatchProcess(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsString()) return Napi::Number::New(env, -1);
+    std::wstring exeName = Utf8ToWstring(info[0].As<Napi::String>().Utf8Value());
+    std::wstring exePath;
+    if (info.Length() > 1 && info[1].IsString()) exePath = Utf8ToWstring(info[1].As<Napi::String>().Utf8Value());
+    return Napi::Number::New(env, processWatcher.AddTarget(exeName, exePath));
+}
+
+Napi::Boolean UnwatchProcess(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsNumber()) return Napi::Boolean::New(env, false);
+    return Napi::Boolean::New(env, processWatcher.RemoveTarget(info[0].As<Napi::Number>().Int32Value()));
+}
+
+// setProcessPollInterval(ms)：进程表的刷新间隔，默认 500ms
+Napi::Boolean SetProcessPollInterval(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsNumber()) return Napi::Boolean::New(env, false);
+    processWatcher.SetInterval(info[0].As<Napi::Number>().Uint32Value());
+    return Napi::Boolean::New(env, true);
+}
+
+// 比较条件的参数：value 为 a；between/approx 的 value2 为 b（上界或容差），
+// increasedBy/decreasedBy 的 value2 为可选的浮点容差；与旧值比较的其余条件不需要参数
+static bool ParseCompareValues(CompareOp op, ValueType type, const Napi::Value& value, const Napi::Value& value2,
+                               CompareArgs& args) {
+    switch (op) {
+        case CompareOp::Any:
+        case CompareOp::Changed:
+        case CompareOp::Unchanged:
+        case CompareOp::Increased:
+        case CompareOp::Decreased:
+            return true;
+        case CompareOp::Between:
+        case CompareOp::Approx:
+            return JsValueToTyped(value, type, args.a) && JsValueToTyped(value2, type, args.b);
+        case CompareOp::IncreasedBy:
+        case CompareOp::DecreasedBy:
+            if (!JsValueToTyped(value, type, args.a)) return false;
+            return value2.IsUndefined() || JsValueToTyped(value2, type, args.b);
+        default:
+            return JsValueToTyped(value, type, args.a);
+    }
+}
+
+static bool ParseCompareName(const Napi::Object& o, CompareOp& op) {
+    if (!o.Has("compare")) return true;
+    Napi::Value v = o.Get("compare");
+    return v.IsString() && ParseCompareOp(v.As<Napi::String>().Utf8Value(), op);
+}
+
+// firstScan/firstScanAsync 的参数解析：(type, value, options?)
+// options.compare 为比较条件（默认 "equal"，"any" 为未知初始值），第二个参数为 options.value2
+static bool ParseScanArgs(const Napi::CallbackInfo& info, ScanOptions& opts, CompareOp& op, CompareArgs& args) {
+    if (info.Length() < 2 || !info[0].IsString()) return false;
+    if (!ParseValueType(info[0].As<Napi::String>().Utf8Value(), opts.type)) return false;
+
+    op = CompareOp::Equal;
+    Napi::Value value2 = info.Env().Undefined();
+    if (info.Length() > 2 && info[2].IsObject()) {
+        Napi::Object o = info[2].As<Napi::Object>();
+        if (o.Has("alignment")) opts.alignment = o.Get("alignment").As<Napi::Number>().Uint32Value();
+        if (o.Has("writableOnly")) opts.writableOnly = o.Get("writableOnly").ToBoolean().Value();
+        if (o.Has("includeMapped")) opts.includeMapped = o.Get("includeMapped").ToBoolean().Value();
+        if (o.Has("start") && !JsValueToAddress(o.Get("start"), opts.startAddress)) return false;
+        if (o.Has("end") && !JsValueToAddress(o.Get("end"), opts.endAddress)) return false;
+        if (o.Has("memoryBudget")) opts.memoryBudget = static_cast<size_t>(o.Get("memoryBudget").As<Napi::Number>().DoubleValue());
+        if (!ParseCompareName(o, op)) return false;
+        value2 = o.Get("value2");
+    }
+    // 首次扫描没有旧值可比较
+    if (CompareNeedsOld(op)) return false;
+    return ParseCompareValues(op, opts.type, info[1], value2, args);
+}
+
+// nextScan/nextScanAsync 的参数解析：value 或 { compare, value, value2 }
+static bool ParseNextScanArgs(Session& s, const Napi::Value& arg, CompareOp& op, CompareArgs& args) {
+    op = CompareOp::Equal;
+    if (!arg.IsObject()) return JsValueToTyped(arg, s.scanner.Type(), args.a);
+    Napi::Object o = arg.As<Napi::Object>();
+    if (!ParseCompareName(o, op)) return false;
+    return ParseCompareValues(op, s.scanner.Type(), o.Get("value"), o.Get("value2"), args);
+}
+
+// first scan: (type, value, { alignment, writableOnly, includeMapped, start, end, memoryBudget, compare, value2 }?) -> hit count
+// 异步扫描进行中时同步扫描接口返回 null，避免阻塞 JS 线程
+static Napi::Value FirstScan(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (s.scanner.Busy()) return env.Null();
+    ScanOptions opts;
+    CompareOp op;
+    CompareArgs args;
+    if (!ParseScanArgs(info, opts, op, args)) return env.Null();
+    size_t count = s.scanner.FirstScan(Source(s), opts, op, args);
+    return Napi::Number::New(env, static_cast<double>(count));
+}
+
+// next scan: (value | { compare, value, value2 }) -> remaining hit count
+// compare 可取 changed/unchanged/increased/decreased/increasedBy/decreasedBy 与上一轮的数值比较
+static Napi::Value NextScan(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || s.scanner.Busy()) return env.Null();
+    CompareOp op;
+    CompareArgs args;
+    if (!ParseNextScanArgs(s, info[0], op, args)) return env.Null();
+    size_t count = s.scanner.NextScan(Source(s), op, args);
+    return Napi::Number::New(env, static_cast<double>(count));
+}
+
+static Napi::Value GetScanCount(Session& s, const Napi::CallbackInfo& info) {
+    if (s.scanner.Busy()) return info.Env().Null();
+    return Napi::Number::New(info.Env(), static_cast<double>(s.scanner.Count()));
+}
+
+// scan stats: { count, bytes, spilled }
+static Napi::Value GetScanStats(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (s.scanner.Busy()) return env.Null();
+    Napi::Object res = Napi::Object::New(env);
+    res.Set("count", Napi::Number::New(env, static_cast<double>(s.scanner.Count())));
+    res.Set("bytes", Napi::Number::New(env, static_cast<double>(s.scanner.BytesUsed())));
+    res.Set("spilled", Napi::Boolean::New(env, s.scanner.Spilled()));
+    return res;
+}
+
+// scan results: (offset, count) -> [{ address: BigInt, value }]
+static Napi::Value GetScanResults(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (s.scanner.Busy()) return env.Null();
+    size_t offset = info.Length() > 0 ? info[0].As<Napi::Number>().Uint32Value() : 0;
+    size_t count = info.Length() > 1 ? info[1].As<Napi::Number>().Uint32Value() : 100;
+
+    std::vector<ScanHit> hits;
+    s.scanner.GetResults(offset, count, hits);
+    ValueType type = s.scanner.Type();
+    Napi::Array arr = Napi::Array::New(env, hits.size());
+    for (size_t i = 0; i < hits.size(); ++i) {
+        Napi::Object item = Napi::Object::New(env);
+        item.Set("address", Napi::BigInt::New(env, static_cast<uint64_t>(hits[i].address)));
+        item.Set("value", TypedToJsValue(env, type, &hits[i].value));
+        arr.Set(static_cast<uint32_t>(i), item);
+    }
+    return arr;
+}
+
+static Napi::Value ResetScan(Session& s, const Napi::CallbackInfo& info) {
+    if (s.scanner.Busy()) return Napi::Boolean::New(info.Env(), false);
+    s.scanner.Reset();
+    return Napi::Boolean::New(info.Env(), true);
+}
+
+// ---------------- string search ----------------
+
+// options: { encoding: "utf8" | "utf16le" | "both", ignoreCase: bool | "ascii" | "unicode", aligned,
+//            writableOnly, includeMapped, start, end, context, maxResults }
+static bool ParseStringSearchOptions(const Napi::CallbackInfo& info, size_t index, StringSearchOptions& opts) {
+    if (info.Length() <= index || info[index].IsUndefined() || info[index].IsNull()) return true;
+    if (!info[index].IsObject()) return false;
+    Napi::Object o = info[index].As<Napi::Object>();
+    Napi::Value enc = o.Get("encoding");
+    if (enc.IsString()) {
+        std::string e = enc.As<Napi::String>().Utf8Value();
+        if (e == "utf8") opts.encodings = EncodingUtf8;
+        else if (e == "utf16le") opts.encodings = EncodingUtf16LE;
+        else if (e == "both") opts.encodings = EncodingUtf8 | EncodingUtf16LE;
+        else return false;
+    }
+    Napi::Value ic = o.Get("ignoreCase");
+    if (ic.IsString()) {
+        std::string c = ic.As<Napi::String>().Utf8Value();
+        if (c == "ascii") opts.caseMode = StringCase::Ascii;
+        else if (c == "unicode") opts.caseMode = StringCase::Unicode;
+        else return false;
+    } else if (!ic.IsUndefined()) {
+        opts.caseMode = ic.ToBoolean().Value() ? StringCase::Unicode : StringCase::Sensitive;
+    }
+    if (o.Has("aligned")) opts.utf16Aligned = o.Get("aligned").ToBoolean().Value();
+    if (o.Has("writableOnly")) opts.writableOnly = o.Get("writableOnly").ToBoolean().Value();
+    if (o.Has("includeMapped")) opts.includeMapped = o.Get("includeMapped").ToBoolean().Value();
+    if (o.Has("start") && !JsValueToAddress(o.Get("start"), opts.startAddress)) return false;
+    if (o.Has("end") && !JsValueToAddress(o.Get("end"), opts.endAddress)) return false;
+    if (o.Has("context")) opts.contextBytes = std::min<uint32_t>(o.Get("context").As<Napi::Number>().Uint32Value(), 4096);
+    if (o.Has("maxResults")) opts.maxResults = static_cast<size_t>(o.Get("maxResults").As<Napi::Number>().DoubleValue());
+    return true;
+}
+
+// searchString(query, options?) -> 匹配数量 | null
+static Napi::Value SearchString(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    StringSearchOptions opts;
+    if (info.Length() < 1 || !info[0].IsString() || s.stringSearcher.Busy() || !ParseStringSearchOptions(info, 1, opts)) {
+        return env.Null();
+    }
+    size_t count = s.stringSearcher.Search(Source(s), info[0].As<Napi::String>().Utf8Value(), opts);
+    return Napi::Number::New(env, static_cast<double>(count));
+}
+
+// getStringResults(offset, count) -> [{ address, encoding, length, text, before, after }]，文本均已解码为 UTF-8
+static Napi::Value GetStringResults(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (s.stringSearcher.Busy()) return env.Null();
+    size_t offset = info.Length() > 0 ? info[0].As<Napi::Number>().Uint32Value() : 0;
+    size_t count = info.Length() > 1 ? info[1].As<Napi::Number>().Uint32Value() : 100;
+
+    std::vector<StringMatch> matches;
+    s.stringSearcher.GetResults(offset, count, matches);
+    Napi::Array arr = Napi::Array::New(env, matches.size());
+    for (size_t i = 0; i < matches.size(); ++i) {
+        const StringMatch &mt = matches[i];
+        const uint8_t* ctx = mt.context.data();
+        size_t afterAt = mt.before + mt.length;
+        Napi::Object item = Napi::Object::New(env);
+        item.Set("address", Napi::BigInt::New(env, static_cast<uint64_t>(mt.address)));
+        item.Set("encoding", Napi::String::New(env, mt.encoding == EncodingUtf8 ? "utf8" : "utf16le"));
+        item.Set("length", Napi::Number::New(env, mt.length));
+        item.Set("text", Napi::String::New(env, DecodeText(ctx + mt.before, mt.length, mt.encoding)));
+        item.Set("before", Napi::String::New(env, DecodeText(ctx, mt.before, mt.encoding)));
+        item.Set("after", Napi::String::New(env, DecodeText(ctx + afterAt, mt.context.size() - afterAt, mt.encoding)));
+        arr.Set(static_cast<uint32_t>(i), item);
+    }
+    return arr;
+}
+
+static Napi::Value GetStringSearchStats(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (s.stringSearcher.Busy()) return env.Null();
+    Napi::Object res = Napi::Object::New(env);
+    res.Set("count", Napi::Number::New(env, static_cast<double>(s.stringSearcher.Count())));
+    res.Set("truncated", Napi::Boolean::New(env, s.stringSearcher.Truncated()));
+    return res;
+}
+
+static Napi::Value ResetStringSearch(Session& s, const Napi::CallbackInfo& info) {
+    if (s.stringSearcher.Busy()) return Napi::Boolean::New(info.Env(), false);
+    s.stringSearcher.Reset();
+    return Napi::Boolean::New(info.Env(), true);
+}
+
+// ---------------- change tracking ----------------
+
+// options: { writableOnly, includeMapped, start, end, maxCopies, mergeGap }
+static bool ParseChangeTrackerOptions(const Napi::CallbackInfo& info, ChangeTrackerOptions& opts) {
+    if (info.Length() < 1 || info[0].IsUndefined() || info[0].IsNull()) return true;
+    if (!info[0].IsObject()) return false;
+    Napi::Object o = info[0].As<Napi::Object>();
+    if (o.Has("writableOnly")) opts.writableOnly = o.Get("writableOnly").ToBoolean().Value();
+    if (o.Has("includeMapped")) opts.includeMapped = o.Get("includeMapped").ToBoolean().Value();
+    if (o.Has("start") && !JsValueToAddress(o.Get("start"), opts.startAddress)) return false;
+    if (o.Has("end") && !JsValueToAddress(o.Get("end"), opts.endAddress)) return false;
+    if (o.Has("maxCopies")) opts.maxCopies = o.Get("maxCopies").As<Napi::Number>().Uint32Value();
+    if (o.Has("mergeGap")) opts.mergeGap = o.Get("mergeGap").As<Napi::Number>().Uint32Value();
+    return true;
+}
+
+// { epoch, pagesHashed, pages: BigUint64Array, ranges: BigUint64Array }，ranges 按 [address, size] 成对存放
+static Napi::Value ChangeSetToJs(Napi::Env env, const ChangeSet& cs) {
+    Napi::Object res = Napi::Object::New(env);
+    res.Set("epoch", Napi::Number::New(env, cs.epoch));
+    res.Set("pagesHashed", Napi::Number::New(env, static_cast<double>(cs.pagesHashed)));
+    Napi::BigUint64Array pages = Napi::BigUint64Array::New(env, cs.pages.size());
+    for (size_t i = 0; i < cs.pages.size(); ++i) pages[i] = static_cast<uint64_t>(cs.pages[i]);
+    Napi::BigUint64Array ranges = Napi::BigUint64Array::New(env, cs.ranges.size() * 2);
+    for (size_t i = 0; i < cs.ranges.size(); ++i) {
+        ranges[i * 2] = static_cast<uint64_t>(cs.ranges[i].address);
+        ranges[i * 2 + 1] = cs.ranges[i].size;
+    }
+    res.Set("pages", pages);
+    res.Set("ranges", ranges);
+    return res;
+}
+
+// startChangeTracking(options?) -> 跟踪的页数：记录所有可读页的哈希，纪元归零
+static Napi::Value StartChangeTracking(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    ChangeTrackerOptions opts;
+    if (s.changeTracker.Busy() || !ParseChangeTrackerOptions(info, opts)) return env.Null();
+    return Napi::Number::New(env, static_cast<double>(s.changeTracker.Start(Source(s), opts)));
+}
+
+// updateChanges() -> { epoch, pagesHashed, pages, ranges } | null：与上一纪元相比变化的页和字节范围
+static Napi::Value UpdateChanges(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    ChangeSet cs;
+    if (s.changeTracker.Busy() || !s.changeTracker.Update(Source(s), cs)) return env.Null();
+    return ChangeSetToJs(env, cs);
+}
+
+// changedPagesSince(epoch) -> BigUint64Array：该纪元之后变化过的页
+static Napi::Value ChangedPagesSince(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsNumber() || s.changeTracker.Busy()) return env.Null();
+    std::vector<uintptr_t> pages;
+    s.changeTracker.ChangedSince(info[0].As<Napi::Number>().Uint32Value(), pages);
+    Napi::BigUint64Array res = Napi::BigUint64Array::New(env, pages.size());
+    for (size_t i = 0; i < pages.size(); ++i) res[i] = static_cast<uint64_t>(pages[i]);
+    return res;
+}
+
+static Napi::Value GetChangeTrackerStats(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (s.changeTracker.Busy()) return env.Null();
+    Napi::Object res = Napi::Object::New(env);
+    res.Set("epoch", Napi::Number::New(env, s.changeTracker.Epoch()));
+    res.Set("pages", Napi::Number::New(env, static_cast<double>(s.changeTracker.PageCount())));
+    res.Set("bytes", Napi::Number::New(env, static_cast<double>(s.changeTracker.BytesUsed())));
+    return res;
+}
+
+static Napi::Value ResetChangeTracking(Session& s, const Napi::CallbackInfo& info) {
+    if (s.changeTracker.Busy()) return Napi::Boolean::New(info.Env(), false);
+    s.changeTracker.Reset();
+    return Napi::Boolean::New(info.Env(), true);
+}
+
+// ---------------- signature scan ----------------
+
+// aobScan 参数：(module, pattern | patterns[], { codeOnly, useCache }?)
+static bool ParseAobArgs(Session& s, const Napi::CallbackInfo& info, ModuleInfo& module, std::vector<Signature>& sigs,
+                         bool& single, AobSearchOptions& opts) {
+    if (info.Length() < 2 || !info[0].IsString()) return false;
+    auto table = Source(s).GetModules();
+    const ModuleInfo* m = table ? table->Find(Utf8ToWstring(info[0].As<Napi::String>().Utf8Value())) : nullptr;
+    if (!m) return false;
+    module = *m;
+
+    sigs.clear();
+    single = info[1].IsString();
+    if (single) {
+        sigs.emplace_back();
+        if (!Signature::Parse(info[1].As<Napi::String>().Utf8Value(), sigs.back())) return false;
+    } else if (info[1].IsArray()) {
+        Napi::Array arr = info[1].As<Napi::Array>();
+        sigs.resize(arr.Length());
+        for (uint32_t i = 0; i < arr.Length(); ++i) {
+            Napi::Value v = arr.Get(i);
+            if (!v.IsString() || !Signature::Parse(v.As<Napi::String>().Utf8Value(), sigs[i])) return false;
+        }
+    } else {
+        return false;
+    }
+
+    if (info.Length() > 2 && info[2].IsObject()) {
+        Napi::Object o = info[2].As<Napi::Object>();
+        if (o.Has("codeOnly")) opts.codeOnly = o.Get("codeOnly").ToBoolean().Value();
+        if (o.Has("useCache")) opts.useCache = o.Get("useCache").ToBoolean().Value();
+    }
+    return true;
+}
+
+// 单个特征码返回地址数组，多个特征码返回数组的数组
+static Napi::Value AobResultsToJs(Napi::Env env, const std::vector<std::vector<uintptr_t>>& results, bool single) {
+    auto toArray = [&](const std::vector<uintptr_t>& addrs) {
+        Napi::Array a = Napi::Array::New(env, addrs.size());
+        for (size_t k = 0; k < addrs.size(); ++k) {
+            a.Set(static_cast<uint32_t>(k), Napi::BigInt::New(env, static_cast<uint64_t>(addrs[k])));
+        }
+        return a;
+    };
+    if (single) return results.empty() ? Napi::Array::New(env) : toArray(results[0]);
+    Napi::Array arr = Napi::Array::New(env, results.size());
+    for (size_t i = 0; i < results.size(); ++i) arr.Set(static_cast<uint32_t>(i), toArray(results[i]));
+    return arr;
+}
+
+// aobScan(module, "48 8B 05 ?? ?? ?? ??" | [...], options?) -> BigInt[] | BigInt[][] | null
+static Napi::Value AobScan(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    ModuleInfo module;
+    std::vector<Signature> sigs;
+    bool single = false;
+    AobSearchOptions opts;
+    if (!ParseAobArgs(s, info, module, sigs, single, opts)) return env.Null();
+    std::vector<std::vector<uintptr_t>> results;
+    if (!FindSignatures(Source(s), module, sigs, opts, &s.aobCache, results)) return env.Null();
+    return AobResultsToJs(env, results, single);
+}
+
+static Napi::Value LoadAobCache(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsString()) return Napi::Boolean::New(env, false);
+    return Napi::Boolean::New(env, s.aobCache.Load(info[0].As<Napi::String>().Utf8Value()));
+}
+
+static Napi::Value SaveAobCache(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsString()) return Napi::Boolean::New(env, false);
+    return Napi::Boolean::New(env, s.aobCache.Save(info[0].As<Napi::String>().Utf8Value()));
+}
+
+// ---------------- pointer scan ----------------
+// 指针扫描接口在异步扫描进行中时返回 null/false，避免阻塞 JS 线程
+
+static void ParsePointerMapOptions(const Napi::CallbackInfo& info, size_t index, PointerMapOptions& opts) {
+    if (info.Length() <= index || !info[index].IsObject()) return;
+    Napi::Object o = info[index].As<Napi::Object>();
+    if (o.Has("alignment")) opts.alignment = o.Get("alignment").As<Napi::Number>().Uint32Value();
+    if (o.Has("writableOnly")) opts.writableOnly = o.Get("writableOnly").ToBoolean().Value();
+    if (o.Has("includeMapped")) opts.includeMapped = o.Get("includeMapped").ToBoolean().Value();
+}
+
+// pointerScan 参数：(target, { maxDepth, maxOffset, maxResults, intersect }?)
+static bool ParsePointerScanArgs(const Napi::CallbackInfo& info, uintptr_t& target, PointerScanOptions& opts) {
+    if (info.Length() < 1 || !JsValueToAddress(info[0], target)) return false;
+    if (info.Length() > 1 && info[1].IsObject()) {
+        Napi::Object o = info[1].As<Napi::Object>();
+        if (o.Has("maxDepth")) opts.maxDepth = o.Get("maxDepth").As<Napi::Number>().Uint32Value();
+        if (o.Has("maxOffset")) opts.maxOffset = o.Get("maxOffset").As<Napi::Number>().Uint32Value();
+        if (o.Has("maxResults")) opts.maxResults = static_cast<size_t>(o.Get("maxResults").As<Napi::Number>().DoubleValue());
+        if (o.Has("intersect")) opts.intersect = o.Get("intersect").ToBoolean().Value();
+    }
+    return true;
+}
+
+// buildPointerMap(options?) -> 指针数量 | null
+static Napi::Value BuildPointerMap(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (s.pointerScanner.Busy()) return env.Null();
+    PointerMapOptions opts;
+    ParsePointerMapOptions(info, 0, opts);
+    auto table = Source(s).GetModules();
+    if (!s.pointerScanner.BuildMap(Source(s), table.get(), opts)) return env.Null();
+    return Napi::Number::New(env, static_cast<double>(s.pointerScanner.MapSize()));
+}
+
+static Napi::Value SavePointerMap(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsString() || s.pointerScanner.Busy()) return Napi::Boolean::New(env, false);
+    return Napi::Boolean::New(env, s.pointerScanner.SaveMap(info[0].As<Napi::String>().Utf8Value()));
+}
+
+static Napi::Value LoadPointerMap(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsString() || s.pointerScanner.Busy()) return Napi::Boolean::New(env, false);
+    return Napi::Boolean::New(env, s.pointerScanner.LoadMap(info[0].As<Napi::String>().Utf8Value()));
+}
+
+// pointerScan(target, options?) -> 路径数量 | null
+static Napi::Value PointerScan(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (s.pointerScanner.Busy()) return env.Null();
+    uintptr_t target = 0;
+    PointerScanOptions opts;
+    if (!ParsePointerScanArgs(info, target, opts)) return env.Null();
+    return Napi::Number::New(env, static_cast<double>(s.pointerScanner.Scan(target, opts)));
+}
+
+// filterPointerResults(target) -> 在当前进程中仍指向 target 的路径数量
+static Napi::Value FilterPointerResults(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    uintptr_t target = 0;
+    if (info.Length() < 1 || !JsValueToAddress(info[0], target) || s.pointerScanner.Busy()) return env.Null();
+    auto table = Source(s).GetModules();
+    return Napi::Number::New(env, static_cast<double>(s.pointerScanner.Filter(Source(s), table.get(), target)));
+}
+
+static Napi::Value GetPointerScanCount(Session& s, const Napi::CallbackInfo& info) {
+    if (s.pointerScanner.Busy()) return info.Env().Null();
+    return Napi::Number::New(info.Env(), static_cast<double>(s.pointerScanner.Count()));
+}
+
+// pointer scan results: (offset, count) -> [["game.exe+0x1A0", "0x8", "0x30"], ...]，格式同 resolvePointer 的参数
+static Napi::Value GetPointerScanResults(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (s.pointerScanner.Busy()) return env.Null();
+    size_t offset = info.Length() > 0 ? info[0].As<Napi::Number>().Uint32Value() : 0;
+    size_t count = info.Length() > 1 ? info[1].As<Napi::Number>().Uint32Value() : 100;
+
+    std::vector<PointerChain> chains;
+    s.pointerScanner.GetResults(offset, count, chains);
+    auto hex = [](uint64_t v) {
+        char buf[24];
+        snprintf(buf, sizeof(buf), "0x%llX", static_cast<unsigned long long>(v));
+        return std::string(buf);
+    };
+    Napi::Array arr = Napi::Array::New(env, chains.size());
+    for (size_t i = 0; i < chains.size(); ++i) {
+        const PointerChain &c = chains[i];
+        Napi::Array path = Napi::Array::New(env, c.depth + 1);
+        path.Set(0u, Napi::String::New(env, WstringToUtf8(s.pointerScanner.ModuleName(c.module)) + "+" + hex(c.baseOffset)));
+        for (uint32_t k = 0; k < c.depth; ++k) path.Set(k + 1, Napi::String::New(env, hex(c.offsets[k])));
+        arr.Set(static_cast<uint32_t>(i), path);
+    }
+    return arr;
+}
+
+static Napi::Value SavePointerResults(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsString() || s.pointerScanner.Busy()) return Napi::Boolean::New(env, false);
+    return Napi::Boolean::New(env, s.pointerScanner.SaveResults(info[0].As<Napi::String>().Utf8Value()));
+}
+
+static Napi::Value LoadPointerResults(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsString() || s.pointerScanner.Busy()) return Napi::Boolean::New(env, false);
+    return Napi::Boolean::New(env, s.pointerScanner.LoadResults(info[0].As<Napi::String>().Utf8Value()));
+}
+
+static Napi::Value ResetPointerScan(Session& s, const Napi::CallbackInfo& info) {
+    if (s.pointerScanner.Busy()) return Napi::Boolean::New(info.Env(), false);
+    s.pointerScanner.Reset();
+    return Napi::Boolean::New(info.Env(), true);
+}
+
+// ---------------- snapshot ----------------
+
+static void ParseSnapshotOptions(const Napi::CallbackInfo& info, size_t index, SnapshotOptions& opts) {
+    if (info.Length() <= index || !info[index].IsObject()) return;
+    Napi::Object o = info[index].As<Napi::Object>();
+    if (o.Has("writableOnly")) opts.writableOnly = o.Get("writableOnly").ToBoolean().Value();
+    if (o.Has("includeMapped")) opts.includeMapped = o.Get("includeMapped").ToBoolean().Value();
+}
+
+// 快照只能在没有后台任务读取它时打开或关闭
+static bool SnapshotIdle(Session& s) {
+    return s.asyncQueue.Pending() == 0 && !s.scanner.Busy() && !s.pointerScanner.Busy() && !s.changeTracker.Busy() &&
+           !s.stringSearcher.Busy();
+}
+
+// captureSnapshot(path, { writableOnly, includeMapped }?) -> 数据字节数 | null（总是读取在线进程）
+static Napi::Value CaptureSnapshotSync(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsString()) return env.Null();
+    SnapshotOptions opts;
+    ParseSnapshotOptions(info, 1, opts);
+    auto table = s.mem.GetModules();
+    uint64_t bytes = 0;
+    if (!CaptureSnapshot(s.mem, table.get(), info[0].As<Napi::String>().Utf8Value(), opts, &bytes)) return env.Null();
+    return Napi::Number::New(env, static_cast<double>(bytes));
+}
+
+// openSnapshot(path) -> bool；之后只读接口从快照读取，直到 closeSnapshot()
+static Napi::Value OpenSnapshot(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsString() || !SnapshotIdle(s)) return Napi::Boolean::New(env, false);
+    bool ok = s.snapshot.Open(info[0].As<Napi::String>().Utf8Value());
+    s.snapshotResolver.Invalidate();
+    return Napi::Boolean::New(env, ok);
+}
+
+static Napi::Value CloseSnapshot(Session& s, const Napi::CallbackInfo& info) {
+    if (!SnapshotIdle(s)) return Napi::Boolean::New(info.Env(), false);
+    s.snapshot.Close();
+    s.snapshotResolver.Invalidate();
+    return Napi::Boolean::New(info.Env(), true);
+}
+
+// getSnapshotInfo() -> { createdAt, regions, modules, bytes } | null
+static Napi::Value GetSnapshotInfo(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (!s.snapshot.IsOpen()) return env.Null();
+    const SnapshotInfo &si = s.snapshot.Info();
+    Napi::Object o = Napi::Object::New(env);
+    o.Set("createdAt", Napi::Number::New(env, static_cast<double>(si.createdAt)));
+    o.Set("regions", Napi::Number::New(env, static_cast<double>(si.regionCount)));
+    o.Set("modules", Napi::Number::New(env, static_cast<double>(si.moduleCount)));
+    o.Set("bytes", Napi::Number::New(env, static_cast<double>(si.bytes)));
+    return o;
+}
+
+// ---------------- watch ----------------
+
+// 在 JS 线程取走累积的变化，作为一个数组交给回调：[{ id, address: BigInt, value }]，不可读时 value 为 null
+static void DeliverWatchChanges(Napi::Env env, Napi::Function callback, int sessionId) {
+    auto it = sessions.find(sessionId);
+    if (it == sessions.end()) return;   // 会话已回收
+    std::vector<WatchChange> changes;
+    it->second->watcher.TakeChanges(changes);
+    if (changes.empty() || callback.IsEmpty()) return;
+    Napi::Array arr = Napi::Array::New(env, changes.size());
+    for (size_t i = 0; i < changes.size(); ++i) {
+        const WatchChange &c = changes[i];
+        Napi::Object o = Napi::Object::New(env);
+        o.Set("id", Napi::Number::New(env, c.id));
+        o.Set("address", Napi::BigInt::New(env, static_cast<uint64_t>(c.address)));
+        o.Set("value", c.valid ? TypedToJsValue(env, c.type, &c.value) : env.Null());
+        arr.Set(static_cast<uint32_t>(i), o);
+    }
+    callback.Call({ arr });
+}
+
+// setWatchCallback(fn | null)：fn(changes) 每个采样周期最多调用一次，只包含变化的监视项
+static Napi::Value SetWatchCallback(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    std::lock_guard<std::mutex> g(s.watchCallbackMutex);
+    if (s.hasWatchCallback) {
+        s.watchCallback.Release();
+        s.hasWatchCallback = false;
+    }
+    if (info.Length() < 1 || !info[0].IsFunction()) return Napi::Boolean::New(env, true);
+    s.watchCallback = Napi::ThreadSafeFunction::New(env, info[0].As<Napi::Function>(), "xmodder-watch", 0, 1);
+    s.watchCallback.Unref(env);
+    s.hasWatchCallback = true;
+    Session* sp = &s;
+    int id = s.id;
+    auto deliver = [id](Napi::Env env, Napi::Function callback) { DeliverWatchChanges(env, callback, id); };
+    s.watcher.SetNotify([sp, deliver]() {
+        std::lock_guard<std::mutex> g(sp->watchCallbackMutex);
+        if (sp->hasWatchCallback) sp->watchCallback.NonBlockingCall(deliver);
+    });
+    // 旧回调未取走的变化交给新回调
+    s.watchCallback.NonBlockingCall(deliver);
+    return Napi::Boolean::New(env, true);
+}
+
+// addWatch(target, type, periodMs?) -> id (-1 失败)
+// target: 指针路径数组（同 resolvePointer）或地址
+static Napi::Value AddWatch(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 2 || !info[1].IsString()) return Napi::Number::New(env, -1);
+    WatchSpec spec;
+    if (!ParseValueType(info[1].As<Napi::String>().Utf8Value(), spec.type)) return Napi::Number::New(env, -1);
+    if (info.Length() > 2 && info[2].IsNumber()) spec.periodMs = info[2].As<Napi::Number>().Uint32Value();
+
+    if (info[0].IsArray()) {
+        PointerPath path;
+        if (!ParsePointerPath(info[0], path)) return Napi::Number::New(env, -1);
+        spec.pointerHandle = s.resolver.Compile(path);
+    } else if (!JsValueToAddress(info[0], spec.address)) {
+        return Napi::Number::New(env, -1);
+    }
+    int id = s.watcher.Add(spec);
+    if (spec.pointerHandle > 0) {
+        if (id > 0) s.watchHandles[id] = spec.pointerHandle;
+        else s.resolver.Release(spec.pointerHandle);
+    }
+    return Napi::Number::New(env, id);
+}
+
+static Napi::Value RemoveWatch(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsNumber()) return Napi::Boolean::New(env, false);
+    int id = info[0].As<Napi::Number>().Int32Value();
+    bool ok = s.watcher.Remove(id);
+    auto it = s.watchHandles.find(id);
+    if (it != s.watchHandles.end()) {
+        s.resolver.Release(it->second);
+        s.watchHandles.erase(it);
+    }
+    return Napi::Boolean::New(env, ok);
+}
+
+static Napi::Value ClearWatches(Session& s, const Napi::CallbackInfo& info) {
+    s.watcher.Clear();
+    for (auto &kv : s.watchHandles) s.resolver.Release(kv.second);
+    s.watchHandles.clear();
+    return Napi::Boolean::New(info.Env(), true);
+}
+
+// ---------------- async API ----------------
+// 以下函数返回 Promise，在会话自己的 asyncQueue 线程上执行，未完成的调用数超过该会话的上限时以 EBUSY 拒绝。
+// 长操作可传入 createCancelToken() 返回的令牌（模块级，任意会话可用），cancelToken(id) 后以 ECANCELED 拒绝。
+
+// 可选的令牌参数：缺省/undefined 表示不可取消
+static bool ParseCancelToken(const Napi::Value& v, CancelFlag& out) {
+    out = nullptr;
+    if (v.IsUndefined() || v.IsNull()) return true;
+    if (!v.IsNumber()) return false;
+    out = cancelTokens.Get(v.As<Napi::Number>().Int32Value());
+    return out != nullptr;
+}
+
+Napi::Number CreateCancelToken(const Napi::CallbackInfo& info) {
+    return Napi::Number::New(info.Env(), cancelTokens.Create());
+}
+
+Napi::Boolean CancelToken(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsNumber()) return Napi::Boolean::New(env, false);
+    return Napi::Boolean::New(env, cancelTokens.Cancel(info[0].As<Napi::Number>().Int32Value()));
+}
+
+Napi::Boolean ReleaseCancelToken(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsNumber()) return Napi::Boolean::New(env, false);
+    return Napi::Boolean::New(env, cancelTokens.Release(info[0].As<Napi::Number>().Int32Value()));
+}
+
+// setAsyncLimit(n)：本会话未完成异步调用数的上限
+static Napi::Value SetAsyncLimit(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsNumber()) return Napi::Boolean::New(env, false);
+    s.asyncQueue.SetLimit(info[0].As<Napi::Number>().Uint32Value());
+    return Napi::Boolean::New(env, true);
+}
+
+// async stats: { pending, limit }
+static Napi::Value GetAsyncStats(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    Napi::Object res = Napi::Object::New(env);
+    res.Set("pending", Napi::Number::New(env, static_cast<double>(s.asyncQueue.Pending())));
+    res.Set("limit", Napi::Number::New(env, static_cast<double>(s.asyncQueue.Limit())));
+    return res;
+}
+
+// isRunningAsync(exeName, exePath) -> Promise<boolean>
+static Napi::Value IsProcessRunningAsync(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString()) return s.asyncQueue.Rejected(env, "invalid arguments");
+    std::wstring exeName = Utf8ToWstring(info[0].As<Napi::String>().Utf8Value());
+    std::wstring exePath = Utf8ToWstring(info[1].As<Napi::String>().Utf8Value());
+    auto running = std::make_shared<bool>(false);
+    return s.asyncQueue.Enqueue(env,
+        [=](std::string&) { *running = processWatcher.IsRunning(exeName, exePath); return true; },
+        [=](Napi::Env env) -> Napi::Value { return Napi::Boolean::New(env, *running); });
+}
+
+// readBytesAsync(addr, size) -> Promise<Buffer | null>
+static Napi::Value ReadBytesAsync(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    uintptr_t addr = 0;
+    if (info.Length() < 2 || !JsValueToAddress(info[0], addr) || !info[1].IsNumber()) {
+        return s.asyncQueue.Rejected(env, "invalid arguments");
+    }
+    size_t size = info[1].As<Napi::Number>().Uint32Value();
+    auto buf = std::make_shared<std::vector<uint8_t>>();
+    auto ok = std::make_shared<bool>(false);
+    Session* sp = &s;
+    return s.asyncQueue.Enqueue(env,
+        [=](std::string&) { *ok = SourceReadBytes(*sp, addr, *buf, size); return true; },
+        [=](Napi::Env env) -> Napi::Value {
+            if (!*ok) return env.Null();
+            return Napi::Buffer<uint8_t>::Copy(env, buf->data(), buf->size());
+        });
+}
+
+// readManyAsync(addresses, sizes) -> Promise<{ data: Buffer, okBits: Buffer }>
+// 参数格式同 readMany，结果 Buffer 由原生侧分配
+static Napi::Value ReadManyAsync(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto reqs = std::make_shared<std::vector<ReadRequest>>();
+    size_t total = 0;
+    if (info.Length() < 2 || !ParseReadRequests(info[0], info[1], *reqs, total)) {
+        return s.asyncQueue.Rejected(env, "invalid arguments");
+    }
+    auto data = std::make_shared<std::vector<uint8_t>>(total);
+    auto bits = std::make_shared<std::vector<uint8_t>>((reqs->size() + 7) / 8);
+    IMemorySource* src = &Source(s);
+    return s.asyncQueue.Enqueue(env,
+        [=](std::string&) {
+            ReadBatch(*src, reqs->data(), reqs->size(), data->data(), bits->data());
+            return true;
+        },
+        [=](Napi::Env env) -> Napi::Value {
+            Napi::Object res = Napi::Object::New(env);
+            res.Set("data", Napi::Buffer<uint8_t>::Copy(env, data->data(), data->size()));
+            res.Set("okBits", Napi::Buffer<uint8_t>::Copy(env, bits->data(), bits->size()));
+            return res;
+        });
+}
+
+// resolvePointerAsync(path) -> Promise<BigInt | null>
+static Napi::Value ResolvePointerAsync(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    PointerPath path;
+    if (info.Length() < 1 || !ParsePointerPath(info[0], path)) return s.asyncQueue.Rejected(env, "invalid pointer path");
+    auto addr = std::make_shared<uintptr_t>(0);
+    auto ok = std::make_shared<bool>(false);
+    PointerResolver* res = &SourceResolver(s);
+    return s.asyncQueue.Enqueue(env,
+        [=](std::string&) { *ok = res->ResolvePath(path, *addr); return true; },
+        [=](Napi::Env env) -> Napi::Value {
+            if (!*ok) return env.Null();
+            return Napi::BigInt::New(env, static_cast<uint64_t>(*addr));
+        });
+}
+
+// firstScanAsync(type, value, options?, token?) -> Promise<hit count>
+static Napi::Value FirstScanAsync(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    ScanOptions opts;
+    CompareOp op;
+    CompareArgs args;
+    CancelFlag cancel;
+    if (!ParseScanArgs(info, opts, op, args)) return s.asyncQueue.Rejected(env, "invalid scan arguments");
+    if (info.Length() > 3 && !ParseCancelToken(info[3], cancel)) return s.asyncQueue.Rejected(env, "invalid cancel token");
+    auto count = std::make_shared<size_t>(0);
+    IMemorySource* src = &Source(s);
+    Session* sp = &s;
+    return s.asyncQueue.Enqueue(env,
+        [=](std::string&) { *count = sp->scanner.FirstScan(*src, opts, op, args, cancel.get()); return true; },
+        [=](Napi::Env env) -> Napi::Value { return Napi::Number::New(env, static_cast<double>(*count)); },
+        cancel);
+}
+
+// nextScanAsync(value | { compare, value, value2 }, token?) -> Promise<remaining hit count>
+static Napi::Value NextScanAsync(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || s.scanner.Busy()) return s.asyncQueue.Rejected(env, "invalid arguments or scan in progress");
+    CompareOp op;
+    CompareArgs args;
+    CancelFlag cancel;
+    if (!ParseNextScanArgs(s, info[0], op, args)) return s.asyncQueue.Rejected(env, "invalid scan value");
+    if (info.Length() > 1 && !ParseCancelToken(info[1], cancel)) return s.asyncQueue.Rejected(env, "invalid cancel token");
+    auto count = std::make_shared<size_t>(0);
+    IMemorySource* src = &Source(s);
+    Session* sp = &s;
+    return s.asyncQueue.Enqueue(env,
+        [=](std::string&) { *count = sp->scanner.NextScan(*src, op, args, cancel.get()); return true; },
+        [=](Napi::Env env) -> Napi::Value { return Napi::Number::New(env, static_cast<double>(*count)); },
+        cancel);
+}
+
+// searchStringAsync(query, options?, token?) -> Promise<匹配数量>
+static Napi::Value SearchStringAsync(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    StringSearchOptions opts;
+    CancelFlag cancel;
+    if (info.Length() < 1 || !info[0].IsString() || s.stringSearcher.Busy() || !ParseStringSearchOptions(info, 1, opts)) {
+        return s.asyncQueue.Rejected(env, "invalid arguments or search in progress");
+    }
+    if (info.Length() > 2 && !ParseCancelToken(info[2], cancel)) return s.asyncQueue.Rejected(env, "invalid cancel token");
+    std::string query = info[0].As<Napi::String>().Utf8Value();
+    auto count = std::make_shared<size_t>(0);
+    IMemorySource* src = &Source(s);
+    Session* sp = &s;
+    return s.asyncQueue.Enqueue(env,
+        [=](std::string&) { *count = sp->stringSearcher.Search(*src, query, opts, cancel.get()); return true; },
+        [=](Napi::Env env) -> Napi::Value { return Napi::Number::New(env, static_cast<double>(*count)); },
+        cancel);
+}
+
+// startChangeTrackingAsync(options?, token?) -> Promise<page count>
+static Napi::Value StartChangeTrackingAsync(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    ChangeTrackerOptions opts;
+    CancelFlag cancel;
+    if (s.changeTracker.Busy() || !ParseChangeTrackerOptions(info, opts)) {
+        return s.asyncQueue.Rejected(env, "invalid arguments or tracking in progress");
+    }
+    if (info.Length() > 1 && !ParseCancelToken(info[1], cancel)) return s.asyncQueue.Rejected(env, "invalid cancel token");
+    auto count = std::make_shared<size_t>(0);
+    IMemorySource* src = &Source(s);
+    Session* sp = &s;
+    return s.asyncQueue.Enqueue(env,
+        [=](std::string&) { *count = sp->changeTracker.Start(*src, opts, cancel.get()); return true; },
+        [=](Napi::Env env) -> Napi::Value { return Napi::Number::New(env, static_cast<double>(*count)); },
+        cancel);
+}
+
+// updateChangesAsync() -> Promise<{ epoch, pagesHashed, pages, ranges }>
+static Napi::Value UpdateChangesAsync(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (s.changeTracker.Busy()) return s.asyncQueue.Rejected(env, "tracking in progress");
+    auto cs = std::make_shared<ChangeSet>();
+    IMemorySource* src = &Source(s);
+    Session* sp = &s;
+    return s.asyncQueue.Enqueue(env,
+        [=](std::string& error) {
+            if (sp->changeTracker.Update(*src, *cs)) return true;
+            error = "change tracking not started";
+            return false;
+        },
+        [=](Napi::Env env) -> Napi::Value { return ChangeSetToJs(env, *cs); });
+}
+
+// aobScanAsync(module, patterns, options?, token?) -> Promise<BigInt[] | BigInt[][]>
+static Napi::Value AobScanAsync(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    ModuleInfo module;
+    auto sigs = std::make_shared<std::vector<Signature>>();
+    bool single = false;
+    AobSearchOptions opts;
+    CancelFlag cancel;
+    if (!ParseAobArgs(s, info, module, *sigs, single, opts)) return s.asyncQueue.Rejected(env, "invalid module or pattern");
+    if (info.Length() > 3 && !ParseCancelToken(info[3], cancel)) return s.asyncQueue.Rejected(env, "invalid cancel token");
+    auto results = std::make_shared<std::vector<std::vector<uintptr_t>>>();
+    IMemorySource* src = &Source(s);
+    Session* sp = &s;
+    return s.asyncQueue.Enqueue(env,
+        [=](std::string& error) {
+            if (FindSignatures(*src, module, *sigs, opts, &sp->aobCache, *results, cancel.get())) return true;
+            error = "module image could not be read";
+            return false;
+        },
+        [=](Napi::Env env) -> Napi::Value { return AobResultsToJs(env, *results, single); },
+        cancel);
+}
+
+// buildPointerMapAsync(options?, token?) -> Promise<指针数量>
+static Napi::Value BuildPointerMapAsync(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    PointerMapOptions opts;
+    CancelFlag cancel;
+    ParsePointerMapOptions(info, 0, opts);
+    if (info.Length() > 1 && !ParseCancelToken(info[1], cancel)) return s.asyncQueue.Rejected(env, "invalid cancel token");
+    IMemorySource* src = &Source(s);
+    auto table = src->GetModules();
+    Session* sp = &s;
+    return s.asyncQueue.Enqueue(env,
+        [=](std::string& error) {
+            if (sp->pointerScanner.BuildMap(*src, table.get(), opts, cancel.get())) return true;
+            error = "pointer map could not be built";
+            return false;
+        },
+        [sp](Napi::Env env) -> Napi::Value { return Napi::Number::New(env, static_cast<double>(sp->pointerScanner.MapSize())); },
+        cancel);
+}
+
+// pointerScanAsync(target, options?, token?) -> Promise<路径数量>
+static Napi::Value PointerScanAsync(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    uintptr_t target = 0;
+    PointerScanOptions opts;
+    CancelFlag cancel;
+    if (!ParsePointerScanArgs(info, target, opts)) return s.asyncQueue.Rejected(env, "invalid pointer scan arguments");
+    if (info.Length() > 2 && !ParseCancelToken(info[2], cancel)) return s.asyncQueue.Rejected(env, "invalid cancel token");
+    auto count = std::make_shared<size_t>(0);
+    Session* sp = &s;
+    return s.asyncQueue.Enqueue(env,
+        [=](std::string&) { *count = sp->pointerScanner.Scan(target, opts, cancel.get()); return true; },
+        [=](Napi::Env env) -> Napi::Value { return Napi::Number::New(env, static_cast<double>(*count)); },
+        cancel);
+}
+
+// captureSnapshotAsync(path, options?, token?) -> Promise<数据字节数>
+static Napi::Value CaptureSnapshotAsync(Session& s, const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsString()) return s.asyncQueue.Rejected(env, "invalid snapshot path");
+    std::string path = info[0].As<Napi::String>().Utf8Value();
+    SnapshotOptions opts;
+    CancelFlag cancel;
+    ParseSnapshotOptions(info, 1, opts);
+    if (info.Length() > 2 && !ParseCancelToken(info[2], cancel)) return s.asyncQueue.Rejected(env, "invalid cancel token");
+    auto table = s.mem.GetModules();
+    auto bytes = std::make_shared<uint64_t>(0);
+    Session* sp = &s;
+    return s.asyncQueue.Enqueue(env,
+        [=](std::string& error) {
+            if (CaptureSnapshot(sp->mem, table.get(), path, opts, bytes.get(), cancel.get())) return true;
+            error = "snapshot could not be written";
+            return false;
+        },
+        [=](Napi::Env env) -> Napi::Value { return Napi::Number::New(env, static_cast<double>(*bytes)); },
+        cancel);
+}
+
+// getStats() -> { enabled, elapsedSec, threads, sessions, ops: { read|write|protect|napi|lockTick: {...} }, locks: {...} }
+// locks 汇总所有会话的锁定
+// 每个 op：calls, failures, bytes, avgUs, p50Us, p99Us, hist（第 i 项为耗时在 [2^i, 2^(i+1)) ns 内的次数）
+// 构建时未启用统计（TRAINER_STATS）时只返回 { enabled: false, locks: { active, threads } }
+Napi::Value GetStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    Napi::Object res = Napi::Object::New(env);
+    Napi::Object locks = Napi::Object::New(env);
+    size_t activeLocks = 0, lockThreads = 0;
+    for (auto &kv : sessions) {
+        activeLocks += kv.second->mem.Locks().ActiveCount();
+        lockThreads += kv.second->mem.Locks().ThreadCount();
+    }
+    locks.Set("active", Napi::Number::New(env, static_cast<double>(activeLocks)));
+    locks.Set("threads", Napi::Number::New(env, static_cast<double>(lockThreads)));
+    res.Set("sessions", Napi::Number::New(env, static_cast<double>(sessions.size())));
+    res.Set("locks", locks);
+
+    StatsSnapshot st;
+    if (!StatsCollect(st)) {
+        res.Set("enabled", Napi::Boolean::New(env, false));
+        return res;
+    }
+    res.Set("enabled", Napi::Boolean::New(env, true));
+    res.Set("elapsedSec", Napi::Number::New(env, st.elapsedSec));
+    res.Set("threads", Napi::Number::New(env, static_cast<double>(st.threads)));
+    Napi::Object ops = Napi::Object::New(env);
+    for (uint32_t i = 0; i < StatOpCount; ++i) {
+        const StatOpSummary &s = st.ops[i];
+        Napi::Object op = Napi::Object::New(env);
+        op.Set("calls", Napi::Number::New(env, static_cast<double>(s.calls)));
+        op.Set("failures", Napi::Number::New(env, static_cast<double>(s.failures)));
+        op.Set("bytes", Napi::Number::New(env, static_cast<double>(s.bytes)));
+        op.Set("avgUs", Napi::Number::New(env, s.calls ? s.totalNs / 1000.0 / s.calls : 0.0));
+        op.Set("p50Us", Napi::Number::New(env, StatPercentileNs(s, 0.5) / 1000.0));
+        op.Set("p99Us", Napi::Number::New(env, StatPercentileNs(s, 0.99) / 1000.0));
+        Napi::Array hist = Napi::Array::New(env, kStatBuckets);
+        for (uint32_t k = 0; k < kStatBuckets; ++k) hist.Set(k, Napi::Number::New(env, static_cast<double>(s.hist[k])));
+        op.Set("hist", hist);
+        ops.Set(StatOpName(static_cast<StatOp>(i)), op);
+    }
+    res.Set("ops", ops);
+    uint64_t lockWrites = st.counters[StatLockWrites];
+    locks.Set("writes", Napi::Number::New(env, static_cast<double>(lockWrites)));
+    locks.Set("skipped", Napi::Number::New(env, static_cast<double>(st.counters[StatLockSkipped])));
+    locks.Set("failures", Napi::Number::New(env, static_cast<double>(st.counters[StatLockFailures])));
+    locks.Set("writesPerSec", Napi::Number::New(env, st.elapsedSec > 0 ? lockWrites / st.elapsedSec : 0.0));
+    return res;
+}
+
+Napi::Boolean ResetStats(const Napi::CallbackInfo& info) {
+    StatsReset();
+    return Napi::Boolean::New(info.Env(), TRAINER_STATS != 0);
+}
+
+#if TRAINER_STATS
+// 导出函数的包装：统计 JS -> native 同步调用的次数与耗时
+template<typename F, F* Fn>
+Napi::Value Counted(const Napi::CallbackInfo& info) {
+    STAT_TIMER(t);
+    Napi::Value res = Fn(info);
+    STAT_RECORD(StatNapiCall, t, 0, true);
+    return res;
+}
+#define NAPI_FN(fn) Counted<decltype(fn), fn>
+#else
+#define NAPI_FN(fn) fn
+#endif
+
+// 模块级接口：作用于默认会话
+template<Napi::Value (*Fn)(Session&, const Napi::CallbackInfo&)>
+Napi::Value OnDefault(const Napi::CallbackInfo& info) {
+    return Fn(defaultSession, info);
+}
+
+// ---------------- session ----------------
+
+// 按 PID（Number）或进程名（String）附加，返回 PID，失败返回 0
+static uint32_t AttachSession(Session& s, const Napi::Value& target) {
+    uint32_t pid = 0;
+    if (target.IsNumber()) {
+        pid = target.As<Napi::Number>().Uint32Value();
+    } else if (target.IsString()) {
+        pid = processWatcher.FindPidByName(Utf8ToWstring(target.As<Napi::String>().Utf8Value()));
+    }
+    if (pid) pid = s.mem.OpenProcessByPid(pid);
+    s.resolver.Invalidate();
+    return pid;
+}
+
+/**
+ * JS 的 Session 对象：new Session() 得到未附加的会话，Session.openByPid / Session.openByName 创建并附加。
+ * 方法与模块级同名接口的参数和返回值相同（readBytes、lockMemory、firstScan、aobScan、pointerScan 等），
+ * 只作用于本会话，扫描结果、特征码缓存和快照也各自独立。
+ * 对象被回收时停止监视线程和锁定调度线程并关闭进程句柄；close() 可提前关闭进程。
+ */
+class SessionWrap : public Napi::ObjectWrap<SessionWrap> {
+public:
+    static Napi::Function Define(Napi::Env env) {
+        Napi::Function fn = DefineClass(env, "Session", {
+            StaticMethod("openByPid", &SessionWrap::CreateByPid),
+            StaticMethod("openByName", &SessionWrap::CreateByName),
+            InstanceAccessor("pid", &SessionWrap::Pid, nullptr),
+            InstanceMethod("open", &SessionWrap::Open),
+            InstanceMethod("close", &SessionWrap::Close),
+            InstanceMethod("getModuleBase", &SessionWrap::Call<GetModuleBase>),
+            InstanceMethod("listModules", &SessionWrap::Call<ListModules>),
+            InstanceMethod("lookupAddress", &SessionWrap::Call<LookupAddress>),
+            InstanceMethod("resolvePointer", &SessionWrap::Call<ResolvePointer>),
+            InstanceMethod("compilePointer", &SessionWrap::Call<CompilePointer>),
+            InstanceMethod("resolveCompiled", &SessionWrap::Call<ResolveCompiled>),
+            InstanceMethod("resolveMany", &SessionWrap::Call<ResolveMany>),
+            InstanceMethod("releasePointer", &SessionWrap::Call<ReleasePointer>),
+            InstanceMethod("invalidatePointers", &SessionWrap::Call<InvalidatePointers>),
+            InstanceMethod("readBytes", &SessionWrap::Call<ReadBytes>),
+            InstanceMethod("readBytesPartial", &SessionWrap::Call<ReadBytesPartial>),
+            InstanceMethod("readMany", &SessionWrap::Call<ReadMany>),
+            InstanceMethod("writeBytes", &SessionWrap::Call<WriteBytes>),
+            InstanceMethod("readValue", &SessionWrap::Call<ReadValue>),
+            InstanceMethod("writeValue", &SessionWrap::Call<WriteValue>),
+            InstanceMethod("readValues", &SessionWrap::Call<ReadValues>),
+            InstanceMethod("writeValues", &SessionWrap::Call<WriteValues>),
+            InstanceMethod("gather", &SessionWrap::Call<GatherStructs>),
+            InstanceMethod("beginWrites", &SessionWrap::Call<BeginWrites>),
+            InstanceMethod("addWrite", &SessionWrap::Call<AddWrite>),
+            InstanceMethod("commitWrites", &SessionWrap::Call<CommitWrites>),
+            InstanceMethod("setReadCache", &SessionWrap::Call<SetReadCache>),
+            InstanceMethod("nextReadEpoch", &SessionWrap::Call<NextReadEpoch>),
+            InstanceMethod("getRegions", &SessionWrap::Call<GetRegions>),
+            InstanceMethod("refreshRegions", &SessionWrap::Call<RefreshRegions>),
+            InstanceMethod("setRegionMap", &SessionWrap::Call<SetRegionMap>),
+            InstanceMethod("getRegionMapStats", &SessionWrap::Call<GetRegionMapStats>),
+            InstanceMethod("lockMemory", &SessionWrap::Call<LockMemory>),
+            InstanceMethod("lockValue", &SessionWrap::Call<LockValue>),
+            InstanceMethod("unlockMemory", &SessionWrap::Call<UnlockMemory>),
+            InstanceMethod("getLockStats", &SessionWrap::Call<GetLockStats>),
+            InstanceMethod("loadTable", &SessionWrap::Call<LoadTable>),
+            InstanceMethod("applyTable", &SessionWrap::Call<ApplyTable>),
+            InstanceMethod("readTable", &SessionWrap::Call<ReadTable>),
+            InstanceMethod("lockTable", &SessionWrap::Call<LockTable>),
+            InstanceMethod("unlockTable", &SessionWrap::Call<UnlockTable>),
+            InstanceMethod("releaseTable", &SessionWrap::Call<ReleaseTable>),
+            InstanceMethod("injectShellcode", &SessionWrap::Call<InjectShellcode>),
+            InstanceMethod("firstScan", &SessionWrap::Call<FirstScan>),
+            InstanceMethod("nextScan", &SessionWrap::Call<NextScan>),
+            InstanceMethod("getScanCount", &SessionWrap::Call<GetScanCount>),
+            InstanceMethod("getScanStats", &SessionWrap::Call<GetScanStats>),
+            InstanceMethod("getScanResults", &SessionWrap::Call<GetScanResults>),
+            InstanceMethod("resetScan", &SessionWrap::Call<ResetScan>),
+            InstanceMethod("searchString", &SessionWrap::Call<SearchString>),
+            InstanceMethod("getStringResults", &SessionWrap::Call<GetStringResults>),
+            InstanceMethod("getStringSearchStats", &SessionWrap::Call<GetStringSearchStats>),
+            InstanceMethod("resetStringSearch", &SessionWrap::Call<ResetStringSearch>),
+            InstanceMethod("startChangeTracking", &SessionWrap::Call<StartChangeTracking>),
+            InstanceMethod("updateChanges", &SessionWrap::Call<UpdateChanges>),
+            InstanceMethod("changedPagesSince", &SessionWrap::Call<ChangedPagesSince>),
+            InstanceMethod("getChangeTrackerStats", &SessionWrap::Call<GetChangeTrackerStats>),
+            InstanceMethod("resetChangeTracking", &SessionWrap::Call<ResetChangeTracking>),
+            InstanceMethod("aobScan", &SessionWrap::Call<AobScan>),
+            InstanceMethod("loadAobCache", &SessionWrap::Call<LoadAobCache>),
+            InstanceMethod("saveAobCache", &SessionWrap::Call<SaveAobCache>),
+            InstanceMethod("buildPointerMap", &SessionWrap::Call<BuildPointerMap>),
+            InstanceMethod("savePointerMap", &SessionWrap::Call<SavePointerMap>),
+            InstanceMethod("loadPointerMap", &SessionWrap::Call<LoadPointerMap>),
+            InstanceMethod("pointerScan", &SessionWrap::Call<PointerScan>),
+            InstanceMethod("filterPointerResults", &SessionWrap::Call<FilterPointerResults>),
+            InstanceMethod("getPointerScanCount", &SessionWrap::Call<GetPointerScanCount>),
+            InstanceMethod("getPointerScanResults", &SessionWrap::Call<GetPointerScanResults>),
+            InstanceMethod("savePointerResults", &SessionWrap::Call<SavePointerResults>),
+            InstanceMethod("loadPointerResults", &SessionWrap::Call<LoadPointerResults>),
+            InstanceMethod("resetPointerScan", &SessionWrap::Call<ResetPointerScan>),
+            InstanceMethod("captureSnapshot", &SessionWrap::Call<CaptureSnapshotSync>),
+            InstanceMethod("openSnapshot", &SessionWrap::Call<OpenSnapshot>),
+            InstanceMethod("closeSnapshot", &SessionWrap::Call<CloseSnapshot>),
+            InstanceMethod("getSnapshotInfo", &SessionWrap::Call<GetSnapshotInfo>),
+            InstanceMethod("readBytesAsync", &SessionWrap::Call<ReadBytesAsync>),
+            InstanceMethod("readManyAsync", &SessionWrap::Call<ReadManyAsync>),
+            InstanceMethod("resolvePointerAsync", &SessionWrap::Call<ResolvePointerAsync>),
+            InstanceMethod("firstScanAsync", &SessionWrap::Call<FirstScanAsync>),
+            InstanceMethod("nextScanAsync", &SessionWrap::Call<NextScanAsync>),
+            InstanceMethod("searchStringAsync", &SessionWrap::Call<SearchStringAsync>),
+            InstanceMethod("startChangeTrackingAsync", &SessionWrap::Call<StartChangeTrackingAsync>),
+            InstanceMethod("updateChangesAsync", &SessionWrap::Call<UpdateChangesAsync>),
+            InstanceMethod("aobScanAsync", &SessionWrap::Call<AobScanAsync>),
+            InstanceMethod("buildPointerMapAsync", &SessionWrap::Call<BuildPointerMapAsync>),
+            InstanceMethod("pointerScanAsync", &SessionWrap::Call<PointerScanAsync>),
+            InstanceMethod("captureSnapshotAsync", &SessionWrap::Call<CaptureSnapshotAsync>),
+            InstanceMethod("setAsyncLimit", &SessionWrap::Call<SetAsyncLimit>),
+            InstanceMethod("getAsyncStats", &SessionWrap::Call<GetAsyncStats>),
+            InstanceMethod("setWatchCallback", &SessionWrap::Call<SetWatchCallback>),
+            InstanceMethod("addWatch", &SessionWrap::Call<AddWatch>),
+            InstanceMethod("removeWatch", &SessionWrap::Call<RemoveWatch>),
+            InstanceMethod("clearWatches", &SessionWrap::Call<ClearWatches>),
+        });
+        env.SetInstanceData(new Napi::FunctionReference(Napi::Persistent(fn)));
+        return fn;
+    }
+
+    explicit SessionWrap(const Napi::CallbackInfo& info)
+        : Napi::ObjectWrap<SessionWrap>(info), session(new Session(nextSessionId++)) {
+        sessions[session->id] = session.get();
+        // 有未完成的异步调用时持有 JS 对象，会话不会在工作线程使用它期间被回收
+        session->asyncQueue.Init(info.Env());
+        session->asyncQueue.SetActiveHook([this](bool active) {
+            if (active) Ref();
+            else Unref();
+        });
+    }
+
+    ~SessionWrap() {
+        sessions.erase(session->id);
+        // 先断开回调，排队中的投递按 id 查找时会找不到本会话；
+        // 之后 session 析构依次停止监视线程、锁定调度线程并关闭进程句柄
+        session->watcher.SetNotify(nullptr);
+        std::lock_guard<std::mutex> g(session->watchCallbackMutex);
+        if (session->hasWatchCallback) {
+            session->watchCallback.Release();
+            session->hasWatchCallback = false;
+        }
+        session->asyncQueue.Release();
+    }
+
+private:
+    // Session.openByPid(pid) / Session.openByName(name) -> Session | null
+    static Napi::Value CreateByPid(const Napi::CallbackInfo& info) {
+        if (info.Length() < 1 || !info[0].IsNumber()) return info.Env().Null();
+        return Create(info.Env(), info[0]);
+    }
+
+    static Napi::Value CreateByName(const Napi::CallbackInfo& info) {
+        if (info.Length() < 1 || !info[0].IsString()) return info.Env().Null();
+        return Create(info.Env(), info[0]);
+    }
+
+    static Napi::Value Create(Napi::Env env, const Napi::Value& target) {
+        Napi::Object obj = env.GetInstanceData<Napi::FunctionReference>()->New({});
+        SessionWrap* wrap = Unwrap(obj);
+        if (!AttachSession(*wrap->session, target)) return env.Null();
+        return obj;
+    }
+
+    template<Napi::Value (*Fn)(Session&, const Napi::CallbackInfo&)>
+    Napi::Value Call(const Napi::CallbackInfo& info) {
+        STAT_TIMER(t);
+        Napi::Value res = Fn(*session, info);
+        STAT_RECORD(StatNapiCall, t, 0, true);
+        return res;
+    }
+
+    Napi::Value Pid(const Napi::CallbackInfo& info) {
+        return Napi::Number::New(info.Env(), session->mem.ProcessId());
+    }
+
+    // open(pid | name) -> pid，失败返回 0；已附加的进程先关闭
+    Napi::Value Open(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        if (info.Length() < 1) return Napi::Number::New(env, 0);
+        return Napi::Number::New(env, AttachSession(*session, info[0]));
+    }
+
+    Napi::Value Close(const Napi::CallbackInfo& info) {
+        session->mem.CloseProcess();
+        session->resolver.Invalidate();
+        return Napi::Boolean::New(info.Env(), true);
+    }
+
+    std::unique_ptr<Session> session;
+};
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+    defaultSession.asyncQueue.Init(env);
+    exports.Set("isRunning", Napi::Function::New(env, NAPI_FN(IsProcessRunning)));
+    exports.Set("watchProcess", Napi::Function::New(env, NAPI_FN(WatchProcess)));
+    exports.Set("unwatchProcess", Napi::Function::New(env, NAPI_FN(UnwatchProcess)));
+    exports.Set("setProcessCallback", Napi::Function::New(env, NAPI_FN(SetProcessCallback)));
+    exports.Set("setProcessPollInterval", Napi::Function::New(env, NAPI_FN(SetProcessPollInterval)));
+    exports.Set("openByPid", Napi::Function::New(env, NAPI_FN(OpenByPid)));
+    exports.Set("openByName", Napi::Function::New(env, NAPI_FN(OpenByName)));
+    exports.Set("close", Napi::Function::New(env, NAPI_FN(CloseProc)));
+    exports.Set("Session", SessionWrap::Define(env));
+    exports.Set("getModuleBase", Napi::Function::New(env, NAPI_FN(OnDefault<GetModuleBase>)));
+    exports.Set("listModules", Napi::Function::New(env, NAPI_FN(OnDefault<ListModules>)));
+    exports.Set("lookupAddress", Napi::Function::New(env, NAPI_FN(OnDefault<LookupAddress>)));
+    exports.Set("resolvePointer", Napi::Function::New(env, NAPI_FN(OnDefault<ResolvePointer>)));
+    exports.Set("compilePointer", Napi::Function::New(env, NAPI_FN(OnDefault<CompilePointer>)));
+    exports.Set("resolveCompiled", Napi::Function::New(env, NAPI_FN(OnDefault<ResolveCompiled>)));
+    exports.Set("resolveMany", Napi::Function::New(env, NAPI_FN(OnDefault<ResolveMany>)));
+    exports.Set("releasePointer", Napi::Function::New(env, NAPI_FN(OnDefault<ReleasePointer>)));
+    exports.Set("invalidatePointers", Napi::Function::New(env, NAPI_FN(OnDefault<InvalidatePointers>)));
+    exports.Set("readBytes", Napi::Function::New(env, NAPI_FN(OnDefault<ReadBytes>)));
+    exports.Set("readBytesPartial", Napi::Function::New(env, NAPI_FN(OnDefault<ReadBytesPartial>)));
+    exports.Set("readMany", Napi::Function::New(env, NAPI_FN(OnDefault<ReadMany>)));
+    exports.Set("writeBytes", Napi::Function::New(env, NAPI_FN(OnDefault<WriteBytes>)));
+    exports.Set("readValue", Napi::Function::New(env, NAPI_FN(OnDefault<ReadValue>)));
+    exports.Set("writeValue", Napi::Function::New(env, NAPI_FN(OnDefault<WriteValue>)));
+    exports.Set("readValues", Napi::Function::New(env, NAPI_FN(OnDefault<ReadValues>)));
+    exports.Set("writeValues", Napi::Function::New(env, NAPI_FN(OnDefault<WriteValues>)));
+    exports.Set("gather", Napi::Function::New(env, NAPI_FN(OnDefault<GatherStructs>)));
+    // 类型标签：readValue 等接口可直接传数字，省去每次的字符串解析
+    Napi::Object valueTypes = Napi::Object::New(env);
+    const char* typeNames[] = { "int8", "int16", "int32", "int64", "uint8", "uint16", "uint32", "uint64", "float", "double" };
+    for (uint32_t i = 0; i < sizeof(typeNames) / sizeof(typeNames[0]); ++i) {
+        valueTypes.Set(typeNames[i], Napi::Number::New(env, i));
+    }
+    exports.Set("valueTypes", valueTypes);
+    exports.Set("beginWrites", Napi::Function::New(env, NAPI_FN(OnDefault<BeginWrites>)));
+    exports.Set("addWrite", Napi::Function::New(env, NAPI_FN(OnDefault<AddWrite>)));
+    exports.Set("commitWrites", Napi::Function::New(env, NAPI_FN(OnDefault<CommitWrites>)));
+    exports.Set("setReadCache", Napi::Function::New(env, NAPI_FN(OnDefault<SetReadCache>)));
+    exports.Set("nextReadEpoch", Napi::Function::New(env, NAPI_FN(OnDefault<NextReadEpoch>)));
+    exports.Set("getRegions", Napi::Function::New(env, NAPI_FN(OnDefault<GetRegions>)));
+    exports.Set("refreshRegions", Napi::Function::New(env, NAPI_FN(OnDefault<RefreshRegions>)));
+    exports.Set("setRegionMap", Napi::Function::New(env, NAPI_FN(OnDefault<SetRegionMap>)));
+    exports.Set("getRegionMapStats", Napi::Function::New(env, NAPI_FN(OnDefault<GetRegionMapStats>)));
+    exports.Set("lockMemory", Napi::Function::New(env, NAPI_FN(OnDefault<LockMemory>)));
+    exports.Set("lockValue", Napi::Function::New(env, NAPI_FN(OnDefault<LockValue>)));
+    exports.Set("unlockMemory", Napi::Function::New(env, NAPI_FN(OnDefault<UnlockMemory>)));
+    exports.Set("getLockStats", Napi::Function::New(env, NAPI_FN(OnDefault<GetLockStats>)));
+    exports.Set("loadTable", Napi::Function::New(env, NAPI_FN(OnDefault<LoadTable>)));
+    exports.Set("applyTable", Napi::Function::New(env, NAPI_FN(OnDefault<ApplyTable>)));
+    exports.Set("readTable", Napi::Function::New(env, NAPI_FN(OnDefault<ReadTable>)));
+    exports.Set("lockTable", Napi::Function::New(env, NAPI_FN(OnDefault<LockTable>)));
+    exports.Set("unlockTable", Napi::Function::New(env, NAPI_FN(OnDefault<UnlockTable>)));
+    exports.Set("releaseTable", Napi::Function::New(env, NAPI_FN(OnDefault<ReleaseTable>)));
+    exports.Set("firstScan", Napi::Function::New(env, NAPI_FN(OnDefault<FirstScan>)));
+    exports.Set("nextScan", Napi::Function::New(env, NAPI_FN(OnDefault<NextScan>)));
+    exports.Set("getScanCount", Napi::Function::New(env, NAPI_FN(OnDefault<GetScanCount>)));
+    exports.Set("getScanStats", Napi::Function::New(env, NAPI_FN(OnDefault<GetScanStats>)));
+    exports.Set("getScanResults", Napi::Function::New(env, NAPI_FN(OnDefault<GetScanResults>)));
+    exports.Set("resetScan", Napi::Function::New(env, NAPI_FN(OnDefault<ResetScan>)));
+    exports.Set("startChangeTracking", Napi::Function::New(env, NAPI_FN(OnDefault<StartChangeTracking>)));
+    exports.Set("updateChanges", Napi::Function::New(env, NAPI_FN(OnDefault<UpdateChanges>)));
+    exports.Set("changedPagesSince", Napi::Function::New(env, NAPI_FN(OnDefault<ChangedPagesSince>)));
+    exports.Set("getChangeTrackerStats", Napi::Function::New(env, NAPI_FN(OnDefault<GetChangeTrackerStats>)));
+    exports.Set("resetChangeTracking", Napi::Function::New(env, NAPI_FN(OnDefault<ResetChangeTracking>)));
+    exports.Set("searchString", Napi::Function::New(env, NAPI_FN(OnDefault<SearchString>)));
+    exports.Set("getStringResults", Napi::Function::New(env, NAPI_FN(OnDefault<GetStringResults>)));
+    exports.Set("getStringSearchStats", Napi::Function::New(env, NAPI_FN(OnDefault<GetStringSearchStats>)));
+    exports.Set("resetStringSearch", Napi::Function::New(env, NAPI_FN(OnDefault<ResetStringSearch>)));
+    exports.Set("injectShellcode", Napi::Function::New(env, NAPI_FN(OnDefault<InjectShellcode>)));
+    exports.Set("aobScan", Napi::Function::New(env, NAPI_FN(OnDefault<AobScan>)));
+    exports.Set("aobScanAsync", Napi::Function::New(env, NAPI_FN(OnDefault<AobScanAsync>)));
+    exports.Set("loadAobCache", Napi::Function::New(env, NAPI_FN(OnDefault<LoadAobCache>)));
+    exports.Set("saveAobCache", Napi::Function::New(env, NAPI_FN(OnDefault<SaveAobCache>)));
+    exports.Set("buildPointerMap", Napi::Function::New(env, NAPI_FN(OnDefault<BuildPointerMap>)));
+    exports.Set("buildPointerMapAsync", Napi::Function::New(env, NAPI_FN(OnDefault<BuildPointerMapAsync>)));
+    exports.Set("savePointerMap", Napi::Function::New(env, NAPI_FN(OnDefault<SavePointerMap>)));
+    exports.Set("loadPointerMap", Napi::Function::New(env, NAPI_FN(OnDefault<LoadPointerMap>)));
+    exports.Set("pointerScan", Napi::Function::New(env, NAPI_FN(OnDefault<PointerScan>)));
+    exports.Set("pointerScanAsync", Napi::Function::New(env, NAPI_FN(OnDefault<PointerScanAsync>)));
+    exports.Set("filterPointerResults", Napi::Function::New(env, NAPI_FN(OnDefault<FilterPointerResults>)));
+    exports.Set("getPointerScanCount", Napi::Function::New(env, NAPI_FN(OnDefault<GetPointerScanCount>)));
+    exports.Set("getPointerScanResults", Napi::Function::New(env, NAPI_FN(OnDefault<GetPointerScanResults>)));
+    exports.Set("savePointerResults", Napi::Function::New(env, NAPI_FN(OnDefault<SavePointerResults>)));
+    exports.Set("loadPointerResults", Napi::Function::New(env, NAPI_FN(OnDefault<LoadPointerResults>)));
+    exports.Set("resetPointerScan", Napi::Function::New(env, NAPI_FN(OnDefault<ResetPointerScan>)));
+    exports.Set("captureSnapshot", Napi::Function::New(env, NAPI_FN(OnDefault<CaptureSnapshotSync>)));
+    exports.Set("captureSnapshotAsync", Napi::Function::New(env, NAPI_FN(OnDefault<CaptureSnapshotAsync>)));
+    exports.Set("openSnapshot", Napi::Function::New(env, NAPI_FN(OnDefault<OpenSnapshot>)));
+    exports.Set("closeSnapshot", Napi::Function::New(env, NAPI_FN(OnDefault<CloseSnapshot>)));
+    exports.Set("getSnapshotInfo", Napi::Function::New(env, NAPI_FN(OnDefault<GetSnapshotInfo>)));
+    exports.Set("setWatchCallback", Napi::Function::New(env, NAPI_FN(OnDefault<SetWatchCallback>)));
+    exports.Set("addWatch", Napi::Function::New(env, NAPI_FN(OnDefault<AddWatch>)));
+    exports.Set("removeWatch", Napi::Function::New(env, NAPI_FN(OnDefault<RemoveWatch>)));
+    exports.Set("clearWatches", Napi::Function::New(env, NAPI_FN(OnDefault<ClearWatches>)));
+    exports.Set("createCancelToken", Napi::Function::New(env, NAPI_FN(CreateCancelToken)));
+    exports.Set("cancelToken", Napi::Function::New(env, NAPI_FN(CancelToken)));
+    exports.Set("releaseCancelToken", Napi::Function::New(env, NAPI_FN(ReleaseCancelToken)));
+    exports.Set("setAsyncLimit", Napi::Function::New(env, NAPI_FN(OnDefault<SetAsyncLimit>)));
+    exports.Set("getAsyncStats", Napi::Function::New(env, NAPI_FN(OnDefault<GetAsyncStats>)));
+    exports.Set("getStats", Napi::Function::New(env, GetStats));
+    exports.Set("resetStats", Napi::Function::New(env, ResetStats));
+    exports.Set("isRunningAsync", Napi::Function::New(env, NAPI_FN(OnDefault<IsProcessRunningAsync>)));
+    exports.Set("readBytesAsync", Napi::Function::New(env, NAPI_FN(OnDefault<ReadBytesAsync>)));
+    exports.Set("readManyAsync", Napi::Function::New(env, NAPI_FN(OnDefault<ReadManyAsync>)));
+    exports.Set("resolvePointerAsync", Napi::Function::New(env, NAPI_FN(OnDefault<ResolvePointerAsync>)));
+    exports.Set("firstScanAsync", Napi::Function::New(env, NAPI_FN(OnDefault<FirstScanAsync>)));
+    exports.Set("nextScanAsync", Napi::Function::New(env, NAPI_FN(OnDefault<NextScanAsync>)));
+    exports.Set("startChangeTrackingAsync", Napi::Function::New(env, NAPI_FN(OnDefault<StartChangeTrackingAsync>)));
+    exports.Set("updateChangesAsync", Napi::Function::New(env, NAPI_FN(OnDefault<UpdateChangesAsync>)));
+    exports.Set("searchStringAsync", Napi::Function::New(env, NAPI_FN(OnDefault<SearchStringAsync>)));
     return exports;
 }
 
@@ -0,0 +1,85 @@
+#include "utf8.h"
+#include <cstdint>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#ifdef _WIN32
+
+// utf-8 -> wstring
+std::wstring Utf8ToWstring(const std::string& s) {
+    if (s.empty()) return std::wstring();
+    int len = MultiByteToWideChar(CP_UTF8, 0, s.c_str(), (int)s.size(), NULL, 0);
+    std::wstring r(len, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, s.c_str(), (int)s.size(), &r[0], len);
+    return r;
+}
+
+// wstring -> utf-8
+std::string WstringToUtf8(const std::wstring& s) {
+    if (s.empty()) return std::string();
+    int len = WideCharToMultiByte(CP_UTF8, 0, s.c_str(), (int)s.size(), NULL, 0, NULL, NULL);
+    std::string r(len, '\0');
+    WideCharToMultiByte(CP_UTF8, 0, s.c_str(), (int)s.size(), &r[0], len, NULL, NULL);
+    return r;
+}
+
+#else
+
+// utf-8 -> wstring（wchar_t 为 UTF-32），非法序列替换为 U+FFFD
+std::wstring Utf8ToWstring(const std::string& s) {
+    std::wstring r;
+    r.reserve(s.size());
+    size_t i = 0;
+    while (i < s.size()) {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        uint32_t cp = 0;
+        size_t n = 0;
+        if (c < 0x80) { cp = c; n = 0; }
+        else if ((c & 0xE0) == 0xC0) { cp = c & 0x1F; n = 1; }
+        else if ((c & 0xF0) == 0xE0) { cp = c & 0x0F; n = 2; }
+        else if ((c & 0xF8) == 0xF0) { cp = c & 0x07; n = 3; }
+        else { r.push_back(static_cast<wchar_t>(0xFFFD)); ++i; continue; }
+        if (i + n >= s.size()) {   // 序列被截断
+            r.push_back(static_cast<wchar_t>(0xFFFD));
+            break;
+        }
+        bool ok = true;
+        for (size_t k = 1; k <= n; ++k) {
+            unsigned char cc = static_cast<unsigned char>(s[i + k]);
+            if ((cc & 0xC0) != 0x80) { ok = false; break; }
+            cp = (cp << 6) | (cc & 0x3F);
+        }
+        if (!ok) { r.push_back(static_cast<wchar_t>(0xFFFD)); ++i; continue; }
+        r.push_back(static_cast<wchar_t>(cp));
+        i += n + 1;
+    }
+    return r;
+}
+
+// wstring -> utf-8
+std::string WstringToUtf8(const std::wstring& s) {
+    std::string r;
+    r.reserve(s.size());
+    for (wchar_t wc : s) {
+        uint32_t cp = static_cast<uint32_t>(wc);
+        if (cp < 0x80) {
+            r.push_back(static_cast<char>(cp));
+        } else if (cp < 0x800) {
+            r.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+            r.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else if (cp < 0x10000) {
+            r.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+            r.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            r.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else {
+            r.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+            r.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+            r.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            r.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+    }
+    return r;
+}
+
+#endif
@@ -0,0 +1,6 @@
+#pragma once
+#include <string>
+
+// UTF-8 与宽字符串互相转换（Windows 下 wchar_t 为 UTF-16，其他平台为 UTF-32）
+std::wstring Utf8ToWstring(const std::string& s);
+std::string WstringToUtf8(const std::wstring& s);
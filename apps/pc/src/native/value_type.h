@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// 与 src/main/utils.ts 中 IDataType 一一对应
+enum class ValueType : uint8_t {
+    Int8,
+    Int16,
+    Int32,
+    Int64,
+    UInt8,
+    UInt16,
+    UInt32,
+    UInt64,
+    Float,
+    Double,
+};
+
+inline size_t ValueTypeSize(ValueType t) {
+    switch (t) {
+        case ValueType::Int8:
+        case ValueType::UInt8:
+            return 1;
+        case ValueType::Int16:
+        case ValueType::UInt16:
+            return 2;
+        case ValueType::Int32:
+        case ValueType::UInt32:
+        case ValueType::Float:
+            return 4;
+        case ValueType::Int64:
+        case ValueType::UInt64:
+        case ValueType::Double:
+            return 8;
+    }
+    return 0;
+}
+
+// "int32" / "float" ... -> ValueType，未知名称返回 false
+inline bool ParseValueType(const std::string& name, ValueType& out) {
+    static const struct { const char* name; ValueType type; } table[] = {
+        { "int8", ValueType::Int8 },     { "int16", ValueType::Int16 },
+        { "int32", ValueType::Int32 },   { "int64", ValueType::Int64 },
+        { "uint8", ValueType::UInt8 },   { "uint16", ValueType::UInt16 },
+        { "uint32", ValueType::UInt32 }, { "uint64", ValueType::UInt64 },
+        { "float", ValueType::Float },   { "double", ValueType::Double },
+    };
+    for (const auto& e : table) {
+        if (name == e.name) { out = e.type; return true; }
+    }
+    return false;
+}
+
+// 按类型调用 fn(T{})，用于把运行时类型分派到模板实现
+template<typename Fn>
+auto DispatchValueType(ValueType t, Fn&& fn) {
+    switch (t) {
+        case ValueType::Int8:   return fn(int8_t{});
+        case ValueType::Int16:  return fn(int16_t{});
+        case ValueType::Int32:  return fn(int32_t{});
+        case ValueType::Int64:  return fn(int64_t{});
+        case ValueType::UInt8:  return fn(uint8_t{});
+        case ValueType::UInt16: return fn(uint16_t{});
+        case ValueType::UInt32: return fn(uint32_t{});
+        case ValueType::UInt64: return fn(uint64_t{});
+        case ValueType::Float:  return fn(float{});
+        case ValueType::Double: return fn(double{});
+    }
+    return fn(uint8_t{});
+}
@@ -0,0 +1,195 @@
+#include "watch_engine.h"
+#include <algorithm>
+#include <cstring>
+#include "batch_read.h"
+#include "pointer_resolver.h"
+
+WatchEngine::WatchEngine(IMemorySource& mem, PointerResolver& resolver)
+    : mem(mem), resolver(resolver), changed(false), stopping(false), nextId(1) {}
+
+WatchEngine::~WatchEngine() {
+    {
+        std::lock_guard<std::mutex> g(m);
+        stopping = true;
+    }
+    cv.notify_all();
+    if (worker.joinable()) worker.join();
+}
+
+void WatchEngine::SetNotify(std::function<void()> fn) {
+    std::lock_guard<std::mutex> g(m);
+    notify = std::move(fn);
+}
+
+void WatchEngine::EnsureThread() {
+    // 调用方持有 m；线程在第一次添加监视时才启动
+    if (worker.joinable()) return;
+    worker = std::thread([this]() { Run(); });
+}
+
+int WatchEngine::Add(const WatchSpec& spec) {
+    if (spec.pointerHandle <= 0 && spec.address == 0) return -1;
+    int id;
+    {
+        std::lock_guard<std::mutex> g(m);
+        id = nextId++;
+        Watch &w = watches[id];
+        w.spec = spec;
+        if (w.spec.periodMs == 0) w.spec.periodMs = 1;
+        w.due = Clock::now();       // 新加入的监视立即采样一次，首次采样总是作为变化上报
+        w.sampled = false;
+        w.valid = false;
+        w.address = 0;
+        w.value = 0;
+        changed = true;
+        EnsureThread();
+    }
+    cv.notify_all();
+    return id;
+}
+
+bool WatchEngine::Remove(int id) {
+    std::lock_guard<std::mutex> g(m);
+    changes.erase(id);
+    return watches.erase(id) > 0;
+}
+
+void WatchEngine::Clear() {
+    std::lock_guard<std::mutex> g(m);
+    watches.clear();
+    changes.clear();
+}
+
+size_t WatchEngine::Count() {
+    std::lock_guard<std::mutex> g(m);
+    return watches.size();
+}
+
+void WatchEngine::TakeChanges(std::vector<WatchChange>& out) {
+    out.clear();
+    {
+        std::lock_guard<std::mutex> g(m);
+        out.reserve(changes.size());
+        for (auto &kv : changes) out.push_back(kv.second);
+        changes.clear();
+    }
+    std::sort(out.begin(), out.end(), [](const WatchChange& a, const WatchChange& b) { return a.id < b.id; });
+}
+
+void WatchEngine::Run() {
+    std::vector<int> due;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lk(m);
+            if (stopping) return;
+            Clock::time_point now = Clock::now();
+            due.clear();
+            Clock::time_point wake = Clock::time_point::max();
+            // 监视项通常只有数百个，线性扫描即可
+            for (auto &kv : watches) {
+                Watch &w = kv.second;
+                if (w.due <= now) {
+                    due.push_back(kv.first);
+                    // 按计划时间推进，落后超过一个周期时重新对齐
+                    w.due += std::chrono::milliseconds(w.spec.periodMs);
+                    if (w.due <= now) w.due = now + std::chrono::milliseconds(w.spec.periodMs);
+                }
+                wake = std::min(wake, w.due);
+            }
+            if (due.empty()) {
+                auto woken = [this]() { return stopping.load() || changed; };
+                if (watches.empty()) cv.wait(lk, woken);
+                else cv.wait_until(lk, wake, woken);
+                changed = false;
+                continue;
+            }
+        }
+        Sample(due);
+    }
+}
+
+void WatchEngine::Sample(const std::vector<int>& ids) {
+    struct Job {
+        int id;
+        int handle;
+        uintptr_t address;
+        ValueType type;
+        bool resolved;
+    };
+    std::vector<Job> jobs;
+    {
+        std::lock_guard<std::mutex> g(m);
+        jobs.reserve(ids.size());
+        for (int id : ids) {
+            auto it = watches.find(id);
+            if (it == watches.end()) continue;
+            const WatchSpec &s = it->second.spec;
+            jobs.push_back({ id, s.pointerHandle, s.address, s.type, s.pointerHandle <= 0 });
+        }
+    }
+    if (jobs.empty()) return;
+
+    // 指针路径一次批量解析，共享前缀只读一次
+    std::vector<int> handles;
+    std::vector<size_t> handleJobs;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        if (jobs[i].handle <= 0) continue;
+        handles.push_back(jobs[i].handle);
+        handleJobs.push_back(i);
+    }
+    if (!handles.empty()) {
+        std::vector<uintptr_t> addrs;
+        std::vector<uint8_t> ok;
+        resolver.ResolveMany(handles, addrs, ok);
+        for (size_t k = 0; k < handleJobs.size(); ++k) {
+            Job &j = jobs[handleJobs[k]];
+            j.resolved = ok[k] != 0;
+            j.address = ok[k] ? addrs[k] : 0;
+        }
+    }
+
+    // 所有已解析的地址合并为一次批量读取
+    std::vector<ReadRequest> reqs;
+    std::vector<size_t> reqJobs;
+    size_t total = 0;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        if (!jobs[i].resolved) continue;
+        uint32_t size = static_cast<uint32_t>(ValueTypeSize(jobs[i].type));
+        reqs.push_back({ jobs[i].address, size, total });
+        reqJobs.push_back(i);
+        total += size;
+    }
+    std::vector<uint8_t> data(total);
+    std::vector<uint8_t> bits((reqs.size() + 7) / 8);
+    if (!reqs.empty()) ReadBatch(mem, reqs.data(), reqs.size(), data.data(), bits.data());
+
+    std::vector<uint8_t> readOk(jobs.size(), 0);
+    std::vector<uint64_t> values(jobs.size(), 0);
+    for (size_t k = 0; k < reqs.size(); ++k) {
+        if (!((bits[k >> 3] >> (k & 7)) & 1)) continue;
+        readOk[reqJobs[k]] = 1;
+        std::memcpy(&values[reqJobs[k]], data.data() + reqs[k].outOffset, reqs[k].size);
+    }
+
+    std::function<void()> fn;
+    {
+        std::lock_guard<std::mutex> g(m);
+        bool wasEmpty = changes.empty();
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            auto it = watches.find(jobs[i].id);
+            if (it == watches.end()) continue;     // 采样期间被移除
+            Watch &w = it->second;
+            bool valid = readOk[i] != 0;
+            uintptr_t address = valid ? jobs[i].address : 0;
+            uint64_t value = valid ? values[i] : 0;
+            if (w.sampled && w.valid == valid && w.address == address && w.value == value) continue;
+            w.sampled = true;
+            w.valid = valid;
+            w.address = address;
+            w.value = value;
+            changes[jobs[i].id] = { jobs[i].id, valid, address, jobs[i].type, value };
+        }
+        if (wasEmpty && !changes.empty()) fn = notify;
+    }
+    if (fn) fn();
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "memory_source.h"
+#include "value_type.h"
+
+class PointerResolver;
+
+struct WatchSpec {
+    int pointerHandle = 0;          // >0 时每次采样先解析预编译指针，否则使用 address
+    uintptr_t address = 0;
+    ValueType type = ValueType::Int32;
+    uint32_t periodMs = 100;
+};
+
+struct WatchChange {
+    int id;
+    bool valid;                     // false 表示地址无法解析或读取
+    uintptr_t address;
+    ValueType type;
+    uint64_t value;                 // 低位按小端存放原始字节
+};
+
+/**
+ * 数值监视引擎：单个采样线程按各监视项的周期批量解析指针、批量读取，
+ * 只记录与上次采样不同的值（地址变化、可读性变化也算变化）。
+ * 变化累积在待取列表中，同一监视项多次变化只保留最新值；
+ * 待取列表从空变为非空时调用 notify，消费方随后用 TakeChanges 一次取走。
+ * 消费方处理较慢时不会堆积多次通知，静止的值不会产生任何通知。
+ */
+class WatchEngine {
+public:
+    WatchEngine(IMemorySource& mem, PointerResolver& resolver);
+    ~WatchEngine();
+
+    // notify 在采样线程上调用，应尽快返回
+    void SetNotify(std::function<void()> notify);
+
+    int Add(const WatchSpec& spec);
+    bool Remove(int id);
+    void Clear();
+    size_t Count();
+
+    // 取走所有待取的变化，按 id 升序
+    void TakeChanges(std::vector<WatchChange>& out);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Watch {
+        WatchSpec spec;
+        Clock::time_point due;
+        bool sampled;               // 是否已有上次采样值
+        bool valid;
+        uintptr_t address;
+        uint64_t value;
+    };
+
+    void EnsureThread();
+    void Run();
+    void Sample(const std::vector<int>& ids);
+
+    IMemorySource& mem;
+    PointerResolver& resolver;
+
+    std::mutex m;
+    std::condition_variable cv;
+    std::unordered_map<int, Watch> watches;
+    std::unordered_map<int, WatchChange> changes;
+    std::function<void()> notify;
+    bool changed;                   // 监视项增删，需要重新计算唤醒时间
+    std::atomic<bool> stopping;
+    std::thread worker;
+    int nextId;
+};
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/**
+ * 批量写入事务：先收集写入，再由 IMemory::CommitWrites 统一提交。
+ * 提交时按页分组，每段不可写的连续页只修改/恢复一次保护属性，相邻写入合并为一次调用。
+ */
+class WriteTransaction {
+public:
+    struct Item {
+        uintptr_t address;
+        uint32_t size;
+        uint32_t offset;    // 数据在 bytes 中的偏移
+    };
+
+    void Add(uintptr_t address, const void* data, size_t size) {
+        items.push_back({ address, static_cast<uint32_t>(size), static_cast<uint32_t>(bytes.size()) });
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        bytes.insert(bytes.end(), p, p + size);
+    }
+
+    void Clear() {
+        items.clear();
+        bytes.clear();
+    }
+
+    size_t Count() const { return items.size(); }
+    const std::vector<Item>& Items() const { return items; }
+    const uint8_t* Data(const Item& item) const { return bytes.data() + item.offset; }
+
+private:
+    std::vector<Item> items;
+    std::vector<uint8_t> bytes;
+};